@@ -0,0 +1,54 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file bounds_benchmark.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Mesh bounding volumes benchmarks
+ *
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+#include "render/mesh.hpp"
+
+LogLevel loglevel = logERROR;
+
+namespace reveal3d {
+
+namespace {
+
+std::vector<render::Vertex>& Vertices(u32 count) {
+    static std::vector<render::Vertex> vertices;
+    if (vertices.size() != count) {
+        std::mt19937 generator(42);
+        std::uniform_real_distribution<f32> distribution(-100.0f, 100.0f);
+        vertices.resize(count);
+        for (auto &vertex : vertices) {
+            vertex.pos = { distribution(generator), distribution(generator), distribution(generator) };
+        }
+    }
+    return vertices;
+}
+
+}
+
+void BM_ComputeBounds(benchmark::State &state) {
+    const u32 count = state.range(0);
+    const std::vector<render::Vertex> &vertices = Vertices(count);
+
+    for (auto _ : state) {
+        render::Bounds bounds = render::ComputeBounds(vertices.data(), count);
+        benchmark::DoNotOptimize(bounds);
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+    state.SetBytesProcessed(state.iterations() * count * sizeof(render::Vertex));
+}
+
+BENCHMARK(BM_ComputeBounds)->Arg(1'000)->Arg(100'000)->Arg(10'000'000)->Unit(benchmark::kMillisecond);
+
+}
@@ -0,0 +1,277 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file gl_submission_benchmark.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief OpenGL submission benchmarks
+ *
+ * CPU time to submit a frame of copies of one mesh. Uniform draws is the former path
+ * (uniform locations queried every frame, a model uniform and a draw per copy), indirect
+ * writes instances and commands to persistently mapped buffers and issues a single multi
+ * draw. Its second argument is the copies per command, all copies in one command is what
+ * instance batches of a shared mesh submit.
+ *
+ * Runs on a surfaceless EGL context (Mesa llvmpipe works), rendering to a small
+ * framebuffer. GPU work is flushed and waited for with timing paused. Software drivers
+ * transform vertices when a draw is submitted, so their numbers include vertex work.
+ *
+ * State benchmarks set program, vertex array, lighting and model uniforms before every
+ * draw, like the former path did per layer and per copy, either straight to the driver or
+ * through the state cache. Counters are the calls issued and filtered per frame.
+ */
+
+#include <benchmark/benchmark.h>
+#include "graphics/opengl/gl_buffers.hpp"
+#include "graphics/opengl/gl_state.hpp"
+#include "render/mesh.hpp"
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include <cstring>
+
+namespace reveal3d {
+
+using namespace graphics::opengl;
+
+namespace {
+
+constexpr u32 targetSize = 64;
+
+const char *uniformVertex = R"(#version 420 core
+layout (location = 0) in vec3 inPosition;
+uniform mat4 vp;
+uniform mat4 model;
+void main() { gl_Position = vp * model * vec4(inPosition, 1.0); })";
+
+const char *instanceVertex = R"(#version 420 core
+layout (location = 0) in vec3 inPosition;
+layout (location = 3) in mat4 inWorld;
+uniform mat4 vp;
+void main() { gl_Position = vp * (vec4(inPosition, 1.0) * inWorld); })";
+
+const char *fragment = R"(#version 420 core
+out vec4 color;
+uniform vec3 ambientColor;
+uniform float ambientLightIntensity;
+void main() { color = vec4(ambientColor * ambientLightIntensity, 1.0); })";
+
+u32 CreateProgram(const char *vs, const char *fs) {
+    const u32 program = glCreateProgram();
+    for (const auto [type, source] : { std::pair { GL_VERTEX_SHADER, vs }, std::pair { GL_FRAGMENT_SHADER, fs } }) {
+        const u32 shader = glCreateShader(type);
+        glShaderSource(shader, 1, &source, nullptr);
+        glCompileShader(shader);
+        glAttachShader(program, shader);
+    }
+    glLinkProgram(program);
+    return program;
+}
+
+struct Context {
+    bool valid { false };
+    GeometryBuffer geometry;
+    RenderElement mesh {};
+    u32 uniformProgram { 0 };
+    u32 instanceProgram { 0 };
+};
+
+// Context, target and a 12 triangle box, created once for every benchmark
+Context& GetContext() {
+    static Context context;
+    static bool created = false;
+    if (created) return context;
+    created = true;
+
+    auto getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC) eglGetProcAddress("eglGetPlatformDisplayEXT");
+    EGLDisplay display = getPlatformDisplay != nullptr ?
+            getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr) : eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    EGLint major, minor;
+    if (display == EGL_NO_DISPLAY or !eglInitialize(display, &major, &minor) or !eglBindAPI(EGL_OPENGL_API)) return context;
+
+    const EGLint attributes[] = { EGL_CONTEXT_MAJOR_VERSION, 4, EGL_CONTEXT_MINOR_VERSION, 5,
+                                  EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT, EGL_NONE };
+    EGLContext eglContext = eglCreateContext(display, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, attributes);
+    if (eglContext == EGL_NO_CONTEXT or !eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, eglContext)) return context;
+    glewExperimental = GL_TRUE;
+    if (glewInit() != GLEW_OK) return context;
+
+    u32 framebuffer, targets[2];
+    glCreateFramebuffers(1, &framebuffer);
+    glCreateRenderbuffers(2, targets);
+    glNamedRenderbufferStorage(targets[0], GL_RGBA8, targetSize, targetSize);
+    glNamedRenderbufferStorage(targets[1], GL_DEPTH_COMPONENT24, targetSize, targetSize);
+    glNamedFramebufferRenderbuffer(framebuffer, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, targets[0]);
+    glNamedFramebufferRenderbuffer(framebuffer, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, targets[1]);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glViewport(0, 0, targetSize, targetSize);
+    glEnable(GL_DEPTH_TEST);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    std::vector<render::Vertex> vertices(8);
+    for (u32 i = 0; i < 8; ++i) {
+        vertices[i].pos = { i & 1 ? 0.5f : -0.5f, i & 2 ? 0.5f : -0.5f, i & 4 ? 0.5f : -0.5f };
+    }
+    std::vector<u32> indices = { 0, 1, 3, 0, 3, 2, 4, 6, 7, 4, 7, 5, 0, 4, 5, 0, 5, 1,
+                                 2, 3, 7, 2, 7, 6, 0, 2, 6, 0, 6, 4, 1, 5, 7, 1, 7, 3 };
+    context.geometry.Init(1024, 1024);
+    context.mesh = context.geometry.Add(vertices, indices, math::mat4());
+    context.geometry.Flush();
+    context.uniformProgram = CreateProgram(uniformVertex, fragment);
+    context.instanceProgram = CreateProgram(instanceVertex, fragment);
+    context.valid = true;
+    return context;
+}
+
+// Copies on a grid in front of the camera, small enough to cover a few pixels each
+std::vector<render::Instance> GetInstances(u32 count) {
+    std::vector<render::Instance> instances(count);
+    for (u32 i = 0; i < count; ++i) {
+        f32 *world = (f32 *) &instances[i].world;
+        std::memset(world, 0, sizeof(math::mat4));
+        world[0] = world[5] = world[10] = world[15] = 0.02f;
+        world[3] = -0.9f + 1.8f * (f32)(i % 50) / 50.0f;
+        world[7] = -0.9f + 1.8f * (f32)(i / 50 % 50) / 50.0f;
+        world[15] = 1.0f;
+    }
+    return instances;
+}
+
+const f32 identity[16] = { 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f };
+
+}
+
+static void GlUniformDraws(benchmark::State &state) {
+    Context &context = GetContext();
+    if (!context.valid) {
+        state.SkipWithError("No OpenGL 4.5 context");
+        return;
+    }
+    const std::vector<render::Instance> instances = GetInstances(state.range(0));
+    const u32 program = context.uniformProgram;
+
+    for (auto _ : state) {
+        const i32 vpLocation = glGetUniformLocation(program, "vp");
+        const i32 modelLocation = glGetUniformLocation(program, "model");
+        const i32 ambientLocation = glGetUniformLocation(program, "ambientColor");
+        glUseProgram(program);
+        glUniform3f(ambientLocation, 1.0f, 1.0f, 1.0f);
+        glUniformMatrix4fv(vpLocation, 1, GL_FALSE, identity);
+        glBindVertexArray(context.geometry.Vao());
+        for (const render::Instance &instance : instances) {
+            glUniformMatrix4fv(modelLocation, 1, GL_TRUE, (const f32 *) &instance.world);
+            glDrawElementsBaseVertex(GL_TRIANGLES, context.mesh.indexCount, GL_UNSIGNED_INT,
+                                     (void *) (sizeof(u32) * context.mesh.firstIndex), context.mesh.baseVertex);
+        }
+
+        state.PauseTiming();
+        glFinish();
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        state.ResumeTiming();
+    }
+    state.counters["Draws"] = (f32)instances.size();
+}
+
+static void GlMultiDrawIndirect(benchmark::State &state) {
+    Context &context = GetContext();
+    if (!context.valid) {
+        state.SkipWithError("No OpenGL 4.5 context");
+        return;
+    }
+    const std::vector<render::Instance> instances = GetInstances(state.range(0));
+    const u32 perCommand = state.range(1);
+    std::vector<DrawCommand> commands(instances.size() / perCommand);
+    for (u32 i = 0; i < commands.size(); ++i) {
+        commands[i] = { context.mesh.indexCount, perCommand, context.mesh.firstIndex, (i32)context.mesh.baseVertex, i * perCommand };
+    }
+
+    FrameRing instanceRing, commandRing;
+    instanceRing.Init(sizeof(render::Instance) * instances.size());
+    commandRing.Init(sizeof(DrawCommand) * commands.size());
+    const u32 program = context.instanceProgram;
+    const i32 vpLocation = glGetUniformLocation(program, "vp");
+    glProgramUniform3f(program, glGetUniformLocation(program, "ambientColor"), 1.0f, 1.0f, 1.0f);
+
+    for (auto _ : state) {
+        std::memcpy(instanceRing.Begin(sizeof(render::Instance) * instances.size()), instances.data(),
+                    sizeof(render::Instance) * instances.size());
+        std::memcpy(commandRing.Begin(sizeof(DrawCommand) * commands.size()), commands.data(),
+                    sizeof(DrawCommand) * commands.size());
+        context.geometry.SetInstances(instanceRing.Buffer(), instanceRing.Offset());
+
+        glUseProgram(program);
+        glUniformMatrix4fv(vpLocation, 1, GL_FALSE, identity);
+        glBindVertexArray(context.geometry.Vao());
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandRing.Buffer());
+        glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (void *) commandRing.Offset(), commands.size(), 0);
+        instanceRing.End();
+        commandRing.End();
+
+        state.PauseTiming();
+        glFinish();
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        state.ResumeTiming();
+    }
+    instanceRing.Terminate();
+    commandRing.Terminate();
+    state.counters["Draws"] = (f32)instances.size();
+    state.counters["Commands"] = (f32)commands.size();
+}
+
+static void GlRedundantState(benchmark::State &state) {
+    Context &context = GetContext();
+    if (!context.valid) {
+        state.SkipWithError("No OpenGL 4.5 context");
+        return;
+    }
+    const std::vector<render::Instance> instances = GetInstances(state.range(0));
+    const bool cached = state.range(1) != 0;
+    const u32 program = context.uniformProgram;
+    const i32 vpLocation = glGetUniformLocation(program, "vp");
+    const i32 modelLocation = glGetUniformLocation(program, "model");
+    const i32 ambientLocation = glGetUniformLocation(program, "ambientColor");
+    const i32 intensityLocation = glGetUniformLocation(program, "ambientLightIntensity");
+    graphics::opengl::state.Invalidate();
+
+    for (auto _ : state) {
+        graphics::opengl::state.ResetCounters();
+        for (const render::Instance &instance : instances) {
+            math::mat4 model = math::Transpose(instance.world);
+            if (cached) {
+                graphics::opengl::state.UseProgram(program);
+                graphics::opengl::state.BindVertexArray(context.geometry.Vao());
+                graphics::opengl::state.Uniform(program, ambientLocation, 1.0f, 1.0f, 1.0f);
+                graphics::opengl::state.Uniform(program, intensityLocation, 0.7f);
+                graphics::opengl::state.UniformMatrix(program, vpLocation, identity);
+                graphics::opengl::state.UniformMatrix(program, modelLocation, (const f32 *) &model);
+            } else {
+                glUseProgram(program);
+                glBindVertexArray(context.geometry.Vao());
+                glUniform3f(ambientLocation, 1.0f, 1.0f, 1.0f);
+                glUniform1f(intensityLocation, 0.7f);
+                glUniformMatrix4fv(vpLocation, 1, GL_FALSE, identity);
+                glUniformMatrix4fv(modelLocation, 1, GL_FALSE, (const f32 *) &model);
+            }
+            glDrawElementsBaseVertex(GL_TRIANGLES, context.mesh.indexCount, GL_UNSIGNED_INT,
+                                     (void *) (sizeof(u32) * context.mesh.firstIndex), context.mesh.baseVertex);
+        }
+
+        state.PauseTiming();
+        glFinish();
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        state.ResumeTiming();
+    }
+    state.counters["Issued"] = cached ? (f32)graphics::opengl::state.Issued() : 6.0f * instances.size();
+    state.counters["Filtered"] = (f32)graphics::opengl::state.Filtered();
+    graphics::opengl::state.Invalidate();
+}
+
+BENCHMARK(GlUniformDraws)->Arg(2000)->Arg(20000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(GlMultiDrawIndirect)->Args({ 2000, 1 })->Args({ 20000, 1 })->Args({ 2000, 2000 })->Args({ 20000, 20000 })
+        ->Unit(benchmark::kMicrosecond);
+BENCHMARK(GlRedundantState)->Args({ 2000, 0 })->Args({ 2000, 1 })->Unit(benchmark::kMicrosecond);
+
+}
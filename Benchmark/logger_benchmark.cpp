@@ -0,0 +1,61 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file logger_benchmark.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Logger hot path benchmarks
+ *
+ * Cost of a log call on the calling thread, the background thread formats out of the
+ * timing. Batches fit in the ring so nothing is dropped. Enabled calls have to stay under
+ * 100 ns, disabled ones are a compare.
+ */
+
+#include <benchmark/benchmark.h>
+#include "common/logger.hpp"
+#include "common/primitive_types.hpp"
+
+namespace reveal3d {
+
+static constexpr u32 batch = 128;
+
+static void LogEnabled(benchmark::State &state) {
+    Logger::SetConsole(false);
+    const LogLevel previous = loglevel;
+    loglevel = logDEBUG;
+    u32 frame = 0;
+    for (auto _ : state) {
+        for (u32 i = 0; i < batch; ++i) {
+            LOG(logDEBUG) << "Frame " << frame << " drew " << i << " meshes in " << 1.25f << " ms";
+        }
+        state.PauseTiming();
+        Logger::Flush();
+        ++frame;
+        state.ResumeTiming();
+    }
+    loglevel = previous;
+    Logger::Clear(logDEBUG);
+    Logger::SetConsole(true);
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+BENCHMARK(LogEnabled);
+
+static void LogDisabled(benchmark::State &state) {
+    const LogLevel previous = loglevel;
+    loglevel = logERROR;
+    u32 frame = 0;
+    for (auto _ : state) {
+        for (u32 i = 0; i < batch; ++i) {
+            LOG(logDEBUG) << "Frame " << frame << " drew " << i << " meshes";
+        }
+        benchmark::ClobberMemory();
+        ++frame;
+    }
+    loglevel = previous;
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+BENCHMARK(LogDisabled);
+
+}
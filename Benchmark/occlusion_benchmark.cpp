@@ -0,0 +1,96 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file occlusion_benchmark.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Software occlusion culling benchmarks
+ *
+ * Quarter of 1080p buffer. A corridor of walls acts as occluders and boxes are
+ * scattered behind and between them, like the interior scenes it is meant for.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+#include "render/occlusion.hpp"
+
+namespace reveal3d {
+
+namespace {
+
+constexpr u32 width = 1920 / 4;
+constexpr u32 height = 1080 / 4;
+
+struct Interior {
+    Interior() {
+        // 90 degree camera at the origin looking down +z
+        frustum.clip[0] = { 1.0f, 0.0f, 0.0f, 0.0f };
+        frustum.clip[1] = { 0.0f, 16.0f / 9.0f, 0.0f, 0.0f };
+        frustum.clip[2] = { 0.0f, 0.0f, 1.0f, -0.1f };
+        frustum.clip[3] = { 0.0f, 0.0f, 1.0f, 0.0f };
+
+        std::mt19937 generator(7);
+        std::uniform_real_distribution<f32> offset(-6.0f, 6.0f);
+        for (u32 i = 0; i < 64; ++i) {
+            // Side walls and partial walls across the corridor, two triangles each
+            const f32 z = 3.0f + (f32)i * 1.5f;
+            const f32 x = offset(generator);
+            const math::vec3 quad[4] = { { x - 2.0f, -2.0f, z }, { x + 2.0f, -2.0f, z },
+                                         { x + 2.0f, 2.0f, z }, { x - 2.0f, 2.0f, z } };
+            triangles.insert(triangles.end(), { quad[0], quad[1], quad[2], quad[0], quad[2], quad[3] });
+        }
+
+        std::uniform_real_distribution<f32> depth(2.0f, 100.0f);
+        boxes.resize(10000);
+        for (auto &box : boxes) {
+            const f32 z = depth(generator);
+            box.center = { offset(generator) * z / 6.0f, offset(generator) * z / 12.0f, z };
+            box.extents = { 0.5f, 0.5f, 0.5f };
+        }
+        buffer.Resize(width, height);
+    }
+
+    render::Frustum frustum;
+    render::OcclusionBuffer buffer;
+    std::vector<math::vec3> triangles;
+    std::vector<render::Bounds> boxes;
+};
+
+Interior& GetInterior() {
+    static Interior interior;
+    return interior;
+}
+
+}
+
+static void OcclusionRender(benchmark::State &state) {
+    Interior &interior = GetInterior();
+    for (auto _ : state) {
+        interior.buffer.Render(interior.frustum, interior.triangles);
+        benchmark::ClobberMemory();
+    }
+    state.counters["Triangles"] = (f32)interior.triangles.size() / 3;
+}
+BENCHMARK(OcclusionRender)->Unit(benchmark::kMicrosecond);
+
+static void OcclusionTest(benchmark::State &state) {
+    Interior &interior = GetInterior();
+    interior.buffer.Render(interior.frustum, interior.triangles);
+    u32 visible = 0;
+    for (auto _ : state) {
+        visible = 0;
+        for (const auto &box : interior.boxes) {
+            visible += interior.buffer.Test(interior.frustum, box);
+        }
+        benchmark::DoNotOptimize(visible);
+    }
+    state.counters["Visible"] = (f32)visible;
+    state.SetItemsProcessed(state.iterations() * interior.boxes.size());
+}
+BENCHMARK(OcclusionTest)->Unit(benchmark::kMicrosecond);
+
+}
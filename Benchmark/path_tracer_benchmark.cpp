@@ -0,0 +1,135 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file path_tracer_benchmark.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Path tracer benchmarks
+ *
+ * One sample per pixel of a 640x360 image: 400 lit ellipsoids of 2304 triangles on a
+ * floor, all of them instances of the same mesh, seen from above at an angle so rays
+ * bounce between them. Reports rays per second, shadow rays included.
+ */
+
+#include <benchmark/benchmark.h>
+#include "graphics/pathtracer/pt_tracer.hpp"
+#include "common/job_system.hpp"
+
+#include <cmath>
+
+namespace reveal3d {
+
+using namespace graphics::pathtracer;
+
+namespace {
+
+constexpr u32 rings = 24;
+constexpr u32 segments = 48;
+
+struct Gallery {
+    Gallery() {
+        for (u32 r = 0; r <= rings; ++r) {
+            for (u32 s = 0; s <= segments; ++s) {
+                const f32 theta = 3.14159265f * (f32)r / (f32)rings;
+                const f32 phi = 6.28318531f * (f32)s / (f32)segments;
+                const math::vec3 normal = { std::sin(theta) * std::cos(phi), std::sin(theta) * std::sin(phi), std::cos(theta) };
+                render::Vertex &vertex = ellipsoid.emplace_back();
+                vertex.pos = { normal.x * 0.4f, normal.y * 0.4f, normal.z * 0.9f };
+                vertex.normal = normal;
+                vertex.color = { 0.8f, 0.6f, 0.5f, 1.0f };
+            }
+        }
+        for (u32 r = 0; r < rings; ++r) {
+            for (u32 s = 0; s < segments; ++s) {
+                const u32 a = r * (segments + 1) + s;
+                const u32 b = a + segments + 1;
+                ellipsoidIndices.insert(ellipsoidIndices.end(), { a, b, a + 1, a + 1, b, b + 1 });
+            }
+        }
+        ellipsoidBvh.Build(ellipsoid.data(), ellipsoidIndices.data(), ellipsoidIndices.size());
+
+        for (u32 i = 0; i < 4; ++i) {
+            render::Vertex &vertex = floor.emplace_back();
+            vertex.pos = { i & 1 ? 1.0f : -1.0f, i & 2 ? 1.0f : -1.0f, 0.0f };
+            vertex.normal = { 0.0f, 0.0f, 1.0f };
+            vertex.color = { 0.6f, 0.6f, 0.6f, 1.0f };
+        }
+        floorBvh.Build(floor.data(), floorIndices, 6);
+
+        items.push_back(Item(floorBvh, floor.data(), floorIndices, 20.0f, 0.0f, 0.0f, 0.0f, { 20.0f, 20.0f, 0.0f }));
+        for (u32 i = 0; i < 400; ++i) {
+            const f32 x = (f32)(i % 20) * 1.5f - 14.25f;
+            const f32 y = (f32)(i / 20) * 1.5f - 14.25f;
+            items.push_back(Item(ellipsoidBvh, ellipsoid.data(), ellipsoidIndices.data(), 1.0f, x, y, 0.9f, { 0.4f, 0.4f, 0.9f }));
+        }
+
+        // 70 degree camera at (0, -18, 12) looking at the origin
+        const f32 focal = 1.0f / std::tan(0.6f);
+        const f32 c = 0.832f;
+        const f32 s = 0.555f;
+        const f32 eye[3] = { 0.0f, -18.0f, 12.0f };
+        const math::vec4 right = { 1.0f, 0.0f, 0.0f, 0.0f };
+        const math::vec4 up = { 0.0f, s, c, -(s * eye[1] + c * eye[2]) };
+        const math::vec4 forward = { 0.0f, c, -s, -(c * eye[1] - s * eye[2]) };
+        frustum.clip[0] = { right.x * focal * 9.0f / 16.0f, right.y, right.z, right.w };
+        frustum.clip[1] = { up.x * focal, up.y * focal, up.z * focal, up.w * focal };
+        frustum.clip[2] = { forward.x, forward.y, forward.z, forward.w - 0.2f };
+        frustum.clip[3] = forward;
+    }
+
+    static TraceItem Item(const spatial::TriangleBvh &bvh, const render::Vertex *vertices, const u32 *indices, f32 scale,
+                          f32 x, f32 y, f32 z, math::vec3 extents) {
+        TraceItem item;
+        item.bvh = &bvh;
+        item.vertices = vertices;
+        item.indices = indices;
+        f32 *world = (f32 *) &item.instance.world;
+        std::fill(world, world + 16, 0.0f);
+        world[0] = world[5] = world[10] = scale;
+        world[15] = 1.0f;
+        world[3] = x;
+        world[7] = y;
+        world[11] = z;
+        item.bounds.center = { x, y, z };
+        item.bounds.extents = extents;
+        return item;
+    }
+
+    render::Frustum frustum;
+    std::vector<render::Vertex> ellipsoid;
+    std::vector<u32> ellipsoidIndices;
+    spatial::TriangleBvh ellipsoidBvh;
+    std::vector<render::Vertex> floor;
+    const u32 floorIndices[6] = { 0, 1, 3, 0, 3, 2 };
+    spatial::TriangleBvh floorBvh;
+    std::vector<TraceItem> items;
+};
+
+Gallery& GetGallery() {
+    static Gallery gallery;
+    return gallery;
+}
+
+}
+
+static void PathTrace(benchmark::State &state) {
+    Gallery &gallery = GetGallery();
+    Tracer tracer;
+    tracer.Resize(640, 360);
+    tracer.SetScene(std::vector<TraceItem>(gallery.items));
+    tracer.SetCamera(gallery.frustum);
+
+    u64 rays = 0;
+    for (auto _ : state) {
+        tracer.Trace();
+        rays += tracer.Rays();
+        benchmark::ClobberMemory();
+    }
+    state.counters["Mrays"] = benchmark::Counter((f64)rays * 1e-6, benchmark::Counter::kIsRate);
+    state.counters["Workers"] = (f32)jobs::WorkerCount();
+}
+BENCHMARK(PathTrace)->Unit(benchmark::kMillisecond);
+
+}
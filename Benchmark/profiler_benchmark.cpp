@@ -0,0 +1,46 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file profiler_benchmark.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Profiler overhead benchmarks
+ *
+ * Cost of an empty PROFILE_SCOPE, recording and disabled. The recording one has to stay
+ * under 50 ns per zone for the engine hot paths to keep their scopes.
+ */
+
+#include <benchmark/benchmark.h>
+#include "common/profiler.hpp"
+
+namespace reveal3d {
+
+static void ProfileScope(benchmark::State &state) {
+    profiler::SetEnabled(state.range(0) != 0);
+    for (auto _ : state) {
+        PROFILE_SCOPE("Empty");
+        benchmark::ClobberMemory();
+    }
+    profiler::SetEnabled(false);
+    profiler::Clear();
+}
+BENCHMARK(ProfileScope)->Arg(0)->Arg(1);
+
+static void ProfileNested(benchmark::State &state) {
+    profiler::SetEnabled(true);
+    for (auto _ : state) {
+        PROFILE_SCOPE("Outer");
+        {
+            PROFILE_SCOPE("Inner");
+            benchmark::ClobberMemory();
+        }
+    }
+    profiler::SetEnabled(false);
+    profiler::Clear();
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK(ProfileNested);
+
+}
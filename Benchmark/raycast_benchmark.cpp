@@ -0,0 +1,93 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file raycast_benchmark.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Triangle BVH benchmarks
+ *
+ * A displaced grid of one million triangles is picked with random rays, the same
+ * kind of query the editor issues on mouse click. Build time is measured separately
+ * since it is paid once at import.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <random>
+
+#include "spatial/triangle_bvh.hpp"
+
+namespace reveal3d {
+
+namespace {
+
+constexpr u32 gridSize = 708; // 2 * 707 * 707 ~= 1M triangles
+
+struct Terrain {
+    Terrain() {
+        vertices.resize(gridSize * gridSize);
+        for (u32 z = 0; z < gridSize; ++z) {
+            for (u32 x = 0; x < gridSize; ++x) {
+                const f32 height = std::sin((f32)x * 0.05f) * std::cos((f32)z * 0.05f) * 10.0f;
+                vertices[z * gridSize + x].pos = { (f32)x, height, (f32)z };
+            }
+        }
+        for (u32 z = 0; z < gridSize - 1; ++z) {
+            for (u32 x = 0; x < gridSize - 1; ++x) {
+                const u32 i = z * gridSize + x;
+                indices.insert(indices.end(), { i, i + gridSize, i + 1, i + 1, i + gridSize, i + gridSize + 1 });
+            }
+        }
+    }
+
+    std::vector<render::Vertex> vertices;
+    std::vector<u32> indices;
+};
+
+Terrain& GetTerrain() {
+    static Terrain terrain;
+    return terrain;
+}
+
+}
+
+static void TriangleBvhBuild(benchmark::State &state) {
+    Terrain &terrain = GetTerrain();
+    for (auto _ : state) {
+        spatial::TriangleBvh bvh;
+        bvh.Build(terrain.vertices.data(), terrain.indices.data(), terrain.indices.size());
+        benchmark::DoNotOptimize(bvh.NodeCount());
+    }
+    state.counters["Triangles"] = (f32)terrain.indices.size() / 3;
+}
+BENCHMARK(TriangleBvhBuild)->Unit(benchmark::kMillisecond);
+
+static void TriangleBvhRaycast(benchmark::State &state) {
+    Terrain &terrain = GetTerrain();
+    static spatial::TriangleBvh bvh;
+    if (bvh.TriangleCount() == 0) {
+        bvh.Build(terrain.vertices.data(), terrain.indices.data(), terrain.indices.size());
+    }
+
+    std::mt19937 generator(3);
+    std::uniform_real_distribution<f32> position(0.0f, (f32)gridSize);
+    std::vector<std::pair<math::vec3, math::vec3>> rays(1024);
+    for (auto &ray : rays) {
+        ray.first = { position(generator), 50.0f, position(generator) };
+        ray.second = { position(generator) - ray.first.x, -50.0f, position(generator) - ray.first.z };
+    }
+
+    u32 i = 0;
+    for (auto _ : state) {
+        const auto &ray = rays[i++ % rays.size()];
+        spatial::TriangleHit hit;
+        benchmark::DoNotOptimize(bvh.Raycast(ray.first, ray.second, FLT_MAX, hit));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(TriangleBvhRaycast);
+
+}
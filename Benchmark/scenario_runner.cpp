@@ -0,0 +1,376 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file scenario_runner.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Scenario benchmark runner
+ *
+ * Builds named scenes of cubes and runs each one through Viewport::BenchMark on a headless
+ * window, timing every frame by stage. Roots are laid out in a square grid and every root
+ * starts a chain of depth entities, so moving one of them dirties the whole chain. Scene
+ * motion and camera path only depend on the frame number, runs on different machines do
+ * the same work.
+ *
+ * ScenarioRunner [--scenario a,b] [--file scenarios.txt] [--frames 600] [--warmup 60]
+ *                [--backend null|software] [--json out.json] [--csv out.csv] [--counters] [--list]
+ *
+ * --counters adds the hardware counters of every PERF_SCOPE system over the timed frames
+ * to the JSON output. Reading them costs a system call per scope, so timings move a bit.
+ * Peak memory of every subsystem, from building the scene to the last frame, is always there.
+ *
+ * Scenario files have one scenario per line: name entities depth moving camera, where
+ * moving is the fraction of entities animated every frame and camera is fixed, orbit or fly.
+ */
+
+#include "common/memory_report.hpp"
+#include "common/perf_counters.hpp"
+#include "render/viewport.hpp"
+#include "window/headless/headless.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace reveal3d;
+
+LogLevel loglevel = logERROR;
+
+namespace {
+
+enum camera_path : u8 { fixed, orbit, fly, count };
+constexpr const char *cameraNames[camera_path::count] = { "fixed", "orbit", "fly" };
+
+struct Scenario {
+    std::string name;
+    u32 entities;
+    u32 depth;          // Entities in each chain, 1 is a flat scene
+    f32 moving;         // Fraction of entities moved every frame
+    camera_path camera;
+};
+
+const Scenario builtIn[] = {
+    { "static_1k",     1000,  1,  0.0f,  fixed },
+    { "crowd_10k",     10000, 1,  0.1f,  orbit },
+    { "moving_5k",     5000,  1,  1.0f,  fly },
+    { "hierarchy_4k",  4096,  8,  0.05f, orbit },
+    { "deep_chain_2k", 2048,  32, 0.01f, fixed },
+};
+
+struct Options {
+    std::vector<Scenario> scenarios;
+    std::string backend { "null" };
+    std::string json;
+    std::string csv;
+    u32 frames { 600 };
+    u32 warmUp { 60 };
+    bool counters { false };
+};
+
+struct Result {
+    Scenario scenario;
+    FrameStats::Summary stages[StageTimes::count];
+    std::vector<perf::System> systems;
+    std::vector<memory::Usage> memory;  // Peaks since the scene was built
+};
+
+constexpr f32 spacing = 3.0f;
+
+// Entities created for a scenario, base is the local position moving ones oscillate around
+struct SceneState {
+    std::vector<core::Entity> moving;
+    std::vector<math::xvec3> base;
+    f32 extent;
+};
+
+SceneState BuildScene(const Scenario &scenario) {
+    SceneState state;
+    core::scene.Clear();
+    memory::ResetPeaks();
+
+    const u32 roots = (scenario.entities + scenario.depth - 1) / scenario.depth;
+    const u32 side = (u32)std::ceil(std::sqrt((f32)roots));
+    state.extent = (f32)side * spacing;
+
+    const u32 movingCount = (u32)std::round(scenario.moving * (f32)scenario.entities);
+    std::vector<core::Entity> entities;
+    entities.reserve(scenario.entities);
+    for (u32 i = 0; i < scenario.entities; ++i) {
+        const u32 root = i / scenario.depth;
+        const bool isRoot = i % scenario.depth == 0;
+        core::Entity entity = core::scene.AddPrimitive(core::Geometry::cube, isRoot ? core::Entity() : entities.back());
+        const math::xvec3 position = isRoot ? math::xvec3((f32)(root % side) * spacing, (f32)(root / side) * spacing, 0.0f)
+                                            : math::xvec3(0.3f, 0.0f, 1.2f);
+        entity.Transform().SetPosition(position);
+        entity.Transform().SetScale({ 0.5f, 0.5f, 0.5f });
+        entities.push_back(entity);
+    }
+
+    // Spread evenly so moving roots and moving children both show up in chains
+    for (u32 i = 0; i < movingCount; ++i) {
+        core::Entity entity = entities[(u64)i * scenario.entities / movingCount];
+        state.moving.push_back(entity);
+        state.base.push_back(entity.Transform().Position());
+    }
+    return state;
+}
+
+void Animate(const SceneState &state, u32 frame) {
+    for (u32 i = 0; i < state.moving.size(); ++i) {
+        const f32 phase = (f32)frame * 0.05f + (f32)i * 0.37f;
+        core::Entity entity = state.moving[i];
+        entity.Transform().SetPosition(state.base[i] + math::xvec3(0.0f, 0.0f, 0.5f * std::sin(phase)));
+        entity.Transform().SetRotation({ 0.0f, 0.0f, std::fmod((f32)frame * 2.0f + (f32)i, 360.0f) });
+    }
+}
+
+void MoveCamera(render::Camera &camera, const Scenario &scenario, const SceneState &state, f32 t) {
+    const f32 center = state.extent * 0.5f;
+    switch (scenario.camera) {
+        case fixed:
+            camera.LookAt({ -6.0f, center, 8.0f }, { center, center, 0.0f });
+            break;
+        case orbit: {
+            const f32 radius = state.extent * 0.6f + 6.0f;
+            const f32 angle = t * 6.28318531f;
+            camera.LookAt({ center + radius * std::cos(angle), center + radius * std::sin(angle), radius * 0.4f },
+                          { center, center, 0.0f });
+            break;
+        }
+        case fly: {
+            const f32 x = -6.0f + t * (state.extent + 12.0f);
+            camera.LookAt({ x, center, 3.0f }, { x + 10.0f, center, 1.0f });
+            break;
+        }
+        default: break;
+    }
+}
+
+template<graphics::HRI Gfx>
+Result Run(const Scenario &scenario, const Options &options) {
+    Result result { scenario };
+    SceneState state = BuildScene(scenario);
+
+    window::InitInfo info(L"ScenarioRunner", 1280, 720);
+    render::Viewport<Gfx, window::Headless> viewport(info);
+    if constexpr (std::same_as<Gfx, graphics::Null>) {
+        viewport.renderer.Graphics().SetRecording(false);
+    }
+    viewport.Init();
+
+    FrameStats stats;
+    const f32 totalFrames = (f32)(options.warmUp + options.frames);
+    viewport.BenchMark(options.warmUp, options.frames, stats, [&](u32 frame) {
+        if (frame == options.warmUp) perf::Reset();
+        Animate(state, frame);
+        MoveCamera(viewport.renderer.GetCamera(), scenario, state, (f32)frame / totalFrames);
+    });
+
+    for (u32 stage = 0; stage < StageTimes::count; ++stage) {
+        result.stages[stage] = stats.Summarize((StageTimes::stage) stage);
+    }
+    if (perf::Enabled()) {
+        result.systems = perf::Report();
+    }
+    result.memory = memory::MemoryReport();
+    return result;
+}
+
+bool ParseCamera(const std::string &name, camera_path &path) {
+    for (u32 i = 0; i < camera_path::count; ++i) {
+        if (name == cameraNames[i]) {
+            path = (camera_path) i;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool LoadScenarios(const std::string &path, std::vector<Scenario> &scenarios) {
+    std::ifstream file(path);
+    if (!file) {
+        LOG(logERROR) << "Can't open scenario file " << path;
+        return false;
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() or line[0] == '#') continue;
+        std::istringstream stream(line);
+        Scenario scenario;
+        std::string camera;
+        if (!(stream >> scenario.name >> scenario.entities >> scenario.depth >> scenario.moving >> camera) or
+            !ParseCamera(camera, scenario.camera) or scenario.entities == 0 or scenario.depth == 0) {
+            LOG(logERROR) << "Bad scenario: " << line;
+            return false;
+        }
+        scenarios.push_back(scenario);
+    }
+    return true;
+}
+
+bool Select(const std::string &names, const std::vector<Scenario> &available, std::vector<Scenario> &selected) {
+    std::istringstream stream(names);
+    std::string name;
+    while (std::getline(stream, name, ',')) {
+        bool found = false;
+        for (const Scenario &scenario : available) {
+            if (scenario.name == name) {
+                selected.push_back(scenario);
+                found = true;
+            }
+        }
+        if (!found) {
+            LOG(logERROR) << "Unknown scenario " << name;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ParseOptions(int argc, char **argv, Options &options) {
+    std::vector<Scenario> available(std::begin(builtIn), std::end(builtIn));
+    std::string names;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--counters") {
+            options.counters = true;
+            continue;
+        }
+        if (arg == "--list") {
+            for (const Scenario &scenario : available) {
+                std::printf("%-16s %6u entities  depth %2u  moving %.2f  %s\n", scenario.name.c_str(), scenario.entities,
+                            scenario.depth, scenario.moving, cameraNames[scenario.camera]);
+            }
+            std::exit(0);
+        }
+        if (i + 1 >= argc) {
+            LOG(logERROR) << "Missing value for " << arg;
+            return false;
+        }
+        const std::string value = argv[++i];
+        if (arg == "--scenario") names = value;
+        else if (arg == "--file") { available.clear(); if (!LoadScenarios(value, available)) return false; }
+        else if (arg == "--frames") options.frames = std::stoul(value);
+        else if (arg == "--warmup") options.warmUp = std::stoul(value);
+        else if (arg == "--backend") options.backend = value;
+        else if (arg == "--json") options.json = value;
+        else if (arg == "--csv") options.csv = value;
+        else {
+            LOG(logERROR) << "Unknown option " << arg;
+            return false;
+        }
+    }
+
+    if (names.empty()) {
+        options.scenarios = available;
+        return true;
+    }
+    return Select(names, available, options.scenarios);
+}
+
+// Totals over the timed frames, only the counters the hardware has
+void WriteCounters(std::ofstream &file, const std::vector<perf::System> &systems) {
+    file << ",\n      \"counters\": {";
+    for (u32 i = 0; i < systems.size(); ++i) {
+        file << (i == 0 ? "\n" : ",\n") << "        \"" << systems[i].name << "\": { \"calls\": " << systems[i].calls;
+        for (u32 counter = 0; counter < perf::Counters::count; ++counter) {
+            if (perf::Supported() & (1u << counter)) {
+                file << ", \"" << perf::Counters::names[counter] << "\": " << systems[i].counters.value[counter];
+            }
+        }
+        file << " }";
+    }
+    file << (systems.empty() ? "}" : "\n      }");
+}
+
+void WriteMemory(std::ofstream &file, const std::vector<memory::Usage> &usage) {
+    file << ",\n      \"memory\": {";
+    for (u32 i = 0; i < usage.size(); ++i) {
+        file << (i == 0 ? "\n" : ",\n") << "        \"" << usage[i].name << "\": { \"bytes\": " << usage[i].bytes
+             << ", \"peak\": " << usage[i].peak << " }";
+    }
+    file << (usage.empty() ? "}" : "\n      }");
+}
+
+void WriteJson(const std::string &path, const Options &options, const std::vector<Result> &results) {
+    std::ofstream file(path);
+    file << "{\n  \"backend\": \"" << options.backend << "\",\n  \"frames\": " << options.frames
+         << ",\n  \"warmup\": " << options.warmUp << ",\n  \"scenarios\": [\n";
+    for (u32 i = 0; i < results.size(); ++i) {
+        const Result &result = results[i];
+        file << "    {\n      \"name\": \"" << result.scenario.name << "\",\n      \"entities\": " << result.scenario.entities
+             << ",\n      \"depth\": " << result.scenario.depth << ",\n      \"moving\": " << result.scenario.moving
+             << ",\n      \"camera\": \"" << cameraNames[result.scenario.camera] << "\",\n      \"stages\": {\n";
+        for (u32 stage = 0; stage < StageTimes::count; ++stage) {
+            const FrameStats::Summary &summary = result.stages[stage];
+            file << "        \"" << StageTimes::names[stage] << "\": { \"mean\": " << summary.mean << ", \"p50\": " << summary.p50
+                 << ", \"p95\": " << summary.p95 << ", \"p99\": " << summary.p99 << ", \"max\": " << summary.max << " }"
+                 << (stage + 1 < StageTimes::count ? ",\n" : "\n");
+        }
+        file << "      }";
+        if (options.counters) {
+            WriteCounters(file, result.systems);
+        }
+        WriteMemory(file, result.memory);
+        file << "\n    }" << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    file << "  ]\n}\n";
+}
+
+void WriteCsv(const std::string &path, const std::vector<Result> &results) {
+    std::ofstream file(path);
+    file << "scenario,stage,mean_ms,p50_ms,p95_ms,p99_ms,max_ms\n";
+    for (const Result &result : results) {
+        for (u32 stage = 0; stage < StageTimes::count; ++stage) {
+            const FrameStats::Summary &summary = result.stages[stage];
+            file << result.scenario.name << ',' << StageTimes::names[stage] << ',' << summary.mean << ',' << summary.p50 << ','
+                 << summary.p95 << ',' << summary.p99 << ',' << summary.max << '\n';
+        }
+    }
+}
+
+}
+
+int main(int argc, char **argv) {
+    Options options;
+    if (!ParseOptions(argc, argv, options)) return 1;
+    if (options.counters and !perf::Init()) {
+        LOG(logWARNING) << "Hardware counters are not available, JSON output won't have them";
+    }
+
+    std::vector<Result> results;
+    for (const Scenario &scenario : options.scenarios) {
+        if (options.backend == "null") {
+            results.push_back(Run<graphics::Null>(scenario, options));
+        } else if (options.backend == "software") {
+            results.push_back(Run<graphics::Software>(scenario, options));
+        } else {
+            LOG(logERROR) << "Unknown backend " << options.backend;
+            return 1;
+        }
+
+        const FrameStats::Summary &frame = results.back().stages[StageTimes::frame];
+        std::printf("%-16s frame mean %.3f ms  p50 %.3f  p95 %.3f  p99 %.3f\n", scenario.name.c_str(), frame.mean, frame.p50,
+                    frame.p95, frame.p99);
+        for (u32 stage = 0; stage < StageTimes::frame; ++stage) {
+            const FrameStats::Summary &summary = results.back().stages[stage];
+            std::printf("  %-14s mean %.3f ms  p50 %.3f  p95 %.3f  p99 %.3f\n", StageTimes::names[stage], summary.mean,
+                        summary.p50, summary.p95, summary.p99);
+        }
+        std::printf("  memory peak   ");
+        for (const memory::Usage &usage : results.back().memory) {
+            std::printf(" %s %.1f KiB", usage.name, (f64) usage.peak / 1024.0);
+        }
+        std::printf("\n");
+    }
+
+    if (!options.json.empty()) WriteJson(options.json, options, results);
+    if (!options.csv.empty()) WriteCsv(options.csv, results);
+    return 0;
+}
@@ -0,0 +1,102 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file software_raster_benchmark.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Software rasterizer benchmarks
+ *
+ * 1080p frame of a crowd laid out like the sample, 10 x 10 columns of instances going
+ * away from the camera. Every instance is a lit ellipsoid of 2304 triangles, about the
+ * size of a character, all of them drawn without culling.
+ */
+
+#include <benchmark/benchmark.h>
+#include "graphics/software/sw_rasterizer.hpp"
+#include "common/job_system.hpp"
+
+#include <cmath>
+
+namespace reveal3d {
+
+using namespace graphics::software;
+
+namespace {
+
+constexpr u32 rings = 24;
+constexpr u32 segments = 48;
+
+struct Crowd {
+    Crowd() {
+        for (u32 r = 0; r <= rings; ++r) {
+            for (u32 s = 0; s <= segments; ++s) {
+                const f32 theta = 3.14159265f * (f32)r / (f32)rings;
+                const f32 phi = 6.28318531f * (f32)s / (f32)segments;
+                const math::vec3 normal = { std::sin(theta) * std::cos(phi), std::sin(theta) * std::sin(phi), std::cos(theta) };
+                render::Vertex &vertex = vertices.emplace_back();
+                vertex.pos = { normal.x * 0.4f, normal.y * 0.4f, normal.z * 0.9f };
+                vertex.normal = normal;
+                vertex.color = { 0.8f, 0.6f, 0.5f, 1.0f };
+            }
+        }
+        for (u32 r = 0; r < rings; ++r) {
+            for (u32 s = 0; s < segments; ++s) {
+                const u32 a = r * (segments + 1) + s;
+                const u32 b = a + segments + 1;
+                indices.insert(indices.end(), { a, b, a + 1, a + 1, b, b + 1 });
+            }
+        }
+
+        instances.resize(2000);
+        for (u32 i = 0; i < instances.size(); ++i) {
+            f32 *world = (f32 *) &instances[i].world;
+            std::fill(world, world + 16, 0.0f);
+            world[0] = world[5] = world[10] = world[15] = 1.0f;
+            world[3] = (f32)(i % 10) * 1.5f - 7.0f;
+            world[7] = (f32)(i / 10 % 10) * 1.5f - 7.0f;
+            world[11] = (f32)(i / 100) * 1.5f + 3.0f;
+        }
+
+        // 70 degree camera at the origin looking down +z
+        const f32 focal = 1.0f / std::tan(0.6f);
+        frustum.clip[0] = { focal * 9.0f / 16.0f, 0.0f, 0.0f, 0.0f };
+        frustum.clip[1] = { 0.0f, focal, 0.0f, 0.0f };
+        frustum.clip[2] = { 0.0f, 0.0f, 1.0f, -0.2f };
+        frustum.clip[3] = { 0.0f, 0.0f, 1.0f, 0.0f };
+    }
+
+    render::Frustum frustum;
+    std::vector<render::Vertex> vertices;
+    std::vector<u32> indices;
+    std::vector<render::Instance> instances;
+};
+
+Crowd& GetCrowd() {
+    static Crowd crowd;
+    return crowd;
+}
+
+}
+
+static void SoftwareRender(benchmark::State &state) {
+    Crowd &crowd = GetCrowd();
+    Rasterizer rasterizer;
+    rasterizer.Resize(1920, 1080);
+    for (u32 i = 0; i < state.range(0); ++i) {
+        rasterizer.Submit({ crowd.vertices.data(), crowd.indices.data(), &crowd.instances[i], (u32)crowd.vertices.size(),
+                            (u32)crowd.indices.size(), render::opaque });
+    }
+    rasterizer.SetGrid(state.range(1) != 0);
+
+    for (auto _ : state) {
+        rasterizer.Render(crowd.frustum);
+        benchmark::ClobberMemory();
+    }
+    state.counters["Triangles"] = (f32)rasterizer.Triangles();
+    state.counters["Workers"] = (f32)jobs::WorkerCount();
+}
+BENCHMARK(SoftwareRender)->Args({ 200, 0 })->Args({ 2000, 0 })->Args({ 2000, 1 })->Unit(benchmark::kMillisecond);
+
+}
@@ -0,0 +1,168 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file spatial_benchmark.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Spatial index benchmarks
+ *
+ * Entities are spread in a 1km cube, every frame 10% of them move a bit.
+ * Every index runs the same cases so they can be compared, filter by name
+ * (e.g. --benchmark_filter=Update) to see one operation side by side.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+#include "spatial/aabb_tree.hpp"
+#include "spatial/loose_octree.hpp"
+#include "spatial/uniform_grid.hpp"
+
+namespace reveal3d {
+
+namespace {
+
+constexpr f32 worldSize = 1000.0f;
+
+struct World {
+    explicit World(u32 count) : boxes(count), generator(1) {
+        std::uniform_real_distribution<f32> position(0.0f, worldSize);
+        std::uniform_real_distribution<f32> size(0.5f, 2.0f);
+        for (auto &box : boxes) {
+            const math::vec3 min { position(generator), position(generator), position(generator) };
+            box = { min, { min.x + size(generator), min.y + size(generator), min.z + size(generator) } };
+        }
+    }
+
+    void Move(u32 frame, f32 speed) {
+        std::uniform_real_distribution<f32> offset(-speed, speed);
+        for (u32 i = frame % 10; i < boxes.size(); i += 10) {
+            const f32 x = offset(generator);
+            const f32 y = offset(generator);
+            boxes[i].min = { boxes[i].min.x + x, boxes[i].min.y + y, boxes[i].min.z };
+            boxes[i].max = { boxes[i].max.x + x, boxes[i].max.y + y, boxes[i].max.z };
+        }
+    }
+
+    std::vector<spatial::Aabb> boxes;
+    std::mt19937 generator;
+};
+
+World& GetWorld(u32 count) {
+    static World world(count);
+    if (world.boxes.size() != count) {
+        world = World(count);
+    }
+    return world;
+}
+
+}
+
+template<spatial::Index T>
+void BM_Insert(benchmark::State &state) {
+    World &world = GetWorld(state.range(0));
+    for (auto _ : state) {
+        T index;
+        for (u32 i = 0; i < world.boxes.size(); ++i) {
+            index.Insert(i, world.boxes[i]);
+        }
+        benchmark::DoNotOptimize(index.Count());
+    }
+    state.SetItemsProcessed(state.iterations() * world.boxes.size());
+}
+
+template<spatial::Index T>
+void BM_Update(benchmark::State &state) {
+    World world(state.range(0));
+    T index;
+    for (u32 i = 0; i < world.boxes.size(); ++i) {
+        index.Insert(i, world.boxes[i]);
+    }
+
+    u32 frame = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        world.Move(frame, 0.5f);
+        state.ResumeTiming();
+        for (u32 i = frame % 10; i < world.boxes.size(); i += 10) {
+            index.Update(i, world.boxes[i]);
+        }
+        ++frame;
+    }
+    state.SetItemsProcessed(state.iterations() * world.boxes.size() / 10);
+}
+
+template<spatial::Index T>
+void BM_Query(benchmark::State &state) {
+    World &world = GetWorld(state.range(0));
+    T index;
+    for (u32 i = 0; i < world.boxes.size(); ++i) {
+        index.Insert(i, world.boxes[i]);
+    }
+
+    std::uniform_real_distribution<f32> position(0.0f, worldSize - 50.0f);
+    u64 found = 0;
+    for (auto _ : state) {
+        const math::vec3 min { position(world.generator), position(world.generator), position(world.generator) };
+        index.Query(spatial::Aabb { min, { min.x + 50.0f, min.y + 50.0f, min.z + 50.0f } }, [&](u32) { ++found; });
+    }
+    benchmark::DoNotOptimize(found);
+    state.SetItemsProcessed(state.iterations());
+}
+
+// About 10% of the world inside the volume
+template<spatial::Index T>
+void BM_Frustum(benchmark::State &state) {
+    World &world = GetWorld(state.range(0));
+    T index;
+    for (u32 i = 0; i < world.boxes.size(); ++i) {
+        index.Insert(i, world.boxes[i]);
+    }
+
+    const math::vec4 planes[] = {
+        { 1.0f, 0.0f, 0.0f, -450.0f }, { -1.0f, 0.0f, 0.0f, 550.0f },
+        { 0.0f, 1.0f, 0.0f, 0.0f }, { 0.0f, -1.0f, 0.0f, worldSize },
+        { 0.0f, 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, -1.0f, worldSize }
+    };
+    u64 found = 0;
+    for (auto _ : state) {
+        index.Query(spatial::Planes(planes), [&](u32) { ++found; });
+    }
+    benchmark::DoNotOptimize(found);
+}
+
+template<spatial::Index T>
+void BM_Raycast(benchmark::State &state) {
+    World &world = GetWorld(state.range(0));
+    T index;
+    for (u32 i = 0; i < world.boxes.size(); ++i) {
+        index.Insert(i, world.boxes[i]);
+    }
+
+    std::uniform_real_distribution<f32> position(0.0f, worldSize);
+    for (auto _ : state) {
+        spatial::Ray ray { { 0.0f, position(world.generator), position(world.generator) }, { 1.0f, 0.0f, 0.0f }, worldSize };
+        u32 hit = UINT_MAX;
+        index.Raycast(ray, [&](u32 id, f32 distance) {
+            hit = id;
+            return distance;
+        });
+        benchmark::DoNotOptimize(hit);
+    }
+}
+
+#define SPATIAL_BENCHMARKS(Type) \
+    BENCHMARK(BM_Insert<Type>)->Arg(1'000'000)->Unit(benchmark::kMillisecond); \
+    BENCHMARK(BM_Update<Type>)->Arg(1'000'000)->Unit(benchmark::kMillisecond); \
+    BENCHMARK(BM_Query<Type>)->Arg(1'000'000); \
+    BENCHMARK(BM_Frustum<Type>)->Arg(1'000'000)->Unit(benchmark::kMillisecond); \
+    BENCHMARK(BM_Raycast<Type>)->Arg(1'000'000);
+
+SPATIAL_BENCHMARKS(spatial::AabbTree)
+SPATIAL_BENCHMARKS(spatial::LooseOctree)
+SPATIAL_BENCHMARKS(spatial::UniformGrid)
+
+}
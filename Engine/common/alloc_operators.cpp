@@ -0,0 +1,114 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file alloc_operators.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Counting global operator new and delete
+ *
+ * Built as the Reveal3dAllocTracker object library instead of in the Reveal3d archive,
+ * a replacement inside a static library only takes effect when the linker happens to pull
+ * its object in. Executables that want counts link it explicitly. Like the default ones,
+ * throwing operators call the new handler until it frees memory or there is none, and
+ * nothrow operators are the throwing ones returning null instead of throwing.
+ */
+
+#include "alloc_tracker.hpp"
+
+#include <cstdlib>
+#include <new>
+
+#ifndef SHIPPING
+
+namespace {
+
+void* TryAllocate(size_t size) {
+    return std::malloc(size != 0 ? size : 1);
+}
+
+void* TryAllocateAligned(size_t size, std::align_val_t alignment) {
+    const size_t align = static_cast<size_t>(alignment);
+#ifdef _WIN32
+    return _aligned_malloc(size != 0 ? size : 1, align);
+#else
+    // aligned_alloc wants a multiple of the alignment
+    return std::aligned_alloc(align, ((size != 0 ? size : 1) + align - 1) & ~(align - 1));
+#endif
+}
+
+template<typename F>
+void* AllocateOrThrow(size_t size, F &&tryAllocate) {
+    while (true) {
+        if (void *ptr = tryAllocate()) {
+            reveal3d::memory::CountAllocation(size);
+            return ptr;
+        }
+        const std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr) throw std::bad_alloc();
+        handler();
+    }
+}
+
+void* Allocate(size_t size) {
+    return AllocateOrThrow(size, [size] { return TryAllocate(size); });
+}
+
+void* AllocateAligned(size_t size, std::align_val_t alignment) {
+    return AllocateOrThrow(size, [size, alignment] { return TryAllocateAligned(size, alignment); });
+}
+
+void Free(void *ptr) {
+    reveal3d::memory::CountFree(ptr);
+    std::free(ptr);
+}
+
+void FreeAligned(void *ptr) {
+    reveal3d::memory::CountFree(ptr);
+#ifdef _WIN32
+    _aligned_free(ptr);
+#else
+    std::free(ptr);
+#endif
+}
+
+}
+
+void* operator new(size_t size) { return Allocate(size); }
+void* operator new[](size_t size) { return Allocate(size); }
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    try { return Allocate(size); } catch (...) { return nullptr; }
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    try { return Allocate(size); } catch (...) { return nullptr; }
+}
+
+void* operator new(size_t size, std::align_val_t alignment) { return AllocateAligned(size, alignment); }
+void* operator new[](size_t size, std::align_val_t alignment) { return AllocateAligned(size, alignment); }
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    try { return AllocateAligned(size, alignment); } catch (...) { return nullptr; }
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    try { return AllocateAligned(size, alignment); } catch (...) { return nullptr; }
+}
+
+void operator delete(void *ptr) noexcept { Free(ptr); }
+void operator delete[](void *ptr) noexcept { Free(ptr); }
+void operator delete(void *ptr, size_t) noexcept { Free(ptr); }
+void operator delete[](void *ptr, size_t) noexcept { Free(ptr); }
+void operator delete(void *ptr, const std::nothrow_t&) noexcept { Free(ptr); }
+void operator delete[](void *ptr, const std::nothrow_t&) noexcept { Free(ptr); }
+
+void operator delete(void *ptr, std::align_val_t) noexcept { FreeAligned(ptr); }
+void operator delete[](void *ptr, std::align_val_t) noexcept { FreeAligned(ptr); }
+void operator delete(void *ptr, size_t, std::align_val_t) noexcept { FreeAligned(ptr); }
+void operator delete[](void *ptr, size_t, std::align_val_t) noexcept { FreeAligned(ptr); }
+void operator delete(void *ptr, std::align_val_t, const std::nothrow_t&) noexcept { FreeAligned(ptr); }
+void operator delete[](void *ptr, std::align_val_t, const std::nothrow_t&) noexcept { FreeAligned(ptr); }
+
+#endif
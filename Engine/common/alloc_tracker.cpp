@@ -0,0 +1,228 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file alloc_tracker.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Heap allocation tracking
+ *
+ * Longer description
+ */
+
+#include "alloc_tracker.hpp"
+#include "platform.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+
+#if defined(__linux__) or defined(__APPLE__)
+#include <cxxabi.h>
+#include <execinfo.h>
+#define ALLOC_TRACKER_BACKTRACE
+#endif
+
+namespace reveal3d::memory {
+
+namespace {
+
+constexpr u32 maxThreads = 256;
+constexpr u32 maxFrames = 16;
+constexpr u32 skippedFrames = 3;        // Sample, CountAllocation and operator new
+constexpr u32 callSiteCapacity = 1024;  // Power of two
+
+/**
+ * Written only by its thread unless more than maxThreads threads ever ran, then the last
+ * slot is shared by the rest. Atomics so totals can be read from any thread
+ */
+struct alignas(64) ThreadSlot {
+    std::atomic<u64> allocations;
+    std::atomic<u64> frees;
+    std::atomic<u64> bytes;
+};
+
+struct Site {
+    u64 hash;
+    u64 allocations;
+    u64 bytes;
+    void *frames[maxFrames];
+    u32 depth;
+};
+
+ThreadSlot slots[maxThreads];
+std::atomic<u32> slotCount { 0 };
+std::atomic<u32> sampleRate { 0 };
+
+// Plain arrays, a container here would allocate from inside operator new
+Site sites[callSiteCapacity];
+std::atomic_flag sitesLock = ATOMIC_FLAG_INIT;
+
+thread_local ThreadSlot *localSlot { nullptr };
+thread_local u32 untilSample { 0 };
+thread_local bool sampling { false };
+
+ThreadSlot& Slot() {
+    if (localSlot == nullptr) {
+        const u32 index = slotCount.fetch_add(1, std::memory_order_relaxed);
+        localSlot = &slots[std::min(index, maxThreads - 1)];
+    }
+    return *localSlot;
+}
+
+INLINE void Add(std::atomic<u64> &counter, u64 value) {
+    if (localSlot == &slots[maxThreads - 1]) {
+        counter.fetch_add(value, std::memory_order_relaxed);
+    } else {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+}
+
+class SitesLock {
+public:
+    SitesLock() { while (sitesLock.test_and_set(std::memory_order_acquire)) { } }
+    ~SitesLock() { sitesLock.clear(std::memory_order_release); }
+};
+
+void Sample(size_t size) {
+#ifdef ALLOC_TRACKER_BACKTRACE
+    // backtrace can allocate the first time it runs
+    sampling = true;
+    void *frames[maxFrames + skippedFrames];
+    const i32 captured = backtrace(frames, maxFrames + skippedFrames);
+    const u32 depth = captured > (i32) skippedFrames ? captured - skippedFrames : 0;
+
+    u64 hash = 14695981039346656037ull;
+    for (u32 i = 0; i < depth; ++i) {
+        hash = (hash ^ (u64) frames[skippedFrames + i]) * 1099511628211ull;
+    }
+
+    {
+        SitesLock lock;
+        // Open addressing, samples of new sites are dropped once the table is full
+        for (u32 i = 0, slot = (u32) hash & (callSiteCapacity - 1); i < callSiteCapacity; ++i, slot = (slot + 1) & (callSiteCapacity - 1)) {
+            Site &site = sites[slot];
+            if (site.allocations == 0) {
+                site.hash = hash;
+                site.depth = depth;
+                std::copy_n(frames + skippedFrames, depth, site.frames);
+            } else if (site.hash != hash) {
+                continue;
+            }
+            ++site.allocations;
+            site.bytes += size;
+            break;
+        }
+    }
+    sampling = false;
+#endif
+}
+
+std::string Symbol(void *frame, const char *symbol) {
+#ifdef ALLOC_TRACKER_BACKTRACE
+    // "binary(mangled+offset) [address]" on Linux, demangled when the name is exported
+    std::string text(symbol);
+    const size_t open = text.find('(');
+    const size_t plus = text.find('+', open);
+    if (open != std::string::npos and plus != std::string::npos and plus > open + 1) {
+        const std::string mangled = text.substr(open + 1, plus - open - 1);
+        i32 status = 0;
+        char *name = abi::__cxa_demangle(mangled.c_str(), nullptr, nullptr, &status);
+        text = status == 0 and name != nullptr ? name : mangled;  // C names aren't mangled
+        std::free(name);
+    }
+    return text;
+#else
+    return std::to_string((uintptr_t) frame);
+#endif
+}
+
+}
+
+void CountAllocation(size_t size) {
+    ThreadSlot &slot = Slot();
+    Add(slot.allocations, 1);
+    Add(slot.bytes, size);
+
+    const u32 rate = sampleRate.load(std::memory_order_relaxed);
+    if (rate != 0 and !sampling and (untilSample == 0 or --untilSample == 0)) {
+        untilSample = rate;
+        Sample(size);
+    }
+}
+
+void CountFree(void *ptr) {
+    if (ptr != nullptr) {
+        Add(Slot().frees, 1);
+    }
+}
+
+AllocationCounts ThreadAllocations() {
+    const ThreadSlot &slot = Slot();
+    return {
+        slot.allocations.load(std::memory_order_relaxed),
+        slot.frees.load(std::memory_order_relaxed),
+        slot.bytes.load(std::memory_order_relaxed)
+    };
+}
+
+AllocationCounts TotalAllocations() {
+    AllocationCounts total;
+    const u32 count = std::min(slotCount.load(std::memory_order_relaxed), maxThreads);
+    for (u32 i = 0; i < count; ++i) {
+        total.allocations += slots[i].allocations.load(std::memory_order_relaxed);
+        total.frees += slots[i].frees.load(std::memory_order_relaxed);
+        total.bytes += slots[i].bytes.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+void SetSampleRate(u32 rate) {
+    sampleRate.store(rate, std::memory_order_relaxed);
+}
+
+u32 SampleRate() {
+    return sampleRate.load(std::memory_order_relaxed);
+}
+
+std::vector<CallSite> TopCallSites(u32 count) {
+    // Copied out first, building the result allocates and would sample into the table
+    std::vector<Site> copy;
+    copy.reserve(callSiteCapacity);
+    {
+        SitesLock lock;
+        for (const Site &site : sites) {
+            if (site.allocations != 0) {
+                copy.push_back(site);
+            }
+        }
+    }
+
+    std::sort(copy.begin(), copy.end(), [](const Site &a, const Site &b) {
+        return a.allocations != b.allocations ? a.allocations > b.allocations : a.bytes > b.bytes;
+    });
+    copy.resize(std::min<size_t>(copy.size(), count));
+
+    std::vector<CallSite> result;
+    result.reserve(copy.size());
+    for (Site &site : copy) {
+        CallSite &callSite = result.emplace_back(CallSite { site.allocations, site.bytes, {} });
+#ifdef ALLOC_TRACKER_BACKTRACE
+        char **symbols = backtrace_symbols(site.frames, (i32) site.depth);
+        for (u32 i = 0; i < site.depth; ++i) {
+            callSite.frames.push_back(symbols != nullptr ? Symbol(site.frames[i], symbols[i]) : Symbol(site.frames[i], "?"));
+        }
+        std::free(symbols);
+#endif
+    }
+    return result;
+}
+
+void ClearCallSites() {
+    SitesLock lock;
+    std::fill(std::begin(sites), std::end(sites), Site {});
+}
+
+}
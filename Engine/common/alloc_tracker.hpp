@@ -0,0 +1,56 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file alloc_tracker.hpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Heap allocation tracking
+ *
+ * Executables linking Reveal3dAllocTracker replace the global operator new and delete to
+ * count every heap allocation, per thread and without locks, so a frame can be checked to
+ * allocate nothing. Call stacks of one in every sample rate allocations are kept by call
+ * site to find where they come from. Without it, or in shipping builds (SHIPPING defined),
+ * the default operators are kept and nothing is counted.
+ */
+
+#pragma once
+
+#include "primitive_types.hpp"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace reveal3d::memory {
+
+struct AllocationCounts {
+    u64 allocations { 0 };
+    u64 frees { 0 };
+    u64 bytes { 0 };    // Requested by allocations, frees don't subtract
+};
+
+struct CallSite {
+    u64 allocations;    // Sampled ones, times the sample rate for an estimate of the total
+    u64 bytes;
+    std::vector<std::string> frames;    // Innermost first
+};
+
+// Since the calling thread started
+AllocationCounts ThreadAllocations();
+// Every thread since start up
+AllocationCounts TotalAllocations();
+
+// Keeps the call stack of one in every rate allocations of each thread, 0 stops sampling
+void SetSampleRate(u32 rate);
+[[nodiscard]] u32 SampleRate();
+// Sampled call sites with the most allocations first
+std::vector<CallSite> TopCallSites(u32 count);
+void ClearCallSites();
+
+// Called by the replaced operators only
+void CountAllocation(size_t size);
+void CountFree(void *ptr);
+
+}
@@ -0,0 +1,53 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file frame_stats.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Per stage frame timing
+ *
+ * Longer description
+ */
+
+#include "frame_stats.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace reveal3d {
+
+/**
+ * Smallest value with at least percent of the samples at or below it. Always one of the
+ * samples, so a p99 of 100 frames is the second worst frame and not an interpolation
+ */
+f64 Percentile(const std::vector<f64> &sorted, f64 percent) {
+    if (sorted.empty()) return 0.0;
+    const f64 rank = std::ceil(percent / 100.0 * (f64)sorted.size());
+    const u64 index = rank < 1.0 ? 0 : std::min((u64)rank - 1, (u64)sorted.size() - 1);
+    return sorted[index];
+}
+
+FrameStats::Summary FrameStats::Summarize(StageTimes::stage stage) const {
+    Summary summary;
+    if (frames_.empty()) return summary;
+
+    std::vector<f64> values;
+    values.reserve(frames_.size());
+    f64 total = 0.0;
+    for (const StageTimes &times : frames_) {
+        values.push_back(times.time[stage]);
+        total += times.time[stage];
+    }
+    std::sort(values.begin(), values.end());
+
+    summary.mean = total / (f64)values.size();
+    summary.p50 = Percentile(values, 50.0);
+    summary.p95 = Percentile(values, 95.0);
+    summary.p99 = Percentile(values, 99.0);
+    summary.max = values.back();
+    return summary;
+}
+
+}
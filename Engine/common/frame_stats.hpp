@@ -0,0 +1,80 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file frame_stats.hpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Per stage frame timing
+ *
+ * CPU time of a frame split in the stages of the main loop. Renderer fills the stages it
+ * runs every frame, the Viewport loop adds the scene ones. Benchmarks keep them in
+ * FrameStats, which gives the mean and the tail percentiles of a whole run.
+ */
+
+#pragma once
+
+#include "primitive_types.hpp"
+#include "platform.hpp"
+
+#include <chrono>
+#include <vector>
+
+namespace reveal3d {
+
+// Milliseconds between laps, steady clock so it never goes back
+class Stopwatch {
+public:
+    Stopwatch() : start_(Clock::now()), last_(start_) { }
+
+    INLINE f64 Lap() {
+        const Clock::time_point now = Clock::now();
+        const f64 lap = std::chrono::duration<f64, std::milli>(now - last_).count();
+        last_ = now;
+        return lap;
+    }
+    [[nodiscard]] INLINE f64 Elapsed() const {
+        return std::chrono::duration<f64, std::milli>(Clock::now() - start_).count();
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point start_;
+    Clock::time_point last_;
+};
+
+// Milliseconds of one frame by stage, frame is the whole loop iteration
+struct StageTimes {
+    enum stage : u8 { sceneUpdate, transforms, extraction, culling, submission, frame, count };
+    static constexpr const char *names[count] = { "scene_update", "transforms", "extraction", "culling", "submission", "frame" };
+
+    f64 time[count] {};
+};
+
+class FrameStats {
+public:
+    struct Summary {
+        f64 mean { 0.0 };
+        f64 p50 { 0.0 };
+        f64 p95 { 0.0 };
+        f64 p99 { 0.0 };
+        f64 max { 0.0 };
+    };
+
+    INLINE void Reserve(u32 frames) { frames_.reserve(frames); }
+    INLINE void Clear() { frames_.clear(); }
+    INLINE void Add(const StageTimes &times) { frames_.push_back(times); }
+
+    [[nodiscard]] Summary Summarize(StageTimes::stage stage) const;
+    [[nodiscard]] INLINE u32 FrameCount() const { return frames_.size(); }
+    [[nodiscard]] INLINE const std::vector<StageTimes>& Frames() const { return frames_; }
+
+private:
+    std::vector<StageTimes> frames_;
+};
+
+// Nearest rank percentile in [0, 100] of values sorted ascending
+f64 Percentile(const std::vector<f64> &sorted, f64 percent);
+
+}
@@ -0,0 +1,241 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file job_system.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Minimal job system
+ *
+ * Longer description
+ */
+
+#include "job_system.hpp"
+#include "profiler.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace reveal3d::jobs {
+
+namespace {
+
+struct Batch {
+    RangeFunc func { nullptr };
+    void *context { nullptr };
+    u32 count { 0 };
+    u32 grain { 1 };
+    std::atomic<u32> done { 0 };
+};
+
+// What a participant runs, copied under mutex together with the batch it belongs to
+struct Job {
+    RangeFunc func { nullptr };
+    void *context { nullptr };
+    u32 grain { 1 };
+    u64 id { 0 };
+};
+
+// Range left to a participant, begin in the low half. Padded so owners don't share cache lines
+struct alignas(64) Slot {
+    std::atomic<u64> range { 0 };
+};
+
+std::vector<std::thread> workers;
+std::unique_ptr<Slot[]> slots; // Caller thread uses the first one, worker i the next ones
+u32 participants { 1 };
+std::mutex dispatchMutex;   // One batch in flight at a time
+std::mutex mutex;
+std::condition_variable wakeUp;
+std::condition_variable finished;
+Batch batch;
+std::atomic<u64> batchId { 0 }; // Written under mutex, participants check it before each range
+u32 activeWorkers { 0 };
+bool running { false };
+thread_local bool isWorker { false };
+
+// Workers are joined before the globals they wait on are destroyed, Shutdown is optional
+struct ExitGuard {
+    ~ExitGuard() { Shutdown(); }
+};
+ExitGuard exitGuard;
+
+inline u64 Pack(u32 begin, u32 end) {
+    return ((u64)end << 32) | begin;
+}
+
+// Owner takes grains from the front of its range
+bool PopFront(Slot &slot, u32 grain, u32 &begin, u32 &end) {
+    u64 range = slot.range.load(std::memory_order_acquire);
+    while (true) {
+        const u32 first = (u32)range;
+        const u32 last = (u32)(range >> 32);
+        if (first >= last) return false;
+        const u32 next = std::min(first + grain, last);
+        if (slot.range.compare_exchange_weak(range, Pack(next, last), std::memory_order_acq_rel)) {
+            begin = first;
+            end = next;
+            return true;
+        }
+    }
+}
+
+/**
+ * Takes the back half of the largest range left, in whole grains so every range still
+ * starts at a multiple of grain. Only called with an empty own slot, thieves never
+ * write empty slots so storing the stolen range needs no compare exchange
+ */
+bool Steal(u32 thief, u32 grain) {
+    while (true) {
+        u32 victim = participants;
+        u32 largest = 0;
+        for (u32 i = 0; i < participants; ++i) {
+            const u64 range = slots[i].range.load(std::memory_order_acquire);
+            const u32 first = (u32)range;
+            const u32 last = (u32)(range >> 32);
+            if (last > first and last - first > largest) {
+                largest = last - first;
+                victim = i;
+            }
+        }
+        if (victim == participants) return false;
+
+        u64 range = slots[victim].range.load(std::memory_order_acquire);
+        const u32 first = (u32)range;
+        const u32 last = (u32)(range >> 32);
+        if (first >= last) continue;
+        const u32 grains = (last - first + grain - 1) / grain;
+        const u32 middle = grains == 1 ? first : first + (grains - grains / 2) * grain;
+        if (slots[victim].range.compare_exchange_strong(range, Pack(first, middle), std::memory_order_acq_rel)) {
+            slots[thief].range.store(Pack(middle, last), std::memory_order_release);
+            return true;
+        }
+    }
+}
+
+// Stops as soon as another batch is published, its ranges belong to a different func
+void RunRanges(u32 participant, const Job &job) {
+    PROFILE_SCOPE("jobs::RunRanges");
+    u32 begin, end;
+    while (batchId.load(std::memory_order_acquire) == job.id) {
+        if (!PopFront(slots[participant], job.grain, begin, end)) {
+            if (!Steal(participant, job.grain)) break;
+            continue;
+        }
+        job.func(job.context, begin, end);
+        if (batch.done.fetch_add(end - begin, std::memory_order_acq_rel) + (end - begin) == batch.count) {
+            std::lock_guard lock(mutex);
+            finished.notify_one();
+        }
+    }
+}
+
+// Workers start at the current batch so they don't run one finished before a restart
+void WorkerLoop(u32 participant, u64 lastBatch) {
+    isWorker = true;
+    PROFILE_THREAD("Worker " + std::to_string(participant));
+    Job job;
+    while (true) {
+        {
+            std::unique_lock lock(mutex);
+            wakeUp.wait(lock, [&] { return !running or batchId.load(std::memory_order_relaxed) != lastBatch; });
+            if (!running) return;
+            lastBatch = batchId.load(std::memory_order_relaxed);
+            job = { batch.func, batch.context, batch.grain, lastBatch };
+            ++activeWorkers;
+        }
+        RunRanges(participant, job);
+        {
+            std::lock_guard lock(mutex);
+            if (--activeWorkers == 0) finished.notify_one();
+        }
+    }
+}
+
+}
+
+void Init(u32 workerCount) {
+    std::lock_guard dispatchLock(dispatchMutex);
+    if (running) return;
+
+    if (workerCount == 0) {
+        const u32 hwThreads = std::thread::hardware_concurrency();
+        workerCount = hwThreads > 1 ? hwThreads - 1 : 0;
+    }
+
+    running = true;
+    participants = workerCount + 1;
+    slots = std::make_unique<Slot[]>(participants);
+    workers.reserve(workerCount);
+    for (u32 i = 0; i < workerCount; ++i) {
+        workers.emplace_back(WorkerLoop, i + 1, batchId.load(std::memory_order_relaxed));
+    }
+}
+
+void Shutdown() {
+    std::lock_guard dispatchLock(dispatchMutex);
+    {
+        std::lock_guard lock(mutex);
+        running = false;
+    }
+    wakeUp.notify_all();
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+}
+
+u32 WorkerCount() {
+    return workers.size();
+}
+
+void Dispatch(u32 count, u32 grain, RangeFunc func, void *context) {
+    if (count == 0) return;
+    grain = std::max(grain, 1U);
+
+    if (!running) Init();
+
+    if (isWorker or workers.empty() or count <= grain) {
+        func(context, 0, count);
+        return;
+    }
+
+    std::lock_guard dispatchLock(dispatchMutex);
+    Job job;
+    {
+        std::lock_guard lock(mutex);
+        batch.func = func;
+        batch.context = context;
+        batch.count = count;
+        batch.grain = grain;
+        batch.done.store(0, std::memory_order_relaxed);
+
+        // Every participant starts with a contiguous share of whole grains
+        const u32 grains = (count + grain - 1) / grain;
+        for (u32 i = 0; i < participants; ++i) {
+            const u32 begin = (u32)((u64)grains * i / participants) * grain;
+            const u32 end = std::min((u32)((u64)grains * (i + 1) / participants) * grain, count);
+            slots[i].range.store(Pack(begin, end), std::memory_order_release);
+        }
+        batchId.fetch_add(1, std::memory_order_release);
+        job = { func, context, grain, batchId.load(std::memory_order_relaxed) };
+    }
+    wakeUp.notify_all();
+
+    // Nested calls from the caller ranges run serially too, dispatchMutex is already held
+    isWorker = true;
+    RunRanges(0, job);
+    isWorker = false;
+
+    std::unique_lock lock(mutex);
+    // Workers must leave the batch before it can be reused
+    finished.wait(lock, [] { return batch.done.load(std::memory_order_acquire) == batch.count and activeWorkers == 0; });
+}
+
+}
@@ -0,0 +1,42 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file job_system.hpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Minimal job system
+ *
+ * Fixed pool of worker threads used to split data parallel loops in ranges.
+ * Caller thread also takes ranges, so ParallelFor blocks until all of them are done.
+ * Each participant starts with an even share of the loop and steals half of the largest
+ * share left when it runs out, so uneven ranges (tiles, rays) still keep every thread busy.
+ * Nested calls from a worker are executed serially on that worker.
+ */
+
+#pragma once
+
+#include "primitive_types.hpp"
+
+#include <type_traits>
+
+namespace reveal3d::jobs {
+
+using RangeFunc = void (*)(void *context, u32 begin, u32 end);
+
+void Init(u32 workerCount = 0);
+void Shutdown();
+u32 WorkerCount();
+void Dispatch(u32 count, u32 grain, RangeFunc func, void *context);
+
+// Calls func(begin, end) for every [begin, end) range of at most grain elements
+template<typename Func>
+void ParallelFor(u32 count, u32 grain, Func &&func) {
+    using F = std::remove_reference_t<Func>;
+    Dispatch(count, grain, [](void *context, u32 begin, u32 end) {
+        (*static_cast<F *>(context))(begin, end);
+    }, (void *) &func);
+}
+
+}
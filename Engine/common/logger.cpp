@@ -6,45 +6,384 @@
  * @file logger.cpp
  * @version 1.0
  * @date 02/06/2024
- * @brief Short description
+ * @brief Asynchronous logger
  *
  * Longer description
  */
 
 #include "logger.hpp"
+#include "memory_report.hpp"
+#include "profiler.hpp"
 
-std::stringstream Logger::persistent_logs_[3];
+#include <algorithm>
+#include <charconv>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
 
-Logger::Logger(LogLevel logLevel) : level_(logLevel) {
+namespace reveal3d::logging {
 
-    switch (logLevel) {
-        case logERROR:
-            buffer_ << "ERROR MSG" << ": ";
-            break;
-        case logWARNING:
-            buffer_ << "WARNING MSG" << ": ";
-            break;
-        case logDEBUG:
-            buffer_ << "DEBUG MSG" << ": ";
-            break;
+// Single producer, the owner thread, and single consumer, the background thread
+struct Ring {
+    static constexpr u32 capacity = 256;    // Slots, power of two
+
+    alignas(64) std::atomic<u32> head { 0 };
+    alignas(64) std::atomic<u32> tail { 0 };
+    std::atomic<bool> retired { false };    // Owner exited, freed once drained
+    Slot slots[capacity];
+};
+
+static_assert(sizeof(Slot) == Slot::size);
+
+namespace {
+
+constexpr const char *prefixes[3] = { "ERROR MSG: ", "WARNING MSG: ", "DEBUG MSG: " };
+constexpr auto wakeInterval = std::chrono::milliseconds(2);
+
+// Last bytes of a level, oldest ones overwritten first
+struct History {
+    void Append(std::string_view text) {
+        if (text.size() > Logger::historyCapacity) {
+            text = text.substr(text.size() - Logger::historyCapacity);
+        }
+        const u32 length = (u32) text.size();
+        const u32 end = (start + size) % Logger::historyCapacity;
+        const u32 first = std::min(length, Logger::historyCapacity - end);
+        std::memcpy(data + end, text.data(), first);
+        std::memcpy(data, text.data() + first, length - first);
+        size += length;
+        if (size > Logger::historyCapacity) {
+            start = (start + size - Logger::historyCapacity) % Logger::historyCapacity;
+            size = Logger::historyCapacity;
+            overwritten = true;
+        }
     }
+
+    std::string Read() const {
+        std::string text(size, '\0');
+        const u32 first = std::min(size, Logger::historyCapacity - start);
+        std::memcpy(text.data(), data + start, first);
+        std::memcpy(text.data() + first, data, size - first);
+        if (overwritten) {
+            // First line lost its beginning
+            const size_t newline = text.find('\n');
+            text.erase(0, newline == std::string::npos ? text.size() : newline + 1);
+        }
+        return text;
+    }
+
+    char data[Logger::historyCapacity];
+    u32 start;
+    u32 size;
+    bool overwritten;
+};
+
+std::mutex ringsMutex;
+std::vector<Ring *> rings;
+
+std::mutex historyMutex;
+History histories[3];
+
+std::mutex wakeMutex;
+std::condition_variable wake;       // Background thread sleeps on it between passes
+std::condition_variable drained;    // Flush waits on it
+u64 requested { 0 };                // Flushes asked for and done, guarded by wakeMutex
+u64 completed { 0 };
+bool stop { false };
+
+std::atomic<bool> started { false };
+std::atomic<bool> stopped { false };
+std::atomic<bool> console { true };
+std::atomic<u64> dropped { 0 };
+std::once_flag startFlag;
+std::thread worker;
+std::thread::id workerId;
+
+thread_local Ring *localRing { nullptr };
+thread_local Slot inPlace;  // Messages of the background thread and the ones after shutdown
+
+struct RingOwner {
+    ~RingOwner() {
+        if (localRing != nullptr) localRing->retired.store(true, std::memory_order_release);
+        localRing = nullptr;
+    }
+};
+
+thread_local RingOwner owner;
+
+// Order breaks ties in time, std::stable_sort would allocate a buffer every pass
+struct Pending {
+    const Slot *slot;
+    u32 order;
+};
+
+template<typename T>
+T Read(const Slot &slot, u32 &offset) {
+    T value;
+    std::memcpy(&value, slot.payload + offset, sizeof(T));
+    offset += sizeof(T);
+    return value;
 }
 
-std::string Logger::Log(LogLevel logLevel) {
-    return persistent_logs_[logLevel].str();
+template<typename T>
+void AppendNumber(std::string &out, T value) {
+    char buffer[24];
+    const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
 }
 
-Logger::~Logger()
-{
-    buffer_ << std::endl;
-    persistent_logs_[level_] << buffer_.str();
+// Same text std::ostream gives with its default flags. Heap strings are freed here
+void Format(const Slot &slot, std::string &out) {
+    out += prefixes[slot.level];
+    for (u32 offset = 0; offset < slot.used;) {
+        const Arg arg = (Arg) slot.payload[offset++];
+        switch (arg) {
+            case boolean: out += Read<bool>(slot, offset) ? '1' : '0'; break;
+            case character: out += Read<char>(slot, offset); break;
+            case integer: AppendNumber(out, Read<i64>(slot, offset)); break;
+            case unsignedInteger: AppendNumber(out, Read<u64>(slot, offset)); break;
+            case real: {
+                char buffer[32];
+                const i32 length = std::snprintf(buffer, sizeof(buffer), "%g", Read<f64>(slot, offset));
+                out.append(buffer, std::min<i32>(length, sizeof(buffer) - 1));
+                break;
+            }
+            case pointer: {
+                char buffer[24];
+                const i32 length = std::snprintf(buffer, sizeof(buffer), "%p", Read<const void *>(slot, offset));
+                out.append(buffer, std::min<i32>(length, sizeof(buffer) - 1));
+                break;
+            }
+            case text: {
+                const u32 length = Read<u32>(slot, offset);
+                out.append(slot.payload + offset, length);
+                offset += length;
+                break;
+            }
+            case heapText: {
+                char *data = Read<char *>(slot, offset);
+                const u32 length = Read<u32>(slot, offset);
+                out.append(data, length);
+                delete[] data;
+                break;
+            }
+        }
+    }
+    if (slot.truncated) out += "...";
+    out += '\n';
+}
+
+void Output(const std::string &out) {
+    if (out.empty() or !console.load(std::memory_order_relaxed)) return;
 #ifdef _WIN32
-    OutputDebugStringA(buffer_.str().c_str());
+    OutputDebugStringA(out.c_str());
 #else
-    std::cerr << buffer_.str();
+    std::fwrite(out.data(), 1, out.size(), stderr);
 #endif
 }
 
+void WriteInPlace(const Slot &slot) {
+    std::string out;
+    Format(slot, out);
+    {
+        std::lock_guard lock(historyMutex);
+        histories[slot.level].Append(out);
+    }
+    Output(out);
+}
+
+/**
+ * Every slot committed when the pass starts, sorted by time so lines of different threads
+ * come out in order. Buffers keep their capacity, passes allocate nothing once warm
+ */
+void Drain(std::vector<Pending> &pending, std::vector<std::pair<Ring *, u32>> &heads, std::string &out) {
+    pending.clear();
+    heads.clear();
+    {
+        std::lock_guard lock(ringsMutex);
+        // Only grows when a thread registers its ring
+        pending.reserve(rings.size() * Ring::capacity);
+        heads.reserve(rings.size());
+        for (Ring *ring : rings) {
+            const u32 head = ring->head.load(std::memory_order_acquire);
+            for (u32 i = ring->tail.load(std::memory_order_relaxed); i != head; ++i) {
+                pending.push_back({ &ring->slots[i & (Ring::capacity - 1)], (u32) pending.size() });
+            }
+            heads.emplace_back(ring, head);
+        }
+    }
+
+    std::sort(pending.begin(), pending.end(), [](const Pending &a, const Pending &b) {
+        return a.slot->time < b.slot->time or (a.slot->time == b.slot->time and a.order < b.order);
+    });
+    out.clear();
+    {
+        std::lock_guard lock(historyMutex);
+        for (const Pending &entry : pending) {
+            const size_t begin = out.size();
+            Format(*entry.slot, out);
+            histories[entry.slot->level].Append(std::string_view(out).substr(begin));
+        }
+    }
+    Output(out);
+
+    for (auto [ring, head] : heads) {
+        ring->tail.store(head, std::memory_order_release);
+    }
+
+    std::lock_guard lock(ringsMutex);
+    std::erase_if(rings, [](Ring *ring) {
+        if (!ring->retired.load(std::memory_order_acquire)) return false;
+        if (ring->tail.load(std::memory_order_relaxed) != ring->head.load(std::memory_order_acquire)) return false;
+        delete ring;
+        memory::Track(memory::logger, -(i64) sizeof(Ring));
+        return true;
+    });
+}
+
+void Run() {
+    std::vector<Pending> pending;
+    std::vector<std::pair<Ring *, u32>> heads;
+    std::string out;
+    for (bool stopping = false; !stopping;) {
+        u64 request;
+        {
+            std::unique_lock lock(wakeMutex);
+            wake.wait_for(lock, wakeInterval, [] { return stop or requested > completed; });
+            request = requested;
+            stopping = stop;
+        }
+        Drain(pending, heads, out);
+        {
+            std::lock_guard lock(wakeMutex);
+            completed = request;
+        }
+        drained.notify_all();
+    }
+}
+
+void Start() {
+    memory::Track(memory::logger, sizeof(histories));
+    worker = std::thread(Run);
+    workerId = worker.get_id();
+    started.store(true, std::memory_order_release);
+}
+
+Ring* Register() {
+    std::call_once(startFlag, Start);
+    if (std::this_thread::get_id() == workerId) return nullptr;
+
+    auto *ring = new Ring();
+    memory::Track(memory::logger, sizeof(Ring));
+    {
+        std::lock_guard lock(ringsMutex);
+        rings.push_back(ring);
+    }
+    (void) &owner; // Constructs it, so its destructor retires the ring
+    localRing = ring;
+    return ring;
+}
+
+// Rings of threads still running at exit are left to the OS, they may be writing to them
+struct Shutdown {
+    ~Shutdown() {
+        if (!started.load(std::memory_order_acquire)) return;
+        stopped.store(true, std::memory_order_release);
+        {
+            std::lock_guard lock(wakeMutex);
+            stop = true;
+        }
+        wake.notify_one();
+        worker.join();
+    }
+};
+
+Shutdown shutdown;
+
+}
+
+}
+
+using namespace reveal3d;
+using namespace reveal3d::logging;
+
+Logger::Logger(LogLevel logLevel) {
+    if (!stopped.load(std::memory_order_relaxed)) {
+        ring_ = localRing != nullptr ? localRing : Register();
+    }
+    if (ring_ == nullptr) {
+        slot_ = &inPlace;
+    } else {
+        const u32 head = ring_->head.load(std::memory_order_relaxed);
+        while (head - ring_->tail.load(std::memory_order_acquire) == Ring::capacity) {
+            if (logLevel != logERROR) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            wake.notify_one();
+            std::this_thread::yield();
+        }
+        slot_ = &ring_->slots[head & (Ring::capacity - 1)];
+    }
+    slot_->time = profiler::Now();
+    slot_->used = 0;
+    slot_->level = (u8) logLevel;
+    slot_->truncated = false;
+}
+
+Logger::~Logger()
+{
+    if (slot_ == nullptr) return;
+    if (ring_ == nullptr) {
+        WriteInPlace(*slot_);
+        return;
+    }
+    ring_->head.store(ring_->head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+// Owned by the slot until the background thread writes it
+void Logger::PutHeapText(std::string_view text) {
+    if (slot_->used + 1 + sizeof(char *) + sizeof(u32) > Slot::payloadSize) {
+        slot_->truncated = true;
+        return;
+    }
+    auto *data = new char[text.size()];
+    std::memcpy(data, text.data(), text.size());
+    const u32 length = (u32) text.size();
+    slot_->payload[slot_->used] = (char) heapText;
+    std::memcpy(slot_->payload + slot_->used + 1, &data, sizeof(data));
+    std::memcpy(slot_->payload + slot_->used + 1 + sizeof(data), &length, sizeof(length));
+    slot_->used += 1 + sizeof(data) + sizeof(length);
+}
+
+void Logger::Flush() {
+    if (!started.load(std::memory_order_acquire) or stopped.load(std::memory_order_acquire)) return;
+    std::unique_lock lock(wakeMutex);
+    const u64 request = ++requested;
+    wake.notify_one();
+    drained.wait(lock, [request] { return completed >= request or stop; });
+}
+
 void Logger::Clear(LogLevel logLevel) {
-    Logger::persistent_logs_[logLevel].str("");
+    Flush();
+    std::lock_guard lock(historyMutex);
+    histories[logLevel].start = 0;
+    histories[logLevel].size = 0;
+    histories[logLevel].overwritten = false;
+}
+
+std::string Logger::Log(LogLevel logLevel) {
+    Flush();
+    std::lock_guard lock(historyMutex);
+    return histories[logLevel].Read();
+}
+
+void Logger::SetConsole(bool enable) {
+    console.store(enable, std::memory_order_relaxed);
+}
+
+uint64_t Logger::Dropped() {
+    return dropped.load(std::memory_order_relaxed);
 }
@@ -6,17 +6,32 @@
  * @file logger.hpp
  * @version 1.0
  * @date 08/03/2024
- * @brief Short description
+ * @brief Asynchronous logger
  *
- * Longer description
+ * LOG(level) << a << b; copies the arguments, unformatted, into a slot of a ring owned by
+ * the calling thread. A background thread formats the slots of every thread in time order,
+ * writes them to the console and keeps the last historyCapacity bytes of each level. Logging
+ * takes no locks and, once the thread has its ring, allocates nothing unless a string is too
+ * long for the slot or the argument is a type the ring doesn't know.
+ *
+ * Levels above LOG_MAX_LEVEL are compiled out, loglevel filters the rest at run time. The
+ * level of LOG has to be a constant expression, a level only known at run time goes through
+ * Logger(level) after checking it against loglevel. The macro is upper case so it doesn't
+ * shadow std::log.
+ * When the ring is full warnings and debug messages are dropped, errors wait for room.
  */
 
 #pragma once
 
 #include "platform.hpp"
 
-#include <iostream>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
 #include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
 
 
 enum LogLevel {
@@ -25,31 +40,122 @@ enum LogLevel {
     logDEBUG,
 };
 
+#ifndef LOG_MAX_LEVEL
+#ifdef SHIPPING
+#define LOG_MAX_LEVEL logERROR
+#else
+#define LOG_MAX_LEVEL logDEBUG
+#endif
+#endif
+
+namespace reveal3d::logging {
+
+enum Arg : uint8_t { boolean, character, integer, unsignedInteger, real, pointer, text, heapText };
+
+// One message, arguments are an Arg followed by its value. Strings are a length and the chars
+struct Slot {
+    static constexpr uint32_t size = 256;
+    static constexpr uint32_t payloadSize = size - 16;
+
+    uint64_t time;
+    uint16_t used;
+    uint8_t level;
+    bool truncated;
+    char payload[payloadSize];
+};
+
+struct Ring;
+
+}
+
 class Logger
 {
 public:
-    Logger(LogLevel logLevel = logERROR);
+    static constexpr uint32_t historyCapacity = 64 << 10;   // Per level
+
+    explicit Logger(LogLevel logLevel = logERROR);
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
 
     template <typename T>
     Logger & operator<<(T const & value)
     {
-        buffer_ << value;
+        using U = std::decay_t<T>;
+        using namespace reveal3d::logging;
+        if (slot_ == nullptr) return *this;
+        if constexpr (std::is_same_v<U, bool>) {
+            Put(boolean, &value, 1);
+        } else if constexpr (std::is_same_v<U, char> or std::is_same_v<U, signed char> or std::is_same_v<U, unsigned char>) {
+            Put(character, &value, 1);
+        } else if constexpr (std::is_integral_v<U> or std::is_enum_v<U>) {
+            if constexpr (std::is_enum_v<U> or std::is_signed_v<U>) {
+                const int64_t number = (int64_t) value;
+                Put(integer, &number, sizeof(number));
+            } else {
+                const uint64_t number = (uint64_t) value;
+                Put(unsignedInteger, &number, sizeof(number));
+            }
+        } else if constexpr (std::is_floating_point_v<U>) {
+            const double number = (double) value;
+            Put(real, &number, sizeof(number));
+        } else if constexpr (std::is_convertible_v<T const &, std::string_view>) {
+            PutText(std::string_view(value));
+        } else if constexpr (std::is_pointer_v<U>) {
+            const void *address = (const void *) value;
+            Put(pointer, &address, sizeof(address));
+        } else {
+            // Unknown types are formatted here, it allocates
+            std::ostringstream stream;
+            stream << value;
+            PutText(stream.view());
+        }
         return *this;
     }
 
+    // Waits until the background thread has written every message logged before the call
+    static void Flush();
     static void Clear(LogLevel logLevel);
+    // Last historyCapacity bytes of the level, whole lines only
     static std::string Log(LogLevel logLevel);
+    // Writing to the console or debugger output, on by default
+    static void SetConsole(bool console);
+    // Warnings and debug messages dropped because the ring of their thread was full
+    static uint64_t Dropped();
     ~Logger();
 
 private:
-    LogLevel level_;
-    std::ostringstream buffer_;
-    static std::stringstream persistent_logs_[3];
+    INLINE void Put(reveal3d::logging::Arg arg, const void *value, uint32_t bytes) {
+        if (slot_->used + 1 + bytes > reveal3d::logging::Slot::payloadSize) {
+            slot_->truncated = true;
+            return;
+        }
+        slot_->payload[slot_->used] = (char) arg;
+        std::memcpy(slot_->payload + slot_->used + 1, value, bytes);
+        slot_->used += 1 + bytes;
+    }
+
+    INLINE void PutText(std::string_view text) {
+        const uint32_t length = (uint32_t) text.size();
+        if (slot_->used + 1 + sizeof(length) + length > reveal3d::logging::Slot::payloadSize) {
+            PutHeapText(text);
+            return;
+        }
+        slot_->payload[slot_->used] = (char) reveal3d::logging::text;
+        std::memcpy(slot_->payload + slot_->used + 1, &length, sizeof(length));
+        std::memcpy(slot_->payload + slot_->used + 1 + sizeof(length), text.data(), length);
+        slot_->used += 1 + sizeof(length) + length;
+    }
+
+    void PutHeapText(std::string_view text);
+
+    reveal3d::logging::Ring *ring_ { nullptr };   // Null when the message is written in place
+    reveal3d::logging::Slot *slot_ { nullptr };   // Null when the message is dropped
 };
 
 extern LogLevel loglevel;
 
-#define log(level) \
-if (level > loglevel) ; \
+#define LOG(level) \
+if constexpr ((level) > LOG_MAX_LEVEL) ; \
+else if ((level) > loglevel) ; \
 else Logger(level)
 
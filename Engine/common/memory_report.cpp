@@ -0,0 +1,96 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file memory_report.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Memory used by each engine subsystem
+ *
+ * Longer description
+ */
+
+#include "memory_report.hpp"
+#include "logger.hpp"
+
+#include <atomic>
+
+namespace reveal3d::memory {
+
+namespace {
+
+// Constant initialized, pools of other static objects can count before main
+struct Counter {
+    std::atomic<u64> bytes;
+    std::atomic<u64> peak;
+    std::atomic<u64> budget;
+    std::atomic<Evict> evict;
+    std::atomic<bool> over;
+};
+
+Counter counters[tag::count];
+
+void OverBudget(tag subsystem, u64 bytes, u64 budget) {
+    LOG(logWARNING) << "Memory of " << tagNames[subsystem] << " over budget: " << bytes << " of " << budget << " bytes";
+    if (const Evict evict = counters[subsystem].evict.load(std::memory_order_acquire)) {
+        evict(subsystem, bytes);
+    }
+}
+
+}
+
+void Track(tag subsystem, i64 bytes) {
+    Counter &counter = counters[subsystem];
+    const u64 now = counter.bytes.fetch_add((u64) bytes, std::memory_order_relaxed) + (u64) bytes;
+
+    u64 peak = counter.peak.load(std::memory_order_relaxed);
+    while (now > peak and !counter.peak.compare_exchange_weak(peak, now, std::memory_order_relaxed)) { }
+
+    const u64 budget = counter.budget.load(std::memory_order_relaxed);
+    if (budget == 0) return;
+    if (now <= budget) {
+        if (counter.over.load(std::memory_order_relaxed)) counter.over.store(false, std::memory_order_relaxed);
+    } else if (!counter.over.exchange(true, std::memory_order_relaxed)) {
+        // Logging or evicting can track this tag again, the flag is already set by then
+        OverBudget(subsystem, now, budget);
+    }
+}
+
+void SetBudget(tag subsystem, u64 bytes, Evict evict) {
+    Counter &counter = counters[subsystem];
+    counter.evict.store(evict, std::memory_order_release);
+    counter.budget.store(bytes, std::memory_order_relaxed);
+    counter.over.store(false, std::memory_order_relaxed);
+}
+
+u64 Budget(tag subsystem) {
+    return counters[subsystem].budget.load(std::memory_order_relaxed);
+}
+
+Usage TagUsage(tag subsystem) {
+    const Counter &counter = counters[subsystem];
+    return {
+        tagNames[subsystem],
+        counter.bytes.load(std::memory_order_relaxed),
+        counter.peak.load(std::memory_order_relaxed),
+        counter.budget.load(std::memory_order_relaxed)
+    };
+}
+
+std::vector<Usage> MemoryReport() {
+    std::vector<Usage> report;
+    report.reserve(tag::count);
+    for (u32 i = 0; i < tag::count; ++i) {
+        report.push_back(TagUsage((tag) i));
+    }
+    return report;
+}
+
+void ResetPeaks() {
+    for (Counter &counter : counters) {
+        counter.peak.store(counter.bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+}
+
+}
@@ -0,0 +1,120 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file memory_report.hpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Memory used by each engine subsystem
+ *
+ * Every subsystem has a tag with the bytes it holds now and the most it ever held. Pools
+ * count themselves through Allocator, data owned by something else (meshes, GPU buffers,
+ * log history) is counted with Tracked or Track. Counting is a relaxed atomic add per
+ * allocation, so tagged containers should grow rarely, as engine pools do.
+ *
+ * A tag can have a soft budget. Going over it logs a warning and calls the eviction
+ * function of the tag, if any, once per crossing.
+ */
+
+#pragma once
+
+#include "primitive_types.hpp"
+#include "platform.hpp"
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+namespace reveal3d::memory {
+
+enum tag : u8 {
+    ecs,        // Entity and component pools
+    meshes,     // Vertices, indices and BVHs of render::Mesh
+    buffers,    // Geometry and frame buffers of the graphics backends, GPU ones included
+    content,    // Data being loaded from files
+    logger,     // Persistent log history
+
+    count
+};
+
+constexpr const char *tagNames[tag::count] = { "ecs", "meshes", "buffers", "content", "logger" };
+
+struct Usage {
+    const char *name;
+    u64 bytes;
+    u64 peak;
+    u64 budget; // 0 if there isn't one
+};
+
+// Gets the subsystem and the bytes it holds, should bring them under budget
+using Evict = void (*)(tag subsystem, u64 bytes);
+
+void Track(tag subsystem, i64 bytes);
+// Soft limit, 0 removes it. evict runs on the thread that crossed the budget
+void SetBudget(tag subsystem, u64 bytes, Evict evict = nullptr);
+[[nodiscard]] u64 Budget(tag subsystem);
+[[nodiscard]] Usage TagUsage(tag subsystem);
+// Every tag, in tag order
+std::vector<Usage> MemoryReport();
+// Peaks start again from what each tag holds now
+void ResetPeaks();
+
+template<typename T, tag Tag>
+struct Allocator {
+    using value_type = T;
+    // Tag is a value, allocator_traits can't rebind it by itself
+    template<typename U> struct rebind { using other = Allocator<U, Tag>; };
+
+    Allocator() = default;
+    template<typename U> Allocator(const Allocator<U, Tag>&) noexcept { }
+
+    T* allocate(size_t n) {
+        T *ptr = std::allocator<T>().allocate(n);
+        Track(Tag, (i64)(n * sizeof(T)));
+        return ptr;
+    }
+
+    void deallocate(T *ptr, size_t n) noexcept {
+        Track(Tag, -(i64)(n * sizeof(T)));
+        std::allocator<T>().deallocate(ptr, n);
+    }
+
+    template<typename U> bool operator==(const Allocator<U, Tag>&) const noexcept { return true; }
+};
+
+template<typename T, tag Tag> using Vector = std::vector<T, Allocator<T, Tag>>;
+template<typename T, tag Tag> using Deque = std::deque<T, Allocator<T, Tag>>;
+
+/**
+ * Bytes of one owner, released when it is destroyed. Moves hand them over, copies start
+ * from zero since they own nothing until they set their own
+ */
+template<tag Tag>
+class Tracked {
+public:
+    Tracked() = default;
+    Tracked(const Tracked&) { }
+    Tracked(Tracked &&other) noexcept : bytes_(other.bytes_) { other.bytes_ = 0; }
+    Tracked& operator=(const Tracked&) { return *this; }
+    Tracked& operator=(Tracked &&other) noexcept {
+        if (this != &other) {
+            Set(0);
+            bytes_ = other.bytes_;
+            other.bytes_ = 0;
+        }
+        return *this;
+    }
+    ~Tracked() { Set(0); }
+
+    INLINE void Set(u64 bytes) {
+        if (bytes != bytes_) Track(Tag, (i64) bytes - (i64) bytes_);
+        bytes_ = bytes;
+    }
+    [[nodiscard]] INLINE u64 Bytes() const { return bytes_; }
+
+private:
+    u64 bytes_ { 0 };
+};
+
+}
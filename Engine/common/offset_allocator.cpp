@@ -0,0 +1,261 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file offset_allocator.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Two level segregated fit range allocator
+ *
+ * Longer description
+ */
+
+#include "offset_allocator.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+
+namespace reveal3d {
+
+namespace {
+
+constexpr u32 mantissaBits = 3;
+constexpr u32 mantissaValue = 1 << mantissaBits;
+constexpr u32 mantissaMask = mantissaValue - 1;
+
+// Small float bin of size, sizes below 8 are exact and every bin above spans 1/8 of its power of two
+u32 BinRoundUp(u32 size) {
+    if (size < mantissaValue) return size;
+    const u32 highestBit = 31 - std::countl_zero(size);
+    const u32 mantissaStart = highestBit - mantissaBits;
+    u32 bin = ((mantissaStart + 1) << mantissaBits) + ((size >> mantissaStart) & mantissaMask);
+    if ((size & ((1u << mantissaStart) - 1)) != 0) {
+        ++bin; // Carry goes to the exponent
+    }
+    return bin;
+}
+
+u32 BinRoundDown(u32 size) {
+    if (size < mantissaValue) return size;
+    const u32 highestBit = 31 - std::countl_zero(size);
+    const u32 mantissaStart = highestBit - mantissaBits;
+    return ((mantissaStart + 1) << mantissaBits) + ((size >> mantissaStart) & mantissaMask);
+}
+
+// Index of the lowest bit set at or after start, UINT_MAX when none
+u32 LowestBitAfter(u32 mask, u32 start) {
+    const u32 masked = start >= 32 ? 0 : mask & ~((1u << start) - 1);
+    return masked == 0 ? UINT_MAX : std::countr_zero(masked);
+}
+
+}
+
+void OffsetAllocator::Reset(u32 size) {
+    nodes_.clear();
+    freeNodes_.clear();
+    std::fill(std::begin(binHeads_), std::end(binHeads_), unused);
+    std::fill(std::begin(usedLeafBins_), std::end(usedLeafBins_), 0);
+    usedTopBins_ = 0;
+    size_ = size;
+    freeStorage_ = 0;
+    freeRegions_ = 0;
+    allocations_ = 0;
+    last_ = size > 0 ? InsertNode(size, 0) : unused;
+}
+
+/**
+ * Smallest non empty bin that is at least the rounded up size, first in the leaf bins of
+ * the same top bin and then in bigger top bins. The rest of the range goes back as free
+ */
+OffsetAllocator::Allocation OffsetAllocator::Allocate(u32 size) {
+    if (size == 0 or size > freeStorage_) return {};
+
+    const u32 minBin = BinRoundUp(size);
+    u32 topBin = minBin / leafBins;
+    u32 leafBin = unused;
+    if (usedTopBins_ & (1u << topBin)) {
+        leafBin = LowestBitAfter(usedLeafBins_[topBin], minBin % leafBins);
+    }
+    if (leafBin == unused) {
+        topBin = LowestBitAfter(usedTopBins_, topBin + 1);
+        if (topBin != unused) {
+            leafBin = std::countr_zero((u32)usedLeafBins_[topBin]);
+        }
+    }
+
+    u32 index = unused;
+    if (leafBin != unused) {
+        index = binHeads_[topBin * leafBins + leafBin];
+    } else {
+        // Ranges in the bin below may still fit, only searched when nothing else does
+        for (u32 i = binHeads_[BinRoundDown(size)]; i != unused and index == unused; i = nodes_[i].binNext) {
+            if (nodes_[i].size >= size) index = i;
+        }
+        if (index == unused) return {};
+    }
+
+    const u32 rangeSize = nodes_[index].size;
+    RemoveNode(index);
+    freeNodes_.pop_back(); // RemoveNode released it, it is kept as the allocation
+    Node &node = nodes_[index];
+    node.size = size;
+    node.used = true;
+    ++allocations_;
+
+    if (rangeSize > size) {
+        const u32 rest = InsertNode(rangeSize - size, nodes_[index].offset + size);
+        Node &allocated = nodes_[index];
+        Node &remainder = nodes_[rest];
+        remainder.neighborPrev = index;
+        remainder.neighborNext = allocated.neighborNext;
+        if (allocated.neighborNext != unused) {
+            nodes_[allocated.neighborNext].neighborPrev = rest;
+        }
+        allocated.neighborNext = rest;
+        if (last_ == index) last_ = rest;
+    }
+    return { nodes_[index].offset, index };
+}
+
+void OffsetAllocator::Free(Allocation allocation) {
+    assert(allocation.Valid() and nodes_[allocation.node].used);
+    const u32 index = allocation.node;
+    u32 offset = nodes_[index].offset;
+    u32 size = nodes_[index].size;
+    u32 prev = nodes_[index].neighborPrev;
+    u32 next = nodes_[index].neighborNext;
+    bool isLast = last_ == index;
+
+    if (prev != unused and !nodes_[prev].used) {
+        offset = nodes_[prev].offset;
+        size += nodes_[prev].size;
+        const u32 merged = prev;
+        prev = nodes_[merged].neighborPrev;
+        RemoveNode(merged);
+    }
+    if (next != unused and !nodes_[next].used) {
+        size += nodes_[next].size;
+        const u32 merged = next;
+        isLast = isLast or last_ == merged;
+        next = nodes_[merged].neighborNext;
+        RemoveNode(merged);
+    }
+
+    nodes_[index] = Node {};
+    freeNodes_.push_back(index);
+    --allocations_;
+
+    const u32 combined = InsertNode(size, offset);
+    nodes_[combined].neighborPrev = prev;
+    nodes_[combined].neighborNext = next;
+    if (prev != unused) nodes_[prev].neighborNext = combined;
+    if (next != unused) nodes_[next].neighborPrev = combined;
+    if (isLast) last_ = combined;
+}
+
+void OffsetAllocator::Grow(u32 size) {
+    if (size <= size_) return;
+    const u32 added = size - size_;
+
+    if (last_ != unused and !nodes_[last_].used) {
+        const u32 offset = nodes_[last_].offset;
+        const u32 merged = nodes_[last_].size + added;
+        const u32 prev = nodes_[last_].neighborPrev;
+        RemoveNode(last_);
+        last_ = InsertNode(merged, offset);
+        nodes_[last_].neighborPrev = prev;
+        if (prev != unused) nodes_[prev].neighborNext = last_;
+    } else {
+        const u32 prev = last_;
+        last_ = InsertNode(added, size_);
+        nodes_[last_].neighborPrev = prev;
+        if (prev != unused) nodes_[prev].neighborNext = last_;
+    }
+    size_ = size;
+}
+
+u32 OffsetAllocator::AllocationSize(Allocation allocation) const {
+    return allocation.Valid() ? nodes_[allocation.node].size : 0;
+}
+
+/**
+ * Bins only hold a lower bound of their sizes, the largest free range is searched in the
+ * list of the highest used bin
+ */
+OffsetAllocator::Stats OffsetAllocator::Statistics() const {
+    Stats stats { size_, freeStorage_, 0, freeRegions_, allocations_ };
+    if (usedTopBins_ == 0) return stats;
+
+    const u32 topBin = 31 - std::countl_zero(usedTopBins_);
+    const u32 leafBin = 31 - std::countl_zero((u32)usedLeafBins_[topBin]);
+    for (u32 index = binHeads_[topBin * leafBins + leafBin]; index != unused; index = nodes_[index].binNext) {
+        stats.largestFree = std::max(stats.largestFree, nodes_[index].size);
+    }
+    return stats;
+}
+
+// Free ranges go to the bin of their rounded down size, every range in a bin is at least its size
+u32 OffsetAllocator::InsertNode(u32 size, u32 offset) {
+    const u32 bin = BinRoundDown(size);
+    const u32 topBin = bin / leafBins;
+    const u32 leafBin = bin % leafBins;
+    usedTopBins_ |= 1u << topBin;
+    usedLeafBins_[topBin] |= 1u << leafBin;
+
+    const u32 index = NewNode();
+    Node &node = nodes_[index];
+    node = Node {};
+    node.offset = offset;
+    node.size = size;
+    node.binNext = binHeads_[bin];
+    if (node.binNext != unused) {
+        nodes_[node.binNext].binPrev = index;
+    }
+    binHeads_[bin] = index;
+
+    freeStorage_ += size;
+    ++freeRegions_;
+    return index;
+}
+
+// Unlinks a free range from its bin and releases its node, neighbor links are left to the caller
+void OffsetAllocator::RemoveNode(u32 index) {
+    Node &node = nodes_[index];
+    if (node.binPrev != unused) {
+        nodes_[node.binPrev].binNext = node.binNext;
+        if (node.binNext != unused) {
+            nodes_[node.binNext].binPrev = node.binPrev;
+        }
+    } else {
+        const u32 bin = BinRoundDown(node.size);
+        binHeads_[bin] = node.binNext;
+        if (node.binNext != unused) {
+            nodes_[node.binNext].binPrev = unused;
+        }
+        if (binHeads_[bin] == unused) {
+            const u32 topBin = bin / leafBins;
+            usedLeafBins_[topBin] &= ~(1u << (bin % leafBins));
+            if (usedLeafBins_[topBin] == 0) {
+                usedTopBins_ &= ~(1u << topBin);
+            }
+        }
+    }
+
+    freeStorage_ -= node.size;
+    --freeRegions_;
+    freeNodes_.push_back(index);
+}
+
+u32 OffsetAllocator::NewNode() {
+    if (freeNodes_.empty()) {
+        nodes_.emplace_back();
+        return nodes_.size() - 1;
+    }
+    const u32 index = freeNodes_.back();
+    freeNodes_.pop_back();
+    return index;
+}
+
+}
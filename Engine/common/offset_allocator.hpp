@@ -0,0 +1,102 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file offset_allocator.hpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Two level segregated fit range allocator
+ *
+ * Hands out [offset, offset + size) ranges of an external resource (GPU buffers, heaps),
+ * it never touches the memory it manages. Free ranges are kept in 256 bins indexed by a
+ * small float of their size, 5 exponent bits select the top bin and 3 mantissa bits the
+ * leaf bin, with one bitmask per level. Allocation and free are O(1): finding a bin is a
+ * couple of bit scans, freed ranges merge with free neighbours right away.
+ *
+ * Allocations round the requested size up to a bin, so a range found in that bin always
+ * fits. Only when no such bin has ranges the bin of the size itself is searched, so an
+ * exactly fitting range is not missed. Sizes are in any unit the caller picks (bytes,
+ * vertices, indices).
+ */
+
+#pragma once
+
+#include "primitive_types.hpp"
+#include "platform.hpp"
+
+#include <climits>
+#include <vector>
+
+namespace reveal3d {
+
+class OffsetAllocator {
+public:
+    static constexpr u32 noSpace = UINT_MAX;
+
+    struct Allocation {
+        u32 offset  { noSpace };
+        u32 node    { noSpace };
+
+        [[nodiscard]] INLINE bool Valid() const { return offset != noSpace; }
+    };
+
+    struct Stats {
+        u32 size            { 0 };
+        u32 free            { 0 };
+        u32 largestFree     { 0 };
+        u32 freeRegions     { 0 };
+        u32 allocations     { 0 };
+
+        // 0 when all free space is contiguous, close to 1 when it is split in small pieces
+        [[nodiscard]] INLINE f32 Fragmentation() const { return free == 0 ? 0.0f : 1.0f - (f32)largestFree / (f32)free; }
+    };
+
+    OffsetAllocator() { Reset(0); }
+    explicit OffsetAllocator(u32 size) { Reset(size); }
+
+    // Frees everything, size becomes the whole range
+    void Reset(u32 size);
+    // Invalid allocation when no free range is big enough
+    Allocation Allocate(u32 size);
+    void Free(Allocation allocation);
+    // Adds [Size(), size) at the end, merged with the last range when it is free
+    void Grow(u32 size);
+
+    [[nodiscard]] u32 AllocationSize(Allocation allocation) const;
+    [[nodiscard]] Stats Statistics() const;
+    [[nodiscard]] INLINE u32 Size() const { return size_; }
+    [[nodiscard]] INLINE u32 FreeSize() const { return freeStorage_; }
+
+private:
+    static constexpr u32 topBins = 32;
+    static constexpr u32 leafBins = 8;
+    static constexpr u32 unused = UINT_MAX;
+
+    struct Node {
+        u32 offset          { 0 };
+        u32 size            { 0 };
+        u32 binPrev         { unused }; // Free ranges of the same bin
+        u32 binNext         { unused };
+        u32 neighborPrev    { unused }; // Ranges before and after, free or not
+        u32 neighborNext    { unused };
+        bool used           { false };
+    };
+
+    u32 InsertNode(u32 size, u32 offset);
+    void RemoveNode(u32 node);
+    u32 NewNode();
+
+    std::vector<Node> nodes_;
+    std::vector<u32> freeNodes_;
+    u32 binHeads_[topBins * leafBins];
+    u32 usedTopBins_ { 0 };
+    u8 usedLeafBins_[topBins] {};
+    u32 size_ { 0 };
+    u32 freeStorage_ { 0 };
+    u32 freeRegions_ { 0 };
+    u32 allocations_ { 0 };
+    u32 last_ { unused }; // Range at the end
+};
+
+}
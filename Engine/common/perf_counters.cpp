@@ -0,0 +1,178 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file perf_counters.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Hardware performance counters per engine system
+ *
+ * Longer description
+ */
+
+#include "perf_counters.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace reveal3d::perf {
+
+std::atomic<bool> enabled { false };
+
+namespace {
+
+std::mutex systemsMutex;
+std::vector<System> systems;
+std::atomic<u32> supported { 0 };
+
+#ifdef __linux__
+
+struct EventConfig {
+    u32 type;
+    u64 config;
+};
+
+constexpr u64 CacheMiss(u64 cache) {
+    return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+const EventConfig events[Counters::count] = {
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+    { PERF_TYPE_HW_CACHE, CacheMiss(PERF_COUNT_HW_CACHE_L1D) },
+    { PERF_TYPE_HW_CACHE, CacheMiss(PERF_COUNT_HW_CACHE_LL) },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+};
+
+/**
+ * Counters of one thread in a single group, so all of them cover the same time. Events the
+ * hardware doesn't have are left out of the group, order maps group slots to counters
+ */
+struct Group {
+    ~Group() {
+        for (u32 i = 0; i < size; ++i) {
+            close(fds[i]);
+        }
+    }
+
+    bool Open() {
+        opened = true;
+        for (u32 i = 0; i < Counters::count; ++i) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = events[i].type;
+            attr.config = events[i].config;
+            attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            attr.disabled = size == 0;
+            attr.exclude_kernel = 1; // Allowed without privileges on the default paranoid level
+            attr.exclude_hv = 1;
+
+            const i32 fd = (i32) syscall(SYS_perf_event_open, &attr, 0, -1, size == 0 ? -1 : fds[0], 0);
+            if (fd < 0) {
+                if (i == Counters::cycles) return false;
+                continue;
+            }
+            fds[size] = fd;
+            order[size++] = (Counters::counter) i;
+            mask |= 1u << i;
+        }
+        ioctl(fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        return true;
+    }
+
+    Counters Read() const {
+        Counters counters;
+        u64 data[3 + Counters::count];
+        if (size == 0 or read(fds[0], data, sizeof(u64) * (3 + size)) <= 0) return counters;
+
+        // Scaled up by the share of time the group was on the PMU
+        const u64 timeEnabled = data[1];
+        const u64 timeRunning = data[2];
+        const f64 scale = timeRunning > 0 and timeRunning < timeEnabled ? (f64) timeEnabled / (f64) timeRunning : 1.0;
+        for (u32 i = 0; i < data[0] and i < size; ++i) {
+            counters.value[order[i]] = scale == 1.0 ? data[3 + i] : (u64)((f64) data[3 + i] * scale);
+        }
+        return counters;
+    }
+
+    i32 fds[Counters::count] {};
+    Counters::counter order[Counters::count] {};
+    u32 size { 0 };
+    u32 mask { 0 };
+    bool opened { false };
+};
+
+thread_local Group group;
+
+Group& LocalGroup() {
+    if (!group.opened) {
+        group.Open();
+    }
+    return group;
+}
+
+#endif
+
+}
+
+bool Init() {
+#ifdef __linux__
+    const u32 mask = LocalGroup().mask;
+    supported.store(mask, std::memory_order_relaxed);
+    enabled.store(mask != 0, std::memory_order_relaxed);
+    return mask != 0;
+#else
+    return false;
+#endif
+}
+
+u32 Supported() {
+    return supported.load(std::memory_order_relaxed);
+}
+
+Counters Read() {
+#ifdef __linux__
+    return LocalGroup().Read();
+#else
+    return {};
+#endif
+}
+
+std::vector<System> Report() {
+    std::lock_guard lock(systemsMutex);
+    return systems;
+}
+
+void Reset() {
+    std::lock_guard lock(systemsMutex);
+    systems.clear();
+}
+
+Scope::~Scope() {
+    if (!active_) return;
+    const Counters end = Read();
+
+    std::lock_guard lock(systemsMutex);
+    auto system = std::find_if(systems.begin(), systems.end(), [&](const System &s) { return std::strcmp(s.name, name_) == 0; });
+    if (system == systems.end()) {
+        system = systems.insert(systems.end(), { name_, 0, {} });
+    }
+    ++system->calls;
+    for (u32 i = 0; i < Counters::count; ++i) {
+        // Scaling can make a later read slightly smaller
+        system->counters.value[i] += end.value[i] > begin_.value[i] ? end.value[i] - begin_.value[i] : 0;
+    }
+}
+
+}
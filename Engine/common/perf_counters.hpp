@@ -0,0 +1,81 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file perf_counters.hpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Hardware performance counters per engine system
+ *
+ * PERF_SCOPE("name") adds the cycles, instructions, cache and branch misses of the rest of
+ * the block to the named system. Counters come from perf_event_open on Linux, one group per
+ * thread counting only that thread, and are scaled when the kernel multiplexes them.
+ * Reading them is a system call, so scopes go around whole systems, not the inner loops
+ * PROFILE_SCOPE can time.
+ *
+ * Nothing is counted until Init succeeds. Other platforms, kernels that don't allow
+ * counters and shipping builds get empty reports.
+ */
+
+#pragma once
+
+#include "primitive_types.hpp"
+#include "platform.hpp"
+
+#include <atomic>
+#include <vector>
+
+namespace reveal3d::perf {
+
+struct Counters {
+    enum counter : u8 { cycles, instructions, l1dMisses, llcMisses, branchMisses, count };
+    static constexpr const char *names[count] = { "cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses" };
+
+    u64 value[count] {};
+};
+
+struct System {
+    const char *name;
+    u64 calls;
+    Counters counters;
+};
+
+extern std::atomic<bool> enabled;
+
+// Opens the counters of the calling thread and starts counting, false if the kernel refuses
+bool Init();
+// Mask of the counters the hardware has, bit i for Counters::counter i
+u32 Supported();
+INLINE bool Enabled() { return enabled.load(std::memory_order_relaxed); }
+INLINE void SetEnabled(bool enable) { enabled.store(enable and Supported() != 0, std::memory_order_relaxed); }
+
+// Totals of the calling thread since its counters were opened
+Counters Read();
+// Every system with a scope that ran since the last reset, in order of first use
+std::vector<System> Report();
+void Reset();
+
+class Scope {
+public:
+    explicit Scope(const char *name) : name_(name), active_(Enabled()) { if (active_) begin_ = Read(); }
+    ~Scope();
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    const char *name_;
+    Counters begin_;
+    bool active_;
+};
+
+}
+
+#define PERF_CONCAT_IMPL(a, b) a##b
+#define PERF_CONCAT(a, b) PERF_CONCAT_IMPL(a, b)
+
+#ifdef SHIPPING
+#define PERF_SCOPE(name)
+#else
+#define PERF_SCOPE(name) ::reveal3d::perf::Scope PERF_CONCAT(perfScope, __LINE__)(name)
+#endif
@@ -41,3 +41,8 @@ using WHandle = GLFWwindow*;
 
 #endif
 
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#define REVEAL3D_SSE
+#include <xmmintrin.h>
+#endif
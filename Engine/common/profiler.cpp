@@ -0,0 +1,182 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file profiler.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Scoped CPU profiler
+ *
+ * Longer description
+ */
+
+#include "profiler.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace reveal3d::profiler {
+
+std::atomic<bool> enabled { false };
+
+namespace {
+
+struct Slot {
+    std::atomic<const char *> name;
+    std::atomic<u64> begin;
+    std::atomic<u64> end;
+};
+
+/**
+ * Single writer seqlock ring. started is bumped before a slot is written and written
+ * after it, so a reader that copied a slot and then sees started <= index + capacity knows
+ * no newer zone has touched that slot
+ */
+struct ThreadBuffer {
+    std::unique_ptr<Slot[]> slots { new Slot[zoneCapacity] };
+    std::atomic<u64> started { 0 };
+    std::atomic<u64> written { 0 };
+    std::string name;
+    u32 id;
+};
+
+std::mutex registryMutex;
+std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+thread_local ThreadBuffer *localBuffer = nullptr;
+thread_local std::string localName; // Until the thread records its first zone
+
+const u64 startTicks = Now();
+const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+ThreadBuffer *Register() {
+    std::lock_guard lock(registryMutex);
+    ThreadBuffer *buffer = buffers.emplace_back(std::make_unique<ThreadBuffer>()).get();
+    buffer->id = buffers.size() - 1;
+    buffer->name = localName.empty() ? "Thread " + std::to_string(buffer->id) : localName;
+    localBuffer = buffer;
+    return buffer;
+}
+
+// Counter ticks per microsecond, measured against the steady clock since start up
+f64 TicksPerMicrosecond() {
+    using namespace std::chrono;
+    constexpr microseconds minWindow { 10000 };
+    const microseconds elapsed = duration_cast<microseconds>(steady_clock::now() - startTime);
+    if (elapsed < minWindow) {
+        std::this_thread::sleep_for(minWindow - elapsed);
+    }
+    const u64 ticks = Now();
+    const f64 time = (f64) duration_cast<nanoseconds>(steady_clock::now() - startTime).count() / 1000.0;
+    return (f64)(ticks - startTicks) / time;
+}
+
+void WriteEscaped(std::ostream &stream, const std::string &text) {
+    for (char c : text) {
+        if (c == '"' or c == '\\') stream << '\\';
+        stream << c;
+    }
+}
+
+}
+
+void SetEnabled(bool enable) {
+    enabled.store(enable, std::memory_order_relaxed);
+}
+
+void Record(const char *name, u64 begin, u64 end) {
+    ThreadBuffer *buffer = localBuffer ? localBuffer : Register();
+    const u64 index = buffer->written.load(std::memory_order_relaxed);
+    buffer->started.store(index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    Slot &slot = buffer->slots[index & (zoneCapacity - 1)];
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.begin.store(begin, std::memory_order_relaxed);
+    slot.end.store(end, std::memory_order_relaxed);
+    buffer->written.store(index + 1, std::memory_order_release);
+}
+
+void SetThreadName(const std::string &name) {
+    localName = name;
+    if (localBuffer != nullptr) {
+        std::lock_guard lock(registryMutex);
+        localBuffer->name = name;
+    }
+}
+
+std::vector<Zone> Collect() {
+    const f64 ticksPerUs = TicksPerMicrosecond();
+    std::vector<Zone> zones;
+
+    std::lock_guard lock(registryMutex);
+    for (const auto &buffer : buffers) {
+        const u64 written = buffer->written.load(std::memory_order_acquire);
+        const u64 first = written > zoneCapacity ? written - zoneCapacity : 0;
+        const size_t base = zones.size();
+        for (u64 i = first; i < written; ++i) {
+            const Slot &slot = buffer->slots[i & (zoneCapacity - 1)];
+            zones.push_back({ slot.name.load(std::memory_order_relaxed), buffer->id,
+                              (f64)(slot.begin.load(std::memory_order_relaxed) - startTicks) / ticksPerUs,
+                              (f64)(slot.end.load(std::memory_order_relaxed) - startTicks) / ticksPerUs });
+        }
+
+        // Zones the writer lapped while they were copied
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const u64 started = buffer->started.load(std::memory_order_relaxed);
+        const u64 valid = started > zoneCapacity ? started - zoneCapacity : 0;
+        if (valid > first) {
+            zones.erase(zones.begin() + base, zones.begin() + base + std::min(valid - first, written - first));
+        }
+    }
+
+    std::sort(zones.begin(), zones.end(), [](const Zone &a, const Zone &b) {
+        return a.begin < b.begin or (a.begin == b.begin and a.end > b.end);
+    });
+    return zones;
+}
+
+/**
+ * Complete events ("ph": "X") with begin and duration, plus one metadata event per
+ * thread for its name
+ */
+bool ExportChromeTrace(const std::string &path) {
+    const std::vector<Zone> zones = Collect();
+    std::ofstream file(path);
+    if (!file) return false;
+
+    file << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    const char *separator = "\n";
+    {
+        std::lock_guard lock(registryMutex);
+        for (const auto &buffer : buffers) {
+            file << separator << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->id << ",\"args\":{\"name\":\"";
+            WriteEscaped(file, buffer->name);
+            file << "\"}}";
+            separator = ",\n";
+        }
+    }
+    file.precision(3);
+    file << std::fixed;
+    for (const Zone &zone : zones) {
+        file << separator << "{\"name\":\"";
+        WriteEscaped(file, zone.name);
+        file << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << zone.thread << ",\"ts\":" << zone.begin << ",\"dur\":" << zone.end - zone.begin << "}";
+        separator = ",\n";
+    }
+    file << "\n]}\n";
+    return file.good();
+}
+
+void Clear() {
+    std::lock_guard lock(registryMutex);
+    for (const auto &buffer : buffers) {
+        buffer->started.store(0, std::memory_order_relaxed);
+        buffer->written.store(0, std::memory_order_relaxed);
+    }
+}
+
+}
@@ -0,0 +1,96 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file profiler.hpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Scoped CPU profiler
+ *
+ * PROFILE_SCOPE("name") times the rest of the enclosing block. Each thread writes its zones
+ * to its own ring of the last zoneCapacity ones, with no locks and no allocations after
+ * its first zone, and nested zones show up nested in the trace. Timestamps are raw cycle
+ * counters on x86, converted to microseconds only when the zones are collected.
+ * Names must be string literals or live as long as the profiler.
+ *
+ * Recording starts disabled. Shipping builds (SHIPPING defined) compile every scope out.
+ */
+
+#pragma once
+
+#include "primitive_types.hpp"
+#include "platform.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) or defined(_M_X64)
+#ifdef _WIN32
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+namespace reveal3d::profiler {
+
+constexpr u32 zoneCapacity = 1 << 15;
+
+struct Zone {
+    const char *name;
+    u32 thread;
+    f64 begin;  // Microseconds since the profiler started
+    f64 end;
+};
+
+INLINE u64 Now() {
+#if defined(__x86_64__) or defined(_M_X64)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+extern std::atomic<bool> enabled;
+
+INLINE bool Enabled() { return enabled.load(std::memory_order_relaxed); }
+void SetEnabled(bool enable);
+void Record(const char *name, u64 begin, u64 end);
+// Shown as the thread name in traces, threads are numbered by their first zone otherwise
+void SetThreadName(const std::string &name);
+
+// Zones of every thread sorted by begin. Safe while other threads record, zones being
+// overwritten at that moment are skipped
+std::vector<Zone> Collect();
+// Chrome trace_event JSON, opens in chrome://tracing and Perfetto
+bool ExportChromeTrace(const std::string &path);
+// Drops every recorded zone, only when no thread is recording
+void Clear();
+
+class Scope {
+public:
+    explicit Scope(const char *name) : name_(name), begin_(Enabled() ? Now() : 0) { }
+    ~Scope() { if (begin_ != 0) Record(name_, begin_, Now()); }
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    const char *name_;
+    u64 begin_;
+};
+
+}
+
+#define PROFILE_CONCAT_IMPL(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+
+#ifdef SHIPPING
+#define PROFILE_SCOPE(name)
+#define PROFILE_THREAD(name)
+#else
+#define PROFILE_SCOPE(name) ::reveal3d::profiler::Scope PROFILE_CONCAT(profileScope, __LINE__)(name)
+#define PROFILE_THREAD(name) ::reveal3d::profiler::SetThreadName(name)
+#endif
@@ -13,6 +13,8 @@
 
 #include "timer.hpp"
 
+#include <algorithm>
+
 namespace reveal3d {
 
 Timer::Timer() :
@@ -34,6 +36,10 @@ void Timer::Reset() {
     prevTime_ = currTime;
     stopTime_ = 0;
     stopped_ = false;
+
+    historyCount_.store(0, std::memory_order_release);
+    meanFrame_ = 0.0f;
+    hitchCount_ = 0;
 }
 
 void Timer::Start() {
@@ -83,6 +89,8 @@ void Timer::Tick() {
     if (stopped_) {
         deltaTime_ = 0.0;
     }
+
+    RecordFrame(static_cast<f32>(frameTime_ * 1000.0));
 }
 f32 Timer::TotalTime() const {
     if (stopped_) {
@@ -98,6 +106,71 @@ f32 Timer::Diff(f32 time) const {
     return TotalTime() - time;
 }
 
+/**
+ * Slot is written before the count is published, readers take the count first and then
+ * copy. A reader slower than historySize frames can see newer times in the oldest slots,
+ * never torn ones
+ */
+void Timer::RecordFrame(f32 time) {
+    const u64 count = historyCount_.load(std::memory_order_relaxed);
+    history_[count % historySize].store(time, std::memory_order_relaxed);
+    historyCount_.store(count + 1, std::memory_order_release);
+
+    const bool overTime = hitchTime_ > 0.0f and time > hitchTime_;
+    const bool overMean = hitchOverMean_ > 0.0f and meanFrame_ > 0.0f and time > hitchOverMean_ * meanFrame_;
+    if (count > 0 and (overTime or overMean)) {
+        Hitch &hitch = hitches_[hitchCount_ % hitchCapacity];
+        hitch.frame = totalFrames_ - 1;
+        hitch.time = time;
+        hitch.stages = stages_;
+        ++hitchCount_;
+    }
+    // First frame after a reset measures the reset itself, it doesn't start the mean
+    if (count > 0) {
+        meanFrame_ = meanFrame_ == 0.0f ? time : meanFrame_ + (time - meanFrame_) * 0.05f;
+    }
+    stages_ = StageTimes();
+}
+
+u32 Timer::FrameHistory(std::span<f32> times) const {
+    const u64 count = historyCount_.load(std::memory_order_acquire);
+    const u32 size = (u32)std::min<u64>({ count, historySize, times.size() });
+    for (u32 i = 0; i < size; ++i) {
+        times[i] = history_[(count - size + i) % historySize].load(std::memory_order_relaxed);
+    }
+    return size;
+}
+
+f32 Timer::FramePercentile(f64 percent) const {
+    std::array<f32, historySize> times;
+    const u32 size = FrameHistory(times);
+    std::vector<f64> sorted(times.begin(), times.begin() + size);
+    std::sort(sorted.begin(), sorted.end());
+    return static_cast<f32>(Percentile(sorted, percent));
+}
+
+void Timer::FrameHistogram(f32 binWidth, std::span<u32> bins) const {
+    std::fill(bins.begin(), bins.end(), 0);
+    if (bins.empty() or binWidth <= 0.0f) return;
+
+    std::array<f32, historySize> times;
+    const u32 size = FrameHistory(times);
+    for (u32 i = 0; i < size; ++i) {
+        const u64 bin = static_cast<u64>(times[i] / binWidth);
+        ++bins[std::min<u64>(bin, bins.size() - 1)];
+    }
+}
+
+std::vector<Hitch> Timer::Hitches() const {
+    const u64 size = std::min<u64>(hitchCount_, hitchCapacity);
+    std::vector<Hitch> hitches;
+    hitches.reserve(size);
+    for (u64 i = hitchCount_ - size; i < hitchCount_; ++i) {
+        hitches.push_back(hitches_[i % hitchCapacity]);
+    }
+    return hitches;
+}
+
 void Timer::Pause(input::action act, input::type type) {
     if(stopped_) {
         Start();
@@ -11,20 +11,39 @@
  * This file declares the timer class used in the library
  * to deal with time, deltatime, etc...
  *
+ * Every tick also stores the frame time in a ring of the last frames, written only by the
+ * ticking thread and readable from any other one, so percentiles and histograms are
+ * available in release builds. Frames over the hitch threshold keep the stage times the
+ * main loop recorded for them.
  */
 
 #pragma once
 
 #include "primitive_types.hpp"
 #include "platform.hpp"
+#include "frame_stats.hpp"
 #include "input/input.hpp"
+
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <span>
 
 
 namespace reveal3d {
 
+// Frame over the hitch threshold with the stage times recorded for it
+struct Hitch {
+    u64 frame { 0 };
+    f32 time { 0.0f }; // Milliseconds
+    StageTimes stages;
+};
+
 class Timer {
 public:
+    static constexpr u32 historySize = 512;
+    static constexpr u32 hitchCapacity = 32;
+
     Timer();
 
     [[nodiscard]] f32 TotalTime() const;
@@ -43,7 +62,24 @@ public:
     void Tick();
     void Pause(input::action act, input::type type);
 
+    /********* Frame history ************/
+    // Milliseconds of the last frames, oldest first. Returns how many were written
+    u32 FrameHistory(std::span<f32> times) const;
+    [[nodiscard]] f32 FramePercentile(f64 percent) const;
+    // Bins of binWidth milliseconds, the last one also counts every longer frame
+    void FrameHistogram(f32 binWidth, std::span<u32> bins) const;
+
+    /********* Hitch detection ************/
+    // Hitch when a frame takes more than milliseconds or overMean times the running mean, 0 disables each test
+    INLINE void SetHitchThreshold(f32 milliseconds, f32 overMean = 0.0f) { hitchTime_ = milliseconds; hitchOverMean_ = overMean; }
+    // Stage times of the frame that is ending, kept if the next tick finds it is a hitch
+    INLINE void RecordStages(const StageTimes &stages) { stages_ = stages; }
+    [[nodiscard]] INLINE u64 HitchCount() const { return hitchCount_; }
+    // Last hitchCapacity hitches, oldest first. Only from the ticking thread
+    std::vector<Hitch> Hitches() const;
+
 private:
+    void RecordFrame(f32 time);
 
 #ifdef _WIN32
     static INLINE void QueryFrequency(i64 &time) { QueryPerformanceFrequency((LARGE_INTEGER *) &time); }
@@ -53,7 +89,7 @@ private:
     static INLINE void QueryCounter(i64 &time) {
         auto now = std::chrono::high_resolution_clock::now();
         auto now_ns = std::chrono::time_point_cast<std::chrono::nanoseconds>(now);
-        ime = now_ns.time_since_epoch().count();
+        time = now_ns.time_since_epoch().count();
     }
 
 #endif
@@ -76,6 +112,16 @@ private:
     u64 totalFrames_;
     bool stopped_;
 
+    std::array<std::atomic<f32>, historySize> history_ {};
+    std::atomic<u64> historyCount_ { 0 };
+    f32 meanFrame_ { 0.0f };
+
+    std::array<Hitch, hitchCapacity> hitches_ {};
+    u64 hitchCount_ { 0 };
+    f32 hitchTime_ { 100.0f };
+    f32 hitchOverMean_ { 0.0f };
+    StageTimes stages_;
+
 };
 
 
@@ -13,9 +13,12 @@
 */
 
 #include "obj_parser.hpp"
+#include "common/profiler.hpp"
+#include "common/memory_report.hpp"
 
 #include <codecvt>
 #include <fstream>
+#include <iostream>
 #include <locale>
 #include <string>
 #include <unordered_map>
@@ -23,6 +26,9 @@
 
 namespace reveal3d::content {
 
+// Parsing data, only alive while a file loads. Its peak is the memory a load needs
+template<typename T> using LoadVector = memory::Vector<T, memory::content>;
+
 struct FaceElem {
     struct Hash {
         size_t operator()(const FaceElem& p) const
@@ -40,7 +46,7 @@ struct FaceElem {
     u32 normalIndex;
 };
 
-static void GetPoly(std::string &line, std::vector<FaceElem> &primitives) {
+static void GetPoly(std::string &line, LoadVector<FaceElem> &primitives) {
     u32 elem[4][3];
     sscanf(line.c_str(), "f %u/%u/%u %u/%u/%u %u/%u/%u %u/%u/%u",
            &elem[0][0], &elem[0][1], &elem[0][2],
@@ -52,7 +58,7 @@ static void GetPoly(std::string &line, std::vector<FaceElem> &primitives) {
     }
 }
 
-static void GetTriangle(std::string &line, std::vector<FaceElem> &primitives) {
+static void GetTriangle(std::string &line, LoadVector<FaceElem> &primitives) {
     u32 elem[3][3];
     sscanf(line.c_str(), "f %u/%u/%u %u/%u/%u %u/%u/%u",
            &elem[0][0], &elem[0][1], &elem[0][2],
@@ -65,6 +71,7 @@ static void GetTriangle(std::string &line, std::vector<FaceElem> &primitives) {
 
 
 u32 GetDataFromObj(const wchar_t *path, std::vector<render::Vertex> &vertices, std::vector<u32> &indices) {
+    PROFILE_SCOPE("GetDataFromObj");
 #ifndef WIN32
     std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
     std::string path_str = converter.to_bytes(path);
@@ -72,10 +79,10 @@ u32 GetDataFromObj(const wchar_t *path, std::vector<render::Vertex> &vertices, s
 #else
     std::ifstream file(path);
 #endif
-    std::vector<math::vec3> positions;
-    std::vector<math::vec3> normals;
-    std::vector<math::vec2> uvs;
-    std::vector<FaceElem> primitives;
+    LoadVector<math::vec3> positions;
+    LoadVector<math::vec3> normals;
+    LoadVector<math::vec2> uvs;
+    LoadVector<FaceElem> primitives;
     char c[2];
     std::string line;
 
@@ -109,7 +116,8 @@ u32 GetDataFromObj(const wchar_t *path, std::vector<render::Vertex> &vertices, s
 
     u32 index = 0;
     render::Vertex vert;
-    std::unordered_map<FaceElem, u32, FaceElem::Hash> cache;
+    std::unordered_map<FaceElem, u32, FaceElem::Hash, std::equal_to<>,
+                       memory::Allocator<std::pair<const FaceElem, u32>, memory::content>> cache;
     for(u64 i = 0; i < primitives.size(); ++i) {
         if (cache.find(primitives[i]) == cache.end()) {
             vert.pos = positions[primitives[i].posIndex - 1U];
@@ -11,6 +11,8 @@
  * Longer description
  */
 
+#pragma once
+
 #include "core/geometry.hpp"
 
 namespace reveal3d::content {
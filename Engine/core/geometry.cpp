@@ -12,6 +12,7 @@
  */
 
 #include "geometry.hpp"
+#include "scene.hpp"
 #include "content/primitives.hpp"
 #include "content/obj_parser.hpp"
 
@@ -30,12 +31,18 @@ namespace reveal3d::core {
 //
 //}
 
-Geometry::Geometry(const wchar_t *path) {
+namespace {
+
+Pool<id_t> dirtyIds;
+
+} //Anonymous namespace
+
+Geometry::Geometry(id_t id, const wchar_t *path) : id_(id) {
     mesh_ = std::make_shared<render::Mesh>();
     AddMesh(path);
 }
 
-Geometry::Geometry(Geometry::primitive type) {
+Geometry::Geometry(id_t id, Geometry::primitive type) : id_(id) {
     mesh_ = std::make_shared<render::Mesh>();
     AddMesh(type);
 }
@@ -43,6 +50,8 @@ Geometry::Geometry(Geometry::primitive type) {
 Geometry::Geometry(std::vector<render::Vertex> &&vertices, std::vector<u32> &&indices)
 {
     mesh_ = std::make_shared<render::Mesh>(vertices, indices);
+    mesh_->bounds = render::ComputeBounds(GetVerticesStart(), VertexCount());
+    mesh_->usage.Set(render::MemorySize(*mesh_));
 }
 void Geometry::AddMesh(const wchar_t *path) {
     render::SubMesh mesh;
@@ -54,7 +63,12 @@ void Geometry::AddMesh(const wchar_t *path) {
     content::GetDataFromObj(path, mesh_->vertices_, mesh_->indices_);
 
     mesh.indexCount = IndexCount() - mesh.indexCount;
+    mesh.bounds = render::ComputeBounds(GetVerticesStart() + mesh.vertexPos, VertexCount() - mesh.vertexPos);
+    mesh_->bounds = meshes_.empty() ? mesh.bounds : render::MergeBounds(mesh_->bounds, mesh.bounds);
+    mesh_->bvhs.emplace_back().Build(GetVerticesStart() + mesh.vertexPos, GetIndicesStart() + mesh.indexPos, mesh.indexCount);
     meshes_.push_back(mesh);
+    mesh_->usage.Set(render::MemorySize(*mesh_));
+    SetDirty();
 }
 
 void Geometry::AddMesh(Geometry::primitive type) {
@@ -74,9 +88,27 @@ void Geometry::AddMesh(Geometry::primitive type) {
     }
 
     mesh.indexCount = IndexCount() - mesh.indexCount;
+    mesh.bounds = render::ComputeBounds(GetVerticesStart() + mesh.vertexPos, VertexCount() - mesh.vertexPos);
+    mesh_->bounds = meshes_.empty() ? mesh.bounds : render::MergeBounds(mesh_->bounds, mesh.bounds);
+    mesh_->bvhs.emplace_back().Build(GetVerticesStart() + mesh.vertexPos, GetIndicesStart() + mesh.indexPos, mesh.indexCount);
     meshes_.push_back(mesh);
+    mesh_->usage.Set(render::MemorySize(*mesh_));
+    SetDirty();
+}
 
+void Geometry::SetOccluder(bool occluder) {
+    for (auto &mesh : meshes_) {
+        mesh.occluder = occluder;
+    }
+    SetDirty();
 }
+
+void Geometry::SetDirty() {
+    if (isDirty_ or !id::isValid(id_)) return;
+    isDirty_ = 1;
+    dirtyIds.push_back(id_);
+}
+
 //Geometry::Geometry(const Geometry &geo) {
 //    mesh_ = geo.mesh_;
 //    meshes_ = geo.meshes_;
@@ -84,6 +116,12 @@ void Geometry::AddMesh(Geometry::primitive type) {
 //
 //}
 
+Pool<id_t>& Scene::DirtyGeometries() {
+    return dirtyIds;
+}
 
+void Scene::ClearGeometries() {
+    dirtyIds.clear();
+}
 
-}
\ No newline at end of file
+}
@@ -34,8 +34,8 @@ public:
     };
 
     Geometry() = default;
-    Geometry(const wchar_t *path);
-    Geometry(primitive type);
+    Geometry(id_t id, const wchar_t *path);
+    Geometry(id_t id, primitive type);
     Geometry(std::vector<render::Vertex> && vertices, std::vector<u32> && indices);
 //    Geometry(const Geometry &geo);
     INLINE u32 VertexCount() { return mesh_->vertices_.size(); }
@@ -47,29 +47,35 @@ public:
     INLINE render::Vertex* GetVerticesStart() { return mesh_->vertices_.data(); }
     INLINE u32* GetIndicesStart() { return mesh_->indices_.data(); }
 
+    INLINE const render::Bounds& Bounds() { return mesh_->bounds; }
+    INLINE const spatial::TriangleBvh& Bvh(u32 subMesh) { return mesh_->bvhs[subMesh]; }
+
     INLINE u32 RenderInfo() { return mesh_->renderInfo; }
-    INLINE void SetRenderInfo(u32 index) { mesh_->renderInfo = index; }
+    INLINE void SetRenderInfo(u32 index) { mesh_->renderInfo = index; SetDirty(); }
 
     //TODO: DON'T HARDCODE THIS AND SHOW SUB MESHES IN SCENE GRAPH
-    INLINE void SetVisibility(bool visibility) { meshes_[0].visible = visibility; }
+    INLINE void SetVisibility(bool visibility) { meshes_[0].visible = visibility; SetDirty(); }
     INLINE bool IsVisible() { return meshes_[0].visible;  }
+    void SetOccluder(bool occluder);
+    INLINE bool IsOccluder() { return meshes_[0].occluder; }
     INLINE math::vec4& Color() { return color_;  }
 
     void AddMesh(const wchar_t *path);
     void AddMesh(primitive type);
 
     INLINE u8 IsDirty() { return isDirty_; }
-    INLINE void UpdateDirty() { --isDirty_;}
+    INLINE void UnDirty() { isDirty_ = 0; }
+    void SetDirty();
 
     INLINE bool OnGpu() { return OnGPU_;}
-    INLINE void MarkAsStored() { OnGPU_ = true;}
+    INLINE void MarkAsStored() { OnGPU_ = true; SetDirty(); }
 
 //    INLINE u8 IsDirty() { return isDirty_; }
 //    INLINE void UpdateDirty() { assert(isDirty_ > 0); --isDirty_; }
 
 private:
-    id_t id_;
-    u8 isDirty_ { 3 };
+    id_t id_ { id::invalid };
+    u8 isDirty_ { 0 };
     bool OnGPU_ { false };
     std::vector<render::SubMesh> meshes_;
     std::shared_ptr<render::Mesh> mesh_;
@@ -12,6 +12,10 @@
  */
 
 #include "scene.hpp"
+#include "common/profiler.hpp"
+
+#include <algorithm>
+#include <cmath>
 
 namespace reveal3d::core {
 
@@ -21,14 +25,14 @@ namespace {
 
 
 // Entity IDs
-std::vector<id_t> generations;
-std::deque<id_t> freeIndices;
+Pool<id_t> generations;
+memory::Deque<id_t, memory::ecs> freeIndices;
 
 //Components IDs
-std::vector<std::string> names;
-std::vector<Transform> transforms;
-std::vector<Geometry> geometries;
-std::vector<Script *> scripts;
+Pool<std::string> names;
+Pool<Transform> transforms;
+Pool<Geometry> geometries;
+Pool<Script *> scripts;
 
 }
 
@@ -50,7 +54,17 @@ Entity::Entity(const wchar_t *path) {
     GenerateId();
     names.emplace_back(name + std::to_string(id::index(id_)));
     transforms.emplace_back(id_);
-    geometries.emplace_back(path);
+    geometries.emplace_back(id_, path);
+    scripts.push_back(nullptr);
+}
+
+Entity::Entity(core::Geometry::primitive type) {
+    const std::string name = "New Entity ";
+
+    GenerateId();
+    names.emplace_back(name + std::to_string(id::index(id_)));
+    transforms.emplace_back(id_);
+    geometries.emplace_back(id_, type);
     scripts.push_back(nullptr);
 }
 
@@ -103,13 +117,13 @@ void Scene::AddEntity(Entity entity) {
         .entity = entity
     };
 
-    if (lastNode != nullptr) {
-       node.prev = lastNode->entity;
-       lastNode->next = node.entity;
+    if (lastNode != UINT_MAX) {
+       node.prev = sceneGraph_.at(lastNode).entity;
+       sceneGraph_.at(lastNode).next = node.entity;
     }
 
     sceneGraph_.push_back(node);
-    lastNode = &sceneGraph_.at(sceneGraph_.size() - 1);
+    lastNode = sceneGraph_.size() - 1;
 }
 
 Entity Scene::AddEntityFromObj(const wchar_t *path) {
@@ -118,6 +132,16 @@ Entity Scene::AddEntityFromObj(const wchar_t *path) {
     return entity;
 }
 
+Entity Scene::AddPrimitive(Geometry::primitive type, Entity parent) {
+    Entity entity(type);
+    if (parent.IsAlive()) {
+        AddChild(entity, parent);
+    } else {
+        AddEntity(entity);
+    }
+    return entity;
+}
+
 void Scene::AddChild(Entity child, Entity parent) {
 
     Node childNode {
@@ -158,6 +182,7 @@ void Scene::Init() {
 
 //Runs scripts
 void Scene::Update(f32 dt) {
+    PROFILE_SCOPE("Scene::Update");
     UpdateTransforms();
 //    UpdateGeometries();
 //    UpdateScripts();
@@ -170,16 +195,141 @@ void Scene::Update(f32 dt) {
 //    }
 }
 
+void Scene::Clear() {
+    ClearTransforms();
+    ClearGeometries();
+    generations.clear();
+    freeIndices.clear();
+    names.clear();
+    transforms.clear();
+    geometries.clear();
+    scripts.clear();
+    sceneGraph_.clear();
+    lastNode = UINT_MAX;
+    std::visit([](auto &entityIndex) { entityIndex.Clear(); }, index_);
+}
+
 Scene::~Scene() {
 //    for(auto *script : scripts_) {
 //        delete script;
 //    }
 }
-std::vector<Transform> &Scene::Transforms() {
+void Scene::UpdateIndex(id_t id) {
+    const id_t index = id::index(id);
+    if (index >= geometries.size() or geometries[index].SubMeshes().empty()) return;
+
+    const render::Bounds bounds = render::TransformBounds(geometries[index].Bounds(), transforms[index].World());
+    std::visit([&](auto &entityIndex) { entityIndex.Update(index, spatial::ToAabb(bounds)); }, index_);
+}
+
+RaycastHit Scene::Raycast(const math::vec3 &origin, const math::vec3 &direction, f32 maxDistance) {
+    RaycastHit closest;
+    closest.distance = maxDistance;
+
+    // Entity boxes are only a broad phase, their triangles give the exact hit
+    const spatial::Ray ray { origin, direction, maxDistance };
+    std::visit([&](const auto &index) {
+        index.Raycast(ray, [&](u32 entity, f32 boxDistance) {
+            if (boxDistance < closest.distance) {
+                RaycastEntity(entity, origin, direction, closest);
+            }
+            return closest.distance;
+        });
+    }, index_);
+
+    return closest;
+}
+
+std::vector<RaycastHit> Scene::RaycastAll(const math::vec3 &origin, const math::vec3 &direction, f32 maxDistance) {
+    std::vector<RaycastHit> hits;
+
+    const spatial::Ray ray { origin, direction, maxDistance };
+    std::visit([&](const auto &index) {
+        index.Raycast(ray, [&](u32 entity, f32) {
+            RaycastHit hit;
+            hit.distance = maxDistance;
+            if (RaycastEntity(entity, origin, direction, hit)) {
+                hits.push_back(hit);
+            }
+            return maxDistance;
+        });
+    }, index_);
+
+    std::sort(hits.begin(), hits.end(), [](const RaycastHit &a, const RaycastHit &b) { return a.distance < b.distance; });
+    return hits;
+}
+
+/**
+ * Ray is moved to entity local space, where the sub mesh BVHs live. Transform is
+ * affine so distances along the ray are the same in both spaces
+ */
+bool Scene::RaycastEntity(u32 index, const math::vec3 &origin, const math::vec3 &direction, RaycastHit &hit) {
+    core::Geometry &geometry = geometries[index];
+    const math::mat4 &world = transforms[index].World();
+    const math::xvec4 rows[3] = { world.GetX(), world.GetY(), world.GetZ() };
+    f32 m[3][4];
+    for (u32 i = 0; i < 3; ++i) {
+        m[i][0] = rows[i].GetX();
+        m[i][1] = rows[i].GetY();
+        m[i][2] = rows[i].GetZ();
+        m[i][3] = rows[i].GetW();
+    }
+
+    const f32 det = m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1]) -
+                    m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0]) +
+                    m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+    if (std::abs(det) < 1e-12f) return false;
+
+    const f32 invDet = 1.0f / det;
+    const f32 inv[3][3] = {
+        { (m[1][1] * m[2][2] - m[1][2] * m[2][1]) * invDet, (m[0][2] * m[2][1] - m[0][1] * m[2][2]) * invDet,
+          (m[0][1] * m[1][2] - m[0][2] * m[1][1]) * invDet },
+        { (m[1][2] * m[2][0] - m[1][0] * m[2][2]) * invDet, (m[0][0] * m[2][2] - m[0][2] * m[2][0]) * invDet,
+          (m[0][2] * m[1][0] - m[0][0] * m[1][2]) * invDet },
+        { (m[1][0] * m[2][1] - m[1][1] * m[2][0]) * invDet, (m[0][1] * m[2][0] - m[0][0] * m[2][1]) * invDet,
+          (m[0][0] * m[1][1] - m[0][1] * m[1][0]) * invDet }
+    };
+    const f32 o[3] = { origin.x - m[0][3], origin.y - m[1][3], origin.z - m[2][3] };
+    const f32 d[3] = { direction.x, direction.y, direction.z };
+    const math::vec3 localOrigin { inv[0][0] * o[0] + inv[0][1] * o[1] + inv[0][2] * o[2],
+                                   inv[1][0] * o[0] + inv[1][1] * o[1] + inv[1][2] * o[2],
+                                   inv[2][0] * o[0] + inv[2][1] * o[1] + inv[2][2] * o[2] };
+    const math::vec3 localDirection { inv[0][0] * d[0] + inv[0][1] * d[1] + inv[0][2] * d[2],
+                                      inv[1][0] * d[0] + inv[1][1] * d[1] + inv[1][2] * d[2],
+                                      inv[2][0] * d[0] + inv[2][1] * d[1] + inv[2][2] * d[2] };
+
+    bool found = false;
+    std::vector<render::SubMesh> &subMeshes = geometry.SubMeshes();
+    for (u32 i = 0; i < subMeshes.size(); ++i) {
+        if (!subMeshes[i].visible) continue;
+
+        spatial::TriangleHit triangleHit;
+        if (geometry.Bvh(i).Raycast(localOrigin, localDirection, hit.distance, triangleHit)) {
+            hit.entity = GetEntity(index).Id();
+            hit.subMesh = i;
+            hit.triangle = triangleHit.triangle;
+            hit.distance = triangleHit.distance;
+            hit.u = triangleHit.u;
+            hit.v = triangleHit.v;
+            found = true;
+        }
+    }
+    return found;
+}
+
+void Scene::SetIndex(EntityIndex &&index) {
+    index_ = std::move(index);
+    std::visit([](auto &entityIndex) { entityIndex.Clear(); }, index_);
+    for (u32 i = 0; i < transforms.size(); ++i) {
+        UpdateIndex(i);
+    }
+}
+
+Pool<Transform> &Scene::Transforms() {
     return transforms;
 }
 
-std::vector<Geometry> &Scene::Geometries() {
+Pool<Geometry> &Scene::Geometries() {
     return geometries;
 }
 
@@ -36,25 +36,33 @@
 #include "geometry.hpp"
 #include "script.hpp"
 #include "transform.hpp"
+#include "spatial/aabb_tree.hpp"
+#include "spatial/loose_octree.hpp"
+#include "spatial/uniform_grid.hpp"
+#include "common/memory_report.hpp"
 
 #include <deque>
-#include <set>
+#include <variant>
 #include <vector>
 
 
 namespace reveal3d::core {
 
+// Entity and component storage, counted in the ecs memory tag
+template<typename T> using Pool = memory::Vector<T, memory::ecs>;
+
 class Entity {
 public:
     Entity() : id_(id::invalid) {}
     explicit Entity(std::string& name);
     explicit Entity(const wchar_t *path);
+    explicit Entity(core::Geometry::primitive type);
     explicit Entity(id_t id);
 
     std::string& Name() const;
-    Transform& Transform();
-    Geometry& Geometry();
-    Script Script();
+    core::Transform& Transform();
+    core::Geometry& Geometry();
+    core::Script Script();
 
     void SetName(std::string_view name);
     void SetTransform();
@@ -70,6 +78,20 @@ private:
 };
 
 
+struct RaycastHit {
+    id_t entity     { id::invalid };
+    u32 subMesh     { 0 };
+    u32 triangle    { 0 };
+    f32 distance    { FLT_MAX };    // In direction lengths
+    f32 u           { 0.0f };       // Barycentrics of second and third triangle vertices
+    f32 v           { 0.0f };
+
+    [[nodiscard]] INLINE bool Hit() const { return entity != id::invalid; }
+};
+
+// Any spatial::Index, chosen per scene. Dense uniform crowds fit better in a grid
+using EntityIndex = std::variant<spatial::AabbTree, spatial::LooseOctree, spatial::UniformGrid>;
+
 class Scene {
 public:
     struct Node {
@@ -87,17 +109,32 @@ public:
     void AddChild(Entity child, Entity parent);
 
     Entity AddEntityFromObj(const wchar_t *path);
+    // Child of parent when it is alive, root entity otherwise
+    Entity AddPrimitive(Geometry::primitive type, Entity parent = {});
     bool RemoveEntity(id_t id);
+    // Removes every entity, only for tools that build many scenes in one run
+    void Clear();
 
     INLINE Entity GetEntity(id_t id) { return sceneGraph_.at(id::index(id)).entity; }
     INLINE u32 NumEntities() const { return sceneGraph_.size(); }
     INLINE Node& GetNode(id_t id) { return sceneGraph_.at(id::index(id)); }
     INLINE Node& Root() { return sceneGraph_.at(0); }
-    INLINE const std::vector<Scene::Node>& Graph() const { return sceneGraph_; }
-
-    std::vector<Transform>& Transforms();
-    std::set<id_t>& DirtyTransforms();
-    std::vector<Geometry>& Geometries();
+    INLINE const Pool<Scene::Node>& Graph() const { return sceneGraph_; }
+
+    Pool<Transform>& Transforms();
+    Pool<id_t>& DirtyTransforms();
+    // Entities whose world changed for the last Update, recalculated or set with SetWorld*
+    const Pool<id_t>& MovedTransforms() const;
+    Pool<Geometry>& Geometries();
+    Pool<id_t>& DirtyGeometries();
+    // World bounds of entities with geometry, keyed by entity index
+    INLINE const EntityIndex& Index() const { return index_; }
+    void SetIndex(EntityIndex &&index);
+
+    // Closest entity hit, direction doesn't need to be normalized
+    RaycastHit Raycast(const math::vec3 &origin, const math::vec3 &direction, f32 maxDistance = FLT_MAX);
+    // Closest hit of every entity crossed by the ray, sorted by distance
+    std::vector<RaycastHit> RaycastAll(const math::vec3 &origin, const math::vec3 &direction, f32 maxDistance = FLT_MAX);
 
     void Init();
     void Update(f32 dt);
@@ -106,9 +143,14 @@ public:
 private:
     void UpdateTransforms();
     void UpdateGeometries();
+    void ClearTransforms();
+    void ClearGeometries();
+    void UpdateIndex(id_t id);
+    bool RaycastEntity(u32 index, const math::vec3 &origin, const math::vec3 &direction, RaycastHit &hit);
     // Entity graph
-    Node* lastNode;
-    std::vector<Scene::Node> sceneGraph_;
+    u32 lastNode { UINT_MAX }; // Last root, an index because adding children reallocates the graph
+    Pool<Scene::Node> sceneGraph_;
+    EntityIndex index_;
 };
 
 extern Scene scene;
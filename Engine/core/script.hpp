@@ -23,7 +23,7 @@ class Script {
 public:
     //    Script(Entity &entity)  : entity_(entity) {}
     virtual void Begin(Entity &entity) {}
-    virtual void Update(Entity &entity, f32 dt) { log(logDEBUG) << "Updating"; }
+    virtual void Update(Entity &entity, f32 dt) { LOG(logDEBUG) << "Updating"; }
 };
 
 }
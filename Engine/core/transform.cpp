@@ -13,9 +13,10 @@
 
 #include "transform.hpp"
 #include "scene.hpp"
+#include "common/perf_counters.hpp"
+#include "common/profiler.hpp"
 
 #include <vector>
-#include <set>
 
 namespace reveal3d::core {
 
@@ -31,12 +32,22 @@ struct Transform {
 
 }
 
-std::vector<math::mat4> world;
-std::vector<math::mat4> invWorld;
-std::vector<internal::Transform> transforms;
-
-std::vector<u8> dirties;
-std::set<id_t> dirtyIds;
+Pool<math::mat4> world;
+Pool<math::mat4> invWorld;
+Pool<internal::Transform> transforms;
+
+Pool<u8> dirties;
+Pool<id_t> dirtyIds;
+Pool<u8> queued;     // Index already in dirtyIds, keeps it unique without a set allocating per insert
+Pool<id_t> movedIds; // World changed since the update before the last one, read after Scene::Update
+u32 movedPublished { 0 }; // Entries of movedIds a frame already read, dropped by the next update
+
+void Queue(id_t id) {
+    const id_t index { id::index(id) };
+    if (queued.at(index)) return;
+    queued.at(index) = 1;
+    dirtyIds.push_back(id);
+}
 
 } //Anonymous namesapce
 
@@ -48,14 +59,15 @@ Transform::Transform(id_t id) : id_(id) {
         world.at(index) = math::Mat4Identity();
         invWorld.at(index) = math::Mat4Identity();
         dirties.at(index) = 4;
-        dirtyIds.insert(id_);
+        Queue(id_);
     }
     else {
         transforms.emplace_back();
         world.emplace_back(math::Mat4Identity());
         invWorld.emplace_back(math::Mat4Identity());
         dirties.emplace_back(4);
-        dirtyIds.insert(id_);
+        queued.emplace_back(0);
+        Queue(id_);
     }
 
 }
@@ -68,14 +80,15 @@ Transform::Transform(id_t id, math::mat4 &parentWorld) {
         world.at(index) = parentWorld;
         invWorld.at(index) = math::Mat4Identity();
         dirties.at(index) = 4;
-        dirtyIds.insert(id_);
+        Queue(id_);
     }
     else {
         transforms.emplace_back();
         world.push_back(parentWorld);
         invWorld.at(index) = math::Mat4Identity();
         dirties.emplace_back(4);
-        dirtyIds.insert(id_);
+        queued.emplace_back(0);
+        Queue(id_);
     }
 
 }
@@ -158,7 +171,8 @@ void Transform::SetWorldPosition(const math::xvec3 pos) {
 
     invWorld.at(idx) = math::Inverse(world.at(idx));
     dirties.at(idx) = 3;
-    dirtyIds.insert(idx);
+    Queue(id_);
+    movedIds.push_back(id_);
     UpdateChilds();
 }
 
@@ -174,7 +188,8 @@ void Transform::SetWorldScale(const math::xvec3 size) {
     }
     invWorld.at(idx) = math::Inverse(world.at(idx));
     dirties.at(idx) = 3;
-    dirtyIds.insert(idx);
+    Queue(id_);
+    movedIds.push_back(id_);
     UpdateChilds();
 }
 
@@ -190,7 +205,8 @@ void Transform::SetWorldRotation(const math::xvec3 rot) {
     }
     invWorld.at(idx) = math::Inverse(world.at(idx));
     dirties.at(idx) = 3;
-    dirtyIds.insert(idx);
+    Queue(id_);
+    movedIds.push_back(id_);
     UpdateChilds();
 }
 
@@ -233,6 +249,7 @@ void Transform::UpdateWorld() {
     }
     InvWorld() = math::Transpose(math::Inverse(world.at(id::index(id_))));
     --dirties.at(id::index(id_));
+    movedIds.push_back(id_);
 }
 
 void Transform::UnDirty() const {
@@ -249,7 +266,7 @@ void Transform::SetDirty() const {
     if (dirties.at(idx) == 4)
         return;
     if (dirties.at(idx) == 0)
-        dirtyIds.insert(id_);
+        Queue(id_);
     UpdateChilds();
     dirties.at(idx) = 4;
 }
@@ -259,20 +276,52 @@ u8 Transform::Dirty() const {
 }
 
 void Scene::UpdateTransforms() {
-    for (auto it = dirtyIds.begin(); it != dirtyIds.end();) {
-        id_t idx = id::index(*it);
+    PROFILE_SCOPE("Scene::UpdateTransforms");
+    PERF_SCOPE("Scene::UpdateTransforms");
+    movedIds.erase(movedIds.begin(), movedIds.begin() + movedPublished);
+
+    // Worlds recalculated in earlier updates count down, nothing outside core reads the count
+    for (const id_t id : dirtyIds) {
+        if (dirties.at(id::index(id)) != 4) GetEntity(id::index(id)).Transform().UnDirty();
+    }
+
+    // Compacted in place, entities still dirty keep their order
+    u32 kept = 0;
+    for (const id_t id : dirtyIds) {
+        id_t idx = id::index(id);
         GetEntity(idx).Transform().UpdateWorld();
         if (dirties.at(idx) == 0) {
-            it = dirtyIds.erase(it);
+            queued.at(idx) = 0;
         } else {
-            ++it;
+            dirtyIds[kept++] = id;
         }
     }
+    dirtyIds.resize(kept);
+
+    for (const id_t id : movedIds) {
+        UpdateIndex(id);
+    }
+    movedPublished = movedIds.size();
+}
+
+void Scene::ClearTransforms() {
+    world.clear();
+    invWorld.clear();
+    transforms.clear();
+    dirties.clear();
+    dirtyIds.clear();
+    queued.clear();
+    movedIds.clear();
+    movedPublished = 0;
 }
 
-std::set<id_t>& Scene::DirtyTransforms() {
+Pool<id_t>& Scene::DirtyTransforms() {
     return dirtyIds;
 }
 
+const Pool<id_t>& Scene::MovedTransforms() const {
+    return movedIds;
+}
+
 
 }
\ No newline at end of file
@@ -21,11 +21,14 @@ cbuffer cbPass : register(b1)
     float deltaTime;
 };
 
-cbuffer cbPerObject : register(b0)
+struct Instance
 {
-	float4x4 objWorld;
+    float4x4 world;
+    float4 color;
 };
 
+StructuredBuffer<Instance> instances : register(t2);
+
 struct VertexIn
 {
 	float3 PosL  : POSITION;
@@ -38,11 +41,12 @@ struct VertexOut
     float4 Color : COLOR;
 };
 
-VertexOut VS(VertexIn vin)
+VertexOut VS(VertexIn vin, uint instanceId : SV_InstanceID)
 {
 	VertexOut vout;
+	Instance instance = instances[instanceId];
 
-	float4 posW = mul(float4(vin.PosL, 1.0f), objWorld);
+	float4 posW = mul(float4(vin.PosL, 1.0f), instance.world);
 	vout.PosH = mul(posW, viewProj);
     vout.Color = vin.Color;
     
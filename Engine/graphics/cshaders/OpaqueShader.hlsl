@@ -20,12 +20,14 @@ cbuffer cbPass : register(b1)
     float deltaTime;
 };
 
-cbuffer cbPerObject : register(b0)
+struct Instance
 {
-	float4x4 objWorld;
-	float4 flatColor;
+    float4x4 world;
+    float4 color;
 };
 
+StructuredBuffer<Instance> instances : register(t2);
+
 struct VertexIn
 {
 	float3 PosL    : POSITION;
@@ -42,15 +44,16 @@ struct VertexOut
 };
 
 
-VertexOut VS(VertexIn vin)
+VertexOut VS(VertexIn vin, uint instanceId : SV_InstanceID)
 {
 	VertexOut vout;
-	float4 posW = mul(float4(vin.PosL, 1.0f), objWorld);
+	Instance instance = instances[instanceId];
+	float4 posW = mul(float4(vin.PosL, 1.0f), instance.world);
 
     vout.PosW = posW.xyz;
 	vout.PosH = mul(posW, viewProj);
-    vout.NormalW = mul(vin.NormalL, (float3x3)objWorld);
-    vout.Color = flatColor;
+    vout.NormalW = mul(vin.NormalL, (float3x3)instance.world);
+    vout.Color = instance.color;
 
     return vout;
 }
@@ -25,6 +25,9 @@ public:
     [[nodiscard]] inline ID3D12CommandQueue * GetQueue() const { return commandQueue_.Get(); }
     [[nodiscard]] inline ID3D12GraphicsCommandList *List() const { return commandList_.Get(); }
     [[nodiscard]] static inline u8 const FrameIndex() { return frameIndex_; }
+    // Value signaled once the GPU finishes the current frame
+    [[nodiscard]] inline u64 FrameFence() const { return fenceValues_[frameIndex_]; }
+    [[nodiscard]] inline u64 CompletedFence() const { return fence_->GetCompletedValue(); }
     void Reset(ID3D12PipelineState* pso);
     void ResetFences();
     void Execute();
@@ -29,6 +29,10 @@ using Microsoft::WRL::ComPtr;
 namespace reveal3d::graphics::dx12 {
 
 constexpr u32 frameBufferCount = 3;
+constexpr u32 maxInstances = 65536; // Per frame instance buffer capacity
+constexpr u32 initialVertices = 1 << 20; // Geometry pool capacity, it grows when full
+constexpr u32 initialIndices = 1 << 22;
+constexpr u32 stagingSize = 16 << 20; // Geometry upload ring, in bytes
 
 }
 
@@ -19,6 +19,7 @@
 
 #include "dx_graphics_core.hpp"
 #include "config/config.hpp"
+#include "common/profiler.hpp"
 namespace reveal3d::graphics {
 
 using namespace render;
@@ -38,6 +39,7 @@ void Dx12::LoadPipeline() {
     heaps_.srv.Initialize(device_.Get(), 1U, true);
     heaps_.dsv.Initialize(device_.Get(), 1U, false);
     renderElements_.reserve(4092U);
+    geometry_.Init(device_.Get(), &cmdManager_, initialVertices, initialIndices);
     dsHandle_ = heaps_.dsv.alloc();
     CreateSwapChain();
     InitFrameResources();
@@ -113,7 +115,7 @@ void Dx12::InitFrameResources() {
 
 void Dx12::InitConstantBuffers() {
     for(auto& frameResource : frameResources_) {
-        frameResource.constantBuffer.Init(device_.Get(), 65536U); //TODO: hardcoded capacity 256 maximum?
+        frameResource.instanceBuffer.Init(device_.Get(), maxInstances);
         frameResource.passBuffer.Init(device_.Get(),  1U); //TODO: hardcoded capacity
 //        frameResource.passHandle = frameResource.passBuffer.CreateView(device_.Get(), heaps_.cbv);
     }
@@ -179,55 +181,31 @@ void Dx12::SetViewport() {
     scissorRect_ = { 0, 0, (i32) desc.BufferDesc.Width, (i32) desc.BufferDesc.Height };
 }
 
+// Geometry is staged, it is copied at the start of next frame
 void Dx12::LoadAssets() {
-    cmdManager_.Reset(nullptr);
-
-    std::vector<core::Transform> &transforms = core::scene.Transforms();
-    std::vector<core::Geometry> &geometries = core::scene.Geometries();
-
+    PROFILE_SCOPE("Dx12::LoadAssets");
     for(u32 i = 0; i < core::scene.NumEntities(); ++i) {
         CreateRenderElement(i);
-        AlignedConstant<ObjConstant, 1> objConstant;
-        for (u32 j = 0; j < frameBufferCount; ++j) {
-            objConstant.data.worldViewProj = transforms[i].World();
-            objConstant.data.flatColor = geometries[i].Color();
-            frameResources_[j].constantBuffer.CopyData(i, &objConstant, 1);
-        }
     }
-    cmdManager_.List()->Close();
-    cmdManager_.Execute();
-    cmdManager_.WaitForGPU();
-
 }
 
 void Dx12::LoadAsset(u32 id) {
-    cmdManager_.Reset(nullptr);
     CreateRenderElement(id);
-    cmdManager_.List()->Close();
-    cmdManager_.Execute();
-    cmdManager_.WaitForGPU();
 }
 
-void Dx12::Update(render::Camera &camera) {
+void Dx12::Update(render::Camera &camera, render::RenderWorld &world) {
     auto &currFrameRes = frameResources_[Commands::FrameIndex()];
     AlignedConstant<PassConstant, 2> passConstant;
 
     passConstant.data.viewProj = math::Transpose(camera.GetViewProjectionMatrix());
     currFrameRes.passBuffer.CopyData(0, &passConstant);
+    renderWorld_ = &world;
 
-    auto &geometries = core::scene.Geometries();
-    std::set<id_t>& dirties = core::scene.DirtyTransforms();
-
-    AlignedConstant<ObjConstant, 1> objConstant;
-    for (auto id : dirties) {
-        objConstant.data.flatColor = geometries.at(id::index(id)).Color();
-        core::Transform trans = core::scene.GetEntity(id).Transform();
-
-        objConstant.data.worldViewProj = trans.World();
-        trans.UnDirty();
-        currFrameRes.constantBuffer.CopyData(id::index(id), &objConstant);
-    }
+    // Batches past the buffer capacity are skipped when drawing
+    const std::vector<render::Instance> &instances = world.Instances();
+    currFrameRes.instanceBuffer.CopyData(0, instances.data(), std::min<u32>(instances.size(), maxInstances));
 
+    auto &geometries = core::scene.Geometries();
     for (u32 i = 0; i < core::scene.NumEntities(); ++i) {
         if (!geometries[i].OnGpu())
             LoadAsset(i);
@@ -235,6 +213,7 @@ void Dx12::Update(render::Camera &camera) {
 }
 
 void Dx12::PrepareRender() {
+    PROFILE_SCOPE("Dx12::PrepareRender");
 
     auto &currFrameRes = frameResources_[Commands::FrameIndex()];
     ID3D12GraphicsCommandList* commandList = cmdManager_.List();
@@ -242,6 +221,7 @@ void Dx12::PrepareRender() {
 
 //    cmdManager_.Reset(renderLayers_[render::Shader::opaque].pso.Get()); //Resets commands list and current frame allocator
     CleanDeferredResources(heaps_); // Clean deferreds resources
+    geometry_.Flush();
 
     commandList->RSSetViewports(1, &viewport_);
     commandList->RSSetScissorRects(1, &scissorRect_);
@@ -260,11 +240,11 @@ void Dx12::PrepareRender() {
     ID3D12DescriptorHeap* srvDesc = heaps_.srv.Get();
     commandList->SetDescriptorHeaps(1, &srvDesc);
 
-    renderLayers_.DrawLayer(commandList, currFrameRes, renderElements_, render::Shader::opaque);
+    renderLayers_.DrawLayer(commandList, currFrameRes, geometry_, renderElements_, *renderWorld_, render::Shader::opaque);
 
     for (u32 i = 1; i < render::Shader::count - 1; ++i) {
         renderLayers_[i].Set(commandList);
-        renderLayers_.DrawLayer(commandList, currFrameRes, renderElements_, i);
+        renderLayers_.DrawLayer(commandList, currFrameRes, geometry_, renderElements_, *renderWorld_, i);
     }
 
     renderLayers_[render::Shader::grid].Set(commandList);
@@ -339,13 +319,10 @@ void Dx12::Terminate() {
     cmdManager_.Flush();
     heaps_.Release();
 
-    for (auto &elem : renderElements_) {
-        elem.vertexBuffer.Release();
-        elem.indexBuffer.Release();
-    }
+    geometry_.Release();
 
     for (auto& frameResource : frameResources_) {
-        frameResource.constantBuffer.Release();
+        frameResource.instanceBuffer.Release();
         frameResource.passBuffer.Release();
     }
     CleanDeferredResources(heaps_);
@@ -355,34 +332,20 @@ void Dx12::CreateRenderElement(u32 index) {
     core::Geometry &geometry = core::scene.GetEntity(index).Geometry();
     geometry.MarkAsStored();
     if (geometry.RenderInfo() == UINT_MAX) {
-        BufferInitInfo vertexBufferInfo = {
-                .device = device_.Get(),
-                .cmdList = cmdManager_.List(),
-                .data = geometry.GetVerticesStart(),
-                .count = geometry.VertexCount()
-        };
-
-        BufferInitInfo indexBufferInfo = {
-                .device = device_.Get(),
-                .cmdList = cmdManager_.List(),
-                .data = geometry.GetIndicesStart(),
-                .count = geometry.IndexCount(),
-                .format = DXGI_FORMAT_R32_UINT
-        };
-
-        renderElements_.emplace_back(vertexBufferInfo, indexBufferInfo);
+        RenderElement element;
+        element.geometry = geometry_.Add(geometry.GetVerticesStart(), geometry.VertexCount(),
+                                         geometry.GetIndicesStart(), geometry.IndexCount());
+        renderElements_.push_back(element);
         geometry.SetRenderInfo(renderElements_.size() - 1U);
         for (auto &subMesh: geometry.SubMeshes()) {
             subMesh.renderInfo = renderElements_.size() - 1U;
             subMesh.constantIndex = index;
-            renderLayers_.AddMesh(subMesh);
         }
     }
     else {
         for (auto &subMesh: geometry.SubMeshes()) {
             subMesh.renderInfo = geometry.RenderInfo();
             subMesh.constantIndex = index;
-            renderLayers_.AddMesh(subMesh);
         }
     }
 
@@ -26,6 +26,7 @@
 
 #include "core/scene.hpp"
 #include "render/camera.hpp"
+#include "render/render_world.hpp"
 #include "window/window_info.hpp"
 
 
@@ -42,7 +43,7 @@ public:
     void LoadPipeline();
     void LoadAssets();
     void LoadAsset(u32 id);
-    void Update(render::Camera &camera);
+    void Update(render::Camera &camera, render::RenderWorld &world);
     void PrepareRender();
     void Draw();
     void Terminate();
@@ -78,7 +79,9 @@ private:
 
     /************ Render elements and layers**********/
     std::vector<RenderElement> renderElements_;
+    dx12::GeometryPool geometry_;
     dx12::RenderLayers renderLayers_;
+    const render::RenderWorld *renderWorld_ { nullptr };
 
     /***************** Surface Info **********************/
     window::Resolution *resolution_;
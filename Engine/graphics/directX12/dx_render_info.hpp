@@ -17,11 +17,10 @@
 
 namespace reveal3d::graphics {
 
+// Mesh range inside the geometry pool
 struct RenderElement {
-    RenderElement(dx12::BufferInitInfo &vertexInfo, dx12::BufferInitInfo &indexInfo);
     D3D_PRIMITIVE_TOPOLOGY topology { D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST };
-    dx12::VertexBuffer vertexBuffer;
-    dx12::IndexBuffer indexBuffer;
+    dx12::GeometryRange geometry;
 //    u32 constantIndex;
 };
 
@@ -55,10 +55,10 @@ void RenderLayers::BuildPSOs(ID3D12Device *device) {
 
     //TODO Config file for assets path
     hr = D3DCompileFromFile(relative(L"Engine/graphics/cshaders/OpaqueShader.hlsl").c_str(), nullptr, nullptr, "VS", "vs_5_0", compileFlags, 0, &vertexShader, &errors);
-    if (errors != nullptr) log(logDEBUG) << (char *) errors->GetBufferPointer();
+    if (errors != nullptr) LOG(logDEBUG) << (char *) errors->GetBufferPointer();
     hr >> utl::DxCheck;
     hr = D3DCompileFromFile(relative(L"Engine/graphics/cshaders/OpaqueShader.hlsl").c_str(), nullptr, nullptr, "PS", "ps_5_0", compileFlags, 0, &pixelShader, &errors);
-    if (errors != nullptr) log(logDEBUG) << (char *) errors->GetBufferPointer();
+    if (errors != nullptr) LOG(logDEBUG) << (char *) errors->GetBufferPointer();
     hr >> utl::DxCheck;
 
     D3D12_INPUT_ELEMENT_DESC inputElementDescs[] = {
@@ -84,10 +84,10 @@ void RenderLayers::BuildPSOs(ID3D12Device *device) {
 
     //TODO Config file for assets path
     hr = D3DCompileFromFile(relative(L"Engine/graphics/cshaders/FlatShader.hlsl").c_str(), nullptr, nullptr, "VS", "vs_5_0", compileFlags, 0, &vertexShader, &errors);
-    if (errors != nullptr) log(logDEBUG) << (char *) errors->GetBufferPointer();
+    if (errors != nullptr) LOG(logDEBUG) << (char *) errors->GetBufferPointer();
     hr >> utl::DxCheck;
     hr = D3DCompileFromFile(relative(L"Engine/graphics/cshaders/FlatShader.hlsl").c_str(), nullptr, nullptr, "PS", "ps_5_0", compileFlags, 0, &pixelShader, &errors);
-    if (errors != nullptr) log(logDEBUG) << (char *) errors->GetBufferPointer();
+    if (errors != nullptr) LOG(logDEBUG) << (char *) errors->GetBufferPointer();
     hr >> utl::DxCheck;
 
     D3D12_INPUT_ELEMENT_DESC flatElementsDesc[] = {
@@ -111,10 +111,10 @@ void RenderLayers::BuildPSOs(ID3D12Device *device) {
     layers_[render::Shader::flat].pso.Finalize(device);
 
     hr = D3DCompileFromFile(relative(L"Engine/graphics/cshaders/GridShader.hlsl").c_str(), nullptr, nullptr, "VS", "vs_5_0", compileFlags, 0, &vertexShader, &errors);
-    if (errors != nullptr) log(logDEBUG) << (char *) errors->GetBufferPointer();
+    if (errors != nullptr) LOG(logDEBUG) << (char *) errors->GetBufferPointer();
     hr >> utl::DxCheck;
     hr = D3DCompileFromFile(relative(L"Engine/graphics/cshaders/GridShader.hlsl").c_str(), nullptr, nullptr, "PS", "ps_5_0", compileFlags, 0, &pixelShader, &errors);
-    if (errors != nullptr) log(logDEBUG) << (char *) errors->GetBufferPointer();
+    if (errors != nullptr) LOG(logDEBUG) << (char *) errors->GetBufferPointer();
     hr >> utl::DxCheck;
 
     D3D12_RENDER_TARGET_BLEND_DESC transparencyBlendDesc;
@@ -153,18 +153,19 @@ void RenderLayers::BuildPSOs(ID3D12Device *device) {
     meshes_[render::Shader::grid].push_back(gridMesh);
 }
 
-void RenderLayers::AddMesh(render::SubMesh &mesh) {
-    meshes_[mesh.shader].push_back(&mesh);
-}
-
-void RenderLayers::DrawLayer(ID3D12GraphicsCommandList *cmdList, FrameResource &frame, std::vector<RenderElement>& elements, u32 layer) {
-    for (auto *mesh : meshes_[layer]) {
-        if (!mesh->visible) continue;
-        cmdList->SetGraphicsRootConstantBufferView(0, frame.constantBuffer.GpuPos(mesh->constantIndex));
-        cmdList->IASetVertexBuffers(0, 1, elements.at(mesh->renderInfo).vertexBuffer.View());
-        cmdList->IASetIndexBuffer(elements[mesh->renderInfo].indexBuffer.View());
-        cmdList->IASetPrimitiveTopology(elements[mesh->renderInfo].topology);
-        cmdList->DrawIndexedInstanced(mesh->indexCount, 1, mesh->indexPos, mesh->vertexPos, 0);
+void RenderLayers::DrawLayer(ID3D12GraphicsCommandList *cmdList, FrameResource &frame, GeometryPool &geometry,
+                             std::vector<RenderElement>& elements, const render::RenderWorld &world, u32 layer) {
+    // One draw per batch, every mesh is in the pool so views are bound once. Instance ids
+    // start at zero, the instance view starts at the first instance of the batch
+    cmdList->IASetVertexBuffers(0, 1, geometry.VertexView());
+    cmdList->IASetIndexBuffer(geometry.IndexView());
+    cmdList->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    for (const render::InstanceBatch &batch : world.Batches(layer)) {
+        if (batch.first + batch.count > maxInstances) break;
+        const GeometryRange &range = elements.at(batch.mesh).geometry;
+        cmdList->SetGraphicsRootShaderResourceView(2, frame.instanceBuffer.GpuPos(batch.first));
+        cmdList->DrawIndexedInstanced(batch.indexCount, batch.count, range.firstIndex + batch.indexPos,
+                                      (i32)(range.baseVertex + batch.vertexPos), 0);
     }
 }
 
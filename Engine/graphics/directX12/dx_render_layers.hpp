@@ -19,6 +19,7 @@
 
 #include "dx_render_info.hpp"
 #include "render/mesh.hpp"
+#include "render/render_world.hpp"
 #include "resources/dx_resources.hpp"
 
 namespace reveal3d::graphics::dx12 {
@@ -36,8 +37,8 @@ public:
     ~RenderLayers();
     void BuildRoots(ID3D12Device *device);
     void BuildPSOs(ID3D12Device *device);
-    void AddMesh(render::SubMesh &mesh);
-    void DrawLayer(ID3D12GraphicsCommandList* cmdList, FrameResource& frame, std::vector<RenderElement> &elements, u32 layer);
+    void DrawLayer(ID3D12GraphicsCommandList* cmdList, FrameResource& frame, GeometryPool &geometry,
+                   std::vector<RenderElement> &elements, const render::RenderWorld &world, u32 layer);
     void DrawEffectLayer(ID3D12GraphicsCommandList* cmdList, u32 layer);
 
     INLINE Layer& operator[] (u32 index) { return layers_.at(index); }
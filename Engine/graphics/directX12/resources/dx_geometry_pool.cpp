@@ -0,0 +1,190 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file dx_geometry_pool.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Shared vertex and index buffers
+ *
+ * Longer description
+ */
+
+#include "dx_geometry_pool.hpp"
+#include "dx_deferring_system.hpp"
+
+#include <algorithm>
+
+namespace reveal3d::graphics::dx12 {
+
+void GeometryUploader::Init(ID3D12Device *device, Commands *commands, GeometryPool *pool) {
+    device_ = device;
+    commands_ = commands;
+    pool_ = pool;
+}
+
+void GeometryUploader::Release() {
+    if (staging_ != nullptr) staging_->Unmap(0, nullptr);
+    DeferredRelease(staging_);
+    staging_ = nullptr;
+}
+
+u8* GeometryUploader::MapStaging(u32 size) {
+    Release();
+    auto heapProperties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
+    auto resDesc = CD3DX12_RESOURCE_DESC::Buffer(size);
+    device_->CreateCommittedResource(
+            &heapProperties,
+            D3D12_HEAP_FLAG_NONE,
+            &resDesc,
+            D3D12_RESOURCE_STATE_GENERIC_READ,
+            nullptr,
+            IID_PPV_ARGS(&staging_)) >> utl::DxCheck;
+    staging_->SetName(L"Geometry staging");
+
+    // Upload heaps stay mapped, the CPU only writes them
+    u8 *mapped;
+    const D3D12_RANGE readRange { 0, 0 };
+    staging_->Map(0, &readRange, reinterpret_cast<void**>(&mapped)) >> utl::DxCheck;
+    return mapped;
+}
+
+u64 GeometryUploader::CompletedFence() {
+    return commands_->CompletedFence();
+}
+
+// Pool buffers are already copy destinations, copies are retired with the fence of this frame
+u64 GeometryUploader::Submit(std::span<const render::StagingCopy> copies) {
+    ID3D12GraphicsCommandList *cmdList = commands_->List();
+    for (const render::StagingCopy &copy : copies) {
+        cmdList->CopyBufferRegion(pool_->Buffer(copy.target), copy.targetOffset, staging_, copy.stagingOffset, copy.size);
+    }
+    return commands_->FrameFence();
+}
+
+void GeometryPool::Init(ID3D12Device *device, Commands *commands, u32 vertexCapacity, u32 indexCapacity) {
+    device_ = device;
+    commands_ = commands;
+    vertexBuffer_ = CreateBuffer(device, sizeof(render::Vertex) * (u64)vertexCapacity, L"Vertex pool");
+    indexBuffer_ = CreateBuffer(device, sizeof(u32) * (u64)indexCapacity, L"Index pool");
+    vertices_.Reset(vertexCapacity);
+    indices_.Reset(indexCapacity);
+
+    vertexView_ = { vertexBuffer_->GetGPUVirtualAddress(), (u32)(sizeof(render::Vertex) * vertexCapacity), sizeof(render::Vertex) };
+    indexView_ = { indexBuffer_->GetGPUVirtualAddress(), (u32)(sizeof(u32) * indexCapacity), DXGI_FORMAT_R32_UINT };
+
+    uploader_.Init(device, commands, this);
+    uploads_.Init(&uploader_, stagingSize);
+}
+
+void GeometryPool::Release() {
+    uploader_.Release();
+    for (auto *&source : growSource_) {
+        DeferredRelease(source);
+        source = nullptr;
+    }
+    DeferredRelease(vertexBuffer_);
+    DeferredRelease(indexBuffer_);
+    vertexBuffer_ = nullptr;
+    indexBuffer_ = nullptr;
+    vertices_.Reset(0);
+    indices_.Reset(0);
+}
+
+GeometryRange GeometryPool::Add(const render::Vertex *vertices, u32 vertexCount, const u32 *indices, u32 indexCount) {
+    auto vertexRange = vertices_.Allocate(vertexCount);
+    auto indexRange = indices_.Allocate(indexCount);
+    if (!vertexRange.Valid() or !indexRange.Valid()) {
+        if (vertexRange.Valid()) vertices_.Free(vertexRange);
+        if (indexRange.Valid()) indices_.Free(indexRange);
+        Grow(std::max(vertices_.Size() * 2, vertices_.Size() + vertexCount),
+             std::max(indices_.Size() * 2, indices_.Size() + indexCount));
+        vertexRange = vertices_.Allocate(vertexCount);
+        indexRange = indices_.Allocate(indexCount);
+    }
+
+    uploads_.Queue(GeometryUploader::vertices, sizeof(render::Vertex) * (u64)vertexRange.offset, vertices,
+                   sizeof(render::Vertex) * vertexCount);
+    uploads_.Queue(GeometryUploader::indices, sizeof(u32) * (u64)indexRange.offset, indices, sizeof(u32) * indexCount);
+
+    return { vertexRange.offset, indexRange.offset, indexCount, vertexRange, indexRange };
+}
+
+void GeometryPool::Remove(GeometryRange &range) {
+    if (range.vertices.Valid()) vertices_.Free(range.vertices);
+    if (range.indices.Valid()) indices_.Free(range.indices);
+    range = GeometryRange {};
+}
+
+/**
+ * Buffers decay to common after every command list. Old contents are copied before the
+ * staged uploads, which already target the new buffers. Free ranges are copied too,
+ * allocations can be anywhere in the old buffers
+ */
+void GeometryPool::Flush() {
+    const bool grown = growSource_[0] != nullptr or growSource_[1] != nullptr;
+    if (!grown and uploads_.Empty()) return;
+
+    ID3D12GraphicsCommandList *cmdList = commands_->List();
+    D3D12_RESOURCE_BARRIER barriers[4];
+    u32 count = 0;
+    for (u32 i = 0; i < 2; ++i) {
+        barriers[count++] = CD3DX12_RESOURCE_BARRIER::Transition(Buffer(i), D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_COPY_DEST);
+        if (growSource_[i] != nullptr) {
+            barriers[count++] = CD3DX12_RESOURCE_BARRIER::Transition(growSource_[i], D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_COPY_SOURCE);
+        }
+    }
+    cmdList->ResourceBarrier(count, barriers);
+
+    for (u32 i = 0; i < 2; ++i) {
+        if (growSource_[i] == nullptr) continue;
+        cmdList->CopyBufferRegion(Buffer(i), 0, growSource_[i], 0, growSize_[i]);
+        DeferredRelease(growSource_[i]);
+        growSource_[i] = nullptr;
+    }
+    uploads_.Flush();
+
+    for (u32 i = 0; i < 2; ++i) {
+        barriers[i] = CD3DX12_RESOURCE_BARRIER::Transition(Buffer(i), D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_GENERIC_READ);
+    }
+    cmdList->ResourceBarrier(2, barriers);
+}
+
+// Growing twice between flushes drops the middle buffers, the GPU never used them
+void GeometryPool::Grow(u32 vertexCapacity, u32 indexCapacity) {
+    ID3D12Resource *oldBuffers[2] = { vertexBuffer_, indexBuffer_ };
+    const u64 oldSizes[2] = { sizeof(render::Vertex) * (u64)vertices_.Size(), sizeof(u32) * (u64)indices_.Size() };
+    for (u32 i = 0; i < 2; ++i) {
+        if (growSource_[i] == nullptr) {
+            growSource_[i] = oldBuffers[i];
+            growSize_[i] = oldSizes[i];
+        } else {
+            DeferredRelease(oldBuffers[i]);
+        }
+    }
+
+    vertexBuffer_ = CreateBuffer(device_, sizeof(render::Vertex) * (u64)vertexCapacity, L"Vertex pool");
+    indexBuffer_ = CreateBuffer(device_, sizeof(u32) * (u64)indexCapacity, L"Index pool");
+    vertices_.Grow(vertexCapacity);
+    indices_.Grow(indexCapacity);
+    vertexView_ = { vertexBuffer_->GetGPUVirtualAddress(), (u32)(sizeof(render::Vertex) * vertexCapacity), sizeof(render::Vertex) };
+    indexView_ = { indexBuffer_->GetGPUVirtualAddress(), (u32)(sizeof(u32) * indexCapacity), DXGI_FORMAT_R32_UINT };
+}
+
+ID3D12Resource* GeometryPool::CreateBuffer(ID3D12Device *device, u64 size, const wchar_t *name) {
+    ID3D12Resource *buffer;
+    auto heapProperties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
+    auto resDesc = CD3DX12_RESOURCE_DESC::Buffer(size);
+    device->CreateCommittedResource(
+            &heapProperties,
+            D3D12_HEAP_FLAG_NONE,
+            &resDesc,
+            D3D12_RESOURCE_STATE_COMMON,
+            nullptr,
+            IID_PPV_ARGS(&buffer)) >> utl::DxCheck;
+    buffer->SetName(name);
+    return buffer;
+}
+
+}
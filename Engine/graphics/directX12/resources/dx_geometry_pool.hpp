@@ -0,0 +1,98 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file dx_geometry_pool.hpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Shared vertex and index buffers
+ *
+ * Every mesh lives in one default heap vertex buffer and one index buffer, so views are
+ * set once per frame and draws only change offsets. Ranges are handed out by an offset
+ * allocator in vertices and indices. When a mesh doesn't fit both buffers are recreated
+ * bigger and the old contents copied on the GPU, offsets of every other mesh stay valid.
+ *
+ * Mesh data is written to a staging ring and copied in one batch per frame, recorded at
+ * the start of the frame command list and retired with the frame fence. Adding meshes
+ * never waits for the GPU.
+ */
+
+#pragma once
+
+#include "../dx_common.hpp"
+#include "../dx_commands.hpp"
+#include "common/offset_allocator.hpp"
+#include "render/staging_ring.hpp"
+#include "render/vertex.hpp"
+
+namespace reveal3d::graphics::dx12 {
+
+struct GeometryRange {
+    u32 baseVertex  { 0 };
+    u32 firstIndex  { 0 };
+    u32 indexCount  { 0 };
+    OffsetAllocator::Allocation vertices;
+    OffsetAllocator::Allocation indices;
+};
+
+class GeometryPool;
+
+// Staging backend of the geometry uploads, copies go to the frame command list
+class GeometryUploader {
+public:
+    enum Target : u32 { vertices, indices };
+
+    void Init(ID3D12Device *device, Commands *commands, GeometryPool *pool);
+    void Release();
+
+    u8* MapStaging(u32 size);
+    u64 CompletedFence();
+    u64 Submit(std::span<const render::StagingCopy> copies);
+
+private:
+    ID3D12Device *device_ { nullptr };
+    Commands *commands_ { nullptr };
+    GeometryPool *pool_ { nullptr };
+    ID3D12Resource *staging_ { nullptr };
+};
+
+class GeometryPool {
+public:
+    void Init(ID3D12Device *device, Commands *commands, u32 vertexCapacity, u32 indexCapacity);
+    void Release();
+    // Data is staged, it reaches the pool on next flush
+    GeometryRange Add(const render::Vertex *vertices, u32 vertexCount, const u32 *indices, u32 indexCount);
+    // The GPU must be done drawing the range
+    void Remove(GeometryRange &range);
+    // Records growth and staged copies, call once per frame with the command list open
+    void Flush();
+
+    [[nodiscard]] INLINE D3D12_VERTEX_BUFFER_VIEW* VertexView() { return &vertexView_; }
+    [[nodiscard]] INLINE D3D12_INDEX_BUFFER_VIEW* IndexView() { return &indexView_; }
+    [[nodiscard]] INLINE ID3D12Resource* Buffer(u32 target) const { return target == GeometryUploader::vertices ? vertexBuffer_ : indexBuffer_; }
+    [[nodiscard]] INLINE OffsetAllocator::Stats VertexStats() const { return vertices_.Statistics(); }
+    [[nodiscard]] INLINE OffsetAllocator::Stats IndexStats() const { return indices_.Statistics(); }
+    [[nodiscard]] INLINE const render::UploadQueue<GeometryUploader>& Uploads() const { return uploads_; }
+
+private:
+    void Grow(u32 vertexCapacity, u32 indexCapacity);
+    static ID3D12Resource* CreateBuffer(ID3D12Device *device, u64 size, const wchar_t *name);
+
+    ID3D12Device *device_ { nullptr };
+    Commands *commands_ { nullptr };
+    ID3D12Resource *vertexBuffer_ { nullptr };
+    ID3D12Resource *indexBuffer_ { nullptr };
+    D3D12_VERTEX_BUFFER_VIEW vertexView_ {};
+    D3D12_INDEX_BUFFER_VIEW indexView_ {};
+    OffsetAllocator vertices_;
+    OffsetAllocator indices_;
+    GeometryUploader uploader_;
+    render::UploadQueue<GeometryUploader> uploads_;
+
+    // Buffers the GPU saw last, copied to the current ones on next flush
+    ID3D12Resource *growSource_[2] {};
+    u64 growSize_[2] {};
+};
+
+}
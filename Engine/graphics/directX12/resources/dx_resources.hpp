@@ -15,6 +15,7 @@
 
 #include "dx_buffer.hpp"
 #include "dx_descriptor_heap.hpp"
+#include "dx_geometry_pool.hpp"
 #include "dx_upload_buffer.hpp"
 #include "dx_deferring_system.hpp"
 
@@ -23,7 +24,7 @@ namespace reveal3d::graphics::dx12 {
 struct FrameResource {
     ComPtr<ID3D12Resource> backBuffer;
     DescriptorHandle backBufferHandle;
-    ConstantBuffer constantBuffer;
+    InstanceBuffer instanceBuffer;
     PassCB passBuffer;
 };
 
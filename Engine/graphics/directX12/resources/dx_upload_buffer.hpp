@@ -17,6 +17,7 @@
 #include "math/math.hpp"
 #include "dx_descriptor_heap.hpp"
 #include "graphics/constants.hpp"
+#include "render/mesh.hpp"
 
 namespace reveal3d::graphics::dx12 {
 
@@ -90,5 +91,6 @@ DescriptorHandle UploadBuffer<T>::CreateView(ID3D12Device *device, DescriptorHea
 
 using ConstantBuffer = UploadBuffer<AlignedConstant<ObjConstant, 1>>;
 using PassCB = UploadBuffer<AlignedConstant<PassConstant, 2>>;
+using InstanceBuffer = UploadBuffer<render::Instance>;
 
 }
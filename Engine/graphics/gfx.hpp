@@ -18,6 +18,9 @@
 #endif
 #include "opengl/gl_graphics_core.hpp"
 #include "vulkan/vk_graphics_core.hpp"
+#include "null/null_graphics_core.hpp"
+#include "software/sw_graphics_core.hpp"
+#include "pathtracer/pt_graphics_core.hpp"
 
 #include <concepts>
 
@@ -25,16 +28,20 @@ namespace reveal3d::graphics {
 
 // Hardware Render Interface Concept
 template<typename Gfx>
-concept HRI = requires(Gfx graphics, render::Camera& camera, window::Resolution& res) {
+concept HRI = requires(Gfx graphics, render::Camera& camera, render::RenderWorld& world, window::Resolution& res) {
     {graphics.LoadPipeline()} ->  std::same_as<void>;
     {graphics.LoadAssets()} ->  std::same_as<void>;
 //    {graphics.LoadAsset(std::declval<u32>)} ->  std::same_as<void>;
-    {graphics.Update(camera)} ->  std::same_as<void>;
+    {graphics.Update(camera, world)} ->  std::same_as<void>;
     {graphics.PrepareRender()} ->  std::same_as<void>;
     {graphics.Draw()} ->  std::same_as<void>;
     {graphics.Terminate()} ->  std::same_as<void>;
     {graphics.Resize(res)} ->  std::same_as<void>;
 };
 
+static_assert(HRI<Null>);
+static_assert(HRI<Software>);
+static_assert(HRI<PathTracer>);
+
 }
 
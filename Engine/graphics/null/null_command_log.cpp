@@ -0,0 +1,151 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file null_command_log.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Recorded stream of backend commands
+ *
+ * Longer description
+ */
+
+#include "null_command_log.hpp"
+
+#include <algorithm>
+#include <fstream>
+
+namespace reveal3d::graphics::null {
+
+namespace {
+
+constexpr u32 fileMagic = 0x4C433352; // "R3CL"
+constexpr u32 fileVersion = 1;
+
+}
+
+u64 CommandLog::Hash(const void *data, u64 size) {
+    u64 hash = 0xCBF29CE484222325ULL;
+    const auto *bytes = (const u8 *) data;
+    for (u64 i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+std::string_view CommandLog::Name(Command::Op op) {
+    constexpr std::string_view names[Command::count] = {
+            "beginFrame", "endFrame", "viewport", "pipeline", "passConstants", "uploadGeometry", "uploadInstances", "draw"
+    };
+    return op < Command::count ? names[op] : "unknown";
+}
+
+void CommandLog::Record(const Command &command) {
+    words_.push_back(command.op);
+    words_.insert(words_.end(), command.args, command.args + argCount[command.op]);
+    if (hashed[command.op]) {
+        words_.push_back((u32) command.hash);
+        words_.push_back((u32) (command.hash >> 32));
+    }
+    ++commands_;
+}
+
+u32 CommandLog::Decode(std::span<const u32> words, u32 position, Command &command) {
+    command = Command {};
+    command.op = (Command::Op) words[position++];
+    for (u32 i = 0; i < argCount[command.op]; ++i) {
+        command.args[i] = words[position++];
+    }
+    if (hashed[command.op]) {
+        command.hash = words[position] | ((u64) words[position + 1] << 32);
+        position += 2;
+    }
+    return position;
+}
+
+bool CommandLog::Save(const char *path) const {
+    std::ofstream file(path, std::ios::binary);
+    if (!file.good()) {
+        LOG(logERROR) << "Could not write command log " << path;
+        return false;
+    }
+    const u32 header[4] = { fileMagic, fileVersion, commands_, (u32) words_.size() };
+    file.write((const char *) header, sizeof(header));
+    file.write((const char *) words_.data(), words_.size() * sizeof(u32));
+    return file.good();
+}
+
+// Words are validated while counting commands, a truncated, padded or foreign file leaves the log empty
+bool CommandLog::Load(const char *path) {
+    Clear();
+    std::ifstream file(path, std::ios::binary);
+    u32 header[4] {};
+    if (!file.read((char *) header, sizeof(header)) or header[0] != fileMagic or header[1] != fileVersion) {
+        LOG(logERROR) << "Invalid command log " << path;
+        return false;
+    }
+
+    // Word count is checked against the file before it sizes anything, a damaged header can't ask for gigabytes
+    const std::streampos wordsBegin = file.tellg();
+    file.seekg(0, std::ios::end);
+    const u64 remaining = (u64) (file.tellg() - wordsBegin);
+    file.seekg(wordsBegin);
+    if ((u64) header[3] * sizeof(u32) != remaining) {
+        LOG(logERROR) << "Truncated command log " << path;
+        return false;
+    }
+
+    std::vector<u32> words(header[3]);
+    if (!file.read((char *) words.data(), words.size() * sizeof(u32))) {
+        LOG(logERROR) << "Truncated command log " << path;
+        return false;
+    }
+
+    u32 commands = 0;
+    u32 position = 0;
+    while (position < words.size() and words[position] < Command::count) {
+        const u32 op = words[position];
+        position += 1 + argCount[op] + (hashed[op] ? 2 : 0);
+        ++commands;
+    }
+    if (position != words.size() or commands != header[2]) {
+        LOG(logERROR) << "Corrupted command log " << path;
+        return false;
+    }
+
+    words_ = std::move(words);
+    commands_ = commands;
+    return true;
+}
+
+void CommandLog::Print(std::ostream &stream) const {
+    Replay([&](const Command &command) {
+        stream << Name(command.op);
+        for (u32 i = 0; i < argCount[command.op]; ++i) {
+            stream << ' ' << command.args[i];
+        }
+        if (hashed[command.op]) {
+            stream << ' ' << std::hex << command.hash << std::dec;
+        }
+        stream << '\n';
+    });
+}
+
+u32 CommandLog::FirstDifference(const CommandLog &other) const {
+    u32 position = 0;
+    u32 index = 0;
+    Command a, b;
+    while (position < words_.size() and position < other.words_.size()) {
+        const u32 next = Decode(words_, position, a);
+        if (Decode(other.words_, position, b) != next or a.op != b.op or a.hash != b.hash or
+            !std::equal(a.args, a.args + argCount[a.op], b.args)) {
+            return index;
+        }
+        position = next;
+        ++index;
+    }
+    return index;
+}
+
+}
@@ -0,0 +1,90 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file null_command_log.hpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Recorded stream of backend commands
+ *
+ * Commands are stored as 32 bit words, an opcode followed by a fixed number of arguments
+ * per opcode, so a draw takes six words. Uploaded data is not kept, only its size and a
+ * 64 bit FNV-1a hash, enough to tell two streams apart.
+ *
+ * Logs are saved as a small header followed by the words. The text form has one command
+ * per line and is meant for diffing streams between versions.
+ */
+
+#pragma once
+
+#include "common/common.hpp"
+
+#include <ostream>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace reveal3d::graphics::null {
+
+struct Command {
+    enum Op : u8 {
+        beginFrame,     // frame
+        endFrame,
+        viewport,       // width, height
+        pipeline,       // layer
+        passConstants,  // hash
+        uploadGeometry, // target, offset, size, hash
+        uploadInstances,// count, hash
+        draw,           // index count, instance count, first index, base vertex, first instance
+        count
+    };
+
+    Op op;
+    u32 args[5] {};
+    u64 hash { 0 };
+};
+
+class CommandLog {
+public:
+    static u64 Hash(const void *data, u64 size);
+    static std::string_view Name(Command::Op op);
+
+    INLINE void Clear() { words_.clear(); commands_ = 0; }
+    void Record(const Command &command);
+
+    // Calls visitor with every command in recorded order
+    template<typename F>
+    void Replay(F &&visitor) const;
+
+    bool Save(const char *path) const;
+    bool Load(const char *path);
+    void Print(std::ostream &stream) const;
+
+    [[nodiscard]] INLINE u32 Count() const { return commands_; }
+    [[nodiscard]] INLINE u64 Bytes() const { return words_.size() * sizeof(u32); }
+    [[nodiscard]] INLINE std::span<const u32> Words() const { return words_; }
+    // Index of the first command that differs, Count() of the shorter log when one is a prefix
+    [[nodiscard]] u32 FirstDifference(const CommandLog &other) const;
+
+private:
+    static constexpr u32 argCount[Command::count] = { 1, 0, 2, 1, 0, 3, 1, 5 };
+    static constexpr bool hashed[Command::count] = { false, false, false, false, true, true, true, false };
+
+    // Decodes the command at word position, returns the position of the next one
+    static u32 Decode(std::span<const u32> words, u32 position, Command &command);
+
+    std::vector<u32> words_;
+    u32 commands_ { 0 };
+};
+
+template<typename F>
+void CommandLog::Replay(F &&visitor) const {
+    Command command;
+    for (u32 position = 0; position < words_.size();) {
+        position = Decode(words_, position, command);
+        visitor(command);
+    }
+}
+
+}
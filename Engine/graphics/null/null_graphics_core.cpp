@@ -0,0 +1,115 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file null_graphics_core.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Backend without GPU recording its command stream
+ *
+ * Longer description
+ */
+
+#include "null_graphics_core.hpp"
+
+#include "core/scene.hpp"
+#include "common/profiler.hpp"
+
+namespace reveal3d::graphics {
+
+using namespace null;
+
+namespace {
+
+enum Target : u32 { vertices, indices };
+
+}
+
+Null::Null(window::Resolution *res) : resolution_(res) {
+
+}
+
+void Null::LoadPipeline() {
+    Record({ Command::viewport, { resolution_->width, resolution_->height } });
+}
+
+void Null::LoadAssets() {
+    PROFILE_SCOPE("Null::LoadAssets");
+    for (u32 i = 0; i < core::scene.NumEntities(); ++i) {
+        CreateRenderElement(i);
+    }
+}
+
+void Null::Update(render::Camera &camera, render::RenderWorld &world) {
+    renderWorld_ = &world;
+
+    const math::mat4 viewProjection = camera.GetViewProjectionMatrix();
+    Record({ .op = Command::passConstants, .hash = CommandLog::Hash(&viewProjection, sizeof(viewProjection)) });
+
+    const std::vector<render::Instance> &instances = world.Instances();
+    Record({ .op = Command::uploadInstances, .args = { (u32)instances.size() },
+             .hash = CommandLog::Hash(instances.data(), sizeof(render::Instance) * instances.size()) });
+
+    auto &geometries = core::scene.Geometries();
+    for (u32 i = 0; i < core::scene.NumEntities(); ++i) {
+        if (!geometries[i].OnGpu())
+            CreateRenderElement(i);
+    }
+}
+
+void Null::PrepareRender() {
+    PROFILE_SCOPE("Null::PrepareRender");
+    Record({ Command::beginFrame, { frame_ } });
+}
+
+void Null::Draw() {
+    if (renderWorld_ != nullptr) {
+        for (u32 layer = 0; layer < render::Shader::count; ++layer) {
+            const std::vector<render::InstanceBatch> &batches = renderWorld_->Batches(layer);
+            if (batches.empty()) continue;
+            Record({ Command::pipeline, { layer } });
+            for (const render::InstanceBatch &batch : batches) {
+                const RenderElement &element = renderElements_[batch.mesh];
+                Record({ Command::draw, { batch.indexCount, batch.count, element.firstIndex + batch.indexPos,
+                                          element.baseVertex + batch.vertexPos, batch.first } });
+            }
+        }
+    }
+    Record({ Command::endFrame });
+    ++frame_;
+}
+
+void Null::Terminate() {
+    renderElements_.clear();
+    bufferBytes_.Set(0);
+    renderWorld_ = nullptr;
+}
+
+void Null::Resize(const window::Resolution &res) {
+    Record({ Command::viewport, { res.width, res.height } });
+}
+
+// Geometry is appended to two virtual buffers, entities sharing geometry share its element
+void Null::CreateRenderElement(u32 index) {
+    core::Geometry &geometry = core::scene.GetEntity(index).Geometry();
+    geometry.MarkAsStored();
+    if (geometry.RenderInfo() == UINT_MAX) {
+        Record({ .op = Command::uploadGeometry, .args = { vertices, vertexCount_, geometry.VertexCount() },
+                 .hash = CommandLog::Hash(geometry.GetVerticesStart(), sizeof(render::Vertex) * geometry.VertexCount()) });
+        Record({ .op = Command::uploadGeometry, .args = { indices, indexCount_, geometry.IndexCount() },
+                 .hash = CommandLog::Hash(geometry.GetIndicesStart(), sizeof(u32) * geometry.IndexCount()) });
+
+        renderElements_.push_back({ vertexCount_, indexCount_ });
+        vertexCount_ += geometry.VertexCount();
+        indexCount_ += geometry.IndexCount();
+        bufferBytes_.Set((u64) vertexCount_ * sizeof(render::Vertex) + (u64) indexCount_ * sizeof(u32));
+        geometry.SetRenderInfo(renderElements_.size() - 1U);
+    }
+    for (auto &subMesh : geometry.SubMeshes()) {
+        subMesh.renderInfo = geometry.RenderInfo();
+        subMesh.constantIndex = index;
+    }
+}
+
+}
@@ -0,0 +1,64 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file null_graphics_core.hpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Backend without GPU recording its command stream
+ *
+ * Does the same CPU work as the other backends, geometry placement in shared buffers,
+ * instance uploads and one draw per instance batch, but every command goes to a log
+ * instead of a device. Runs anywhere, so it measures the engine side of submission and
+ * lets command streams be compared between versions.
+ */
+
+#pragma once
+
+#include "null_command_log.hpp"
+
+#include "render/camera.hpp"
+#include "render/render_world.hpp"
+#include "window/window_info.hpp"
+
+namespace reveal3d::graphics {
+
+class Null {
+public:
+    explicit Null(window::Resolution *res);
+    void LoadPipeline();
+    void LoadAssets();
+    void Update(render::Camera &camera, render::RenderWorld &world);
+    void PrepareRender();
+    void Draw();
+    void Terminate();
+    void Resize(const window::Resolution &res);
+
+    INLINE void SetWindow(WHandle wHandle) {}
+    // Recording can be turned off to measure the engine alone
+    INLINE void SetRecording(bool recording) { recording_ = recording; }
+    [[nodiscard]] INLINE null::CommandLog& Log() { return log_; }
+    [[nodiscard]] INLINE u32 Frame() const { return frame_; }
+
+private:
+    struct RenderElement {
+        u32 baseVertex;
+        u32 firstIndex;
+    };
+
+    void CreateRenderElement(u32 index);
+    INLINE void Record(const null::Command &command) { if (recording_) log_.Record(command); }
+
+    window::Resolution *resolution_;
+    std::vector<RenderElement> renderElements_;
+    const render::RenderWorld *renderWorld_ { nullptr };
+    null::CommandLog log_;
+    u32 vertexCount_ { 0 };
+    u32 indexCount_ { 0 };
+    memory::Tracked<memory::buffers> bufferBytes_; // What the two virtual buffers would take
+    u32 frame_ { 0 };
+    bool recording_ { true };
+};
+
+}
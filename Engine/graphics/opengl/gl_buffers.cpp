@@ -0,0 +1,231 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file gl_buffers.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Shared geometry and per frame buffers
+ *
+ * Longer description
+ */
+
+#include "gl_buffers.hpp"
+#include "gl_state.hpp"
+#include "render/mesh.hpp"
+
+#include <algorithm>
+
+namespace reveal3d::graphics::opengl {
+
+namespace {
+
+constexpr u32 vertexBinding = 0;
+constexpr u32 instanceBinding = 1;
+constexpr u32 regionAlignment = 256;
+constexpr u32 stagingSize = 16 << 20;
+constexpr u64 fenceTimeout = 1000000000; // 1 second, in nanoseconds
+
+}
+
+void GeometryBuffer::Init(u32 vertexCapacity, u32 indexCapacity) {
+    glCreateVertexArrays(1, &vao_);
+
+    glEnableVertexArrayAttrib(vao_, 0);
+    glVertexArrayAttribFormat(vao_, 0, 3, GL_FLOAT, GL_FALSE, offsetof(render::Vertex, pos));
+    glVertexArrayAttribBinding(vao_, 0, vertexBinding);
+
+    glEnableVertexArrayAttrib(vao_, 1);
+    glVertexArrayAttribFormat(vao_, 1, 4, GL_FLOAT, GL_FALSE, offsetof(render::Vertex, color));
+    glVertexArrayAttribBinding(vao_, 1, vertexBinding);
+
+    glEnableVertexArrayAttrib(vao_, 2);
+    glVertexArrayAttribFormat(vao_, 2, 3, GL_FLOAT, GL_FALSE, offsetof(render::Vertex, normal));
+    glVertexArrayAttribBinding(vao_, 2, vertexBinding);
+
+    // World matrix takes locations 3 to 6, one row per location
+    for (u32 row = 0; row < 4; ++row) {
+        glEnableVertexArrayAttrib(vao_, 3 + row);
+        glVertexArrayAttribFormat(vao_, 3 + row, 4, GL_FLOAT, GL_FALSE, offsetof(render::Instance, world) + row * sizeof(math::vec4));
+        glVertexArrayAttribBinding(vao_, 3 + row, instanceBinding);
+    }
+    glVertexArrayBindingDivisor(vao_, instanceBinding, 1);
+
+    Grow(vertexCapacity, indexCapacity);
+    uploads_.Init(&uploader_, stagingSize);
+}
+
+void GeometryBuffer::Terminate() {
+    uploader_.Terminate();
+    state.DeleteBuffer(vbo_);
+    state.DeleteBuffer(ebo_);
+    state.DeleteVertexArray(vao_);
+    *this = GeometryBuffer {};
+}
+
+RenderElement GeometryBuffer::Add(std::vector<render::Vertex> &vertices, std::vector<u32> &indices, math::mat4 world) {
+    auto vertexRange = vertices_.Allocate(vertices.size());
+    auto indexRange = indices_.Allocate(indices.size());
+    if (!vertexRange.Valid() or !indexRange.Valid()) {
+        if (vertexRange.Valid()) vertices_.Free(vertexRange);
+        if (indexRange.Valid()) indices_.Free(indexRange);
+        // Added space merges with a free tail, so the mesh always fits after growing
+        Grow(std::max<u32>(vertices_.Size() * 2, vertices_.Size() + vertices.size()),
+             std::max<u32>(indices_.Size() * 2, indices_.Size() + indices.size()));
+        vertexRange = vertices_.Allocate(vertices.size());
+        indexRange = indices_.Allocate(indices.size());
+    }
+
+    uploads_.Queue(GeometryUploader::vertices, sizeof(render::Vertex) * (u64)vertexRange.offset, vertices.data(),
+                   sizeof(render::Vertex) * vertices.size());
+    uploads_.Queue(GeometryUploader::indices, sizeof(u32) * (u64)indexRange.offset, indices.data(), sizeof(u32) * indices.size());
+
+    return { vertexRange.offset, indexRange.offset, (u32)indices.size(), world, vertexRange, indexRange };
+}
+
+void GeometryBuffer::Remove(RenderElement &element) {
+    if (element.vertices.Valid()) vertices_.Free(element.vertices);
+    if (element.indices.Valid()) indices_.Free(element.indices);
+    element.vertices = {};
+    element.indices = {};
+    element.indexCount = 0;
+}
+
+void GeometryBuffer::SetInstances(u32 buffer, u64 offset) const {
+    glVertexArrayVertexBuffer(vao_, instanceBinding, buffer, offset, sizeof(render::Instance));
+}
+
+// Meshes are usually loaded once, growing copies the old contents on the GPU
+void GeometryBuffer::Grow(u32 vertexCapacity, u32 indexCapacity) {
+    u32 buffers[2];
+    glCreateBuffers(2, buffers);
+    glNamedBufferData(buffers[0], sizeof(render::Vertex) * vertexCapacity, nullptr, GL_STATIC_DRAW);
+    glNamedBufferData(buffers[1], sizeof(u32) * indexCapacity, nullptr, GL_STATIC_DRAW);
+
+    // Free ranges are copied too, allocations can be anywhere in the old buffers
+    if (vbo_ != 0) {
+        glCopyNamedBufferSubData(vbo_, buffers[0], 0, 0, sizeof(render::Vertex) * vertices_.Size());
+        glCopyNamedBufferSubData(ebo_, buffers[1], 0, 0, sizeof(u32) * indices_.Size());
+        state.DeleteBuffer(vbo_);
+        state.DeleteBuffer(ebo_);
+    }
+
+    // Staged copies are recorded after this one, they already go to the new buffers
+    vbo_ = buffers[0];
+    ebo_ = buffers[1];
+    uploader_.SetTargets(vbo_, ebo_);
+    vertices_.Grow(vertexCapacity);
+    indices_.Grow(indexCapacity);
+    glVertexArrayVertexBuffer(vao_, vertexBinding, vbo_, 0, sizeof(render::Vertex));
+    glVertexArrayElementBuffer(vao_, ebo_);
+    bytes_.Set(sizeof(render::Vertex) * (u64)vertexCapacity + sizeof(u32) * (u64)indexCapacity);
+}
+
+void GeometryUploader::Terminate() {
+    for (auto &[fence, sync] : fences_) {
+        glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, fenceTimeout);
+        glDeleteSync(sync);
+    }
+    if (buffer_ != 0) {
+        glUnmapNamedBuffer(buffer_);
+        state.DeleteBuffer(buffer_);
+    }
+    *this = GeometryUploader {};
+}
+
+// Coherent mapping, the copies read what the CPU wrote without explicit flushes
+u8* GeometryUploader::MapStaging(u32 size) {
+    constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    if (buffer_ != 0) {
+        glUnmapNamedBuffer(buffer_);
+        state.DeleteBuffer(buffer_);
+    }
+    glCreateBuffers(1, &buffer_);
+    glNamedBufferStorage(buffer_, size, nullptr, flags);
+    bytes_.Set(size);
+    auto *mapped = (u8 *) glMapNamedBufferRange(buffer_, 0, size, flags);
+    if (mapped == nullptr) {
+        throw std::runtime_error("Could not map staging buffer");
+    }
+    return mapped;
+}
+
+// Polls without waiting, fences signal in submission order
+u64 GeometryUploader::CompletedFence() {
+    while (!fences_.empty()) {
+        const GLenum status = glClientWaitSync(fences_.front().second, 0, 0);
+        if (status != GL_ALREADY_SIGNALED and status != GL_CONDITION_SATISFIED) break;
+        completed_ = fences_.front().first;
+        glDeleteSync(fences_.front().second);
+        fences_.pop_front();
+    }
+    return completed_;
+}
+
+u64 GeometryUploader::Submit(std::span<const render::StagingCopy> copies) {
+    for (const render::StagingCopy &copy : copies) {
+        glCopyNamedBufferSubData(buffer_, targets_[copy.target], copy.stagingOffset, copy.targetOffset, copy.size);
+    }
+    fences_.emplace_back(++submitted_, glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+    return submitted_;
+}
+
+void FrameRing::Init(u32 regionSize) {
+    Allocate(regionSize);
+}
+
+void FrameRing::Terminate() {
+    for (u32 region = 0; region < frameCount; ++region) {
+        Wait(region);
+    }
+    glUnmapNamedBuffer(buffer_);
+    state.DeleteBuffer(buffer_);
+    *this = FrameRing {};
+}
+
+u8* FrameRing::Begin(u32 size) {
+    Wait(region_);
+    if (size > regionSize_) {
+        for (u32 region = 0; region < frameCount; ++region) {
+            Wait(region);
+        }
+        glUnmapNamedBuffer(buffer_);
+        state.DeleteBuffer(buffer_);
+        Allocate(std::max(size, regionSize_ * 2));
+    }
+    return mapped_ + Offset();
+}
+
+void FrameRing::End() {
+    fences_[region_] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    region_ = (region_ + 1) % frameCount;
+}
+
+void FrameRing::Wait(u32 region) {
+    if (fences_[region] == nullptr) return;
+    // First wait flushes, so the fence is guaranteed to be signaled eventually
+    GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+    while (glClientWaitSync(fences_[region], flags, fenceTimeout) == GL_TIMEOUT_EXPIRED) {
+        LOG(logWARNING) << "Waiting for GPU frame " << region;
+        flags = 0;
+    }
+    glDeleteSync(fences_[region]);
+    fences_[region] = nullptr;
+}
+
+// Coherent mapping, writes are visible to the GPU without explicit flushes
+void FrameRing::Allocate(u32 regionSize) {
+    constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    regionSize_ = (regionSize + regionAlignment - 1) & ~(regionAlignment - 1);
+    region_ = 0;
+    glCreateBuffers(1, &buffer_);
+    glNamedBufferStorage(buffer_, (u64)regionSize_ * frameCount, nullptr, flags);
+    bytes_.Set((u64)regionSize_ * frameCount);
+    mapped_ = (u8 *) glMapNamedBufferRange(buffer_, 0, (u64)regionSize_ * frameCount, flags);
+    if (mapped_ == nullptr) {
+        throw std::runtime_error("Could not map frame buffer");
+    }
+}
+
+}
@@ -0,0 +1,118 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file gl_buffers.hpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Shared geometry and per frame buffers
+ *
+ * Every mesh lives in one vertex and one index buffer read through a single vertex
+ * array, so drawing any mesh needs no binds and all meshes of a layer go in one
+ * multi draw. Meshes are addressed by base vertex and first index, ranges of both
+ * buffers are handed out by an offset allocator so removed meshes leave room for new
+ * ones. Mesh data goes through a staging ring and is copied to the buffers in one batch
+ * per frame.
+ *
+ * Data written every frame (instances, indirect commands) goes to persistently mapped
+ * buffers split in one region per frame in flight. A region is written again only after
+ * the fence placed when its frame was submitted is signaled, so the CPU never waits on
+ * the frame the GPU is reading.
+ */
+
+#pragma once
+
+#include "gl_render_info.hpp"
+#include "render/staging_ring.hpp"
+#include "common/memory_report.hpp"
+
+#include <deque>
+
+namespace reveal3d::graphics::opengl {
+
+// Staging backend of the geometry uploads, targets are the vertex and index buffers
+class GeometryUploader {
+public:
+    enum Target : u32 { vertices, indices };
+
+    void Terminate();
+    INLINE void SetTargets(u32 vbo, u32 ebo) { targets_[vertices] = vbo; targets_[indices] = ebo; }
+
+    u8* MapStaging(u32 size);
+    u64 CompletedFence();
+    u64 Submit(std::span<const render::StagingCopy> copies);
+
+private:
+    u32 buffer_ { 0 };
+    u32 targets_[2] {};
+    std::deque<std::pair<u64, GLsync>> fences_;
+    u64 submitted_ { 0 };
+    u64 completed_ { 0 };
+    memory::Tracked<memory::buffers> bytes_;
+};
+
+class GeometryBuffer {
+public:
+    void Init(u32 vertexCapacity, u32 indexCapacity);
+    void Terminate();
+    // Buffers grow when the mesh doesn't fit, keeping the offsets of every other mesh. Data
+    // is staged, it reaches the buffers on next flush
+    RenderElement Add(std::vector<render::Vertex> &vertices, std::vector<u32> &indices, math::mat4 world);
+    // Returns the ranges of the mesh, the GPU must be done drawing it
+    void Remove(RenderElement &element);
+    // Copies the staged meshes, call once per frame before drawing
+    INLINE void Flush() { uploads_.Flush(); }
+    // Per instance attributes 3 to 6 read world matrices of the instance buffer from offset
+    void SetInstances(u32 buffer, u64 offset) const;
+
+    [[nodiscard]] INLINE u32 Vao() const { return vao_; }
+    [[nodiscard]] INLINE u32 VertexCount() const { return vertices_.Size() - vertices_.FreeSize(); }
+    [[nodiscard]] INLINE u32 IndexCount() const { return indices_.Size() - indices_.FreeSize(); }
+    [[nodiscard]] INLINE OffsetAllocator::Stats VertexStats() const { return vertices_.Statistics(); }
+    [[nodiscard]] INLINE OffsetAllocator::Stats IndexStats() const { return indices_.Statistics(); }
+    [[nodiscard]] INLINE const render::UploadQueue<GeometryUploader>& Uploads() const { return uploads_; }
+
+private:
+    void Grow(u32 vertexCapacity, u32 indexCapacity);
+
+    u32 vao_ { 0 };
+    u32 vbo_ { 0 };
+    u32 ebo_ { 0 };
+    OffsetAllocator vertices_;
+    OffsetAllocator indices_;
+    GeometryUploader uploader_;
+    render::UploadQueue<GeometryUploader> uploads_;
+    memory::Tracked<memory::buffers> bytes_;    // GPU memory of both buffers
+};
+
+class FrameRing {
+public:
+    static constexpr u32 frameCount = 3;
+
+    void Init(u32 regionSize);
+    void Terminate();
+    // Waits until the GPU is done with the region of this frame. The buffer is recreated,
+    // changing its name, when size doesn't fit in a region
+    u8* Begin(u32 size);
+    // Fences the region, call once the frame commands reading it are submitted
+    void End();
+
+    [[nodiscard]] INLINE u32 Buffer() const { return buffer_; }
+    // Start of the region of this frame
+    [[nodiscard]] INLINE u64 Offset() const { return (u64)region_ * regionSize_; }
+    [[nodiscard]] INLINE u32 RegionSize() const { return regionSize_; }
+
+private:
+    void Wait(u32 region);
+    void Allocate(u32 regionSize);
+
+    u32 buffer_ { 0 };
+    u8 *mapped_ { nullptr };
+    u32 regionSize_ { 0 };
+    u32 region_ { 0 };
+    GLsync fences_[frameCount] {};
+    memory::Tracked<memory::buffers> bytes_;
+};
+
+}
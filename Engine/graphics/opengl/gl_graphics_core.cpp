@@ -12,9 +12,12 @@
  */
 
 #include "gl_graphics_core.hpp"
+#include "gl_state.hpp"
 
 #include "core/scene.hpp"
 #include "config/config.hpp"
+#include "common/perf_counters.hpp"
+#include "common/profiler.hpp"
 //#ifdef WIN32
 //#include <GL/wglew.h>
 //#else
@@ -45,27 +48,23 @@ void OpenGL::LoadPipeline() {
 }
 
 void OpenGL::LoadAssets() {
-    std::vector<core::Transform> &transforms = core::scene.Transforms();
-    std::vector<core::Geometry> &geometries = core::scene.Geometries();
-
-    for(u32 i = 0; i < core::scene.NumEntities(); ++i) {
-        if (geometries[i].RenderInfo() == UINT_MAX) {
-
-            renderElements_.emplace_back(geometries[i].Vertices(), geometries[i].Indices(), transforms[i].World());
-            geometries[i].SetRenderInfo(i);
-
-            for (auto &mesh : geometries[i].SubMeshes()) {
-                mesh.renderInfo = i;
-                mesh.constantIndex = i;
-                renderLayers_.AddMesh(mesh);
-            }
-        } else {
-            for (auto &mesh : geometries[i].SubMeshes()) {
-                mesh.renderInfo = geometries[i].RenderInfo();
-                mesh.constantIndex = i;
-                renderLayers_.AddMesh(mesh);
-            }
-        }
+    PROFILE_SCOPE("OpenGL::LoadAssets");
+    for (u32 i = 0; i < core::scene.NumEntities(); ++i) {
+        CreateRenderElement(i);
+    }
+}
+
+// Elements are pushed in load order, entities sharing geometry share its element
+void OpenGL::CreateRenderElement(u32 index) {
+    core::Entity entity = core::scene.GetEntity(index);
+    core::Geometry &geometry = entity.Geometry();
+    if (geometry.RenderInfo() == UINT_MAX) {
+        renderElements_.push_back(renderLayers_.AddMesh(geometry.Vertices(), geometry.Indices(), entity.Transform().World()));
+        geometry.SetRenderInfo(renderElements_.size() - 1U);
+    }
+    for (auto &subMesh : geometry.SubMeshes()) {
+        subMesh.renderInfo = geometry.RenderInfo();
+        subMesh.constantIndex = index;
     }
 }
 
@@ -73,8 +72,10 @@ void OpenGL::LoadAsset() {
     //TODO
 }
 
-void OpenGL::Update(render::Camera &camera) {
+void OpenGL::Update(render::Camera &camera, render::RenderWorld &world) {
     passConstant_ = camera.GetViewProjectionMatrix();
+    renderWorld_ = &world;
+    renderLayers_.Upload(renderElements_, world);
 
 //    auto &transforms = core::scene.Transforms();
 //
@@ -87,18 +88,25 @@ void OpenGL::Update(render::Camera &camera) {
 }
 
 void OpenGL::PrepareRender() {
+    PROFILE_SCOPE("OpenGL::PrepareRender");
+    opengl::state.ResetCounters(); // Counters cover a single frame
     glClearColor(config::clearColor.x, config::clearColor.y, config::clearColor.z, config::clearColor.w);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 }
 
 void OpenGL::Draw() {
-    for(u32 i = 0; i < render::Shader::count; ++i) {
-        renderLayers_.Draw(renderElements_, passConstant_,i);
+    PERF_SCOPE("OpenGL::Draw");
+    if (renderWorld_ != nullptr) {
+        for(u32 i = 0; i < render::Shader::count; ++i) {
+            renderLayers_.Draw(passConstant_, i);
+        }
+        renderLayers_.EndFrame();
     }
     SwapBuffer();
 }
 
 void OpenGL::Terminate() {
+    renderLayers_.Terminate();
     TerminateContext();
 }
 
@@ -142,15 +150,15 @@ void OpenGL::TerminateContext() {
 
 #else
 
-void Dx12::CreateContext() {
-    glfwMakeContextCurrent(window);
+void OpenGL::CreateContext() {
+    glfwMakeContextCurrent(window_);
 }
 
-void Dx12::SwapBuffer() {
-    glfwSwapBuffers(window);
+void OpenGL::SwapBuffer() {
+    glfwSwapBuffers(window_);
 }
 
-void Dx12::TerminateContext() {
+void OpenGL::TerminateContext() {
 
 }
 
@@ -14,6 +14,7 @@
 
 #include "gl_render_info.hpp"
 #include "render/camera.hpp"
+#include "render/render_world.hpp"
 
 #include "gl_render_layers.hpp"
 
@@ -25,7 +26,7 @@ public:
     void LoadPipeline();
     void LoadAssets();
     void LoadAsset();
-    void Update(render::Camera& camera);
+    void Update(render::Camera& camera, render::RenderWorld& world);
     void PrepareRender();
     void Draw();
     void Terminate();
@@ -34,12 +35,14 @@ public:
     INLINE void SetWindow(WHandle wHandle) { window_ = wHandle; }
 
 private:
+    void CreateRenderElement(u32 index);
     void CreateContext();
     void SwapBuffer();
     void TerminateContext();
     math::mat4 passConstant_;
     std::vector<opengl::RenderElement> renderElements_;
     opengl::RenderLayers renderLayers_;
+    const render::RenderWorld *renderWorld_ { nullptr };
     WHandle window_ {};
 };
 
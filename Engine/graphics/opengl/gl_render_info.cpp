@@ -1,45 +0,0 @@
-/************************************************************************
- * Copyright (c) 2024 Alvaro Cabrera Barrio
- * This code is licensed under MIT license (see LICENSE.txt for details)
- ************************************************************************/
-/**
- * @file gl_render_info.cpp
- * @version 1.0
- * @date 17/04/2024
- * @brief Short description
- *
- * Longer description
- */
-#include "gl_render_info.hpp"
-
-
-namespace reveal3d::graphics::opengl {
-
-RenderElement::RenderElement(std::vector<render::Vertex> &vertices, std::vector<u32> &indices, math::mat4 world) : world(world) {
-
-    glGenVertexArrays(1, &vao);
-    glBindVertexArray(vao);
-
-    glGenBuffers(1, &vbo);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(render::Vertex) * vertices.size(), vertices.data(), GL_STATIC_DRAW);
-
-    glGenBuffers(1, &ebo);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(u32) * indices.size(), indices.data(), GL_STATIC_DRAW);
-
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(render::Vertex), static_cast<GLvoid *>(0));
-
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(render::Vertex), (void *) (offsetof(render::Vertex, Vertex::color)));
-
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(render::Vertex), (void *) (offsetof(render::Vertex, Vertex::normal)));
-
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
-}
-
-}
-
@@ -14,6 +14,7 @@
 #pragma once
 
 #include "common/common.hpp"
+#include "common/offset_allocator.hpp"
 #include "math/math.hpp"
 #include "render/vertex.hpp"
 
@@ -23,12 +24,23 @@
 
 namespace reveal3d::graphics::opengl {
 
+// Mesh range inside the shared geometry buffer
 struct RenderElement {
-    RenderElement(std::vector<render::Vertex> &vertices, std::vector<u32> &indices, math::mat4 world);
-    u32 vao;
-    u32 vbo;
-    u32 ebo;
+    u32 baseVertex;
+    u32 firstIndex;
+    u32 indexCount;
     math::mat4 world;
+    OffsetAllocator::Allocation vertices;
+    OffsetAllocator::Allocation indices;
+};
+
+// Layout of glMultiDrawElementsIndirect commands
+struct DrawCommand {
+    u32 count;
+    u32 instanceCount;
+    u32 firstIndex;
+    i32 baseVertex;
+    u32 baseInstance;
 };
 
 }
@@ -12,24 +12,99 @@
  */
 
 #include "gl_render_layers.hpp"
-#include "core/scene.hpp"
+#include "gl_state.hpp"
+#include "common/profiler.hpp"
 
+#include <cstring>
 #include <fstream>
+#include <iostream>
 
 namespace reveal3d::graphics::opengl {
 
+namespace {
+
+constexpr u32 initialVertices = 1 << 20;
+constexpr u32 initialIndices = 1 << 22;
+constexpr u32 initialInstances = 4096;
+
+}
+
 void RenderLayers::Init() {
     layers_[render::Shader::opaque].shaderId = CreateProgram(relative("Engine/graphics/opengl/shaders/solidShader.vert").c_str(),
                                                            relative("Engine/graphics/opengl/shaders/solidShader.frag").c_str());
 //    layers_[render::Shader::flat].shaderId = CreateProgram(relative("Engine/graphics/opengl/shaders/flatShader.vert").c_str(),
 //                                                             relative("Engine/graphics/opengl/shaders/flatShader.frag").c_str());
+
+    // Lighting is constant, it is set once instead of every frame
+    const u32 opaque = layers_[render::Shader::opaque].shaderId;
+    layers_[render::Shader::opaque].vpLocation = glGetUniformLocation(opaque, "vp");
+    state.Uniform(opaque, glGetUniformLocation(opaque, "ambientLightIntensity"), 0.7f);
+    state.Uniform(opaque, glGetUniformLocation(opaque, "ambientColor"), 1.0f, 1.0f, 1.0f);
+    state.Uniform(opaque, glGetUniformLocation(opaque, "sunLightDirection"), 0.0f, 0.5f, -1.0f);
+    state.Uniform(opaque, glGetUniformLocation(opaque, "sunLightColor"), 1.0f, 1.0f, 1.0f);
+    state.Uniform(opaque, glGetUniformLocation(opaque, "sunLightIntensity"), 0.9f);
+
+    geometry_.Init(initialVertices, initialIndices);
+    instances_.Init(sizeof(render::Instance) * initialInstances);
+    commands_.Init(sizeof(DrawCommand) * initialInstances);
+}
+
+void RenderLayers::Terminate() {
+    instances_.Terminate();
+    commands_.Terminate();
+    geometry_.Terminate();
+    for (Layer &layer : layers_) {
+        state.DeleteProgram(layer.shaderId);
+        layer = Layer {};
+    }
+}
+
+void RenderLayers::Upload(const std::vector<RenderElement> &elements, const render::RenderWorld &world) {
+    geometry_.Flush();
+    drawCommands_.clear();
+    for (u32 layer = 0; layer < render::Shader::count; ++layer) {
+        layerFirst_[layer] = drawCommands_.size();
+        for (const render::InstanceBatch &batch : world.Batches(layer)) {
+            const RenderElement &element = elements[batch.mesh];
+            drawCommands_.push_back({ batch.indexCount, batch.count, element.firstIndex + batch.indexPos,
+                                      (i32)(element.baseVertex + batch.vertexPos), batch.first });
+        }
+        layerCount_[layer] = drawCommands_.size() - layerFirst_[layer];
+    }
+
+    const std::vector<render::Instance> &instances = world.Instances();
+    u8 *instanceData = instances_.Begin(sizeof(render::Instance) * instances.size());
+    std::memcpy(instanceData, instances.data(), sizeof(render::Instance) * instances.size());
+    u8 *commandData = commands_.Begin(sizeof(DrawCommand) * drawCommands_.size());
+    std::memcpy(commandData, drawCommands_.data(), sizeof(DrawCommand) * drawCommands_.size());
+
+    // Base instance of the commands is relative to the region of this frame
+    geometry_.SetInstances(instances_.Buffer(), instances_.Offset());
+}
+
+void RenderLayers::Draw(const math::mat4 &passConstants, u32 layer) {
+    PROFILE_SCOPE("RenderLayers::Draw");
+    if (layers_[layer].shaderId == 0 or layerCount_[layer] == 0) return;
+
+    // Still camera and consecutive layers sharing buffers set nothing again
+    state.UseProgram(layers_[layer].shaderId);
+    state.UniformMatrix(layers_[layer].shaderId, layers_[layer].vpLocation, (const f32 *) &passConstants);
+    state.BindVertexArray(geometry_.Vao());
+    state.BindBuffer(GL_DRAW_INDIRECT_BUFFER, commands_.Buffer());
+    glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (void *) (commands_.Offset() + sizeof(DrawCommand) * layerFirst_[layer]),
+                                layerCount_[layer], 0);
+}
+
+void RenderLayers::EndFrame() {
+    instances_.End();
+    commands_.End();
 }
 
 std::string RenderLayers::ReadShader(const char* fileName) {
     std::string shader_code;
     std::ifstream file(fileName, std::ios::in);
     if (!file.good()) {
-        log(logERROR) << "Could not read Shader...";
+        LOG(logERROR) << "Could not read Shader...";
         std::terminate();
     }
 
@@ -55,7 +130,7 @@ u32 RenderLayers::CreateShader(GLenum shaderType, std::string &source, const cha
         glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &info_log_length);
         std::vector<char> shader_log(info_log_length);
         glGetShaderInfoLog(shader, info_log_length, NULL, shader_log.data());
-        log(logDEBUG) << "Error compiling Shader: " << shader_log.data();
+        LOG(logDEBUG) << "Error compiling Shader: " << shader_log.data();
         return 0;
     }
     return shader;
@@ -87,41 +162,5 @@ u32 RenderLayers::CreateProgram(const char *vs, const char *fs) {
     return program;
 }
 
-void RenderLayers::AddMesh(render::SubMesh &mesh) {
-    subMeshes_[mesh.shader].push_back(&mesh);
-}
-
-void RenderLayers::Draw(std::vector<RenderElement> &renderElments, math::mat4& passConstants, u32 layer) {
-
-    const i32 vp_loc = glGetUniformLocation(layers_[layer].shaderId, "vp");
-    const i32 model_loc = glGetUniformLocation(layers_[layer].shaderId, "model");
-    const i32 ambient_color_loc = glGetUniformLocation(layers_[layer].shaderId, "ambientColor");
-    const i32 ambient_light_intensity_loc = glGetUniformLocation(layers_[layer].shaderId, "ambientLightIntensity");
-    const i32 sun_light_dir_loc = glGetUniformLocation(layers_[layer].shaderId, "sunLightDirection");
-    const i32 sun_light_color_loc = glGetUniformLocation(layers_[layer].shaderId, "sunLightColor");
-    const i32 sun_light_intensity_loc = glGetUniformLocation(layers_[layer].shaderId, "sunLightIntensity");
-
-    glUseProgram(layers_[layer].shaderId);
-    glUniform1f(ambient_light_intensity_loc, 0.7f);
-    glUniform3f(ambient_color_loc, 1.0f, 1.0f, 1.0f);
-    glUniform3f(sun_light_dir_loc, 0.0f, 0.5f, -1.0f);
-    glUniform3f(sun_light_color_loc, 1.0f, 1.0f, 1.0f);
-    glUniform1f(sun_light_intensity_loc, 0.9f);
-    glUniformMatrix4fv(vp_loc, 1, GL_FALSE, (f32 *) &passConstants);
-
-//    glBindTexture(GL_TEXTURE_2D, texture_);
-
-    for (const auto &mesh: subMeshes_[layer]) {
-        if (!mesh->visible) continue;
-        const math::mat4 world = math::Transpose(core::scene.Transforms()[mesh->constantIndex].World());
-        glUniformMatrix4fv(model_loc, 1, GL_FALSE, (f32 *) &world);
-        glBindVertexArray(renderElments[mesh->renderInfo].vao);
-        glDrawElements(GL_TRIANGLES, mesh->indexCount * 2, GL_UNSIGNED_INT, 0);
-        glBindVertexArray(0);
-    }
-}
-
-
-
 };
 
@@ -14,22 +14,35 @@
 #pragma once
 
 #include "render/mesh.hpp"
-#include "gl_render_info.hpp"
+#include "render/render_world.hpp"
+#include "gl_buffers.hpp"
 
 namespace reveal3d::graphics::opengl {
 
 struct Layer {
-    u32 shaderId;
+    u32 shaderId    { 0 };
+    i32 vpLocation  { -1 };
 };
 
 class RenderLayers  {
 public:
     void Init();
-    void AddMesh(render::SubMesh &mesh);
-    void Draw(std::vector<RenderElement>& renderElments, math::mat4 &passConstants, u32 layer);
+    void Terminate();
+    INLINE RenderElement AddMesh(std::vector<render::Vertex> &vertices, std::vector<u32> &indices, math::mat4 world) {
+        return geometry_.Add(vertices, indices, world);
+    }
+    INLINE void RemoveMesh(RenderElement &element) { geometry_.Remove(element); }
+    // Copies staged meshes, writes the frame instances and one indirect command per instance
+    // batch, call before drawing
+    void Upload(const std::vector<RenderElement> &elements, const render::RenderWorld &world);
+    // Every batch of the layer in a single multi draw
+    void Draw(const math::mat4 &passConstants, u32 layer);
+    // Fences the frame buffers, call once every layer is drawn
+    void EndFrame();
 
     INLINE Layer& operator[] (u32 index) { return layers_[index]; }
     INLINE const Layer& operator[] (u32 index) const { return layers_[index]; }
+    [[nodiscard]] INLINE const GeometryBuffer& Geometry() const { return geometry_; }
 
 private:
     static std::string ReadShader(const char* fileName);
@@ -37,8 +50,12 @@ private:
     static u32 CreateProgram(const char* vs, const char* fs);
 
     Layer layers_[render::Shader::count];
-    std::vector<render::SubMesh *> subMeshes_[render::Shader::count];
-
+    GeometryBuffer geometry_;
+    FrameRing instances_;
+    FrameRing commands_;
+    std::vector<DrawCommand> drawCommands_;
+    u32 layerFirst_[render::Shader::count] {};
+    u32 layerCount_[render::Shader::count] {};
 };
 
 }
@@ -0,0 +1,146 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file gl_state.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief OpenGL state cache
+ *
+ * Longer description
+ */
+
+#include "gl_state.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace reveal3d::graphics::opengl {
+
+StateCache state;
+
+void StateCache::UseProgram(u32 program) {
+    if (Changed(program_, program)) {
+        glUseProgram(program);
+    }
+}
+
+void StateCache::BindVertexArray(u32 vao) {
+    if (Changed(vao_, vao)) {
+        glBindVertexArray(vao);
+    }
+}
+
+void StateCache::BindBuffer(GLenum target, u32 buffer) {
+    const u32 index = TargetIndex(target);
+    if (index == unknown) {
+        ++issued_;
+        glBindBuffer(target, buffer);
+    } else if (Changed(buffers_[index], buffer)) {
+        glBindBuffer(target, buffer);
+    }
+}
+
+void StateCache::BindTexture(u32 unit, u32 texture) {
+    if (unit >= maxTextureUnits) {
+        ++issued_;
+        glBindTextureUnit(unit, texture);
+    } else if (Changed(textures_[unit], texture)) {
+        glBindTextureUnit(unit, texture);
+    }
+}
+
+void StateCache::Uniform(u32 program, i32 location, f32 x) {
+    if (UniformChanged(program, location, &x, sizeof(x))) {
+        glProgramUniform1f(program, location, x);
+    }
+}
+
+void StateCache::Uniform(u32 program, i32 location, f32 x, f32 y, f32 z) {
+    const f32 value[3] = { x, y, z };
+    if (UniformChanged(program, location, value, sizeof(value))) {
+        glProgramUniform3f(program, location, x, y, z);
+    }
+}
+
+void StateCache::UniformMatrix(u32 program, i32 location, const f32 *matrix) {
+    if (UniformChanged(program, location, matrix, 16 * sizeof(f32))) {
+        glProgramUniformMatrix4fv(program, location, 1, GL_FALSE, matrix);
+    }
+}
+
+void StateCache::DeleteProgram(u32 program) {
+    if (program == 0) return;
+    glDeleteProgram(program);
+    if (program_ == program) program_ = unknown;
+    std::erase_if(uniforms_, [program](const auto &uniform) { return uniform.first >> 32 == program; });
+}
+
+void StateCache::DeleteVertexArray(u32 vao) {
+    if (vao == 0) return;
+    glDeleteVertexArrays(1, &vao);
+    if (vao_ == vao) vao_ = unknown;
+}
+
+void StateCache::DeleteBuffer(u32 buffer) {
+    if (buffer == 0) return;
+    glDeleteBuffers(1, &buffer);
+    std::replace(std::begin(buffers_), std::end(buffers_), buffer, unknown);
+}
+
+void StateCache::DeleteTexture(u32 texture) {
+    if (texture == 0) return;
+    glDeleteTextures(1, &texture);
+    std::replace(std::begin(textures_), std::end(textures_), texture, unknown);
+}
+
+void StateCache::Invalidate() {
+    program_ = unknown;
+    vao_ = unknown;
+    std::fill(std::begin(buffers_), std::end(buffers_), unknown);
+    std::fill(std::begin(textures_), std::end(textures_), unknown);
+    uniforms_.clear();
+}
+
+u32 StateCache::TargetIndex(GLenum target) {
+    switch (target) {
+        case GL_ARRAY_BUFFER:           return 0;
+        case GL_DRAW_INDIRECT_BUFFER:   return 1;
+        case GL_UNIFORM_BUFFER:         return 2;
+        case GL_SHADER_STORAGE_BUFFER:  return 3;
+        case GL_COPY_READ_BUFFER:       return 4;
+        case GL_COPY_WRITE_BUFFER:      return 5;
+        case GL_PIXEL_PACK_BUFFER:      return 6;
+        case GL_PIXEL_UNPACK_BUFFER:    return 7;
+        default:                        return unknown; // Element buffer belongs to the vertex array
+    }
+}
+
+bool StateCache::Changed(u32 &cached, u32 value) {
+    if (cached == value) {
+        ++filtered_;
+        return false;
+    }
+    cached = value;
+    ++issued_;
+    return true;
+}
+
+bool StateCache::UniformChanged(u32 program, i32 location, const void *data, u32 size) {
+    if (location < 0) {
+        ++filtered_;
+        return false;
+    }
+    UniformValue &cached = uniforms_[((u64)program << 32) | (u32)location];
+    if (cached.size == size and std::memcmp(cached.data, data, size) == 0) {
+        ++filtered_;
+        return false;
+    }
+    std::memcpy(cached.data, data, size);
+    cached.size = size;
+    ++issued_;
+    return true;
+}
+
+}
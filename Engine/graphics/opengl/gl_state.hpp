@@ -0,0 +1,85 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file gl_state.hpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief OpenGL state cache
+ *
+ * Keeps the bound program, vertex array, buffers, textures and the last value of every
+ * uniform, calls that would set what is already set never reach the driver. Uniforms go
+ * through glProgramUniform, so they are cached per program and don't depend on the bound
+ * one.
+ *
+ * The cache only knows about changes made through it. Objects must be deleted through it
+ * too, names of deleted objects are reused by the driver. Anything touching state behind
+ * its back (third party renderers like ImGui) must call Invalidate afterwards.
+ */
+
+#pragma once
+
+#include "common/common.hpp"
+
+#include "GL/glew.h"
+
+#include <unordered_map>
+
+namespace reveal3d::graphics::opengl {
+
+class StateCache {
+public:
+    static constexpr u32 maxTextureUnits = 16;
+
+    StateCache() { Invalidate(); }
+
+    void UseProgram(u32 program);
+    void BindVertexArray(u32 vao);
+    void BindBuffer(GLenum target, u32 buffer);
+    void BindTexture(u32 unit, u32 texture);
+
+    void Uniform(u32 program, i32 location, f32 x);
+    void Uniform(u32 program, i32 location, f32 x, f32 y, f32 z);
+    void UniformMatrix(u32 program, i32 location, const f32 *matrix);
+
+    void DeleteProgram(u32 program);
+    void DeleteVertexArray(u32 vao);
+    void DeleteBuffer(u32 buffer);
+    void DeleteTexture(u32 texture);
+
+    // Forgets everything, next calls always reach the driver
+    void Invalidate();
+    INLINE void ResetCounters() { issued_ = 0; filtered_ = 0; }
+
+    [[nodiscard]] INLINE u32 Issued() const { return issued_; }
+    [[nodiscard]] INLINE u32 Filtered() const { return filtered_; }
+
+private:
+    static constexpr u32 unknown = UINT_MAX;
+    static constexpr u32 bufferTargets = 8;
+    static constexpr u32 maxUniformSize = 16 * sizeof(f32);
+
+    struct UniformValue {
+        u8 data[maxUniformSize];
+        u32 size { 0 };
+    };
+
+    static u32 TargetIndex(GLenum target);
+    // True when value differs from the cached one, which is then updated
+    bool Changed(u32 &cached, u32 value);
+    bool UniformChanged(u32 program, i32 location, const void *data, u32 size);
+
+    u32 program_;
+    u32 vao_;
+    u32 buffers_[bufferTargets];
+    u32 textures_[maxTextureUnits];
+    std::unordered_map<u64, UniformValue> uniforms_; // Program in high bits, location in low bits
+    u32 issued_ { 0 };
+    u32 filtered_ { 0 };
+};
+
+// Cache of the current context
+extern StateCache state;
+
+}
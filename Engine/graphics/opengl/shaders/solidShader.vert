@@ -3,16 +3,16 @@
 layout (location = 0) in vec3 inPosition; 
 layout (location = 1) in vec4 inColor;
 layout (location = 2) in vec3 inNormal;
+layout (location = 3) in mat4 inWorld; // Per instance, stored transposed so vectors multiply on the left
 
 out vec4 passColor;
 out vec3 passNormal;
 
 uniform mat4 vp;
-uniform mat4 model;
 
 void main()
 {
-	gl_Position = vp * model * vec4(inPosition, 1.0);
+	gl_Position = vp * (vec4(inPosition, 1.0) * inWorld);
 	passColor = inColor;
-	passNormal = mat3(model) * inNormal;
-}
\ No newline at end of file
+	passNormal = inNormal * mat3(inWorld);
+}
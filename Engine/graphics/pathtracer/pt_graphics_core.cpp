@@ -0,0 +1,119 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file pt_graphics_core.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief CPU path tracing backend
+ *
+ * Longer description
+ */
+
+#include "pt_graphics_core.hpp"
+
+#include "core/scene.hpp"
+#include "common/profiler.hpp"
+
+namespace reveal3d::graphics {
+
+using namespace pathtracer;
+
+PathTracer::PathTracer(window::Resolution *res) : resolution_(res) {
+
+}
+
+void PathTracer::LoadPipeline() {
+    tracer_.Resize(resolution_->width, resolution_->height);
+}
+
+void PathTracer::LoadAssets() {
+    PROFILE_SCOPE("PathTracer::LoadAssets");
+    for (u32 i = 0; i < core::scene.NumEntities(); ++i) {
+        CreateRenderElement(i);
+    }
+}
+
+void PathTracer::Update(render::Camera &camera, render::RenderWorld &world) {
+    bool added = false;
+    auto &geometries = core::scene.Geometries();
+    for (u32 i = 0; i < core::scene.NumEntities(); ++i) {
+        if (!geometries[i].OnGpu())
+            added = CreateRenderElement(i) or added;
+    }
+
+    // New elements can move the shared arrays, items point into them
+    if (added or !world.Updated().empty() or world.Count() != proxyCount_) {
+        BuildScene(world);
+    }
+    tracer_.SetCamera(camera.GetFrustum());
+}
+
+void PathTracer::PrepareRender() {
+    PROFILE_SCOPE("PathTracer::PrepareRender");
+
+}
+
+void PathTracer::Draw() {
+    tracer_.Trace();
+    ++frame_;
+}
+
+void PathTracer::Terminate() {
+    renderElements_.clear();
+    vertices_.clear();
+    indices_.clear();
+    bvhs_.clear();
+    tracer_.SetScene({});
+    proxyCount_ = 0;
+}
+
+void PathTracer::Resize(const window::Resolution &res) {
+    tracer_.Resize(res.width, res.height);
+}
+
+// Like the software backend, plus the BVH of every sub mesh. Returns true if geometry was added
+bool PathTracer::CreateRenderElement(u32 index) {
+    core::Geometry &geometry = core::scene.GetEntity(index).Geometry();
+    geometry.MarkAsStored();
+    bool added = false;
+    if (geometry.RenderInfo() == UINT_MAX) {
+        renderElements_.push_back({ (u32)vertices_.size(), (u32)indices_.size() });
+        vertices_.insert(vertices_.end(), geometry.GetVerticesStart(), geometry.GetVerticesStart() + geometry.VertexCount());
+        indices_.insert(indices_.end(), geometry.GetIndicesStart(), geometry.GetIndicesStart() + geometry.IndexCount());
+        geometry.SetRenderInfo(renderElements_.size() - 1U);
+        added = true;
+    }
+    auto &subMeshes = geometry.SubMeshes();
+    for (u32 i = 0; i < subMeshes.size(); ++i) {
+        subMeshes[i].renderInfo = geometry.RenderInfo();
+        subMeshes[i].constantIndex = index;
+        bvhs_[((u64)geometry.RenderInfo() << 32) | subMeshes[i].indexPos] = &geometry.Bvh(i);
+    }
+    return added;
+}
+
+// Every visible proxy is traced, culling doesn't apply to shadows and bounces
+void PathTracer::BuildScene(const render::RenderWorld &world) {
+    std::vector<TraceItem> items;
+    items.reserve(world.Count());
+    for (const render::Proxy &proxy : world.Proxies()) {
+        if (!proxy.visible or proxy.mesh == UINT_MAX or proxy.shader == render::grid) continue;
+        const auto bvh = bvhs_.find(((u64)proxy.mesh << 32) | proxy.indexPos);
+        if (bvh == bvhs_.end()) continue;
+
+        const RenderElement &element = renderElements_[proxy.mesh];
+        TraceItem &item = items.emplace_back();
+        item.bvh = bvh->second;
+        item.vertices = &vertices_[element.baseVertex + proxy.vertexPos];
+        item.indices = &indices_[element.firstIndex + proxy.indexPos];
+        item.instance = { proxy.world, proxy.color };
+        item.bounds = proxy.bounds;
+        item.shader = proxy.shader;
+    }
+    tracer_.SetScene(std::move(items));
+    proxyCount_ = world.Count();
+}
+
+}
@@ -0,0 +1,67 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file pt_graphics_core.hpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief CPU path tracing backend
+ *
+ * Path traces the opaque and flat layers into an in memory framebuffer, converging
+ * while the camera and the scene don't change. Scene is a two level BVH: sub meshes use
+ * the triangle BVH their mesh already has, shared by every entity using it, and the
+ * proxies of the render world are placed on top with their world matrices. The grid
+ * layer is not traced.
+ */
+
+#pragma once
+
+#include "pt_tracer.hpp"
+
+#include "render/camera.hpp"
+#include "render/render_world.hpp"
+#include "window/window_info.hpp"
+
+#include <unordered_map>
+
+namespace reveal3d::graphics {
+
+class PathTracer {
+public:
+    explicit PathTracer(window::Resolution *res);
+    void LoadPipeline();
+    void LoadAssets();
+    void Update(render::Camera &camera, render::RenderWorld &world);
+    void PrepareRender();
+    void Draw();
+    void Terminate();
+    void Resize(const window::Resolution &res);
+
+    INLINE void SetWindow(WHandle wHandle) {}
+    [[nodiscard]] INLINE const software::Framebuffer& Target() const { return tracer_.Target(); }
+    // Samples per pixel accumulated since the view or the scene changed
+    [[nodiscard]] INLINE u32 Samples() const { return tracer_.Samples(); }
+    [[nodiscard]] INLINE u64 Rays() const { return tracer_.Rays(); }
+    [[nodiscard]] INLINE u32 Frame() const { return frame_; }
+
+private:
+    struct RenderElement {
+        u32 baseVertex;
+        u32 firstIndex;
+    };
+
+    bool CreateRenderElement(u32 index);
+    void BuildScene(const render::RenderWorld &world);
+
+    window::Resolution *resolution_;
+    std::vector<RenderElement> renderElements_;
+    memory::Vector<render::Vertex, memory::buffers> vertices_;
+    memory::Vector<u32, memory::buffers> indices_;
+    std::unordered_map<u64, const spatial::TriangleBvh *> bvhs_; // Render element and index start to sub mesh BVH
+    pathtracer::Tracer tracer_;
+    u32 proxyCount_ { 0 };
+    u32 frame_ { 0 };
+};
+
+}
@@ -0,0 +1,363 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file pt_tracer.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Progressive CPU path tracer
+ *
+ * Longer description
+ */
+
+#include "pt_tracer.hpp"
+#include "common/job_system.hpp"
+#include "config/config.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+
+namespace reveal3d::graphics::pathtracer {
+
+namespace {
+
+// Lighting of the OpenGL solid shader, light colors are white
+constexpr f32 skyIntensity = 0.7f;
+constexpr f32 sunIntensity = 0.9f;
+const f32 sunLength = std::sqrt(0.5f * 0.5f + 1.0f);
+const f32 sunDirection[3] = { 0.0f, 0.5f / sunLength, -1.0f / sunLength };
+
+constexpr f32 pi = 3.14159265f;
+
+INLINE u32 ToByte(f32 value) {
+    return (u32)(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+INLINE f32 Dot(const f32 *a, const f32 *b) {
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+INLINE void Normalize(f32 *v) {
+    const f32 length = std::sqrt(Dot(v, v));
+    if (length > 0.0f) {
+        v[0] /= length;
+        v[1] /= length;
+        v[2] /= length;
+    }
+}
+
+// PCG, seeded from the pixel and the pass so images don't depend on the workers
+struct Random {
+    explicit Random(u32 seed) : state(seed * 747796405U + 2891336453U) {}
+
+    INLINE f32 Next() {
+        state = state * 747796405U + 2891336453U;
+        u32 word = ((state >> ((state >> 28U) + 4U)) ^ state) * 277803737U;
+        word = (word >> 22U) ^ word;
+        return (f32)(word >> 8) * (1.0f / 16777216.0f);
+    }
+
+    u32 state;
+};
+
+INLINE u32 Hash(u32 value) {
+    value ^= value >> 16;
+    value *= 0x7feb352dU;
+    value ^= value >> 15;
+    value *= 0x846ca68bU;
+    value ^= value >> 16;
+    return value;
+}
+
+// Direction around the normal with density proportional to the cosine
+void CosineSample(const f32 *normal, Random &random, f32 *out) {
+    const f32 r = std::sqrt(random.Next());
+    const f32 phi = 2.0f * pi * random.Next();
+    const f32 x = r * std::cos(phi);
+    const f32 y = r * std::sin(phi);
+    const f32 z = std::sqrt(std::max(0.0f, 1.0f - x * x - y * y));
+
+    // Orthonormal basis without branches on the normal sign (Duff et al.)
+    const f32 sign = std::copysign(1.0f, normal[2]);
+    const f32 a = -1.0f / (sign + normal[2]);
+    const f32 b = normal[0] * normal[1] * a;
+    const f32 tangent[3] = { 1.0f + sign * normal[0] * normal[0] * a, sign * b, -sign * normal[0] };
+    const f32 bitangent[3] = { b, sign + normal[1] * normal[1] * a, -normal[1] };
+    for (u32 i = 0; i < 3; ++i) {
+        out[i] = tangent[i] * x + bitangent[i] * y + normal[i] * z;
+    }
+}
+
+} // Anonymous namespace
+
+void Tracer::Resize(u32 width, u32 height) {
+    width_ = width;
+    height_ = height;
+    target_.Resize(width, height, width);
+    accumulation_.assign(width * height * 3, 0.0f);
+
+    // Tiles nearest to the center first, so a partial pass shows the middle of the image
+    const u32 tilesX = (width + tileSize - 1) / tileSize;
+    const u32 tilesY = (height + tileSize - 1) / tileSize;
+    tiles_.resize(tilesX * tilesY);
+    for (u32 i = 0; i < tiles_.size(); ++i) {
+        tiles_[i] = i;
+    }
+    auto distance = [&](u32 tile) {
+        const f32 x = ((f32)(tile % tilesX) + 0.5f) * tileSize - (f32)width * 0.5f;
+        const f32 y = ((f32)(tile / tilesX) + 0.5f) * tileSize - (f32)height * 0.5f;
+        return x * x + y * y;
+    };
+    std::stable_sort(tiles_.begin(), tiles_.end(), [&](u32 a, u32 b) { return distance(a) < distance(b); });
+    Reset();
+}
+
+void Tracer::SetScene(std::vector<TraceItem> &&items) {
+    items_ = std::move(items);
+    std::vector<spatial::InstanceBvh::Instance> instances(items_.size());
+    for (u32 i = 0; i < items_.size(); ++i) {
+        instances[i].bvh = items_[i].bvh;
+        std::memcpy(instances[i].world, &items_[i].instance.world, sizeof(instances[i].world));
+        instances[i].bounds = spatial::ToAabb(items_[i].bounds);
+    }
+    scene_.Build(instances);
+    Reset();
+}
+
+/**
+ * Camera is taken from the clip rows: the eye is where x, y and w are 0, and the pixel
+ * ray is the line where x / w and y / w are the pixel coordinates. Only perspective
+ * projections have an eye, like the camera ones
+ */
+void Tracer::SetCamera(const render::Frustum &frustum) {
+    if (std::memcmp(clip_, frustum.clip, sizeof(clip_)) == 0) return;
+    std::memcpy(clip_, frustum.clip, sizeof(clip_));
+
+    const math::vec4 &a = clip_[0];
+    const math::vec4 &b = clip_[1];
+    const math::vec4 &c = clip_[3];
+    const f32 det = a.x * (b.y * c.z - b.z * c.y) - a.y * (b.x * c.z - b.z * c.x) + a.z * (b.x * c.y - b.y * c.x);
+    if (std::abs(det) > 1e-12f) {
+        const f32 r[3] = { -a.w, -b.w, -c.w };
+        eye_[0] = (r[0] * (b.y * c.z - b.z * c.y) - a.y * (r[1] * c.z - b.z * r[2]) + a.z * (r[1] * c.y - b.y * r[2])) / det;
+        eye_[1] = (a.x * (r[1] * c.z - b.z * r[2]) - r[0] * (b.x * c.z - b.z * c.x) + a.z * (b.x * r[2] - r[1] * c.x)) / det;
+        eye_[2] = (a.x * (b.y * r[2] - r[1] * c.y) - a.y * (b.x * r[2] - r[1] * c.x) + r[0] * (b.x * c.y - b.y * c.x)) / det;
+    }
+    Reset();
+}
+
+void Tracer::Reset() {
+    std::fill(accumulation_.begin(), accumulation_.end(), 0.0f);
+    samples_ = 0;
+}
+
+void Tracer::Trace() {
+    rays_.store(0, std::memory_order_relaxed);
+    ++samples_;
+    jobs::ParallelFor(tiles_.size(), 1, [&](u32 begin, u32 end) {
+        for (u32 i = begin; i < end; ++i) {
+            TraceTile(tiles_[i]);
+        }
+    });
+}
+
+void Tracer::TraceTile(u32 tile) {
+    const u32 tilesX = (width_ + tileSize - 1) / tileSize;
+    const u32 x0 = (tile % tilesX) * tileSize;
+    const u32 y0 = (tile / tilesX) * tileSize;
+    const u32 x1 = std::min(x0 + tileSize, width_);
+    const u32 y1 = std::min(y0 + tileSize, height_);
+
+    u64 rays = 0;
+    for (u32 y = y0; y < y1; y += 2) {
+        for (u32 x = x0; x < x1; x += 2) {
+            rays += TraceQuad(x, y);
+        }
+    }
+    rays_.fetch_add(rays, std::memory_order_relaxed);
+
+    const f32 scale = 1.0f / (f32)samples_;
+    for (u32 y = y0; y < y1; ++y) {
+        const f32 *sums = &accumulation_[(y * width_ + x0) * 3];
+        u32 *row = target_.ColorRow(y);
+        for (u32 x = x0; x < x1; ++x, sums += 3) {
+            row[x] = software::Framebuffer::Pack(ToByte(sums[0] * scale), ToByte(sums[1] * scale), ToByte(sums[2] * scale));
+        }
+    }
+}
+
+/**
+ * Lanes are the pixels of the quad. Every bounce traces the packet of live paths, then a
+ * packet of shadow rays towards the sun from the opaque hits. Returns the rays traced
+ */
+u64 Tracer::TraceQuad(u32 x, u32 y) {
+    const math::vec4 &clear = config::clearColor;
+    const f32 background[3] = { clear.x, clear.y, clear.z };
+
+    spatial::RayPacket packet;
+    f32 throughput[4][3];
+    f32 radiance[4][3] {};
+    Random random[4] = { Random(0), Random(0), Random(0), Random(0) };
+    u32 alive = 0;
+
+    for (u32 lane = 0; lane < 4; ++lane) {
+        const u32 px = x + (lane & 1);
+        const u32 py = y + (lane >> 1);
+        for (u32 i = 0; i < 3; ++i) {
+            packet.origin[i][lane] = eye_[i];
+            packet.direction[i][lane] = 0.0f;
+            throughput[lane][i] = 1.0f;
+        }
+        if (px >= width_ or py >= height_) continue;
+        alive |= 1U << lane;
+
+        random[lane] = Random(Hash(py * width_ + px) ^ Hash(samples_ * 0x9E3779B9U));
+        const f32 nx = ((f32)px + random[lane].Next()) / (f32)width_ * 2.0f - 1.0f;
+        const f32 ny = 1.0f - ((f32)py + random[lane].Next()) / (f32)height_ * 2.0f;
+        const f32 a[3] = { clip_[0].x - nx * clip_[3].x, clip_[0].y - nx * clip_[3].y, clip_[0].z - nx * clip_[3].z };
+        const f32 b[3] = { clip_[1].x - ny * clip_[3].x, clip_[1].y - ny * clip_[3].y, clip_[1].z - ny * clip_[3].z };
+        f32 direction[3] = { a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0] };
+        const f32 forward[3] = { clip_[3].x, clip_[3].y, clip_[3].z };
+        const f32 sign = Dot(direction, forward) < 0.0f ? -1.0f : 1.0f;
+        Normalize(direction);
+        for (u32 i = 0; i < 3; ++i) {
+            packet.direction[i][lane] = direction[i] * sign;
+        }
+    }
+    const u32 pixels = alive;
+    u64 rays = 0;
+
+    for (u32 bounce = 0; bounce <= maxBounces and alive != 0; ++bounce) {
+        spatial::SceneHit hit;
+        for (u32 lane = 0; lane < 4; ++lane) {
+            hit.distance[lane] = alive & (1U << lane) ? FLT_MAX : 0.0f;
+        }
+        scene_.RaycastPacket(packet, hit);
+        rays += std::popcount(alive);
+
+        spatial::RayPacket shadow = packet;
+        f32 sunLight[4][3];
+        u32 shadowed = 0;
+
+        for (u32 lane = 0; lane < 4; ++lane) {
+            if ((alive & (1U << lane)) == 0) continue;
+
+            if (hit.instance[lane] == UINT_MAX) {
+                for (u32 i = 0; i < 3; ++i) {
+                    radiance[lane][i] += throughput[lane][i] * (bounce == 0 ? background[i] : skyIntensity);
+                }
+                alive &= ~(1U << lane);
+                continue;
+            }
+
+            Surface surface = Shade(hit, lane);
+            if (surface.emissive) {
+                for (u32 i = 0; i < 3; ++i) {
+                    radiance[lane][i] += throughput[lane][i] * surface.color[i];
+                }
+                alive &= ~(1U << lane);
+                continue;
+            }
+
+            // Both faces are lit, the normal is turned towards the ray
+            const f32 direction[3] = { packet.direction[0][lane], packet.direction[1][lane], packet.direction[2][lane] };
+            if (Dot(surface.normal, direction) > 0.0f) {
+                for (f32 &n : surface.normal) n = -n;
+            }
+            f32 position[3];
+            f32 largest = 1.0f;
+            for (u32 i = 0; i < 3; ++i) {
+                position[i] = packet.origin[i][lane] + direction[i] * hit.distance[lane];
+                largest = std::max(largest, std::abs(position[i]));
+            }
+            // Moved off the surface relative to its magnitude so new rays don't hit it again
+            for (u32 i = 0; i < 3; ++i) {
+                position[i] += surface.normal[i] * largest * 1e-4f;
+            }
+
+            const f32 cosine = Dot(surface.normal, sunDirection);
+            if (cosine > 0.0f) {
+                for (u32 i = 0; i < 3; ++i) {
+                    sunLight[lane][i] = throughput[lane][i] * surface.color[i] * sunIntensity * cosine;
+                    shadow.origin[i][lane] = position[i];
+                    shadow.direction[i][lane] = sunDirection[i];
+                }
+                shadowed |= 1U << lane;
+            }
+
+            // Cosine sampling cancels the cosine and pi of the lambertian bounce
+            f32 next[3];
+            CosineSample(surface.normal, random[lane], next);
+            for (u32 i = 0; i < 3; ++i) {
+                throughput[lane][i] *= surface.color[i];
+                packet.origin[i][lane] = position[i];
+                packet.direction[i][lane] = next[i];
+            }
+        }
+
+        if (shadowed != 0) {
+            spatial::SceneHit occluder;
+            for (u32 lane = 0; lane < 4; ++lane) {
+                occluder.distance[lane] = shadowed & (1U << lane) ? FLT_MAX : 0.0f;
+            }
+            const u32 blocked = scene_.RaycastPacket(shadow, occluder);
+            rays += std::popcount(shadowed);
+            for (u32 lane = 0; lane < 4; ++lane) {
+                if ((shadowed & ~blocked & (1U << lane)) == 0) continue;
+                for (u32 i = 0; i < 3; ++i) {
+                    radiance[lane][i] += sunLight[lane][i];
+                }
+            }
+        }
+    }
+
+    for (u32 lane = 0; lane < 4; ++lane) {
+        if ((pixels & (1U << lane)) == 0) continue;
+        f32 *sums = &accumulation_[((y + (lane >> 1)) * width_ + x + (lane & 1)) * 3];
+        for (u32 i = 0; i < 3; ++i) {
+            sums[i] += radiance[lane][i];
+        }
+    }
+    return rays;
+}
+
+// Interpolated vertex color times the instance one, normal in world space
+Tracer::Surface Tracer::Shade(const spatial::SceneHit &hit, u32 lane) const {
+    const TraceItem &item = items_[hit.instance[lane]];
+    const u32 *indices = &item.indices[hit.triangle[lane] * 3];
+    const render::Vertex &a = item.vertices[indices[0]];
+    const render::Vertex &b = item.vertices[indices[1]];
+    const render::Vertex &c = item.vertices[indices[2]];
+    const f32 u = hit.u[lane];
+    const f32 v = hit.v[lane];
+    const f32 w = 1.0f - u - v;
+    const f32 *world = (const f32 *) &item.instance.world;
+    const math::vec4 &tint = item.instance.color;
+
+    Surface surface;
+    surface.emissive = item.shader == render::flat;
+    surface.color[0] = (a.color.x * w + b.color.x * u + c.color.x * v) * tint.x;
+    surface.color[1] = (a.color.y * w + b.color.y * u + c.color.y * v) * tint.y;
+    surface.color[2] = (a.color.z * w + b.color.z * u + c.color.z * v) * tint.z;
+
+    f32 normal[3] = { a.normal.x * w + b.normal.x * u + c.normal.x * v,
+                      a.normal.y * w + b.normal.y * u + c.normal.y * v,
+                      a.normal.z * w + b.normal.z * u + c.normal.z * v };
+    if (Dot(normal, normal) == 0.0f) {
+        const f32 e1[3] = { b.pos.x - a.pos.x, b.pos.y - a.pos.y, b.pos.z - a.pos.z };
+        const f32 e2[3] = { c.pos.x - a.pos.x, c.pos.y - a.pos.y, c.pos.z - a.pos.z };
+        normal[0] = e1[1] * e2[2] - e1[2] * e2[1];
+        normal[1] = e1[2] * e2[0] - e1[0] * e2[2];
+        normal[2] = e1[0] * e2[1] - e1[1] * e2[0];
+    }
+    for (u32 i = 0; i < 3; ++i) {
+        surface.normal[i] = world[i * 4] * normal[0] + world[i * 4 + 1] * normal[1] + world[i * 4 + 2] * normal[2];
+    }
+    Normalize(surface.normal);
+    return surface;
+}
+
+}
@@ -0,0 +1,87 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file pt_tracer.hpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Progressive CPU path tracer
+ *
+ * Every pass adds one jittered sample to each pixel and resolves the running average,
+ * so the image converges while the camera and scene stay still. The image is split in
+ * square tiles, nearest to the center first, and every tile is a job of the job system.
+ * Pixels are traced in 2x2 quads, one ray packet per quad and bounce.
+ *
+ * Surfaces are lambertian and use the lights of the OpenGL solid shader: the sun is
+ * traced with a shadow ray and the ambient term becomes a sky of the same intensity
+ * reached by the bounces. Flat surfaces emit their color. Camera rays that miss show
+ * the clear color.
+ */
+
+#pragma once
+
+#include "graphics/software/sw_rasterizer.hpp"
+#include "spatial/instance_bvh.hpp"
+
+#include <atomic>
+#include <vector>
+
+namespace reveal3d::graphics::pathtracer {
+
+// Sub mesh placed with the world and color of an instance
+struct TraceItem {
+    const spatial::TriangleBvh *bvh { nullptr };
+    const render::Vertex *vertices { nullptr };
+    const u32 *indices { nullptr };     // Relative to vertices, bvh triangles follow them
+    render::Instance instance;
+    render::Bounds bounds;              // World space
+    render::Shader shader { render::opaque };
+};
+
+class Tracer {
+public:
+    static constexpr u32 tileSize = 16;
+    static constexpr u32 maxBounces = 4;
+
+    void Resize(u32 width, u32 height);
+    // Builds the instance BVH over the items and restarts accumulation
+    void SetScene(std::vector<TraceItem> &&items);
+    // Restarts accumulation when the view changed
+    void SetCamera(const render::Frustum &frustum);
+    void Reset();
+    // Adds one sample to every pixel and resolves the target
+    void Trace();
+
+    [[nodiscard]] INLINE const software::Framebuffer& Target() const { return target_; }
+    [[nodiscard]] INLINE u32 Samples() const { return samples_; }
+    // Rays traced in last pass, shadow rays included
+    [[nodiscard]] INLINE u64 Rays() const { return rays_.load(std::memory_order_relaxed); }
+    [[nodiscard]] INLINE u32 TileCount() const { return tiles_.size(); }
+    [[nodiscard]] INLINE u32 ItemCount() const { return items_.size(); }
+
+private:
+    struct Surface {
+        f32 color[3];
+        f32 normal[3];
+        bool emissive;
+    };
+
+    void TraceTile(u32 tile);
+    u64 TraceQuad(u32 x, u32 y);
+    Surface Shade(const spatial::SceneHit &hit, u32 lane) const;
+
+    std::vector<TraceItem> items_;
+    spatial::InstanceBvh scene_;
+    software::Framebuffer target_;
+    memory::Vector<f32, memory::buffers> accumulation_; // Sum of the samples, RGB per pixel
+    std::vector<u32> tiles_;                             // Center first
+    math::vec4 clip_[4] {};
+    f32 eye_[3] {};
+    u32 width_ { 0 };
+    u32 height_ { 0 };
+    u32 samples_ { 0 };
+    std::atomic<u64> rays_ { 0 };
+};
+
+}
@@ -0,0 +1,122 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file sw_graphics_core.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief CPU backend rendering to memory
+ *
+ * Longer description
+ */
+
+#include "sw_graphics_core.hpp"
+
+#include "core/scene.hpp"
+#include "common/profiler.hpp"
+
+#include <algorithm>
+
+namespace reveal3d::graphics {
+
+using namespace software;
+
+Software::Software(window::Resolution *res) : resolution_(res) {
+
+}
+
+void Software::LoadPipeline() {
+    rasterizer_.Resize(resolution_->width, resolution_->height);
+}
+
+void Software::LoadAssets() {
+    PROFILE_SCOPE("Software::LoadAssets");
+    for (u32 i = 0; i < core::scene.NumEntities(); ++i) {
+        CreateRenderElement(i);
+    }
+}
+
+void Software::Update(render::Camera &camera, render::RenderWorld &world) {
+    frustum_ = camera.GetFrustum();
+    renderWorld_ = &world;
+
+    auto &geometries = core::scene.Geometries();
+    for (u32 i = 0; i < core::scene.NumEntities(); ++i) {
+        if (!geometries[i].OnGpu())
+            CreateRenderElement(i);
+    }
+}
+
+void Software::PrepareRender() {
+    PROFILE_SCOPE("Software::PrepareRender");
+    rasterizer_.Clear();
+}
+
+// Batches are already sorted nearest first, so most hidden pixels fail the depth test before shading
+void Software::Draw() {
+    if (renderWorld_ != nullptr) {
+        const std::vector<render::Instance> &instances = renderWorld_->Instances();
+        for (const render::Shader shader : { render::opaque, render::flat }) {
+            for (const render::InstanceBatch &batch : renderWorld_->Batches(shader)) {
+                const RenderElement &element = renderElements_[batch.mesh];
+                DrawItem item;
+                item.vertices = &vertices_[element.baseVertex + batch.vertexPos];
+                item.indices = &indices_[element.firstIndex + batch.indexPos];
+                item.vertexCount = SubMeshVertices(batch);
+                item.indexCount = batch.indexCount;
+                item.shader = shader;
+                for (u32 i = batch.first; i < batch.first + batch.count; ++i) {
+                    item.instance = &instances[i];
+                    rasterizer_.Submit(item);
+                }
+            }
+        }
+        rasterizer_.SetGrid(!renderWorld_->Batches(render::grid).empty());
+    }
+    rasterizer_.Render(frustum_);
+    ++frame_;
+}
+
+void Software::Terminate() {
+    renderElements_.clear();
+    vertices_.clear();
+    indices_.clear();
+    subMeshVertices_.clear();
+    rasterizer_.Clear();
+    renderWorld_ = nullptr;
+}
+
+void Software::Resize(const window::Resolution &res) {
+    rasterizer_.Resize(res.width, res.height);
+}
+
+// Geometry is appended to two shared arrays, entities sharing geometry share its element
+void Software::CreateRenderElement(u32 index) {
+    core::Geometry &geometry = core::scene.GetEntity(index).Geometry();
+    geometry.MarkAsStored();
+    if (geometry.RenderInfo() == UINT_MAX) {
+        renderElements_.push_back({ (u32)vertices_.size(), (u32)indices_.size() });
+        vertices_.insert(vertices_.end(), geometry.GetVerticesStart(), geometry.GetVerticesStart() + geometry.VertexCount());
+        indices_.insert(indices_.end(), geometry.GetIndicesStart(), geometry.GetIndicesStart() + geometry.IndexCount());
+        geometry.SetRenderInfo(renderElements_.size() - 1U);
+    }
+    for (auto &subMesh : geometry.SubMeshes()) {
+        subMesh.renderInfo = geometry.RenderInfo();
+        subMesh.constantIndex = index;
+    }
+}
+
+// Sub meshes only store their index range, vertices used go up to the largest index
+u32 Software::SubMeshVertices(const render::InstanceBatch &batch) {
+    const u64 key = ((u64)batch.mesh << 32) | batch.indexPos;
+    auto it = subMeshVertices_.find(key);
+    if (it == subMeshVertices_.end()) {
+        const u32 *indices = &indices_[renderElements_[batch.mesh].firstIndex + batch.indexPos];
+        const u32 count = batch.indexCount == 0 ? 0 : *std::max_element(indices, indices + batch.indexCount) + 1;
+        it = subMeshVertices_.emplace(key, count).first;
+    }
+    return it->second;
+}
+
+}
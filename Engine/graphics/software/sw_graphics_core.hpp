@@ -0,0 +1,66 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file sw_graphics_core.hpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief CPU backend rendering to memory
+ *
+ * Renders the opaque, flat and grid layers without GPU, for machines without one (render
+ * farms, CI). Geometry is kept in two shared arrays like the other backends buffers,
+ * every instance of a batch becomes a draw of the tiled rasterizer. The image stays in
+ * an in memory framebuffer that can be saved to a file.
+ */
+
+#pragma once
+
+#include "sw_rasterizer.hpp"
+
+#include "render/camera.hpp"
+#include "render/render_world.hpp"
+#include "window/window_info.hpp"
+
+#include <unordered_map>
+
+namespace reveal3d::graphics {
+
+class Software {
+public:
+    explicit Software(window::Resolution *res);
+    void LoadPipeline();
+    void LoadAssets();
+    void Update(render::Camera &camera, render::RenderWorld &world);
+    void PrepareRender();
+    void Draw();
+    void Terminate();
+    void Resize(const window::Resolution &res);
+
+    INLINE void SetWindow(WHandle wHandle) {}
+    [[nodiscard]] INLINE const software::Framebuffer& Target() const { return rasterizer_.Target(); }
+    // Triangles drawn in last frame, after near plane clipping
+    [[nodiscard]] INLINE u32 Triangles() const { return rasterizer_.Triangles(); }
+    [[nodiscard]] INLINE u32 Frame() const { return frame_; }
+
+private:
+    struct RenderElement {
+        u32 baseVertex;
+        u32 firstIndex;
+    };
+
+    void CreateRenderElement(u32 index);
+    u32 SubMeshVertices(const render::InstanceBatch &batch);
+
+    window::Resolution *resolution_;
+    std::vector<RenderElement> renderElements_;
+    memory::Vector<render::Vertex, memory::buffers> vertices_;
+    memory::Vector<u32, memory::buffers> indices_;
+    std::unordered_map<u64, u32> subMeshVertices_; // Render element and index start to vertex count
+    const render::RenderWorld *renderWorld_ { nullptr };
+    render::Frustum frustum_ {};
+    software::Rasterizer rasterizer_;
+    u32 frame_ { 0 };
+};
+
+}
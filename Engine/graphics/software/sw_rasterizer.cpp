@@ -0,0 +1,581 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file sw_rasterizer.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Tiled CPU rasterizer
+ *
+ * Longer description
+ */
+
+#include "sw_rasterizer.hpp"
+#include "common/job_system.hpp"
+#include "config/config.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+#ifdef REVEAL3D_SSE
+#include <emmintrin.h>
+#endif
+
+namespace reveal3d::graphics::software {
+
+namespace {
+
+constexpr f32 minW = 1e-4f;
+
+// Lighting of the OpenGL solid shader, light colors are white
+constexpr f32 ambientIntensity = 0.7f;
+constexpr f32 sunIntensity = 0.9f;
+const f32 sunLength = std::sqrt(0.5f * 0.5f + 1.0f);
+const f32 sunDirection[3] = { 0.0f, 0.5f / sunLength, -1.0f / sunLength };
+
+// Grid shader, fading uses the linear depth of its 0.01 to 25 range
+constexpr f32 gridFarZ = 25.0f;
+
+INLINE u32 ToByte(f32 value) {
+    return (u32)(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+INLINE f32 Fraction(f32 value) {
+    return value - std::floor(value);
+}
+
+/**
+ * Pixels of a row inside the triangle, solved from the edge functions. Rounded outwards,
+ * pixels are still tested against the edges so the span only has to contain them
+ */
+bool RowSpan(const f32 edgeA[3], const f32 edgeB[3], const f32 edgeC[3], f32 py, i32 minX, i32 maxX, u32 &begin, u32 &end) {
+    f32 spanMin = (f32)minX;
+    f32 spanMax = (f32)maxX;
+    for (u32 i = 0; i < 3; ++i) {
+        const f32 a = edgeA[i];
+        const f32 rowValue = edgeB[i] * py + edgeC[i];
+        if (a > 0.0f) {
+            spanMin = std::max(spanMin, std::floor(-rowValue / a - 0.5f));
+        } else if (a < 0.0f) {
+            spanMax = std::min(spanMax, std::ceil(-rowValue / a - 0.5f));
+        } else if (rowValue < 0.0f) {
+            return false;
+        }
+    }
+    if (spanMin > spanMax) return false;
+    begin = (u32)spanMin;
+    end = (u32)spanMax + 1;
+    return true;
+}
+
+// Adds one resolution of the grid shader pattern, d are the screen space derivatives of x and y
+void AddGrid(f32 x, f32 y, f32 dx, f32 dy, f32 scale, f32 gray, f32 color[4]) {
+    const f32 derivativeX = std::max(dx * scale, 1e-6f);
+    const f32 derivativeY = std::max(dy * scale, 1e-6f);
+    const f32 lineX = std::abs(Fraction(x * scale - 0.5f) - 0.5f) / derivativeX;
+    const f32 lineY = std::abs(Fraction(y * scale - 0.5f) - 0.5f) / derivativeY;
+
+    f32 grid[4] = { gray, gray, gray, 1.0f - std::min(std::min(lineX, lineY), 1.0f) };
+    if (std::abs(x) < 0.1f * std::min(derivativeX, 1.0f)) grid[2] = 1.0f; // y axis
+    if (std::abs(y) < 0.1f * std::min(derivativeY, 1.0f)) grid[0] = 1.0f; // x axis
+    for (u32 i = 0; i < 4; ++i) {
+        color[i] += grid[i];
+    }
+}
+
+}
+
+void Framebuffer::Resize(u32 width, u32 height, u32 stride) {
+    width_ = width;
+    height_ = height;
+    stride_ = stride;
+    color_.assign(stride * height, 0);
+    depth_.assign(stride * height, 0.0f);
+}
+
+bool Framebuffer::Save(const char *path) const {
+    std::ofstream file(path, std::ios::binary);
+    if (!file.good()) {
+        LOG(logERROR) << "Could not write image " << path;
+        return false;
+    }
+    file << "P6\n" << width_ << " " << height_ << "\n255\n";
+    std::vector<u8> row(width_ * 3);
+    for (u32 y = 0; y < height_; ++y) {
+        for (u32 x = 0; x < width_; ++x) {
+            const u32 color = color_[y * stride_ + x];
+            row[x * 3] = color & 0xFF;
+            row[x * 3 + 1] = (color >> 8) & 0xFF;
+            row[x * 3 + 2] = (color >> 16) & 0xFF;
+        }
+        file.write((const char *) row.data(), row.size());
+    }
+    return file.good();
+}
+
+void Rasterizer::Resize(u32 width, u32 height) {
+    tilesX_ = (width + tileWidth - 1) / tileWidth;
+    tilesY_ = (height + tileHeight - 1) / tileHeight;
+    target_.Resize(width, height, tilesX_ * tileWidth);
+}
+
+void Rasterizer::Clear() {
+    draws_.clear();
+}
+
+void Rasterizer::Render(const render::Frustum &frustum) {
+    std::copy(std::begin(frustum.clip), std::end(frustum.clip), clip_);
+
+    // Chunk bounds only depend on the draws, not on the number of workers
+    chunkCount_ = 0;
+    u32 triangles = 0;
+    for (u32 i = 0; i < draws_.size(); ++i) {
+        if (chunkCount_ == 0 or triangles >= chunkTriangles) {
+            if (chunks_.size() == chunkCount_) chunks_.emplace_back();
+            chunks_[chunkCount_++].firstDraw = i;
+            triangles = 0;
+        }
+        chunks_[chunkCount_ - 1].endDraw = i + 1;
+        triangles += draws_[i].indexCount / 3;
+    }
+
+    jobs::ParallelFor(chunkCount_, 1, [&](u32 begin, u32 end) {
+        for (u32 chunk = begin; chunk < end; ++chunk) {
+            SetupChunk(chunks_[chunk]);
+        }
+    });
+
+    // Tiles never share pixels, no synchronization needed
+    jobs::ParallelFor(TileCount(), 1, [&](u32 begin, u32 end) {
+        for (u32 tile = begin; tile < end; ++tile) {
+            RasterizeTile(tile);
+        }
+    });
+}
+
+u32 Rasterizer::Triangles() const {
+    u32 triangles = 0;
+    for (u32 i = 0; i < chunkCount_; ++i) {
+        triangles += chunks_[i].triangles.size();
+    }
+    return triangles;
+}
+
+/**
+ * Vertices of every draw are projected once, triangles fully in front of the near plane
+ * use them directly. The near plane is z = -w, on DirectX clip space it keeps a bit more
+ * than the view frustum, w stays positive in both conventions
+ */
+void Rasterizer::SetupChunk(Chunk &chunk) {
+    chunk.screen.clear();
+    chunk.triangles.clear();
+    chunk.bins.resize(TileCount());
+    for (auto &bin : chunk.bins) {
+        bin.clear();
+    }
+
+    for (u32 i = chunk.firstDraw; i < chunk.endDraw; ++i) {
+        const DrawItem &item = draws_[i];
+        const bool lit = item.shader == render::opaque;
+        Transform(item, chunk);
+        const u32 base = chunk.screen.size();
+        for (const ClipVertex &vertex : chunk.clip) {
+            Project(vertex, chunk);
+        }
+
+        for (u32 index = 0; index + 2 < item.indexCount; index += 3) {
+            const u32 *triangle = &item.indices[index];
+            const ClipVertex *vertices[3] = { &chunk.clip[triangle[0]], &chunk.clip[triangle[1]], &chunk.clip[triangle[2]] };
+            u32 inFront = 0;
+            for (const ClipVertex *vertex : vertices) {
+                inFront += vertex->position[2] + vertex->position[3] >= 0.0f;
+            }
+            if (inFront == 3) {
+                Bin(base + triangle[0], base + triangle[1], base + triangle[2], lit, chunk);
+            } else if (inFront > 0) {
+                ClipTriangle(vertices, lit, chunk);
+            }
+        }
+    }
+}
+
+// World matrices keep translation in w of the first three rows, they are folded into the clip rows
+void Rasterizer::Transform(const DrawItem &item, Chunk &chunk) const {
+    const math::mat4 &world = item.instance->world;
+    const math::xvec4 rows[3] = { world.GetX(), world.GetY(), world.GetZ() };
+    f32 w[3][4];
+    for (u32 i = 0; i < 3; ++i) {
+        w[i][0] = rows[i].GetX();
+        w[i][1] = rows[i].GetY();
+        w[i][2] = rows[i].GetZ();
+        w[i][3] = rows[i].GetW();
+    }
+    f32 m[4][4];
+    for (u32 k = 0; k < 4; ++k) {
+        for (u32 j = 0; j < 4; ++j) {
+            m[k][j] = clip_[k].x * w[0][j] + clip_[k].y * w[1][j] + clip_[k].z * w[2][j] + (j == 3 ? clip_[k].w : 0.0f);
+        }
+    }
+
+    const math::vec4 &tint = item.instance->color;
+    chunk.clip.resize(item.vertexCount);
+
+#ifdef REVEAL3D_SSE
+    __m128 columns[4];
+    __m128 normalColumns[3];
+    for (u32 j = 0; j < 4; ++j) {
+        columns[j] = _mm_setr_ps(m[0][j], m[1][j], m[2][j], m[3][j]);
+    }
+    for (u32 j = 0; j < 3; ++j) {
+        normalColumns[j] = _mm_setr_ps(w[0][j], w[1][j], w[2][j], 0.0f);
+    }
+    const __m128 tint4 = _mm_setr_ps(tint.x, tint.y, tint.z, tint.w);
+
+    for (u32 i = 0; i < item.vertexCount; ++i) {
+        const render::Vertex &vertex = item.vertices[i];
+        ClipVertex &out = chunk.clip[i];
+
+        const __m128 position = _mm_add_ps(_mm_add_ps(_mm_mul_ps(columns[0], _mm_set1_ps(vertex.pos.x)),
+                                                      _mm_mul_ps(columns[1], _mm_set1_ps(vertex.pos.y))),
+                                           _mm_add_ps(_mm_mul_ps(columns[2], _mm_set1_ps(vertex.pos.z)), columns[3]));
+        const __m128 normal = _mm_add_ps(_mm_add_ps(_mm_mul_ps(normalColumns[0], _mm_set1_ps(vertex.normal.x)),
+                                                    _mm_mul_ps(normalColumns[1], _mm_set1_ps(vertex.normal.y))),
+                                         _mm_mul_ps(normalColumns[2], _mm_set1_ps(vertex.normal.z)));
+        _mm_store_ps(out.position, position);
+        _mm_store_ps(out.normal, normal);
+        _mm_store_ps(out.color, _mm_mul_ps(_mm_loadu_ps(&vertex.color.x), tint4));
+    }
+#else
+    const f32 tints[4] = { tint.x, tint.y, tint.z, tint.w };
+    for (u32 i = 0; i < item.vertexCount; ++i) {
+        const render::Vertex &vertex = item.vertices[i];
+        const f32 color[4] = { vertex.color.x, vertex.color.y, vertex.color.z, vertex.color.w };
+        ClipVertex &out = chunk.clip[i];
+        for (u32 k = 0; k < 4; ++k) {
+            out.position[k] = m[k][0] * vertex.pos.x + m[k][1] * vertex.pos.y + m[k][2] * vertex.pos.z + m[k][3];
+            out.normal[k] = k < 3 ? w[k][0] * vertex.normal.x + w[k][1] * vertex.normal.y + w[k][2] * vertex.normal.z : 0.0f;
+            out.color[k] = color[k] * tints[k];
+        }
+    }
+#endif
+}
+
+// Triangle with one or two vertices in front of the near plane becomes one or two triangles
+void Rasterizer::ClipTriangle(const ClipVertex *vertices[3], bool lit, Chunk &chunk) const {
+    ClipVertex polygon[4];
+    u32 count = 0;
+    for (u32 i = 0; i < 3; ++i) {
+        const ClipVertex &a = *vertices[i];
+        const ClipVertex &b = *vertices[(i + 1) % 3];
+        const f32 distanceA = a.position[2] + a.position[3];
+        const f32 distanceB = b.position[2] + b.position[3];
+        if (distanceA >= 0.0f) {
+            polygon[count++] = a;
+        }
+        if ((distanceA >= 0.0f) != (distanceB >= 0.0f)) {
+            const f32 t = distanceA / (distanceA - distanceB);
+            ClipVertex &vertex = polygon[count++];
+            for (u32 k = 0; k < 4; ++k) {
+                vertex.position[k] = a.position[k] + (b.position[k] - a.position[k]) * t;
+                vertex.normal[k] = a.normal[k] + (b.normal[k] - a.normal[k]) * t;
+                vertex.color[k] = a.color[k] + (b.color[k] - a.color[k]) * t;
+            }
+        }
+    }
+
+    u32 indices[4];
+    for (u32 i = 0; i < count; ++i) {
+        indices[i] = Project(polygon[i], chunk);
+    }
+    Bin(indices[0], indices[1], indices[2], lit, chunk);
+    if (count == 4) {
+        Bin(indices[0], indices[2], indices[3], lit, chunk);
+    }
+}
+
+// Vertices behind the camera are projected too, triangles using them are never binned
+u32 Rasterizer::Project(const ClipVertex &vertex, Chunk &chunk) const {
+    const f32 invW = vertex.position[3] > minW ? 1.0f / vertex.position[3] : 0.0f;
+    ScreenVertex &screen = chunk.screen.emplace_back();
+    screen.x = (vertex.position[0] * invW * 0.5f + 0.5f) * (f32)target_.Width();
+    screen.y = (0.5f - vertex.position[1] * invW * 0.5f) * (f32)target_.Height();
+    screen.invW = invW;
+    for (u32 i = 0; i < 3; ++i) {
+        screen.attributes[i] = vertex.color[i] * invW;
+        screen.attributes[3 + i] = vertex.normal[i] * invW;
+    }
+    return chunk.screen.size() - 1;
+}
+
+// Winding is made consistent so both faces are drawn, as the other backends do
+void Rasterizer::Bin(u32 a, u32 b, u32 c, bool lit, Chunk &chunk) const {
+    const ScreenVertex &v0 = chunk.screen[a];
+    const ScreenVertex &v1 = chunk.screen[b];
+    const ScreenVertex &v2 = chunk.screen[c];
+    const f32 area = (v1.x - v0.x) * (v2.y - v0.y) - (v2.x - v0.x) * (v1.y - v0.y);
+    if (std::abs(area) < 1e-6f) return;
+
+    // Pixels whose centers are inside the bounds, triangles between centers cover nothing
+    const f32 minX = std::ceil(std::min({ v0.x, v1.x, v2.x }) - 0.5f);
+    const f32 maxX = std::floor(std::max({ v0.x, v1.x, v2.x }) - 0.5f);
+    const f32 minY = std::ceil(std::min({ v0.y, v1.y, v2.y }) - 0.5f);
+    const f32 maxY = std::floor(std::max({ v0.y, v1.y, v2.y }) - 0.5f);
+    const f32 width = (f32)target_.Width();
+    const f32 height = (f32)target_.Height();
+    if (minX > maxX or minY > maxY) return;
+    if (maxX < 0.0f or maxY < 0.0f or minX >= width or minY >= height) return;
+
+    const u32 tileX0 = (u32)std::max(0.0f, minX) / tileWidth;
+    const u32 tileX1 = (u32)std::min(width - 1.0f, maxX) / tileWidth;
+    const u32 tileY0 = (u32)std::max(0.0f, minY) / tileHeight;
+    const u32 tileY1 = (u32)std::min(height - 1.0f, maxY) / tileHeight;
+
+    const u32 triangle = chunk.triangles.size();
+    if (area > 0.0f) {
+        chunk.triangles.push_back({ { a, b, c }, lit });
+    } else {
+        chunk.triangles.push_back({ { a, c, b }, lit });
+    }
+    for (u32 ty = tileY0; ty <= tileY1; ++ty) {
+        for (u32 tx = tileX0; tx <= tileX1; ++tx) {
+            chunk.bins[ty * tilesX_ + tx].push_back(triangle);
+        }
+    }
+}
+
+void Rasterizer::RasterizeTile(u32 tile) {
+    const i32 tileX = (i32)((tile % tilesX_) * tileWidth);
+    const i32 tileY = (i32)((tile / tilesX_) * tileHeight);
+    const i32 tileMaxX = std::min(tileX + (i32)tileWidth, (i32)target_.Width()) - 1;
+    const i32 tileMaxY = std::min(tileY + (i32)tileHeight, (i32)target_.Height()) - 1;
+
+    const math::vec4 &clear = config::clearColor;
+    const u32 clearColor = Framebuffer::Pack(ToByte(clear.x), ToByte(clear.y), ToByte(clear.z), ToByte(clear.w));
+    for (i32 y = tileY; y <= tileMaxY; ++y) {
+        std::fill_n(target_.ColorRow(y) + tileX, tileWidth, clearColor);
+        std::fill_n(target_.DepthRow(y) + tileX, tileWidth, 0.0f);
+    }
+
+#ifdef REVEAL3D_SSE
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 pixelCenters = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+    const __m128 ambient = _mm_set1_ps(ambientIntensity);
+    const __m128 sun = _mm_set1_ps(sunIntensity);
+    const __m128 sunX = _mm_set1_ps(sunDirection[0]);
+    const __m128 sunY = _mm_set1_ps(sunDirection[1]);
+    const __m128 sunZ = _mm_set1_ps(sunDirection[2]);
+    const __m128 byteScale = _mm_set1_ps(255.0f);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128i alpha = _mm_set1_epi32((i32)0xFF000000);
+#endif
+
+    for (u32 c = 0; c < chunkCount_; ++c) {
+        const Chunk &chunk = chunks_[c];
+        for (const u32 index : chunk.bins[tile]) {
+            const Triangle &triangle = chunk.triangles[index];
+            const ScreenVertex *v[3] = { &chunk.screen[triangle.vertices[0]], &chunk.screen[triangle.vertices[1]],
+                                         &chunk.screen[triangle.vertices[2]] };
+
+            const i32 minX = (i32)std::clamp(std::ceil(std::min({ v[0]->x, v[1]->x, v[2]->x }) - 0.5f), (f32)tileX, (f32)tileMaxX + 1.0f);
+            const i32 maxX = (i32)std::clamp(std::floor(std::max({ v[0]->x, v[1]->x, v[2]->x }) - 0.5f), (f32)tileX - 1.0f, (f32)tileMaxX);
+            const i32 minY = (i32)std::clamp(std::ceil(std::min({ v[0]->y, v[1]->y, v[2]->y }) - 0.5f), (f32)tileY, (f32)tileMaxY + 1.0f);
+            const i32 maxY = (i32)std::clamp(std::floor(std::max({ v[0]->y, v[1]->y, v[2]->y }) - 0.5f), (f32)tileY - 1.0f, (f32)tileMaxY);
+            if (minX > maxX or minY > maxY) continue;
+
+            // Edge i goes from vertex i to the next one and is positive inside, it is the weight
+            // of the opposite vertex. Weights are normalized per pixel instead of using planes
+            // of the attributes, they are never negative inside so thin triangles can not
+            // extrapolate attributes
+            f32 edgeA[3], edgeB[3], edgeC[3];
+            for (u32 i = 0; i < 3; ++i) {
+                const u32 next = (i + 1) % 3;
+                edgeA[i] = v[i]->y - v[next]->y;
+                edgeB[i] = v[next]->x - v[i]->x;
+                edgeC[i] = -(edgeA[i] * v[i]->x + edgeB[i] * v[i]->y);
+            }
+            const ScreenVertex *opposite[3] = { v[2], v[0], v[1] };
+            const u32 attributes = triangle.lit ? attributeCount : 3;
+
+#ifdef REVEAL3D_SSE
+            __m128 edgeX[3], depths[3], values[3][attributeCount];
+            for (u32 i = 0; i < 3; ++i) {
+                edgeX[i] = _mm_set1_ps(edgeA[i]);
+                depths[i] = _mm_set1_ps(opposite[i]->invW);
+                for (u32 k = 0; k < attributes; ++k) {
+                    values[i][k] = _mm_set1_ps(opposite[i]->attributes[k]);
+                }
+            }
+#endif
+
+            for (i32 y = minY; y <= maxY; ++y) {
+                const f32 py = (f32)y + 0.5f;
+                u32 spanBegin, spanEnd;
+                if (!RowSpan(edgeA, edgeB, edgeC, py, minX, maxX, spanBegin, spanEnd)) continue;
+                u32 *colorRow = target_.ColorRow(y);
+                f32 *depthRow = target_.DepthRow(y);
+
+#ifdef REVEAL3D_SSE
+                __m128 edgeRow[3];
+                for (u32 i = 0; i < 3; ++i) {
+                    edgeRow[i] = _mm_set1_ps(edgeB[i] * py + edgeC[i]);
+                }
+
+                // Tile width is a multiple of four so the last group of four stays in the tile
+                for (u32 x = spanBegin & ~3U; x < spanEnd; x += 4) {
+                    const __m128 px = _mm_add_ps(_mm_set1_ps((f32)x), pixelCenters);
+                    const __m128 edge0 = _mm_add_ps(_mm_mul_ps(edgeX[0], px), edgeRow[0]);
+                    const __m128 edge1 = _mm_add_ps(_mm_mul_ps(edgeX[1], px), edgeRow[1]);
+                    const __m128 edge2 = _mm_add_ps(_mm_mul_ps(edgeX[2], px), edgeRow[2]);
+                    __m128 pass = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(edge0, zero), _mm_cmpge_ps(edge1, zero)), _mm_cmpge_ps(edge2, zero));
+
+                    // Depth test before dividing, weights sum is positive inside
+                    const __m128 sum = _mm_add_ps(_mm_add_ps(edge0, edge1), edge2);
+                    const __m128 weightedDepth = _mm_add_ps(_mm_add_ps(_mm_mul_ps(edge0, depths[0]), _mm_mul_ps(edge1, depths[1])),
+                                                            _mm_mul_ps(edge2, depths[2]));
+                    const __m128 current = _mm_loadu_ps(depthRow + x);
+                    pass = _mm_and_ps(pass, _mm_cmpgt_ps(weightedDepth, _mm_mul_ps(current, sum)));
+                    if (_mm_movemask_ps(pass) == 0) continue;
+
+                    // Attributes are divided by w, dividing by the interpolated 1 / w too cancels the weights sum
+                    const __m128 depth = _mm_div_ps(weightedDepth, sum);
+                    const __m128 scale = _mm_div_ps(one, weightedDepth);
+                    __m128 interpolated[attributeCount];
+                    for (u32 k = 0; k < attributes; ++k) {
+                        interpolated[k] = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(edge0, values[0][k]), _mm_mul_ps(edge1, values[1][k])),
+                                                                _mm_mul_ps(edge2, values[2][k])), scale);
+                    }
+                    __m128 r = interpolated[0];
+                    __m128 g = interpolated[1];
+                    __m128 b = interpolated[2];
+                    if (triangle.lit) {
+                        const __m128 nx = interpolated[3];
+                        const __m128 ny = interpolated[4];
+                        const __m128 nz = interpolated[5];
+                        const __m128 lengthSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, nx), _mm_mul_ps(ny, ny)), _mm_mul_ps(nz, nz));
+                        const __m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, sunX), _mm_mul_ps(ny, sunY)), _mm_mul_ps(nz, sunZ));
+                        const __m128 lengthPositive = _mm_cmpgt_ps(lengthSq, zero);
+                        const __m128 diffuse = _mm_and_ps(lengthPositive, _mm_max_ps(_mm_div_ps(dot, _mm_sqrt_ps(lengthSq)), zero));
+                        const __m128 light = _mm_add_ps(ambient, _mm_mul_ps(diffuse, sun));
+                        r = _mm_mul_ps(r, light);
+                        g = _mm_mul_ps(g, light);
+                        b = _mm_mul_ps(b, light);
+                    }
+
+                    const __m128i red = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_min_ps(_mm_max_ps(r, zero), one), byteScale), half));
+                    const __m128i green = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_min_ps(_mm_max_ps(g, zero), one), byteScale), half));
+                    const __m128i blue = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_min_ps(_mm_max_ps(b, zero), one), byteScale), half));
+                    const __m128i color = _mm_or_si128(_mm_or_si128(red, _mm_slli_epi32(green, 8)),
+                                                       _mm_or_si128(_mm_slli_epi32(blue, 16), alpha));
+
+                    const __m128i mask = _mm_castps_si128(pass);
+                    const __m128i currentColor = _mm_loadu_si128((const __m128i *) (colorRow + x));
+                    _mm_storeu_si128((__m128i *) (colorRow + x), _mm_or_si128(_mm_and_si128(mask, color), _mm_andnot_si128(mask, currentColor)));
+                    _mm_storeu_ps(depthRow + x, _mm_or_ps(_mm_and_ps(pass, depth), _mm_andnot_ps(pass, current)));
+                }
+#else
+                for (u32 x = spanBegin; x < spanEnd; ++x) {
+                    const f32 px = (f32)x + 0.5f;
+                    f32 edges[3];
+                    bool inside = true;
+                    for (u32 i = 0; i < 3; ++i) {
+                        edges[i] = edgeA[i] * px + edgeB[i] * py + edgeC[i];
+                        inside = inside and edges[i] >= 0.0f;
+                    }
+                    if (!inside) continue;
+                    const f32 sum = edges[0] + edges[1] + edges[2];
+                    const f32 weightedDepth = edges[0] * opposite[0]->invW + edges[1] * opposite[1]->invW + edges[2] * opposite[2]->invW;
+                    if (weightedDepth <= depthRow[x] * sum) continue;
+
+                    f32 values[attributeCount];
+                    for (u32 k = 0; k < attributes; ++k) {
+                        values[k] = (edges[0] * opposite[0]->attributes[k] + edges[1] * opposite[1]->attributes[k] +
+                                     edges[2] * opposite[2]->attributes[k]) / weightedDepth;
+                    }
+                    f32 light = 1.0f;
+                    if (triangle.lit) {
+                        const f32 length = std::sqrt(values[3] * values[3] + values[4] * values[4] + values[5] * values[5]);
+                        const f32 dot = values[3] * sunDirection[0] + values[4] * sunDirection[1] + values[5] * sunDirection[2];
+                        light = ambientIntensity + (length > 0.0f ? std::max(dot / length, 0.0f) : 0.0f) * sunIntensity;
+                    }
+                    colorRow[x] = Framebuffer::Pack(ToByte(values[0] * light), ToByte(values[1] * light), ToByte(values[2] * light));
+                    depthRow[x] = weightedDepth / sum;
+                }
+#endif
+            }
+        }
+    }
+
+    if (grid_) {
+        DrawGrid(tile);
+    }
+}
+
+/**
+ * Every pixel is intersected with the z = 0 plane solving the two clip space equations of
+ * its x and y, derivatives come from the intersections of the next pixels. The grid is
+ * blended over the image, only where nothing closer was drawn
+ */
+void Rasterizer::DrawGrid(u32 tile) {
+    const u32 tileX = (tile % tilesX_) * tileWidth;
+    const u32 tileY = (tile / tilesX_) * tileHeight;
+    const u32 tileEndX = std::min(tileX + tileWidth, target_.Width());
+    const u32 tileEndY = std::min(tileY + tileHeight, target_.Height());
+    const f32 width = (f32)target_.Width();
+    const f32 height = (f32)target_.Height();
+
+    auto ground = [&](f32 px, f32 py, f32 &x, f32 &y, f32 &w) {
+        const f32 ndcX = px / width * 2.0f - 1.0f;
+        const f32 ndcY = 1.0f - py / height * 2.0f;
+        const f32 a11 = clip_[0].x - ndcX * clip_[3].x;
+        const f32 a12 = clip_[0].y - ndcX * clip_[3].y;
+        const f32 a21 = clip_[1].x - ndcY * clip_[3].x;
+        const f32 a22 = clip_[1].y - ndcY * clip_[3].y;
+        const f32 b1 = ndcX * clip_[3].w - clip_[0].w;
+        const f32 b2 = ndcY * clip_[3].w - clip_[1].w;
+        const f32 determinant = a11 * a22 - a12 * a21;
+        if (std::abs(determinant) < 1e-12f) return false;
+        x = (b1 * a22 - a12 * b2) / determinant;
+        y = (a11 * b2 - b1 * a21) / determinant;
+        w = clip_[3].x * x + clip_[3].y * y + clip_[3].w;
+        return w > minW;
+    };
+
+    for (u32 py = tileY; py < tileEndY; ++py) {
+        u32 *colorRow = target_.ColorRow(py);
+        const f32 *depthRow = target_.DepthRow(py);
+        for (u32 px = tileX; px < tileEndX; ++px) {
+            f32 x, y, w;
+            if (!ground((f32)px + 0.5f, (f32)py + 0.5f, x, y, w)) continue;
+            const f32 fading = std::max(0.0f, 0.5f - w / gridFarZ);
+            if (fading == 0.0f or 1.0f / w <= depthRow[px]) continue;
+
+            f32 nextX[2], nextY[2], nextW;
+            f32 dx = 0.0f, dy = 0.0f;
+            for (u32 i = 0; i < 2; ++i) {
+                if (ground((f32)px + 0.5f + (f32)(i == 0), (f32)py + 0.5f + (f32)(i == 1), nextX[i], nextY[i], nextW)) {
+                    dx += std::abs(nextX[i] - x);
+                    dy += std::abs(nextY[i] - y);
+                }
+            }
+
+            f32 color[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+            AddGrid(x, y, dx, dy, 2.0f, 0.1f, color);
+            AddGrid(x, y, dx, dy, 1.0f, 0.5f, color);
+            const f32 alpha = std::clamp(color[3] * fading, 0.0f, 1.0f);
+            if (alpha == 0.0f) continue;
+
+            const u32 current = colorRow[px];
+            u32 blended[3];
+            for (u32 i = 0; i < 3; ++i) {
+                const f32 destination = (f32)((current >> (i * 8)) & 0xFF) / 255.0f;
+                blended[i] = ToByte(std::min(color[i], 1.0f) * alpha + destination * (1.0f - alpha));
+            }
+            colorRow[px] = Framebuffer::Pack(blended[0], blended[1], blended[2]);
+        }
+    }
+}
+
+}
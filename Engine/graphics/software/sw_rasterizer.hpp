@@ -0,0 +1,135 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file sw_rasterizer.hpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Tiled CPU rasterizer
+ *
+ * Draws are split in chunks of consecutive draws with about chunkTriangles triangles.
+ * Every chunk is a job: vertices are transformed to clip space four components at once
+ * with SSE, triangles crossing the near plane are clipped, projected and binned in the
+ * screen tiles their bounds touch. Then every tile is a job: it walks the bins of every
+ * chunk in submission order, sets up the triangles and shades four pixels at once,
+ * so the image does not depend on the number of workers.
+ *
+ * Depth is stored as 1 / w like the occlusion buffer, bigger values are closer to the
+ * camera. Colors and normals are interpolated perspective correct. Opaque triangles use
+ * the lighting of the OpenGL solid shader, flat triangles only their color. The grid is
+ * the infinite z = 0 plane of the grid shader, drawn per pixel after triangles.
+ */
+
+#pragma once
+
+#include "render/camera.hpp"
+#include "render/mesh.hpp"
+
+#include <vector>
+
+namespace reveal3d::graphics::software {
+
+// RGBA8 color and 1 / w depth, rows are padded to a whole number of tiles
+class Framebuffer {
+public:
+    void Resize(u32 width, u32 height, u32 stride);
+    // Binary PPM, alpha is dropped
+    bool Save(const char *path) const;
+
+    static INLINE u32 Pack(u32 r, u32 g, u32 b, u32 a = 255) { return r | (g << 8) | (b << 16) | (a << 24); }
+
+    [[nodiscard]] INLINE u32 Width() const { return width_; }
+    [[nodiscard]] INLINE u32 Height() const { return height_; }
+    [[nodiscard]] INLINE u32 Stride() const { return stride_; }
+    [[nodiscard]] INLINE u32 Color(u32 x, u32 y) const { return color_[y * stride_ + x]; }
+    [[nodiscard]] INLINE f32 Depth(u32 x, u32 y) const { return depth_[y * stride_ + x]; }
+    [[nodiscard]] INLINE u32* ColorRow(u32 y) { return &color_[y * stride_]; }
+    [[nodiscard]] INLINE f32* DepthRow(u32 y) { return &depth_[y * stride_]; }
+
+private:
+    memory::Vector<u32, memory::buffers> color_;
+    memory::Vector<f32, memory::buffers> depth_;
+    u32 width_ { 0 };
+    u32 height_ { 0 };
+    u32 stride_ { 0 };
+};
+
+// Sub mesh drawn once with the world and color of an instance
+struct DrawItem {
+    const render::Vertex *vertices { nullptr };
+    const u32 *indices { nullptr };         // Relative to vertices
+    const render::Instance *instance { nullptr };
+    u32 vertexCount { 0 };
+    u32 indexCount { 0 };
+    render::Shader shader { render::opaque };
+};
+
+class Rasterizer {
+public:
+    static constexpr u32 tileWidth = 64;
+    static constexpr u32 tileHeight = 32;
+    static constexpr u32 chunkTriangles = 1 << 14;
+
+    void Resize(u32 width, u32 height);
+    // Forgets submitted draws
+    void Clear();
+    INLINE void Submit(const DrawItem &item) { draws_.push_back(item); }
+    INLINE void SetGrid(bool grid) { grid_ = grid; }
+    // Clears the target and draws submitted items in order, then the grid
+    void Render(const render::Frustum &frustum);
+
+    [[nodiscard]] INLINE const Framebuffer& Target() const { return target_; }
+    [[nodiscard]] INLINE u32 TileCount() const { return tilesX_ * tilesY_; }
+    // Triangles binned in last render, after near plane clipping
+    [[nodiscard]] u32 Triangles() const;
+
+private:
+    static constexpr u32 attributeCount = 6; // Color and normal
+
+    struct alignas(16) ClipVertex {
+        f32 position[4];
+        f32 normal[4];
+        f32 color[4];
+    };
+
+    // Pixel coordinates with y pointing down, attributes divided by w
+    struct ScreenVertex {
+        f32 x, y, invW;
+        f32 attributes[attributeCount];
+    };
+
+    struct Triangle {
+        u32 vertices[3];
+        bool lit;
+    };
+
+    // Consecutive draws set up by the same job
+    struct Chunk {
+        u32 firstDraw { 0 };
+        u32 endDraw { 0 };
+        std::vector<ClipVertex> clip;   // Current draw only
+        std::vector<ScreenVertex> screen;
+        std::vector<Triangle> triangles;
+        std::vector<std::vector<u32>> bins; // Per tile, triangles touching it
+    };
+
+    void SetupChunk(Chunk &chunk);
+    void Transform(const DrawItem &item, Chunk &chunk) const;
+    void ClipTriangle(const ClipVertex *vertices[3], bool lit, Chunk &chunk) const;
+    u32 Project(const ClipVertex &vertex, Chunk &chunk) const;
+    void Bin(u32 a, u32 b, u32 c, bool lit, Chunk &chunk) const;
+    void RasterizeTile(u32 tile);
+    void DrawGrid(u32 tile);
+
+    Framebuffer target_;
+    std::vector<DrawItem> draws_;
+    std::vector<Chunk> chunks_;
+    u32 chunkCount_ { 0 };
+    math::vec4 clip_[4];
+    u32 tilesX_ { 0 };
+    u32 tilesY_ { 0 };
+    bool grid_ { false };
+};
+
+}
@@ -17,6 +17,7 @@
 #include "window/window_info.hpp"
 
 #include "render/camera.hpp"
+#include "render/render_world.hpp"
 
 namespace reveal3d::graphics::Vk {
 
@@ -25,7 +26,7 @@ public:
     Graphics(const window::Resolution &res) :width_(res.width), height_(res.height) {}
     void LoadPipeline() {}
     void LoadAssets() {}
-    void Update(render::Camera &camera) {}
+    void Update(render::Camera &camera, render::RenderWorld &world) {}
     void SetWindow(WHandle winHandle) {}
 
     [[nodiscard]] INLINE u32 GetWidth() const { return width_; }
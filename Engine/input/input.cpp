@@ -13,6 +13,8 @@
 
 #include "input.hpp"
 
+#include <algorithm>
+
 namespace reveal3d::input  {
 
 std::vector<BaseSystem *> inputSystems;
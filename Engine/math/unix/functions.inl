@@ -27,8 +27,10 @@ INLINE xvec3 Cross(xvec3 v1, xvec3 v2) { return glm::cross(glm::vec3(v1), glm::v
 INLINE xvec3 VecToRadians(xvec3 v) { return { glm::radians(v.GetX()), glm::radians(v.GetY()), glm::radians(v.GetZ()) }; }
 INLINE xvec3 VecToDegrees(xvec3 v) { return { glm::degrees(v.GetX()), glm::degrees(v.GetY()), glm::degrees(v.GetZ()) }; }
 INLINE mat4 Transpose(mat4 mat) { return glm::transpose(glm::mat4(mat)); }
+INLINE mat4 Inverse(mat4 mat) { return glm::inverse(glm::mat4(mat)); }
+INLINE mat4 Mat4Identity() { return glm::mat4(1.0f); }
 INLINE mat4 LookAt(xvec3 position, xvec3 focusPoint, xvec3 upDir) { return glm::lookAt(glm::vec3(position), glm::vec3(focusPoint), glm::vec3(upDir)); }
-INLINE mat4 PerspectiveFov(f32 fov, f32 aspectRatio, f32 nearPlane, f32 farPlane) { return glm::perspective(fov, aspectRatio, nearPlane, farPlane); }
+INLINE mat4 PerspectiveFov(f32 fov, f32 aspectRatio, f32 nearPlane, f32 farPlane) { return glm::perspective(glm::radians(fov), aspectRatio, nearPlane, farPlane); }
 INLINE mat4 AffineTransformation(const xvec3 position, const xvec3 scale, const xvec3 rotation) {
     glm::mat4 translationMatrix = glm::translate(glm::mat4(1.0f), glm::vec3(position));
     glm::mat4 rotationMatrix = glm::rotate(glm::mat4(1.0f), rotation.GetX(), glm::vec3(1.0f, 0.0f, 0.0f)) *
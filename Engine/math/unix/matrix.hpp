@@ -51,15 +51,37 @@ public:
     void SetZ(vector<T> z) { mat_.r[2] = z; }
     void SetW(vector<T> w) { mat_.r[3] = w; }
 
+    // Same layout as win32 worlds: row i is mat_[i], translation in the last column and
+    // column j of the 3x3 block is local axis j times scale j
+    [[nodiscard]] vector<3> GetTranslation() const { return { mat_[0][3], mat_[1][3], mat_[2][3] }; }
+    [[nodiscard]] vector<3> GetScale() const { return { AxisLength(0), AxisLength(1), AxisLength(2) }; }
+    // Radians around x, y and z, in the order AffineTransformation composes them (Rx * Ry * Rz)
+    [[nodiscard]] vector<3> GetRotation() const {
+        const glm::vec3 scale(AxisLength(0), AxisLength(1), AxisLength(2));
+        const auto rot = [&](u32 row, u32 col) { return mat_[row][col] / scale[col]; };
+        const f32 sinY = glm::clamp(rot(0, 2), -1.0f, 1.0f);
+        if (glm::abs(sinY) < 0.9999f) {
+            return { glm::atan(-rot(1, 2), rot(2, 2)), glm::asin(sinY), glm::atan(-rot(0, 1), rot(0, 0)) };
+        }
+        // Gimbal lock, x and z turn around the same axis, all of it goes to x
+        return { glm::atan(rot(2, 1), rot(1, 1)), glm::asin(sinY), 0.0f };
+    }
+
 
     operator glm::mat<T,T, f32>() const { return mat_; }
 //    xvec4 operator*(xvec3 vec) const { return vec * mat_; }
 //    xvec4 operator*(xvec4 vec) const { return vec * mat_; }
     matrix operator*(const matrix &mat) const { return mat.mat_ * mat_; }
+    // Row vector times matrix with w = 1, as XMVector3Transform
+    vector<3> operator*(vector<3> vec) const { return glm::vec3(mat_ * glm::vec4(glm::vec3(vec), 1.0f)); }
     matrix MakeScale(scalar scale) {
         return scale * mat_; }
 //    matrix MakeScale(xvec3 scale) { return XMMatrixScalingFromVector(scale); }
 private:
+    [[nodiscard]] f32 AxisLength(u32 col) const {
+        return glm::length(glm::vec3(mat_[0][col], mat_[1][col], mat_[2][col]));
+    }
+
     glm::mat<T,T,f32> mat_;
 };
 
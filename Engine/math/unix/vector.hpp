@@ -32,7 +32,7 @@ public:
 //    xvec3(const glm::vec3 &vec) : vec_(vec) {}
     template<u32 value = T> requires Dimension<3, value> vector(glm::vec3 vec) : vec_(vec) {}
     template<u32 value = T> requires Dimension<4, value> vector(glm::vec4 vec) : vec_(vec) {}
-    template<u32 value = T> requires Dimension<3, value> operator glm::vec3() const { return vec_; }
+    template<u32 value = T> requires Dimension<3, value> operator glm::vec3() const { return glm::vec3(vec_); }
     template<u32 value = T> requires Dimension<4, value> operator glm::vec4() const { return vec_; }
 
     void SetX(f32 x) { vec_.x = x; }
@@ -43,7 +43,7 @@ public:
     [[nodiscard]] scalar GetX() const { return vec_.x; }
     [[nodiscard]] scalar GetY() const { return vec_.y; }
     template<u32 value = T> requires Dimension<3, value> [[nodiscard]] scalar GetZ() const { return vec_.z; }
-    template<u32 value = T> requires Dimension<4, value> [[nodiscard]] scalar GetW() const { return vec_.z; }
+    template<u32 value = T> requires Dimension<4, value> [[nodiscard]] scalar GetW() const { return vec_.w; }
 
     vector operator-() const { return vec_; }
     vector operator+(vector v2) const { return vec_ + glm::vec<T, f32>(v2); }
@@ -13,6 +13,8 @@
 
 #include "camera.hpp"
 
+#include <cmath>
+
 
 namespace reveal3d::render{
 
@@ -47,15 +49,26 @@ void Camera::Update(const Timer& timer) {
     UpdateFront();
     viewMatrix_ = math::LookAt(position_, position_ + front_, up_);
     viewProjectionMatrix_ = viewMatrix_ * projectionMatrix_;
+    UpdateFrustum();
 }
 
 void Camera::Resize(const window::Resolution &res) {
     projectionMatrix_ = math::PerspectiveFov(65.f, res.aspectRatio, 0.1f, 100.0f);
 }
 
+void Camera::LookAt(const math::xvec3 &position, const math::xvec3 &target) {
+    position_ = position;
+    front_ = math::Normalize(target - position);
+    right_ = math::Normalize(math::Cross(front_, worldUp_));
+    up_ = math::Normalize(math::Cross(right_, front_));
+    // Keeps mouse look continuous from the new direction
+    pitch_ = std::asin(front_.GetZ()) * 57.2957795f;
+    yaw_ = std::atan2(front_.GetY(), front_.GetX()) * 57.2957795f;
+}
+
 void Camera::Move(const input::action dir, const input::type value) {
     isMoving_[dir] = value;
-//    log(logDEBUG) << "EyePos: " << position_.GetX() << ", " << position_.GetY() << ", " << position_.GetZ();
+//    LOG(logDEBUG) << "EyePos: " << position_.GetX() << ", " << position_.GetY() << ", " << position_.GetZ();
 }
 
 void Camera::SetLooking(const input::action action, const input::type value) {
@@ -116,12 +129,43 @@ void Camera::UpdateFront() {
             math::Sin(math::Radians(pitch_))
     };
 
-//    log(logDEBUG) << newFront.GetX() << ", " << newFront.GetY() << ", " << newFront.GetZ();
+//    LOG(logDEBUG) << newFront.GetX() << ", " << newFront.GetY() << ", " << newFront.GetZ();
     front_ = math::Normalize(newFront);
     right_ = math::Normalize(math::Cross(front_, worldUp_));
     up_ = math::Normalize(math::Cross(right_, front_));
     lastPos_ = newPos_;
-//    log(logDEBUG) << front_.GetX() << ", " << front_.GetY() << ", " << front_.GetZ();
+//    LOG(logDEBUG) << front_.GetX() << ", " << front_.GetY() << ", " << front_.GetZ();
 }
 
-}
\ No newline at end of file
+/**
+ * Gribb-Hartmann plane extraction. Rows of the transposed view projection are the
+ * clip space equations. Near plane uses OpenGL depth range, on DirectX it is just a
+ * bit more conservative
+ */
+void Camera::UpdateFrustum() {
+    const math::mat4 clip = math::Transpose(viewProjectionMatrix_);
+    const math::xvec4 rows[4] = { clip.GetX(), clip.GetY(), clip.GetZ(), clip.GetW() };
+    f32 m[4][4];
+
+    for (u32 i = 0; i < 4; ++i) {
+        m[i][0] = rows[i].GetX();
+        m[i][1] = rows[i].GetY();
+        m[i][2] = rows[i].GetZ();
+        m[i][3] = rows[i].GetW();
+        frustum_.clip[i] = { m[i][0], m[i][1], m[i][2], m[i][3] };
+    }
+
+    for (u32 i = 0; i < Frustum::count; ++i) {
+        const u32 row = i / 2;
+        const f32 sign = (i % 2 == 0) ? 1.0f : -1.0f;
+        math::vec4 &plane = frustum_.planes[i];
+        plane = { m[3][0] + sign * m[row][0], m[3][1] + sign * m[row][1],
+                  m[3][2] + sign * m[row][2], m[3][3] + sign * m[row][3] };
+        const f32 length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+        if (length > 0.0f) {
+            plane = { plane.x / length, plane.y / length, plane.z / length, plane.w / length };
+        }
+    }
+}
+
+}
@@ -19,17 +19,26 @@
 
 namespace reveal3d::render {
 
+// Normalized planes pointing inwards, xyz is the normal and w the distance
+struct Frustum {
+    enum plane : u8 { left, right, bottom, top, zNear, zFar, count };
+    math::vec4 planes[plane::count];
+    math::vec4 clip[4]; // View projection rows, clip space component i is dot(clip[i], {p, 1})
+};
+
 class Camera {
 public:
     explicit Camera(const window::Resolution &res);
 
     void Update(const Timer& timer);
     void Resize(const window::Resolution &res);
-    // TODO: Frustum
+    // Places the camera without input, takes effect on the next Update
+    void LookAt(const math::xvec3 &position, const math::xvec3 &target);
 
     [[nodiscard]] INLINE math::mat4 GetProjectionMatrix() const { return projectionMatrix_; }
     [[nodiscard]] INLINE math::mat4 const GetViewProjectionMatrix() const { return viewProjectionMatrix_; }
     [[nodiscard]] INLINE math::mat4 GetViewMatrix() const { return viewMatrix_; }
+    [[nodiscard]] INLINE const Frustum& GetFrustum() const { return frustum_; }
 
     /********* Input handling ************/
     void Move(input::action dir, input::type value);
@@ -41,6 +50,7 @@ public:
 private:
     void UpdatePos(math::scalar dt);
     void UpdateFront();
+    void UpdateFrustum();
 
     math::xvec3 position_;
     math::xvec3 front_;
@@ -50,6 +60,7 @@ private:
     math::mat4 projectionMatrix_;
     math::mat4 viewMatrix_;
     math::mat4 viewProjectionMatrix_;
+    Frustum frustum_;
 
     math::scalar moveSpeed_;
     input::System<Camera> inputSys_;
@@ -0,0 +1,113 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file culling.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Frustum culling
+ *
+ * Longer description
+ */
+
+#include "culling.hpp"
+
+#include <cmath>
+
+namespace reveal3d::render {
+
+void CullingBoxes::Resize(u32 count) {
+    centerX_.resize(count);
+    centerY_.resize(count);
+    centerZ_.resize(count);
+    extentX_.resize(count);
+    extentY_.resize(count);
+    extentZ_.resize(count);
+}
+
+void CullingBoxes::Clear() {
+    Resize(0);
+}
+
+void CullingBoxes::Set(u32 index, const Bounds &bounds) {
+    centerX_[index] = bounds.center.x;
+    centerY_[index] = bounds.center.y;
+    centerZ_[index] = bounds.center.z;
+    extentX_[index] = bounds.extents.x;
+    extentY_[index] = bounds.extents.y;
+    extentZ_[index] = bounds.extents.z;
+}
+
+/**
+ * A box is outside when it is fully behind any plane, that is, the signed distance of
+ * its center plus its projected radius on the plane normal is negative
+ */
+void FrustumCull(const Frustum &frustum, const CullingBoxes &boxes, u32 begin, u32 end, u8 *visible) {
+    const f32 *cx = boxes.CenterX();
+    const f32 *cy = boxes.CenterY();
+    const f32 *cz = boxes.CenterZ();
+    const f32 *ex = boxes.ExtentX();
+    const f32 *ey = boxes.ExtentY();
+    const f32 *ez = boxes.ExtentZ();
+    u32 i = begin;
+
+#ifdef REVEAL3D_SSE
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    __m128 planes[Frustum::count][4];
+    __m128 absNormals[Frustum::count][3];
+
+    for (u32 p = 0; p < Frustum::count; ++p) {
+        const math::vec4 &plane = frustum.planes[p];
+        planes[p][0] = _mm_set1_ps(plane.x);
+        planes[p][1] = _mm_set1_ps(plane.y);
+        planes[p][2] = _mm_set1_ps(plane.z);
+        planes[p][3] = _mm_set1_ps(plane.w);
+        for (u32 j = 0; j < 3; ++j) {
+            absNormals[p][j] = _mm_andnot_ps(signMask, planes[p][j]);
+        }
+    }
+
+    for (; i + 4 <= end; i += 4) {
+        const __m128 x = _mm_loadu_ps(cx + i);
+        const __m128 y = _mm_loadu_ps(cy + i);
+        const __m128 z = _mm_loadu_ps(cz + i);
+        const __m128 extX = _mm_loadu_ps(ex + i);
+        const __m128 extY = _mm_loadu_ps(ey + i);
+        const __m128 extZ = _mm_loadu_ps(ez + i);
+        __m128 inside = _mm_cmpeq_ps(zero, zero);
+
+        for (u32 p = 0; p < Frustum::count; ++p) {
+            __m128 distance = _mm_add_ps(_mm_mul_ps(planes[p][0], x), planes[p][3]);
+            distance = _mm_add_ps(distance, _mm_mul_ps(planes[p][1], y));
+            distance = _mm_add_ps(distance, _mm_mul_ps(planes[p][2], z));
+            __m128 radius = _mm_mul_ps(absNormals[p][0], extX);
+            radius = _mm_add_ps(radius, _mm_mul_ps(absNormals[p][1], extY));
+            radius = _mm_add_ps(radius, _mm_mul_ps(absNormals[p][2], extZ));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distance, radius), zero));
+        }
+
+        const i32 mask = _mm_movemask_ps(inside);
+        visible[i + 0] = (mask >> 0) & 1;
+        visible[i + 1] = (mask >> 1) & 1;
+        visible[i + 2] = (mask >> 2) & 1;
+        visible[i + 3] = (mask >> 3) & 1;
+    }
+#endif
+
+    for (; i < end; ++i) {
+        u8 inside = 1;
+        for (const math::vec4 &plane : frustum.planes) {
+            const f32 distance = plane.x * cx[i] + plane.y * cy[i] + plane.z * cz[i] + plane.w;
+            const f32 radius = std::abs(plane.x) * ex[i] + std::abs(plane.y) * ey[i] + std::abs(plane.z) * ez[i];
+            if (distance + radius < 0.0f) {
+                inside = 0;
+                break;
+            }
+        }
+        visible[i] = inside;
+    }
+}
+
+}
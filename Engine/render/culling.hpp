@@ -0,0 +1,50 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file culling.hpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Frustum culling
+ *
+ * World space boxes are kept in SoA layout so each frustum plane is tested
+ * against four boxes at once with SSE. Platforms without SSE use the scalar path.
+ */
+
+#pragma once
+
+#include "camera.hpp"
+#include "mesh.hpp"
+
+#include <vector>
+
+namespace reveal3d::render {
+
+class CullingBoxes {
+public:
+    void Resize(u32 count);
+    void Clear();
+    void Set(u32 index, const Bounds &bounds);
+
+    [[nodiscard]] INLINE u32 Count() const { return centerX_.size(); }
+    [[nodiscard]] INLINE const f32* CenterX() const { return centerX_.data(); }
+    [[nodiscard]] INLINE const f32* CenterY() const { return centerY_.data(); }
+    [[nodiscard]] INLINE const f32* CenterZ() const { return centerZ_.data(); }
+    [[nodiscard]] INLINE const f32* ExtentX() const { return extentX_.data(); }
+    [[nodiscard]] INLINE const f32* ExtentY() const { return extentY_.data(); }
+    [[nodiscard]] INLINE const f32* ExtentZ() const { return extentZ_.data(); }
+
+private:
+    std::vector<f32> centerX_;
+    std::vector<f32> centerY_;
+    std::vector<f32> centerZ_;
+    std::vector<f32> extentX_;
+    std::vector<f32> extentY_;
+    std::vector<f32> extentZ_;
+};
+
+// Writes 1 for every box in [begin, end) inside or intersecting the frustum, 0 otherwise
+void FrustumCull(const Frustum &frustum, const CullingBoxes &boxes, u32 begin, u32 end, u8 *visible);
+
+}
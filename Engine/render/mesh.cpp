@@ -0,0 +1,160 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file mesh.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Mesh bounding volumes
+ *
+ * Longer description
+ */
+
+#include "mesh.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace reveal3d::render {
+
+/**
+ * Two passes over the vertex stream, min/max for the AABB and then max squared
+ * distance to its center for the sphere. With SSE position is loaded as a whole
+ * vector (w lane reads color.r and is ignored), four vertices per iteration
+ */
+Bounds ComputeBounds(const Vertex *vertices, u32 count) {
+    Bounds bounds;
+    if (count == 0) return bounds;
+
+    f32 min[4] = { FLT_MAX, FLT_MAX, FLT_MAX, FLT_MAX };
+    f32 max[4] = { -FLT_MAX, -FLT_MAX, -FLT_MAX, -FLT_MAX };
+    f32 radiusSq = 0.0f;
+    u32 i = 0;
+
+#ifdef REVEAL3D_SSE
+    __m128 min0 = _mm_loadu_ps(min), min1 = min0, min2 = min0, min3 = min0;
+    __m128 max0 = _mm_loadu_ps(max), max1 = max0, max2 = max0, max3 = max0;
+
+    for (; i + 4 <= count; i += 4) {
+        const __m128 p0 = _mm_loadu_ps(&vertices[i + 0].pos.x);
+        const __m128 p1 = _mm_loadu_ps(&vertices[i + 1].pos.x);
+        const __m128 p2 = _mm_loadu_ps(&vertices[i + 2].pos.x);
+        const __m128 p3 = _mm_loadu_ps(&vertices[i + 3].pos.x);
+        min0 = _mm_min_ps(min0, p0); max0 = _mm_max_ps(max0, p0);
+        min1 = _mm_min_ps(min1, p1); max1 = _mm_max_ps(max1, p1);
+        min2 = _mm_min_ps(min2, p2); max2 = _mm_max_ps(max2, p2);
+        min3 = _mm_min_ps(min3, p3); max3 = _mm_max_ps(max3, p3);
+    }
+    _mm_storeu_ps(min, _mm_min_ps(_mm_min_ps(min0, min1), _mm_min_ps(min2, min3)));
+    _mm_storeu_ps(max, _mm_max_ps(_mm_max_ps(max0, max1), _mm_max_ps(max2, max3)));
+#endif
+
+    for (; i < count; ++i) {
+        const math::vec3 &pos = vertices[i].pos;
+        min[0] = std::min(min[0], pos.x); max[0] = std::max(max[0], pos.x);
+        min[1] = std::min(min[1], pos.y); max[1] = std::max(max[1], pos.y);
+        min[2] = std::min(min[2], pos.z); max[2] = std::max(max[2], pos.z);
+    }
+
+    bounds.center = { (min[0] + max[0]) * 0.5f, (min[1] + max[1]) * 0.5f, (min[2] + max[2]) * 0.5f };
+    bounds.extents = { (max[0] - min[0]) * 0.5f, (max[1] - min[1]) * 0.5f, (max[2] - min[2]) * 0.5f };
+
+    i = 0;
+#ifdef REVEAL3D_SSE
+    const __m128 centerX = _mm_set1_ps(bounds.center.x);
+    const __m128 centerY = _mm_set1_ps(bounds.center.y);
+    const __m128 centerZ = _mm_set1_ps(bounds.center.z);
+    __m128 maxSq = _mm_setzero_ps();
+
+    for (; i + 4 <= count; i += 4) {
+        __m128 x = _mm_loadu_ps(&vertices[i + 0].pos.x);
+        __m128 y = _mm_loadu_ps(&vertices[i + 1].pos.x);
+        __m128 z = _mm_loadu_ps(&vertices[i + 2].pos.x);
+        __m128 w = _mm_loadu_ps(&vertices[i + 3].pos.x);
+        _MM_TRANSPOSE4_PS(x, y, z, w);
+        x = _mm_sub_ps(x, centerX);
+        y = _mm_sub_ps(y, centerY);
+        z = _mm_sub_ps(z, centerZ);
+        const __m128 distanceSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+        maxSq = _mm_max_ps(maxSq, distanceSq);
+    }
+
+    f32 lanes[4];
+    _mm_storeu_ps(lanes, maxSq);
+    radiusSq = std::max({ lanes[0], lanes[1], lanes[2], lanes[3] });
+#endif
+
+    for (; i < count; ++i) {
+        const math::vec3 &pos = vertices[i].pos;
+        const f32 x = pos.x - bounds.center.x;
+        const f32 y = pos.y - bounds.center.y;
+        const f32 z = pos.z - bounds.center.z;
+        radiusSq = std::max(radiusSq, x * x + y * y + z * z);
+    }
+    bounds.radius = std::sqrt(radiusSq);
+
+    return bounds;
+}
+
+Bounds MergeBounds(const Bounds &a, const Bounds &b) {
+    const f32 ac[3] = { a.center.x, a.center.y, a.center.z };
+    const f32 ae[3] = { a.extents.x, a.extents.y, a.extents.z };
+    const f32 bc[3] = { b.center.x, b.center.y, b.center.z };
+    const f32 be[3] = { b.extents.x, b.extents.y, b.extents.z };
+    f32 center[3];
+    f32 extents[3];
+
+    for (u32 i = 0; i < 3; ++i) {
+        const f32 min = std::min(ac[i] - ae[i], bc[i] - be[i]);
+        const f32 max = std::max(ac[i] + ae[i], bc[i] + be[i]);
+        center[i] = (min + max) * 0.5f;
+        extents[i] = (max - min) * 0.5f;
+    }
+
+    Bounds bounds;
+    bounds.center = { center[0], center[1], center[2] };
+    bounds.extents = { extents[0], extents[1], extents[2] };
+    // Sphere keeps being centered in the AABB, grow it to contain both
+    const f32 da = std::sqrt((ac[0] - center[0]) * (ac[0] - center[0]) + (ac[1] - center[1]) * (ac[1] - center[1]) +
+                             (ac[2] - center[2]) * (ac[2] - center[2]));
+    const f32 db = std::sqrt((bc[0] - center[0]) * (bc[0] - center[0]) + (bc[1] - center[1]) * (bc[1] - center[1]) +
+                             (bc[2] - center[2]) * (bc[2] - center[2]));
+    bounds.radius = std::max(da + a.radius, db + b.radius);
+    return bounds;
+}
+
+Bounds TransformBounds(const Bounds &local, const math::mat4 &world) {
+    const math::xvec4 rows[3] = { world.GetX(), world.GetY(), world.GetZ() };
+    const f32 c[3] = { local.center.x, local.center.y, local.center.z };
+    const f32 e[3] = { local.extents.x, local.extents.y, local.extents.z };
+    f32 center[3];
+    f32 extents[3];
+    f32 scale[3] = { 0.0f, 0.0f, 0.0f };
+
+    for (u32 i = 0; i < 3; ++i) {
+        const f32 m[4] = { rows[i].GetX(), rows[i].GetY(), rows[i].GetZ(), rows[i].GetW() };
+        center[i] = m[0] * c[0] + m[1] * c[1] + m[2] * c[2] + m[3];
+        extents[i] = std::abs(m[0]) * e[0] + std::abs(m[1]) * e[1] + std::abs(m[2]) * e[2];
+        for (u32 j = 0; j < 3; ++j) {
+            scale[j] += m[j] * m[j];
+        }
+    }
+
+    Bounds bounds;
+    bounds.center = { center[0], center[1], center[2] };
+    bounds.extents = { extents[0], extents[1], extents[2] };
+    bounds.radius = local.radius * std::sqrt(std::max({ scale[0], scale[1], scale[2] }));
+    return bounds;
+}
+
+u64 MemorySize(const Mesh &mesh) {
+    u64 bytes = mesh.vertices_.capacity() * sizeof(Vertex) + mesh.indices_.capacity() * sizeof(u32);
+    for (const spatial::TriangleBvh &bvh : mesh.bvhs) {
+        bytes += sizeof(spatial::TriangleBvh) + bvh.MemorySize();
+    }
+    return bytes;
+}
+
+}
@@ -15,6 +15,8 @@
 
 #include "math/math.hpp"
 #include "vertex.hpp"
+#include "spatial/triangle_bvh.hpp"
+#include "common/memory_report.hpp"
 
 #include <vector>
 
@@ -29,6 +31,12 @@ enum Shader : u8 {
     count
 };
 
+struct Bounds {
+    math::vec3 center  { 0.0f, 0.0f, 0.0f };
+    math::vec3 extents { 0.0f, 0.0f, 0.0f }; // Half size of the AABB
+    f32 radius         { 0.0f };
+};
+
 struct SubMesh {
     u32 renderInfo      { UINT_MAX };
     u32 constantIndex   { 0 };
@@ -36,14 +44,43 @@ struct SubMesh {
     u32 vertexPos       { 0 };
     u32 indexPos        { 0 };
     u32 indexCount      { 0 };
+    Bounds bounds;      // Local space
     bool visible        { true };
+    bool occluder       { false }; // Rasterized for software occlusion culling
+};
+
+// Per instance data of instanced draws, world is stored as proxies keep it
+struct Instance {
+    math::mat4 world;
+    math::vec4 color { 1.0f, 1.0f, 1.0f, 1.0f };
+};
+
+// Sub mesh drawn once for instances [first, first + count) of the frame instance buffer
+struct InstanceBatch {
+    u32 mesh        { UINT_MAX };
+    u32 vertexPos   { 0 };
+    u32 indexPos    { 0 };
+    u32 indexCount  { 0 };
+    u32 first       { 0 };
+    u32 count       { 0 };
 };
 
 struct Mesh {
     std::vector<render::Vertex> vertices_;
     std::vector<u32> indices_;
     u32 renderInfo { UINT_MAX }; // Vertex buffer where mesh is
+    Bounds bounds;               // Local space, all sub meshes
+    std::vector<spatial::TriangleBvh> bvhs; // Per sub mesh, shared by every entity using the mesh
+    memory::Tracked<memory::meshes> usage;  // Set to MemorySize after the data changes
 };
 
+// AABB and bounding sphere around the AABB center of a vertex range
+Bounds ComputeBounds(const Vertex *vertices, u32 count);
+Bounds MergeBounds(const Bounds &a, const Bounds &b);
+// World matrices are stored with translation in w component of the first three rows
+Bounds TransformBounds(const Bounds &local, const math::mat4 &world);
+// Bytes of vertices, indices and BVHs, counting reserved capacity
+u64 MemorySize(const Mesh &mesh);
+
 }
 
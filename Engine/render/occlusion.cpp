@@ -0,0 +1,311 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file occlusion.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Software occlusion culling
+ *
+ * Longer description
+ */
+
+#include "occlusion.hpp"
+#include "common/job_system.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace reveal3d::render {
+
+namespace {
+
+constexpr f32 minW = 1e-4f;
+constexpr u32 setupGrain = 1024;
+
+struct Projected {
+    f32 x, y, depth, w;
+};
+
+// Pixel coordinates with y pointing down and 1 / w as depth
+Projected Project(const Frustum &frustum, f32 x, f32 y, f32 z, f32 width, f32 height) {
+    const math::vec4 *clip = frustum.clip;
+    const f32 clipX = clip[0].x * x + clip[0].y * y + clip[0].z * z + clip[0].w;
+    const f32 clipY = clip[1].x * x + clip[1].y * y + clip[1].z * z + clip[1].w;
+    const f32 clipW = clip[3].x * x + clip[3].y * y + clip[3].z * z + clip[3].w;
+    if (clipW < minW) {
+        return { 0.0f, 0.0f, 0.0f, clipW };
+    }
+    const f32 invW = 1.0f / clipW;
+    return { (clipX * invW * 0.5f + 0.5f) * width, (0.5f - clipY * invW * 0.5f) * height, invW, clipW };
+}
+
+}
+
+void OcclusionBuffer::Resize(u32 width, u32 height) {
+    width_ = width;
+    height_ = height;
+    tilesX_ = (width + tileWidth - 1) / tileWidth;
+    tilesY_ = (height + tileHeight - 1) / tileHeight;
+    stride_ = tilesX_ * tileWidth;
+    depth_.assign(stride_ * height_, 0.0f);
+    tileDepth_.assign(tilesX_ * tilesY_, 0.0f);
+}
+
+void OcclusionBuffer::Render(const Frustum &frustum, std::span<const math::vec3> triangles) {
+    triangles_.resize(triangles.size() / 3);
+    jobs::ParallelFor(triangles_.size(), setupGrain, [&](u32 begin, u32 end) {
+        for (u32 i = begin; i < end; ++i) {
+            Setup(frustum, &triangles[i * 3], triangles_[i]);
+        }
+    });
+
+    // Tile rows never share pixels, no synchronization needed
+    jobs::ParallelFor(tilesY_, 1, [&](u32 begin, u32 end) {
+        for (u32 tileRow = begin; tileRow < end; ++tileRow) {
+            RasterizeTiles(tileRow);
+        }
+    });
+}
+
+/**
+ * The box is projected to a screen rectangle with the depth of its closest corner. It is
+ * occluded when every pixel of the rectangle has an occluder closer than that corner
+ */
+bool OcclusionBuffer::Test(const Frustum &frustum, const Bounds &bounds) const {
+    if (width_ == 0 or height_ == 0) return true;
+
+    f32 minX = FLT_MAX, minY = FLT_MAX;
+    f32 maxX = -FLT_MAX, maxY = -FLT_MAX;
+    f32 boxDepth = 0.0f;
+    for (u32 i = 0; i < 8; ++i) {
+        const f32 x = bounds.center.x + ((i & 1) ? bounds.extents.x : -bounds.extents.x);
+        const f32 y = bounds.center.y + ((i & 2) ? bounds.extents.y : -bounds.extents.y);
+        const f32 z = bounds.center.z + ((i & 4) ? bounds.extents.z : -bounds.extents.z);
+        const Projected corner = Project(frustum, x, y, z, (f32)width_, (f32)height_);
+        if (corner.w < minW) return true; // Crosses the near plane
+        minX = std::min(minX, corner.x);
+        maxX = std::max(maxX, corner.x);
+        minY = std::min(minY, corner.y);
+        maxY = std::max(maxY, corner.y);
+        boxDepth = std::max(boxDepth, corner.depth);
+    }
+
+    // Out of screen boxes are left to frustum culling
+    if (maxX < 0.0f or maxY < 0.0f or minX >= (f32)width_ or minY >= (f32)height_) return true;
+
+    const u32 x0 = (u32)std::max(0.0f, std::floor(minX));
+    const u32 x1 = (u32)std::min((f32)width_ - 1.0f, std::floor(maxX));
+    const u32 y0 = (u32)std::max(0.0f, std::floor(minY));
+    const u32 y1 = (u32)std::min((f32)height_ - 1.0f, std::floor(maxY));
+
+#ifdef REVEAL3D_SSE
+    const __m128 boxDepth4 = _mm_set1_ps(boxDepth);
+#endif
+
+    for (u32 ty = y0 / tileHeight; ty <= y1 / tileHeight; ++ty) {
+        for (u32 tx = x0 / tileWidth; tx <= x1 / tileWidth; ++tx) {
+            if (tileDepth_[ty * tilesX_ + tx] > boxDepth) continue; // Whole tile covered by closer occluders
+
+            const u32 rowBegin = std::max(y0, ty * tileHeight);
+            const u32 rowEnd = std::min(y1 + 1, (ty + 1) * tileHeight);
+            const u32 columnBegin = std::max(x0, tx * tileWidth);
+            const u32 columnEnd = std::min(x1 + 1, (tx + 1) * tileWidth);
+
+            for (u32 y = rowBegin; y < rowEnd; ++y) {
+                const f32 *row = &depth_[y * stride_];
+                u32 x = columnBegin;
+#ifdef REVEAL3D_SSE
+                for (; x + 4 <= columnEnd; x += 4) {
+                    if (_mm_movemask_ps(_mm_cmple_ps(_mm_loadu_ps(row + x), boxDepth4))) return true;
+                }
+#endif
+                for (; x < columnEnd; ++x) {
+                    if (row[x] <= boxDepth) return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * Triangles crossing the near plane are dropped, missing an occluder only makes culling
+ * less effective. Winding is made consistent so both faces occlude
+ */
+void OcclusionBuffer::Setup(const Frustum &frustum, const math::vec3 *vertices, ScreenTriangle &triangle) const {
+    triangle.minX = 1;
+    triangle.maxX = 0;
+
+    f32 x[3], y[3], depth[3];
+    for (u32 i = 0; i < 3; ++i) {
+        const Projected vertex = Project(frustum, vertices[i].x, vertices[i].y, vertices[i].z, (f32)width_, (f32)height_);
+        if (vertex.w < minW) return;
+        x[i] = vertex.x;
+        y[i] = vertex.y;
+        depth[i] = vertex.depth;
+    }
+
+    f32 area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+    if (std::abs(area) < 1e-6f) return;
+    if (area < 0.0f) {
+        std::swap(x[1], x[2]);
+        std::swap(y[1], y[2]);
+        std::swap(depth[1], depth[2]);
+        area = -area;
+    }
+
+    const f32 minX = std::floor(std::min({ x[0], x[1], x[2] }));
+    const f32 maxX = std::ceil(std::max({ x[0], x[1], x[2] }));
+    const f32 minY = std::floor(std::min({ y[0], y[1], y[2] }));
+    const f32 maxY = std::ceil(std::max({ y[0], y[1], y[2] }));
+    if (maxX < 0.0f or maxY < 0.0f or minX >= (f32)width_ or minY >= (f32)height_) return;
+
+    // Edge i goes from vertex i to the next one and is positive inside. Divided by the area
+    // it is the barycentric weight of the opposite vertex
+    for (u32 i = 0; i < 3; ++i) {
+        const u32 next = (i + 1) % 3;
+        triangle.edgeA[i] = y[i] - y[next];
+        triangle.edgeB[i] = x[next] - x[i];
+        triangle.edgeC[i] = -(triangle.edgeA[i] * x[i] + triangle.edgeB[i] * y[i]);
+    }
+
+    const f32 invArea = 1.0f / area;
+    triangle.depthX = (depth[0] * triangle.edgeA[1] + depth[1] * triangle.edgeA[2] + depth[2] * triangle.edgeA[0]) * invArea;
+    triangle.depthY = (depth[0] * triangle.edgeB[1] + depth[1] * triangle.edgeB[2] + depth[2] * triangle.edgeB[0]) * invArea;
+    triangle.depthC = (depth[0] * triangle.edgeC[1] + depth[1] * triangle.edgeC[2] + depth[2] * triangle.edgeC[0]) * invArea;
+
+    triangle.minX = (i32)std::max(0.0f, minX);
+    triangle.maxX = (i32)std::min((f32)width_ - 1.0f, maxX);
+    triangle.minY = (i32)std::max(0.0f, minY);
+    triangle.maxY = (i32)std::min((f32)height_ - 1.0f, maxY);
+}
+
+/**
+ * Pixels of a row inside the triangle, solved from the edge functions. Rounded outwards,
+ * pixels are still tested against the edges so the span only has to contain them
+ */
+bool OcclusionBuffer::RowSpan(const ScreenTriangle &triangle, f32 py, u32 &begin, u32 &end) {
+    f32 spanMin = (f32)triangle.minX;
+    f32 spanMax = (f32)triangle.maxX;
+    for (u32 i = 0; i < 3; ++i) {
+        const f32 a = triangle.edgeA[i];
+        const f32 rowValue = triangle.edgeB[i] * py + triangle.edgeC[i];
+        if (a > 0.0f) {
+            spanMin = std::max(spanMin, std::floor(-rowValue / a - 0.5f));
+        } else if (a < 0.0f) {
+            spanMax = std::min(spanMax, std::ceil(-rowValue / a - 0.5f));
+        } else if (rowValue < 0.0f) {
+            return false;
+        }
+    }
+    if (spanMin > spanMax) return false;
+    begin = (u32)spanMin;
+    end = (u32)spanMax + 1;
+    return true;
+}
+
+void OcclusionBuffer::RasterizeTiles(u32 tileRow) {
+    const u32 rowBegin = tileRow * tileHeight;
+    const u32 rowEnd = std::min(rowBegin + tileHeight, height_);
+    std::fill(depth_.begin() + rowBegin * stride_, depth_.begin() + rowEnd * stride_, 0.0f);
+
+#ifdef REVEAL3D_SSE
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 pixelCenters = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+#endif
+
+    for (const ScreenTriangle &triangle : triangles_) {
+        if (triangle.minX > triangle.maxX or triangle.maxY < (i32)rowBegin or triangle.minY >= (i32)rowEnd) continue;
+
+        const u32 yBegin = std::max((u32)triangle.minY, rowBegin);
+        const u32 yEnd = std::min((u32)triangle.maxY + 1, rowEnd);
+
+#ifdef REVEAL3D_SSE
+        const __m128 edgeA0 = _mm_set1_ps(triangle.edgeA[0]);
+        const __m128 edgeA1 = _mm_set1_ps(triangle.edgeA[1]);
+        const __m128 edgeA2 = _mm_set1_ps(triangle.edgeA[2]);
+        const __m128 depthX = _mm_set1_ps(triangle.depthX);
+
+        const __m128 edgeStep0 = _mm_set1_ps(triangle.edgeA[0] * 4.0f);
+        const __m128 edgeStep1 = _mm_set1_ps(triangle.edgeA[1] * 4.0f);
+        const __m128 edgeStep2 = _mm_set1_ps(triangle.edgeA[2] * 4.0f);
+        const __m128 depthStep = _mm_set1_ps(triangle.depthX * 4.0f);
+
+        for (u32 y = yBegin; y < yEnd; ++y) {
+            const f32 py = (f32)y + 0.5f;
+            f32 *row = &depth_[y * stride_];
+            u32 spanBegin, spanEnd;
+            if (!RowSpan(triangle, py, spanBegin, spanEnd)) continue;
+            spanBegin &= ~3U;
+
+            // Values at the first four pixels of the span, then stepped four pixels at a time
+            const __m128 px = _mm_add_ps(_mm_set1_ps((f32)spanBegin), pixelCenters);
+            __m128 edge0 = _mm_add_ps(_mm_mul_ps(edgeA0, px), _mm_set1_ps(triangle.edgeB[0] * py + triangle.edgeC[0]));
+            __m128 edge1 = _mm_add_ps(_mm_mul_ps(edgeA1, px), _mm_set1_ps(triangle.edgeB[1] * py + triangle.edgeC[1]));
+            __m128 edge2 = _mm_add_ps(_mm_mul_ps(edgeA2, px), _mm_set1_ps(triangle.edgeB[2] * py + triangle.edgeC[2]));
+            __m128 depth = _mm_add_ps(_mm_mul_ps(depthX, px), _mm_set1_ps(triangle.depthY * py + triangle.depthC));
+
+            // Stride is a multiple of tile width so the last group of four stays in the row
+            for (u32 x = spanBegin; x < spanEnd; x += 4) {
+                __m128 inside = _mm_cmpge_ps(edge0, zero);
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(edge1, zero));
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(edge2, zero));
+                const __m128 current = _mm_loadu_ps(row + x);
+                const __m128 closest = _mm_max_ps(current, depth);
+                _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, closest), _mm_andnot_ps(inside, current)));
+
+                edge0 = _mm_add_ps(edge0, edgeStep0);
+                edge1 = _mm_add_ps(edge1, edgeStep1);
+                edge2 = _mm_add_ps(edge2, edgeStep2);
+                depth = _mm_add_ps(depth, depthStep);
+            }
+        }
+#else
+        for (u32 y = yBegin; y < yEnd; ++y) {
+            const f32 py = (f32)y + 0.5f;
+            f32 *row = &depth_[y * stride_];
+            u32 spanBegin, spanEnd;
+            if (!RowSpan(triangle, py, spanBegin, spanEnd)) continue;
+
+            for (u32 x = spanBegin; x < spanEnd; ++x) {
+                const f32 px = (f32)x + 0.5f;
+                bool inside = true;
+                for (u32 i = 0; i < 3; ++i) {
+                    inside = inside and (triangle.edgeA[i] * px + triangle.edgeB[i] * py + triangle.edgeC[i] >= 0.0f);
+                }
+                if (inside) {
+                    row[x] = std::max(row[x], triangle.depthX * px + triangle.depthY * py + triangle.depthC);
+                }
+            }
+        }
+#endif
+    }
+
+    // Farthest depth of every tile in the row
+    for (u32 tx = 0; tx < tilesX_; ++tx) {
+        const u32 columnBegin = tx * tileWidth;
+        const u32 columnEnd = std::min(columnBegin + tileWidth, width_);
+        f32 farthest = FLT_MAX;
+        for (u32 y = rowBegin; y < rowEnd; ++y) {
+            const f32 *row = &depth_[y * stride_];
+            u32 x = columnBegin;
+#ifdef REVEAL3D_SSE
+            __m128 farthest4 = _mm_set1_ps(farthest);
+            for (; x + 4 <= columnEnd; x += 4) {
+                farthest4 = _mm_min_ps(farthest4, _mm_loadu_ps(row + x));
+            }
+            alignas(16) f32 lanes[4];
+            _mm_store_ps(lanes, farthest4);
+            farthest = std::min({ lanes[0], lanes[1], lanes[2], lanes[3] });
+#endif
+            for (; x < columnEnd; ++x) {
+                farthest = std::min(farthest, row[x]);
+            }
+        }
+        tileDepth_[tileRow * tilesX_ + tx] = farthest;
+    }
+}
+
+}
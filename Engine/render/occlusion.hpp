@@ -0,0 +1,72 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file occlusion.hpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Software occlusion culling
+ *
+ * A few designated occluder meshes are rasterized on the CPU into a small depth buffer,
+ * boxes that passed frustum culling are then tested against it before being drawn.
+ * Depth is stored as 1 / w, which is linear in screen space and independent of the
+ * backend clip space convention, bigger values are closer to the camera.
+ *
+ * The buffer is split in tiles of tileWidth x tileHeight pixels. Every row of tiles is
+ * rasterized by a different job and four pixels are shaded at once with SSE. Each tile
+ * keeps the farthest depth written on it, so most tests against fully covered tiles
+ * never touch pixels.
+ */
+
+#pragma once
+
+#include "camera.hpp"
+#include "mesh.hpp"
+
+#include <span>
+#include <vector>
+
+namespace reveal3d::render {
+
+class OcclusionBuffer {
+public:
+    static constexpr u32 tileWidth = 32;
+    static constexpr u32 tileHeight = 8;
+
+    void Resize(u32 width, u32 height);
+    // Clears the buffer and rasterizes triangles, three consecutive world space positions each
+    void Render(const Frustum &frustum, std::span<const math::vec3> triangles);
+    // False only when the whole box is behind rendered occluders
+    [[nodiscard]] bool Test(const Frustum &frustum, const Bounds &bounds) const;
+
+    [[nodiscard]] INLINE u32 Width() const { return width_; }
+    [[nodiscard]] INLINE u32 Height() const { return height_; }
+    [[nodiscard]] INLINE f32 Depth(u32 x, u32 y) const { return depth_[y * stride_ + x]; }
+    [[nodiscard]] INLINE f32 TileDepth(u32 x, u32 y) const { return tileDepth_[y * tilesX_ + x]; }
+
+private:
+    // Edge functions and depth plane in pixel coordinates
+    struct ScreenTriangle {
+        f32 edgeA[3];
+        f32 edgeB[3];
+        f32 edgeC[3];
+        f32 depthX, depthY, depthC;
+        i32 minX, maxX, minY, maxY; // Empty when minX > maxX
+    };
+
+    void Setup(const Frustum &frustum, const math::vec3 *vertices, ScreenTriangle &triangle) const;
+    void RasterizeTiles(u32 tileRow);
+    static bool RowSpan(const ScreenTriangle &triangle, f32 py, u32 &begin, u32 &end);
+
+    std::vector<f32> depth_;
+    std::vector<f32> tileDepth_;
+    std::vector<ScreenTriangle> triangles_;
+    u32 width_ { 0 };
+    u32 height_ { 0 };
+    u32 stride_ { 0 };  // Width rounded up to tile width
+    u32 tilesX_ { 0 };
+    u32 tilesY_ { 0 };
+};
+
+}
@@ -0,0 +1,111 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file render_queue.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Sorted draw queue
+ *
+ * Longer description
+ */
+
+#include "render_queue.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace reveal3d::render {
+
+namespace {
+
+constexpr u32 radixBits = 8;
+constexpr u32 radixSize = 1 << radixBits;
+constexpr u32 radixPasses = 64 / radixBits;
+
+}
+
+/**
+ * Positive floats keep their order when read as integers. The exponent gives the power of
+ * two bucket, starting at 1/8, and the 16 high bits the quantized depth
+ */
+u64 RenderQueue::MakeKey(u32 layer, u32 pipeline, u32 material, u32 mesh, f32 depth, bool backToFront) {
+    depth = std::max(depth, 0.0f);
+    u32 bits;
+    std::memcpy(&bits, &depth, sizeof(bits));
+
+    u64 bucket = std::clamp((i32)(bits >> 23) - 124, 0, 15);
+    u64 quantized = bits >> 16;
+    if (backToFront) {
+        bucket = 15 - bucket;
+        quantized = 0xFFFF - quantized;
+    }
+
+    return ((u64)(layer & 0xF) << 60) | ((u64)(pipeline & 0xFF) << 52) | ((u64)(material & 0xFFF) << 40) |
+           (bucket << 36) | ((u64)(mesh & 0xFFFFF) << 16) | quantized;
+}
+
+void RenderQueue::Clear() {
+    keys_.clear();
+    items_.clear();
+    std::fill(std::begin(layerBegin_), std::end(layerBegin_), 0);
+}
+
+void RenderQueue::Sort() {
+    const u32 count = keys_.size();
+    if (count == 0) {
+        std::fill(std::begin(layerBegin_), std::end(layerBegin_), 0);
+        return;
+    }
+
+    // Histograms of every pass are built in a single read of the keys
+    u32 histograms[radixPasses][radixSize] {};
+    for (const u64 key : keys_) {
+        for (u32 pass = 0; pass < radixPasses; ++pass) {
+            ++histograms[pass][(key >> (pass * radixBits)) & (radixSize - 1)];
+        }
+    }
+
+    tempKeys_.resize(count);
+    tempItems_.resize(count);
+    for (u32 pass = 0; pass < radixPasses; ++pass) {
+        const u32 shift = pass * radixBits;
+        u32 *histogram = histograms[pass];
+        if (histogram[(keys_[0] >> shift) & (radixSize - 1)] == count) continue; // Every key has the same byte
+
+        u32 offset = 0;
+        for (u32 i = 0; i < radixSize; ++i) {
+            const u32 size = histogram[i];
+            histogram[i] = offset;
+            offset += size;
+        }
+        for (u32 i = 0; i < count; ++i) {
+            const u32 position = histogram[(keys_[i] >> shift) & (radixSize - 1)]++;
+            tempKeys_[position] = keys_[i];
+            tempItems_[position] = items_[i];
+        }
+        keys_.swap(tempKeys_);
+        items_.swap(tempItems_);
+    }
+
+    for (u32 layer = 0; layer < maxLayers; ++layer) {
+        layerBegin_[layer] = std::lower_bound(keys_.begin(), keys_.end(), (u64)layer << 60) - keys_.begin();
+    }
+    layerBegin_[maxLayers] = count;
+}
+
+std::span<const u32> RenderQueue::Layer(u32 layer) const {
+    return { items_.data() + layerBegin_[layer], layerBegin_[layer + 1] - layerBegin_[layer] };
+}
+
+u32 RenderQueue::StateChanges(u64 mask) const {
+    if (keys_.empty()) return 0;
+    u32 changes = 1;
+    for (u32 i = 1; i < keys_.size(); ++i) {
+        changes += ((keys_[i] ^ keys_[i - 1]) & mask) != 0;
+    }
+    return changes;
+}
+
+}
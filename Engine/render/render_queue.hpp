@@ -0,0 +1,67 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file render_queue.hpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Sorted draw queue
+ *
+ * Every visible item gets a 64 bit key with the state it needs, most expensive state
+ * changes in the most significant bits, so sorting the keys groups draws sharing state.
+ *
+ *   63      60 59     52 51     40 39     36 35       16 15      0
+ *  | layer    | pipeline | material | bucket   | mesh       | depth   |
+ *
+ * Depth is the view distance of the item. Bucket is its power of two, so inside every
+ * material opaque items go roughly front to back without breaking mesh runs, depth then
+ * sorts items of the same mesh. Back to front layers store the depth bits inverted.
+ *
+ * Keys are sorted with a LSD radix sort on bytes, passes where every key has the same
+ * byte are skipped.
+ */
+
+#pragma once
+
+#include "common/common.hpp"
+
+#include <span>
+#include <vector>
+
+namespace reveal3d::render {
+
+class RenderQueue {
+public:
+    static constexpr u32 maxLayers = 16;
+
+    static constexpr u64 layerMask    = 0xFULL << 60;
+    static constexpr u64 pipelineMask = 0xFFULL << 52;
+    static constexpr u64 materialMask = 0xFFFULL << 40;
+    static constexpr u64 meshMask     = 0xFFFFFULL << 16;
+    static constexpr u64 stateMask    = layerMask | pipelineMask | materialMask | meshMask;
+
+    static u64 MakeKey(u32 layer, u32 pipeline, u32 material, u32 mesh, f32 depth, bool backToFront = false);
+
+    void Clear();
+    INLINE void Push(u64 key, u32 item) { keys_.push_back(key); items_.push_back(item); }
+    void Sort();
+
+    [[nodiscard]] INLINE u32 Count() const { return keys_.size(); }
+    [[nodiscard]] INLINE u64 Key(u32 index) const { return keys_[index]; }
+    [[nodiscard]] INLINE u32 Item(u32 index) const { return items_[index]; }
+    [[nodiscard]] INLINE std::span<const u32> Items() const { return items_; }
+    // Items of a layer, only valid after sorting
+    [[nodiscard]] std::span<const u32> Layer(u32 layer) const;
+    // Times two consecutive items differ in the masked key bits, in current order
+    [[nodiscard]] u32 StateChanges(u64 mask = stateMask) const;
+
+private:
+    std::vector<u64> keys_;
+    std::vector<u32> items_;
+    std::vector<u64> tempKeys_;
+    std::vector<u32> tempItems_;
+    u32 layerBegin_[maxLayers + 1] {};
+};
+
+}
@@ -0,0 +1,365 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file render_world.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Render proxies
+ *
+ * Longer description
+ */
+
+#include "render_world.hpp"
+#include "common/job_system.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace reveal3d::render {
+
+namespace {
+
+constexpr u32 extractionGrain = 256;
+constexpr u32 cullingGrain = 4096;
+constexpr u32 occlusionGrain = 256;
+
+}
+
+void RenderWorld::Extract(core::Scene &scene) {
+    core::Pool<core::Transform> &transforms = scene.Transforms();
+    core::Pool<core::Geometry> &geometries = scene.Geometries();
+    const u32 entityCount = std::min(transforms.size(), geometries.size());
+
+    updated_.clear();
+
+    if (entityCount < firstProxy_.size()) {
+        RemoveEntities(entityCount);
+    }
+
+    // Mesh, material or visibility changes
+    for (const id_t id : scene.DirtyGeometries()) {
+        const id_t index = id::index(id);
+        if (index < firstProxy_.size()) {
+            SyncGeometry(index, geometries[index]);
+        }
+        geometries[index].UnDirty();
+    }
+    scene.DirtyGeometries().clear();
+
+    // New entities, they copy their world when added
+    const u32 knownCount = firstProxy_.size();
+    for (u32 i = knownCount; i < entityCount; ++i) {
+        AddEntity(i, geometries[i], transforms[i]);
+    }
+
+    // Moved entities, read once from the worlds the last scene update recalculated
+    const u32 movedBegin = updated_.size();
+    for (const id_t id : scene.MovedTransforms()) {
+        const id_t index = id::index(id);
+        if (index >= knownCount) continue;
+        for (u32 i = 0; i < proxyCount_[index]; ++i) {
+            updated_.push_back(firstProxy_[index] + i);
+        }
+    }
+
+    jobs::ParallelFor(updated_.size() - movedBegin, extractionGrain, [&](u32 begin, u32 end) {
+        for (u32 i = movedBegin + begin; i < movedBegin + end; ++i) {
+            Proxy &proxy = proxies_[updated_[i]];
+            proxy.world = transforms[proxy.entity].World();
+            SetBounds(updated_[i], TransformBounds(localBounds_[updated_[i]], proxy.world));
+        }
+    });
+
+    for (u32 i = movedBegin; i < updated_.size(); ++i) {
+        occludersDirty_ = occludersDirty_ or proxies_[updated_[i]].occluder;
+    }
+
+    if (layersDirty_) {
+        BuildLayers();
+    }
+    if (occludersDirty_) {
+        BuildOccluders();
+    }
+
+    visibility_.Resize(proxies_.size());
+    for (const u32 index : updated_) {
+        visibility_.Invalidate(index);
+    }
+}
+
+void RenderWorld::Cull(const Frustum &frustum) {
+    visibleMask_.resize(proxies_.size());
+    jobs::ParallelFor(proxies_.size(), cullingGrain, [&](u32 begin, u32 end) {
+        FrustumCull(frustum, boxes_, begin, end, visibleMask_.data());
+    });
+
+    for (u32 layer = 0; layer < Shader::count; ++layer) {
+        visible_[layer].clear();
+        for (const u32 index : layers_[layer]) {
+            if (visibleMask_[index]) {
+                visible_[layer].push_back(index);
+            }
+        }
+    }
+}
+
+void RenderWorld::CullCached(const Frustum &frustum) {
+    visibility_.Update(frustum, boxes_);
+
+    if (cachedDirty_) {
+        BuildCachedLists();
+    } else {
+        for (const u32 index : visibility_.Changed()) {
+            const Proxy &proxy = proxies_[index];
+            if (!proxy.visible or proxy.mesh == UINT_MAX) continue;
+
+            std::vector<u32> &list = cached_[proxy.shader];
+            const u32 slot = cachedSlot_[index];
+            if (visibility_.Visible(index) and slot == UINT_MAX) {
+                cachedSlot_[index] = list.size();
+                list.push_back(index);
+            } else if (!visibility_.Visible(index) and slot != UINT_MAX) {
+                list[slot] = list.back();
+                cachedSlot_[list[slot]] = slot;
+                list.pop_back();
+                cachedSlot_[index] = UINT_MAX;
+            }
+        }
+    }
+
+    for (u32 layer = 0; layer < Shader::count; ++layer) {
+        visible_[layer].assign(cached_[layer].begin(), cached_[layer].end());
+    }
+}
+
+void RenderWorld::Occlude(const Frustum &frustum) {
+    if (occluderTriangles_.empty() or occlusion_.Width() == 0) return;
+
+    occlusion_.Render(frustum, occluderTriangles_);
+
+    for (auto &visible : visible_) {
+        visibleMask_.resize(visible.size());
+        jobs::ParallelFor(visible.size(), occlusionGrain, [&](u32 begin, u32 end) {
+            for (u32 i = begin; i < end; ++i) {
+                visibleMask_[i] = occlusion_.Test(frustum, proxies_[visible[i]].bounds);
+            }
+        });
+
+        u32 count = 0;
+        for (u32 i = 0; i < visible.size(); ++i) {
+            if (visibleMask_[i]) {
+                visible[count++] = visible[i];
+            }
+        }
+        visible.resize(count);
+    }
+}
+
+void RenderWorld::BuildQueue(const Frustum &frustum) {
+    const math::vec4 &w = frustum.clip[3];
+    queue_.Clear();
+    for (u32 layer = 0; layer < Shader::count; ++layer) {
+        for (const u32 index : visible_[layer]) {
+            const Proxy &proxy = proxies_[index];
+            const math::vec3 &center = proxy.bounds.center;
+            const f32 depth = w.x * center.x + w.y * center.y + w.z * center.z + w.w;
+            // No material system yet, per entity color goes through constant buffers
+            queue_.Push(RenderQueue::MakeKey(layer, proxy.shader, 0, proxy.mesh, depth), index);
+        }
+    }
+    queue_.Sort();
+    BuildBatches();
+}
+
+void RenderWorld::AddEntity(u32 index, core::Geometry &geometry, core::Transform &transform) {
+    const u32 first = proxies_.size();
+    const u32 count = geometry.SubMeshes().size();
+
+    firstProxy_.push_back(first);
+    proxyCount_.push_back(count);
+    proxies_.resize(first + count);
+    localBounds_.resize(first + count);
+    occluderMeshes_.resize(first + count);
+    boxes_.Resize(first + count);
+
+    for (u32 i = 0; i < count; ++i) {
+        proxies_[first + i].entity = index;
+        proxies_[first + i].world = transform.World();
+    }
+    SyncGeometry(index, geometry);
+}
+
+// Proxies are kept in entity order, the ones of removed trailing entities are the last ones
+void RenderWorld::RemoveEntities(u32 entityCount) {
+    const u32 proxyCount = firstProxy_[entityCount];
+    firstProxy_.resize(entityCount);
+    proxyCount_.resize(entityCount);
+    proxies_.resize(proxyCount);
+    localBounds_.resize(proxyCount);
+    occluderMeshes_.resize(proxyCount);
+    boxes_.Resize(proxyCount);
+
+    // Layers, occluders and cached lists are rebuilt from the remaining proxies this frame
+    queue_.Clear();
+    for (auto &batches : batches_) {
+        batches.clear();
+    }
+    instances_.clear();
+    layersDirty_ = true;
+}
+
+void RenderWorld::SyncGeometry(u32 index, core::Geometry &geometry) {
+    std::vector<SubMesh> &subMeshes = geometry.SubMeshes();
+
+    if (subMeshes.size() != proxyCount_[index]) {
+        // Sub meshes were added, entity range is no longer valid. Rebuild everything
+        proxies_.clear();
+        localBounds_.clear();
+        occluderMeshes_.clear();
+        boxes_.Clear();
+        visibility_.Clear();
+        firstProxy_.clear();
+        proxyCount_.clear();
+        updated_.clear();
+        return;
+    }
+
+    for (u32 i = 0; i < subMeshes.size(); ++i) {
+        const u32 proxyIndex = firstProxy_[index] + i;
+        Proxy &proxy = proxies_[proxyIndex];
+        const SubMesh &subMesh = subMeshes[i];
+
+        proxy.color = geometry.Color();
+        proxy.mesh = subMesh.renderInfo;
+        proxy.vertexPos = subMesh.vertexPos;
+        proxy.indexPos = subMesh.indexPos;
+        proxy.indexCount = subMesh.indexCount;
+        proxy.shader = subMesh.shader;
+        proxy.visible = subMesh.visible;
+        proxy.occluder = subMesh.occluder;
+        occluderMeshes_[proxyIndex] = subMesh.occluder ?
+            OccluderMesh { geometry.GetVerticesStart() + subMesh.vertexPos, geometry.GetIndicesStart() + subMesh.indexPos } :
+            OccluderMesh {};
+        localBounds_[proxyIndex] = subMesh.bounds;
+        SetBounds(proxyIndex, TransformBounds(localBounds_[proxyIndex], proxy.world));
+        updated_.push_back(proxyIndex);
+    }
+    layersDirty_ = true;
+}
+
+void RenderWorld::BuildLayers() {
+    for (auto &layer : layers_) {
+        layer.clear();
+    }
+    occluders_.clear();
+    for (u32 i = 0; i < proxies_.size(); ++i) {
+        if (proxies_[i].visible and proxies_[i].mesh != UINT_MAX) {
+            layers_[proxies_[i].shader].push_back(i);
+        }
+        if (proxies_[i].visible and proxies_[i].occluder) {
+            occluders_.push_back(i);
+        }
+    }
+    layersDirty_ = false;
+    occludersDirty_ = true;
+    cachedDirty_ = true;
+}
+
+void RenderWorld::BuildCachedLists() {
+    cachedSlot_.assign(proxies_.size(), UINT_MAX);
+    for (u32 layer = 0; layer < Shader::count; ++layer) {
+        cached_[layer].clear();
+        for (const u32 index : layers_[layer]) {
+            if (visibility_.Visible(index)) {
+                cachedSlot_[index] = cached_[layer].size();
+                cached_[layer].push_back(index);
+            }
+        }
+    }
+    cachedDirty_ = false;
+}
+
+/**
+ * Batches are created in queue order, so they keep the nearest first order of their first
+ * instance, and instances of a batch keep their queue order
+ */
+void RenderWorld::BuildBatches() {
+    instances_.resize(queue_.Count());
+    u32 first = 0;
+    for (u32 layer = 0; layer < Shader::count; ++layer) {
+        std::vector<InstanceBatch> &batches = batches_[layer];
+        const std::span<const u32> items = queue_.Layer(layer);
+        batches.clear();
+        batchOf_.resize(items.size());
+        // A node based map would allocate every batch of every frame, this table keeps its memory
+        const u32 mask = std::bit_ceil(std::max<u32>((u32) items.size() * 2, 16)) - 1;
+        batchIndex_.assign(mask + 1, { UINT64_MAX, 0 });
+
+        u64 lastKey = UINT64_MAX;
+        u32 batch = 0;
+        for (u32 i = 0; i < items.size(); ++i) {
+            const Proxy &proxy = proxies_[items[i]];
+            const u64 key = ((u64)proxy.mesh << 32) | proxy.indexPos;
+            if (key != lastKey) {
+                u32 slot = (u32) ((key * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+                while (batchIndex_[slot].first != key and batchIndex_[slot].first != UINT64_MAX) {
+                    slot = (slot + 1) & mask;
+                }
+                if (batchIndex_[slot].first == UINT64_MAX) {
+                    batchIndex_[slot] = { key, (u32) batches.size() };
+                    batches.push_back({ proxy.mesh, proxy.vertexPos, proxy.indexPos, proxy.indexCount, 0, 0 });
+                }
+                batch = batchIndex_[slot].second;
+                lastKey = key;
+            }
+            ++batches[batch].count;
+            batchOf_[i] = batch;
+        }
+
+        for (InstanceBatch &instanceBatch : batches) {
+            instanceBatch.first = first;
+            first += instanceBatch.count;
+            instanceBatch.count = 0;
+        }
+        for (u32 i = 0; i < items.size(); ++i) {
+            InstanceBatch &instanceBatch = batches[batchOf_[i]];
+            Instance &instance = instances_[instanceBatch.first + instanceBatch.count++];
+            instance.world = proxies_[items[i]].world;
+            instance.color = proxies_[items[i]].color;
+        }
+    }
+}
+
+// Occluders are usually static, triangles are only transformed again when one of them moves
+void RenderWorld::BuildOccluders() {
+    occluderTriangles_.clear();
+    for (const u32 index : occluders_) {
+        const Proxy &proxy = proxies_[index];
+        const OccluderMesh &mesh = occluderMeshes_[index];
+        const math::xvec4 rows[3] = { proxy.world.GetX(), proxy.world.GetY(), proxy.world.GetZ() };
+        f32 m[3][4];
+        for (u32 i = 0; i < 3; ++i) {
+            m[i][0] = rows[i].GetX();
+            m[i][1] = rows[i].GetY();
+            m[i][2] = rows[i].GetZ();
+            m[i][3] = rows[i].GetW();
+        }
+
+        for (u32 i = 0; i < proxy.indexCount; ++i) {
+            const math::vec3 &p = mesh.vertices[mesh.indices[i]].pos;
+            occluderTriangles_.push_back({ m[0][0] * p.x + m[0][1] * p.y + m[0][2] * p.z + m[0][3],
+                                           m[1][0] * p.x + m[1][1] * p.y + m[1][2] * p.z + m[1][3],
+                                           m[2][0] * p.x + m[2][1] * p.y + m[2][2] * p.z + m[2][3] });
+        }
+    }
+    occludersDirty_ = false;
+}
+
+void RenderWorld::SetBounds(u32 index, const Bounds &bounds) {
+    proxies_[index].bounds = bounds;
+    boxes_.Set(index, bounds);
+}
+
+}
@@ -0,0 +1,122 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file render_world.hpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Render proxies
+ *
+ * Render side copy of the scene. Once per frame the extraction stage copies only
+ * render relevant data that changed (world matrix, mesh, material and bounds) from
+ * core components into compact proxies. Backends only read proxies, never the scene.
+ *
+ * There is one proxy per entity sub mesh, proxies of the same entity are contiguous.
+ * After extraction proxies are culled against the camera frustum and then against the
+ * depth of occluder flagged sub meshes. Visible proxies are then sorted by state and
+ * depth in the render queue. Queued sub meshes sharing mesh and shader are grouped in
+ * instance batches, their world matrices written contiguously in a per frame instance
+ * array, so backends issue one instanced draw per batch.
+ */
+
+#pragma once
+
+#include "mesh.hpp"
+#include "culling.hpp"
+#include "occlusion.hpp"
+#include "visibility_cache.hpp"
+#include "render_queue.hpp"
+#include "core/scene.hpp"
+
+#include <array>
+#include <utility>
+#include <vector>
+
+namespace reveal3d::render {
+
+struct Proxy {
+    math::mat4 world;
+    math::vec4 color { 1.0f, 1.0f, 1.0f, 1.0f };
+    Bounds bounds;                  // World space
+    u32 mesh        { UINT_MAX };   // Backend render element
+    u32 entity      { UINT_MAX };   // Constant buffer slot
+    u32 vertexPos   { 0 };
+    u32 indexPos    { 0 };
+    u32 indexCount  { 0 };
+    Shader shader   { opaque };
+    bool visible    { true };
+    bool occluder   { false };
+};
+
+class RenderWorld {
+public:
+    // Call once after each scene update, moved entities are taken from Scene::MovedTransforms
+    void Extract(core::Scene &scene);
+    void Cull(const Frustum &frustum);
+    // Reuses last frame results, only moved proxies and proxies close to moved planes are tested
+    void CullCached(const Frustum &frustum);
+    // Removes from the visible lists proxies hidden behind occluders, call after culling
+    void Occlude(const Frustum &frustum);
+    INLINE void ResizeOcclusion(u32 width, u32 height) { occlusion_.Resize(width, height); }
+    // Sorts visible proxies by layer, pipeline, mesh and depth and groups them in instance batches, call after culling
+    void BuildQueue(const Frustum &frustum);
+
+    [[nodiscard]] INLINE const std::vector<Proxy>& Proxies() const { return proxies_; }
+    [[nodiscard]] INLINE const Proxy& operator[] (u32 index) const { return proxies_[index]; }
+    [[nodiscard]] INLINE u32 Count() const { return proxies_.size(); }
+    // Proxies to be drawn in a layer, only visible flagged and already uploaded ones
+    [[nodiscard]] INLINE const std::vector<u32>& Layer(u32 layer) const { return layers_[layer]; }
+    // Proxies of a layer that passed last culling
+    [[nodiscard]] INLINE const std::vector<u32>& Visible(u32 layer) const { return visible_[layer]; }
+    // Proxies whose world or material changed in last extraction
+    [[nodiscard]] INLINE const std::vector<u32>& Updated() const { return updated_; }
+    [[nodiscard]] INLINE const OcclusionBuffer& Occlusion() const { return occlusion_; }
+    [[nodiscard]] INLINE const RenderQueue& Queue() const { return queue_; }
+    // Instanced draws of a layer, nearest batches first
+    [[nodiscard]] INLINE const std::vector<InstanceBatch>& Batches(u32 layer) const { return batches_[layer]; }
+    [[nodiscard]] INLINE const std::vector<Instance>& Instances() const { return instances_; }
+
+private:
+    struct OccluderMesh {
+        const Vertex *vertices { nullptr };
+        const u32 *indices { nullptr };
+    };
+
+    void AddEntity(u32 index, core::Geometry &geometry, core::Transform &transform);
+    // Drops every entity from entityCount on
+    void RemoveEntities(u32 entityCount);
+    void SyncGeometry(u32 index, core::Geometry &geometry);
+    void BuildLayers();
+    void SetBounds(u32 index, const Bounds &bounds);
+    void BuildOccluders();
+    void BuildCachedLists();
+    void BuildBatches();
+
+    std::vector<Proxy> proxies_;
+    std::vector<Bounds> localBounds_;
+    std::vector<u32> firstProxy_; // Per entity
+    std::vector<u32> proxyCount_; // Per entity
+    std::array<std::vector<u32>, Shader::count> layers_;
+    std::array<std::vector<u32>, Shader::count> visible_;
+    CullingBoxes boxes_;
+    std::vector<u8> visibleMask_;
+    std::vector<u32> updated_;
+    std::vector<OccluderMesh> occluderMeshes_;  // Per proxy, only set on occluders
+    std::vector<u32> occluders_;
+    std::vector<math::vec3> occluderTriangles_; // World space
+    OcclusionBuffer occlusion_;
+    VisibilityCache visibility_;
+    RenderQueue queue_;
+    std::array<std::vector<InstanceBatch>, Shader::count> batches_;
+    std::vector<Instance> instances_;
+    std::vector<u32> batchOf_;                 // Per layer queue item, its batch
+    std::vector<std::pair<u64, u32>> batchIndex_; // Mesh and index start to batch, open addressing
+    std::array<std::vector<u32>, Shader::count> cached_; // Visible lists kept by CullCached
+    std::vector<u32> cachedSlot_;                        // Per proxy, position in its cached list
+    bool layersDirty_ { false };
+    bool occludersDirty_ { false };
+    bool cachedDirty_ { true };
+};
+
+}
@@ -15,11 +15,17 @@
 
 #include <functional>
 #include "camera.hpp"
+#include "render_world.hpp"
 #include "core/scene.hpp"
+#include "common/frame_stats.hpp"
+#include "common/perf_counters.hpp"
+#include "common/profiler.hpp"
 #include "graphics/gfx.hpp"
 
+#ifdef WIN32
 #include "IMGUI/backends/imgui_impl_win32.h"
 #include "IMGUI/backends/imgui_impl_dx12.h"
+#endif
 
 namespace reveal3d::render {
 
@@ -34,14 +40,22 @@ public:
     void Resize(const window::Resolution &res);
 
     Gfx& Graphics() { return graphics_; }
+    INLINE Camera& GetCamera() { return camera_; }
+    INLINE const RenderWorld& World() const { return world_; }
+    // Extraction, culling and submission times of the last frame
+    INLINE const StageTimes& Stages() const { return stages_; }
 
     INLINE f32 DeltaTime() const { return timer_.DeltaTime(); }
     INLINE  void CameraResetMouse() { camera_.ResetMouse(); }
     INLINE Timer& Time() { return timer_; }
 
 private:
+    static constexpr u32 occlusionScale = 4; // Occlusion buffer is a quarter of the window resolution
+
     Gfx graphics_;
     Camera camera_;
+    RenderWorld world_;
+    StageTimes stages_;
     Timer& timer_;
 };
 
@@ -51,7 +65,7 @@ Renderer<Gfx>::Renderer(window::Resolution *res, Timer &timer)
           graphics_(res),
           timer_(timer)
 {
-
+    world_.ResizeOcclusion(res->width / occlusionScale, res->height / occlusionScale);
 }
 
 template<graphics::HRI Gfx>
@@ -59,33 +73,48 @@ void Renderer<Gfx>::Init(WHandle wHandle) {
     f32 time = timer_.TotalTime();
     graphics_.SetWindow(wHandle);
     graphics_.LoadPipeline();
-    log(logDEBUG) << "Initializing Pipeline...[" << timer_.Diff(time) * 1000 <<"ms]";
+    LOG(logDEBUG) << "Initializing Pipeline...[" << timer_.Diff(time) * 1000 <<"ms]";
     time = timer_.TotalTime();
     graphics_.LoadAssets();
-    log(logDEBUG) << "Loading assets...[" << timer_.Diff(time) * 1000 <<"ms]";
+    LOG(logDEBUG) << "Loading assets...[" << timer_.Diff(time) * 1000 <<"ms]";
 }
 
 template<graphics::HRI Gfx>
 void Renderer<Gfx>::Update() {
+    PROFILE_SCOPE("Renderer::Update");
+    PERF_SCOPE("Renderer::Update");
+    Stopwatch watch;
     camera_.Update(timer_);
-    graphics_.Update(camera_);
+    world_.Extract(core::scene);
+    stages_.time[StageTimes::extraction] = watch.Lap();
+    world_.CullCached(camera_.GetFrustum());
+    world_.Occlude(camera_.GetFrustum());
+    world_.BuildQueue(camera_.GetFrustum());
+    stages_.time[StageTimes::culling] = watch.Lap();
+    graphics_.Update(camera_, world_);
+    stages_.time[StageTimes::submission] = watch.Lap();
 }
 
 template<graphics::HRI Gfx>
 void Renderer<Gfx>::Render() {
+    PROFILE_SCOPE("Renderer::Render");
+    PERF_SCOPE("Renderer::Render");
+    Stopwatch watch;
     graphics_.PrepareRender();
     graphics_.Draw();
+    stages_.time[StageTimes::submission] += watch.Lap();
 }
 
 template<graphics::HRI Gfx>
 void Renderer<Gfx>::Destroy() {
-    log(logDEBUG) << "Cleaning pipeline...[" << timer_.TotalTime()  <<"]";
+    LOG(logDEBUG) << "Cleaning pipeline...[" << timer_.TotalTime()  <<"]";
     graphics_.Terminate();
 }
 
 template<graphics::HRI Gfx>
 void Renderer<Gfx>::Resize(const window::Resolution &res) {
     camera_.Resize(res);
+    world_.ResizeOcclusion(res.width / occlusionScale, res.height / occlusionScale);
     graphics_.Resize(res);
 }
 }
\ No newline at end of file
@@ -0,0 +1,73 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file staging_ring.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Batched uploads through a staging ring buffer
+ *
+ * Longer description
+ */
+
+#include "staging_ring.hpp"
+
+namespace reveal3d::render {
+
+void StagingRing::Reset(u32 size) {
+    batches_.clear();
+    size_ = size;
+    head_ = 0;
+    tail_ = 0;
+    used_ = 0;
+    open_ = 0;
+}
+
+/**
+ * Free memory is [head, size) plus [0, tail) while head is after tail, [head, tail) once
+ * the ring wrapped. Allocations never cross the end, the rest of the ring is skipped
+ */
+u32 StagingRing::Allocate(u32 size, u32 alignment) {
+    if (size == 0 or size > size_) return noSpace;
+    if (used_ == 0) {
+        head_ = 0;
+        tail_ = 0;
+    }
+
+    u32 start = (head_ + alignment - 1) / alignment * alignment;
+    u32 end = start + size;
+    u32 taken = end - head_;
+    const bool full = head_ == tail_ and used_ > 0;
+    if (head_ >= tail_ and !full) {
+        if (end > size_) {
+            if (size > tail_) return noSpace;
+            start = 0;
+            end = size;
+            taken = size_ - head_ + end;
+        }
+    } else if (end > tail_) {
+        return noSpace;
+    }
+
+    head_ = end;
+    used_ += taken;
+    open_ += taken;
+    return start;
+}
+
+void StagingRing::Close(u64 fence) {
+    if (open_ == 0) return;
+    batches_.push_back({ fence, head_, open_ });
+    open_ = 0;
+}
+
+void StagingRing::Retire(u64 completedFence) {
+    while (!batches_.empty() and batches_.front().fence <= completedFence) {
+        used_ -= batches_.front().bytes;
+        tail_ = batches_.front().end;
+        batches_.pop_front();
+    }
+}
+
+}
@@ -0,0 +1,174 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file staging_ring.hpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Batched uploads through a staging ring buffer
+ *
+ * Data going to GPU buffers is first written to a ring of CPU visible staging memory.
+ * Uploads queued during a frame are copied to their targets in a single batch, the ring
+ * memory of a batch is reused once the fence the backend signals after its copies is
+ * completed. Nothing ever waits for the GPU: uploads that don't fit in the ring stay in
+ * CPU memory and go in a later batch, in queue order.
+ *
+ * The ring and queue only keep offsets and fence values, the backend owns the staging
+ * memory and records the copies. Targets are ids the backend maps to its buffers, so
+ * buffers can be recreated while uploads are queued.
+ */
+
+#pragma once
+
+#include "common/common.hpp"
+
+#include <climits>
+#include <concepts>
+#include <cstring>
+#include <deque>
+#include <span>
+#include <vector>
+
+namespace reveal3d::render {
+
+struct StagingCopy {
+    u32 target;
+    u64 targetOffset;
+    u32 stagingOffset;
+    u32 size;
+};
+
+template<typename T>
+concept StagingBackend = requires(T backend, u32 size, std::span<const StagingCopy> copies) {
+    // Staging memory of size bytes, only called when no copy is reading the previous one
+    {backend.MapStaging(size)} -> std::same_as<u8*>;
+    // Last fence value signaled by the GPU
+    {backend.CompletedFence()} -> std::same_as<u64>;
+    // Records the copies, returns the fence value signaled once they are done
+    {backend.Submit(copies)} -> std::same_as<u64>;
+};
+
+class StagingRing {
+public:
+    static constexpr u32 noSpace = UINT_MAX;
+
+    void Reset(u32 size);
+    // Offset of size contiguous bytes, noSpace when they are not free yet
+    u32 Allocate(u32 size, u32 alignment = 1);
+    // Allocations since the last close are released when fence is completed
+    void Close(u64 fence);
+    void Retire(u64 completedFence);
+
+    [[nodiscard]] INLINE u32 Size() const { return size_; }
+    // Allocated bytes, including padding and the end of the ring skipped when wrapping
+    [[nodiscard]] INLINE u32 Used() const { return used_; }
+    [[nodiscard]] INLINE u32 InFlight() const { return batches_.size(); }
+
+private:
+    struct Batch {
+        u64 fence;
+        u32 end;
+        u32 bytes;
+    };
+
+    std::deque<Batch> batches_;
+    u32 size_ { 0 };
+    u32 head_ { 0 };
+    u32 tail_ { 0 };
+    u32 used_ { 0 };
+    u32 open_ { 0 }; // Bytes allocated since the last close
+};
+
+template<StagingBackend Backend>
+class UploadQueue {
+public:
+    void Init(Backend *backend, u32 size);
+    // Data is copied right away, it can be released after the call
+    void Queue(u32 target, u64 targetOffset, const void *data, u32 size);
+    // Retires completed batches and submits every upload that fits in a single batch
+    void Flush();
+
+    [[nodiscard]] INLINE const StagingRing& Ring() const { return ring_; }
+    // Nothing to submit on next flush
+    [[nodiscard]] INLINE bool Empty() const { return copies_.empty() and pending_.empty(); }
+    // Bytes waiting for ring space
+    [[nodiscard]] INLINE u32 Deferred() const { return overflow_.size(); }
+    [[nodiscard]] INLINE u32 Batches() const { return batches_; }
+
+private:
+    static constexpr u32 alignment = 16;
+
+    struct Pending {
+        u32 target;
+        u64 targetOffset;
+        u32 size;
+    };
+
+    bool Stage(u32 target, u64 targetOffset, const void *data, u32 size);
+
+    Backend *backend_ { nullptr };
+    u8 *mapped_ { nullptr };
+    StagingRing ring_;
+    std::vector<StagingCopy> copies_;
+    std::vector<Pending> pending_;
+    std::vector<u8> overflow_;
+    u32 batches_ { 0 };
+};
+
+template<StagingBackend Backend>
+void UploadQueue<Backend>::Init(Backend *backend, u32 size) {
+    backend_ = backend;
+    mapped_ = backend_->MapStaging(size);
+    ring_.Reset(size);
+    copies_.clear();
+    pending_.clear();
+    overflow_.clear();
+    batches_ = 0;
+}
+
+template<StagingBackend Backend>
+void UploadQueue<Backend>::Queue(u32 target, u64 targetOffset, const void *data, u32 size) {
+    if (size == 0) return;
+    // Once something waits, everything after it waits too so uploads keep their order
+    if (pending_.empty() and Stage(target, targetOffset, data, size)) return;
+    pending_.push_back({ target, targetOffset, size });
+    overflow_.insert(overflow_.end(), (const u8 *) data, (const u8 *) data + size);
+}
+
+template<StagingBackend Backend>
+void UploadQueue<Backend>::Flush() {
+    ring_.Retire(backend_->CompletedFence());
+
+    u32 staged = 0;
+    u32 consumed = 0;
+    for (; staged < pending_.size(); ++staged) {
+        const Pending &upload = pending_[staged];
+        // Ring is only replaced when idle, the backend can release the old memory at once
+        if (upload.size > ring_.Size() and ring_.Used() == 0) {
+            const u32 size = std::max(upload.size, ring_.Size() * 2);
+            mapped_ = backend_->MapStaging(size);
+            ring_.Reset(size);
+        }
+        if (!Stage(upload.target, upload.targetOffset, overflow_.data() + consumed, upload.size)) break;
+        consumed += upload.size;
+    }
+    pending_.erase(pending_.begin(), pending_.begin() + staged);
+    overflow_.erase(overflow_.begin(), overflow_.begin() + consumed);
+
+    if (copies_.empty()) return;
+    ring_.Close(backend_->Submit(copies_));
+    copies_.clear();
+    ++batches_;
+}
+
+template<StagingBackend Backend>
+bool UploadQueue<Backend>::Stage(u32 target, u64 targetOffset, const void *data, u32 size) {
+    const u32 offset = ring_.Allocate(size, alignment);
+    if (offset == StagingRing::noSpace) return false;
+    std::memcpy(mapped_ + offset, data, size);
+    copies_.push_back({ target, targetOffset, offset, size });
+    return true;
+}
+
+}
@@ -15,7 +15,9 @@
 
 #include "window/window.hpp"
 #include "renderer.hpp"
+#include "common/alloc_tracker.hpp"
 
+#include <functional>
 #include <stdexcept>
 #include <iostream>
 
@@ -25,13 +27,27 @@ template<graphics::HRI Gfx, window::Mng<Gfx> Window>
 struct Viewport {
     explicit Viewport(window::InitInfo &windowInfo) : window(windowInfo), renderer(&window.GetRes(), timer) { }
     void Init();
-    void Run();
+    // update(frame) runs before each frame, moves the scene the way game code would
+    void Run(const std::function<void(u32)> &update = {});
     f64 BenchMark(u32 seconds);
+    // Times frames after warmUp untimed ones, update(frame) moves the scene before each of them
+    void BenchMark(u32 warmUp, u32 frames, FrameStats &stats, const std::function<void(u32)> &update);
     INLINE Timer& Time() { return timer; }
+    // Run counts heap allocations of every frame after warmUp ones and reports where they come from
+    INLINE void CheckAllocations(u32 warmUp) { checkAllocations_ = true; allocationWarmUp_ = warmUp; }
+    [[nodiscard]] INLINE u64 FrameAllocations() const { return frameAllocations_; }
 
     Window window;
     Renderer<Gfx> renderer;
     Timer timer;
+
+private:
+    StageTimes Frame(u32 frame, const std::function<void(u32)> &update);
+    void ReportAllocations();
+
+    u64 frameAllocations_ { 0 };
+    u32 allocationWarmUp_ { 0 };
+    bool checkAllocations_ { false };
 };
 
 template<graphics::HRI Gfx, window::Mng<Gfx> Window>
@@ -43,33 +59,81 @@ void Viewport<Gfx, Window>::Init() {
 
     } catch(std::exception &e) {
         renderer.Destroy();
-        log(logERROR) << e.what();
+        LOG(logERROR) << e.what();
 //        MessageBoxA(window.GetHandle().hwnd, e.what(), NULL, MB_ICONERROR | MB_SETFOREGROUND);
     }
 }
 
+/**
+ * One iteration of the main loop. Transforms are propagated before the renderer extracts
+ * them, entities moved this frame are drawn this frame. Stage times also go to the timer,
+ * so the next tick can keep them if this frame turns out to be a hitch
+ */
 template<graphics::HRI Gfx, window::Mng<Gfx> Window>
-void Viewport<Gfx, Window>::Run() {
-    try {
-        timer.Reset();
-        while(!window.ShouldClose()) {
-            timer.Tick();
-            window.ClipMouse(renderer);
-            renderer.Update();
-            core::scene.Update(timer.DeltaTime());
+StageTimes Viewport<Gfx, Window>::Frame(u32 frame, const std::function<void(u32)> &update) {
+    PROFILE_SCOPE("Frame");
+    PERF_SCOPE("Frame");
+    Stopwatch watch;
+    StageTimes times;
+    timer.Tick();
+    window.ClipMouse(renderer);
+    if (update) update(frame);
+    times.time[StageTimes::sceneUpdate] = watch.Lap();
+    core::scene.Update(timer.DeltaTime());
+    times.time[StageTimes::transforms] = watch.Lap();
+    renderer.Update();
 #ifdef WIN32
-            if constexpr (not std::same_as<Window, window::Win32>)
-                renderer.Render();
+    if constexpr (not std::same_as<Window, window::Win32>)
+        renderer.Render();
 #else
-            renderer.Render();
+    renderer.Render();
 #endif
-            window.Update();
+    window.Update();
+    times.time[StageTimes::frame] = watch.Elapsed();
+
+    const StageTimes &stages = renderer.Stages();
+    times.time[StageTimes::extraction] = stages.time[StageTimes::extraction];
+    times.time[StageTimes::culling] = stages.time[StageTimes::culling];
+    times.time[StageTimes::submission] = stages.time[StageTimes::submission];
+    timer.RecordStages(times);
+    return times;
+}
+
+template<graphics::HRI Gfx, window::Mng<Gfx> Window>
+void Viewport<Gfx, Window>::Run(const std::function<void(u32)> &update) {
+    try {
+        timer.Reset();
+        frameAllocations_ = 0;
+        for (u32 frame = 0; !window.ShouldClose(); ++frame) {
+            if (!checkAllocations_ or frame < allocationWarmUp_) {
+                Frame(frame, update);
+                continue;
+            }
+            // Sites of warm up allocations would bury the steady state ones
+            if (frame == allocationWarmUp_) memory::ClearCallSites();
+            const u64 before = memory::TotalAllocations().allocations;
+            Frame(frame, update);
+            frameAllocations_ += memory::TotalAllocations().allocations - before;
         }
+        if (frameAllocations_ > 0) ReportAllocations();
         renderer.Destroy();
     } catch(std::exception &e) {
         renderer.Destroy();
-        log(logERROR) << e.what();
+        LOG(logERROR) << e.what();
+#ifdef WIN32
         MessageBoxA(window.GetHandle().hwnd, e.what(), NULL, MB_ICONERROR | MB_SETFOREGROUND);
+#endif
+    }
+}
+
+template<graphics::HRI Gfx, window::Mng<Gfx> Window>
+void Viewport<Gfx, Window>::ReportAllocations() {
+    LOG(logERROR) << "Steady state frames allocated " << frameAllocations_ << " times";
+    for (const memory::CallSite &site : memory::TopCallSites(5)) {
+        LOG(logERROR) << site.allocations << " sampled allocations of " << site.bytes << " bytes from";
+        for (const std::string &frame : site.frames) {
+            LOG(logERROR) << "    " << frame;
+        }
     }
 }
 
@@ -77,25 +141,35 @@ template<graphics::HRI Gfx, window::Mng<Gfx> Window>
 f64 Viewport<Gfx, Window>::BenchMark(u32 seconds) {
     try {
         timer.Reset();
-        while(!window.ShouldClose()) {
+        for (u32 frame = 0; !window.ShouldClose(); ++frame) {
             if (timer.TotalTime() > seconds)
                 break;
-            timer.Tick();
-            window.ClipMouse(renderer);
-            renderer.Update();
-            core::scene.Update(timer.DeltaTime());
-#ifdef WIN32
-            if constexpr (not std::same_as<Window, window::Win32>)
-                renderer.Render();
-#endif
-            window.Update();
+            Frame(frame, {});
         }
         renderer.Destroy();
     } catch(std::exception &e) {
         renderer.Destroy();
-        log(logERROR) << e.what();
+        LOG(logERROR) << e.what();
+#ifdef WIN32
         MessageBoxA(window.GetHandle().hwnd, e.what(), NULL, MB_ICONERROR | MB_SETFOREGROUND);
+#endif
     }
     return timer.MeanFps();
 }
+
+template<graphics::HRI Gfx, window::Mng<Gfx> Window>
+void Viewport<Gfx, Window>::BenchMark(u32 warmUp, u32 frames, FrameStats &stats, const std::function<void(u32)> &update) {
+    stats.Reserve(stats.FrameCount() + frames);
+    try {
+        timer.Reset();
+        for (u32 frame = 0; frame < warmUp + frames and !window.ShouldClose(); ++frame) {
+            const StageTimes times = Frame(frame, update);
+            if (frame >= warmUp) stats.Add(times);
+        }
+        renderer.Destroy();
+    } catch(std::exception &e) {
+        renderer.Destroy();
+        LOG(logERROR) << e.what();
+    }
+}
 } // reveal3d
\ No newline at end of file
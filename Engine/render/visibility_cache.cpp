@@ -0,0 +1,305 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file visibility_cache.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Temporal coherence of frustum culling
+ *
+ * Longer description
+ */
+
+#include "visibility_cache.hpp"
+#include "common/job_system.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+
+namespace reveal3d::render {
+
+namespace {
+
+constexpr u32 fullTestDivisor = 4; // Testing more than a quarter of the boxes one by one is slower than a full test
+constexpr u32 testGrain = 1024;
+
+}
+
+void VisibilityCache::Resize(u32 count) {
+    if (count < entries_.size()) {
+        Clear();
+    }
+    const u32 first = entries_.size();
+    entries_.resize(count);
+    for (u32 i = first; i < count; ++i) {
+        Invalidate(i);
+    }
+}
+
+void VisibilityCache::Clear() {
+    entries_.clear();
+    for (auto &epoch : epochs_) {
+        epoch = Epoch {};
+    }
+    pending_.clear();
+    changed_.clear();
+    newest_ = noEpoch;
+}
+
+void VisibilityCache::Invalidate(u32 index) {
+    Entry &entry = entries_[index];
+    ++entry.version;
+    if (!entry.pending) {
+        entry.pending = true;
+        pending_.push_back(index);
+    }
+}
+
+void VisibilityCache::Update(const Frustum &frustum, const CullingBoxes &boxes) {
+    changed_.clear();
+    tested_ = 0;
+
+    if (newest_ == noEpoch) {
+        TestAll(frustum, boxes);
+        return;
+    }
+
+    // With a still camera every cached result is still valid, only invalidated boxes are tested
+    if (std::memcmp(frustum.planes, last_.planes, sizeof(frustum.planes)) != 0) {
+        for (u32 e = 0; e < maxEpochs; ++e) {
+            if (!epochs_[e].used) continue;
+            f32 rotation, translation;
+            Motion(epochs_[e], frustum, rotation, translation);
+            Pop(e, epochs_[e].rotationHeap, rotation);
+            Pop(e, epochs_[e].translationHeap, translation);
+        }
+    }
+    last_ = frustum;
+
+    if (pending_.size() > entries_.size() / fullTestDivisor) {
+        TestAll(frustum, boxes);
+        return;
+    }
+    if (pending_.empty()) return;
+
+    for (const u32 index : pending_) {
+        Entry &entry = entries_[index];
+        if (entry.epoch != noEpoch) {
+            --epochs_[entry.epoch].live;
+            entry.epoch = noEpoch;
+        }
+    }
+    for (auto &epoch : epochs_) {
+        if (epoch.used and epoch.live == 0) {
+            epoch = Epoch {};
+        }
+    }
+
+    const u32 epoch = AcquireEpoch(frustum);
+    for (const u32 index : pending_) {
+        Entry &entry = entries_[index];
+        const bool wasVisible = entry.visible;
+        Test(index, epochs_[epoch], boxes);
+        entry.epoch = epoch;
+        entry.pending = false;
+        ++entry.version;
+        ++epochs_[epoch].live;
+        if (entry.visible != wasVisible) {
+            changed_.push_back(index);
+        }
+        Push(index);
+    }
+    tested_ = pending_.size();
+    pending_.clear();
+
+    // Tested boxes leave stale heap entries behind
+    for (u32 e = 0; e < maxEpochs; ++e) {
+        if (epochs_[e].used and epochs_[e].rotationHeap.size() > 2 * epochs_[e].live + 64) {
+            Compact(e);
+        }
+    }
+}
+
+void VisibilityCache::TestAll(const Frustum &frustum, const CullingBoxes &boxes) {
+    for (auto &epoch : epochs_) {
+        epoch = Epoch {};
+    }
+    newest_ = noEpoch;
+    const u32 epoch = AcquireEpoch(frustum);
+    Epoch &all = epochs_[epoch];
+
+    flipped_.resize(entries_.size());
+    jobs::ParallelFor(entries_.size(), testGrain, [&](u32 begin, u32 end) {
+        for (u32 i = begin; i < end; ++i) {
+            Entry &entry = entries_[i];
+            const bool wasVisible = entry.visible;
+            Test(i, all, boxes);
+            entry.epoch = epoch;
+            entry.pending = false;
+            ++entry.version;
+            flipped_[i] = entry.visible != wasVisible;
+        }
+    });
+
+    all.live = entries_.size();
+    all.rotationHeap.reserve(entries_.size());
+    all.translationHeap.reserve(entries_.size());
+    for (u32 i = 0; i < entries_.size(); ++i) {
+        all.rotationHeap.push_back({ entries_[i].rotation, i, entries_[i].version });
+        all.translationHeap.push_back({ entries_[i].translation, i, entries_[i].version });
+        if (flipped_[i]) {
+            changed_.push_back(i);
+        }
+    }
+    std::make_heap(all.rotationHeap.begin(), all.rotationHeap.end(), std::greater<>());
+    std::make_heap(all.translationHeap.begin(), all.translationHeap.end(), std::greater<>());
+
+    tested_ = entries_.size();
+    pending_.clear();
+    last_ = frustum;
+}
+
+/**
+ * Boxes tested with the same frustum share the newest epoch. Without free slots the
+ * epoch with less boxes is retired and its boxes are tested again with the new one
+ */
+u32 VisibilityCache::AcquireEpoch(const Frustum &frustum) {
+    if (newest_ != noEpoch and epochs_[newest_].used and
+        std::memcmp(epochs_[newest_].frustum.planes, frustum.planes, sizeof(frustum.planes)) == 0) {
+        return newest_;
+    }
+
+    u32 slot = noEpoch;
+    for (u32 e = 0; e < maxEpochs and slot == noEpoch; ++e) {
+        if (!epochs_[e].used) slot = e;
+    }
+    if (slot == noEpoch) {
+        slot = 0;
+        for (u32 e = 1; e < maxEpochs; ++e) {
+            if (epochs_[e].live < epochs_[slot].live) slot = e;
+        }
+        for (const Candidate &candidate : epochs_[slot].rotationHeap) {
+            Entry &entry = entries_[candidate.index];
+            if (candidate.version != entry.version or entry.epoch != slot or entry.pending) continue;
+            entry.epoch = noEpoch;
+            entry.pending = true;
+            pending_.push_back(candidate.index);
+        }
+    }
+
+    // Camera position solving left, right and bottom planes, orthographic frusta use the origin
+    Epoch &epoch = epochs_[slot];
+    epoch = Epoch {};
+    epoch.frustum = frustum;
+    epoch.used = true;
+
+    const math::vec4 &p1 = frustum.planes[Frustum::left];
+    const math::vec4 &p2 = frustum.planes[Frustum::right];
+    const math::vec4 &p3 = frustum.planes[Frustum::bottom];
+    const f32 cross23[3] = { p2.y * p3.z - p2.z * p3.y, p2.z * p3.x - p2.x * p3.z, p2.x * p3.y - p2.y * p3.x };
+    const f32 cross31[3] = { p3.y * p1.z - p3.z * p1.y, p3.z * p1.x - p3.x * p1.z, p3.x * p1.y - p3.y * p1.x };
+    const f32 cross12[3] = { p1.y * p2.z - p1.z * p2.y, p1.z * p2.x - p1.x * p2.z, p1.x * p2.y - p1.y * p2.x };
+    const f32 det = p1.x * cross23[0] + p1.y * cross23[1] + p1.z * cross23[2];
+    for (u32 i = 0; i < 3; ++i) {
+        epoch.apex[i] = std::abs(det) < 1e-6f ? 0.0f : -(p1.w * cross23[i] + p2.w * cross31[i] + p3.w * cross12[i]) / det;
+    }
+
+    newest_ = slot;
+    return slot;
+}
+
+/**
+ * A point x moves with respect to plane p by dn · (x - apex) + (dn · apex + dd), so the
+ * distance change of any point at most reach away from the apex is below
+ * rotation * reach + translation
+ */
+void VisibilityCache::Motion(const Epoch &epoch, const Frustum &frustum, f32 &rotation, f32 &translation) {
+    rotation = 0.0f;
+    translation = 0.0f;
+    for (u32 p = 0; p < Frustum::count; ++p) {
+        const math::vec4 &current = frustum.planes[p];
+        const math::vec4 &reference = epoch.frustum.planes[p];
+        const f32 dn[3] = { current.x - reference.x, current.y - reference.y, current.z - reference.z };
+        const f32 dd = current.w - reference.w;
+        rotation = std::max(rotation, std::sqrt(dn[0] * dn[0] + dn[1] * dn[1] + dn[2] * dn[2]));
+        translation = std::max(translation, std::abs(dn[0] * epoch.apex[0] + dn[1] * epoch.apex[1] + dn[2] * epoch.apex[2] + dd));
+    }
+}
+
+/**
+ * Same test as FrustumCull. A visible box stays visible while no plane moves more than its
+ * smallest distance, a culled box stays culled while the plane it is behind moves less than
+ * its distance to it
+ */
+void VisibilityCache::Test(u32 index, const Epoch &epoch, const CullingBoxes &boxes) {
+    const f32 cx = boxes.CenterX()[index];
+    const f32 cy = boxes.CenterY()[index];
+    const f32 cz = boxes.CenterZ()[index];
+    const f32 ex = boxes.ExtentX()[index];
+    const f32 ey = boxes.ExtentY()[index];
+    const f32 ez = boxes.ExtentZ()[index];
+
+    bool visible = true;
+    f32 inside = FLT_MAX;
+    f32 outside = 0.0f;
+    for (const math::vec4 &plane : epoch.frustum.planes) {
+        const f32 distance = plane.x * cx + plane.y * cy + plane.z * cz + plane.w;
+        const f32 radius = std::abs(plane.x) * ex + std::abs(plane.y) * ey + std::abs(plane.z) * ez;
+        const f32 farthest = distance + radius;
+        if (farthest < 0.0f) {
+            visible = false;
+            outside = std::max(outside, -farthest);
+        }
+        inside = std::min(inside, farthest);
+    }
+
+    const f32 slack = visible ? inside : outside;
+    const f32 offset[3] = { cx - epoch.apex[0], cy - epoch.apex[1], cz - epoch.apex[2] };
+    const f32 reach = std::sqrt(offset[0] * offset[0] + offset[1] * offset[1] + offset[2] * offset[2]) +
+                      std::sqrt(ex * ex + ey * ey + ez * ez);
+
+    Entry &entry = entries_[index];
+    entry.visible = visible;
+    entry.rotation = 0.5f * slack / std::max(reach, 1e-6f);
+    entry.translation = 0.5f * slack;
+}
+
+// Boxes that may have changed are marked pending
+void VisibilityCache::Pop(u32 epoch, std::vector<Candidate> &heap, f32 motion) {
+    while (!heap.empty() and heap.front().tolerance <= motion) {
+        if (pending_.size() > entries_.size() / fullTestDivisor) return;
+        std::pop_heap(heap.begin(), heap.end(), std::greater<>());
+        const Candidate candidate = heap.back();
+        heap.pop_back();
+
+        Entry &entry = entries_[candidate.index];
+        if (candidate.version != entry.version or entry.epoch != epoch or entry.pending) continue;
+        entry.pending = true;
+        pending_.push_back(candidate.index);
+    }
+}
+
+void VisibilityCache::Push(u32 index) {
+    const Entry &entry = entries_[index];
+    Epoch &epoch = epochs_[entry.epoch];
+    epoch.rotationHeap.push_back({ entry.rotation, index, entry.version });
+    std::push_heap(epoch.rotationHeap.begin(), epoch.rotationHeap.end(), std::greater<>());
+    epoch.translationHeap.push_back({ entry.translation, index, entry.version });
+    std::push_heap(epoch.translationHeap.begin(), epoch.translationHeap.end(), std::greater<>());
+}
+
+void VisibilityCache::Compact(u32 epoch) {
+    auto stale = [&](const Candidate &candidate) {
+        const Entry &entry = entries_[candidate.index];
+        return candidate.version != entry.version or entry.epoch != epoch or entry.pending;
+    };
+    for (auto *heap : { &epochs_[epoch].rotationHeap, &epochs_[epoch].translationHeap }) {
+        std::erase_if(*heap, stale);
+        std::make_heap(heap->begin(), heap->end(), std::greater<>());
+    }
+}
+
+}
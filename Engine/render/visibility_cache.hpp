@@ -0,0 +1,98 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file visibility_cache.hpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Temporal coherence of frustum culling
+ *
+ * Keeps the frustum result of every box between frames. Along with the result each box
+ * stores its slack, how far the frustum planes can move before the result may change,
+ * and its reach, how far the box goes from the camera. Plane motion since the frustum
+ * the box was tested with is bounded by rotation * reach + translation, so only boxes
+ * whose slack is below that bound are tested again.
+ *
+ * Boxes tested in the same frame share that frustum as reference and form an epoch.
+ * Half of the slack is given to each motion term and every epoch keeps its boxes in two
+ * min heaps ordered by the rotation and translation they tolerate, finding the boxes to
+ * test costs as much as the number of boxes that changed.
+ *
+ * Boxes whose bounds changed must be invalidated. When too many boxes need a test
+ * (camera jumps, big rotations) everything is tested in a single epoch.
+ */
+
+#pragma once
+
+#include "culling.hpp"
+
+#include <array>
+#include <vector>
+
+namespace reveal3d::render {
+
+class VisibilityCache {
+public:
+    // New boxes are tested in next update, shrinking resets the cache
+    void Resize(u32 count);
+    void Clear();
+    void Invalidate(u32 index);
+    void Update(const Frustum &frustum, const CullingBoxes &boxes);
+
+    [[nodiscard]] INLINE u32 Count() const { return entries_.size(); }
+    [[nodiscard]] INLINE bool Visible(u32 index) const { return entries_[index].visible; }
+    // Boxes whose result flipped in last update
+    [[nodiscard]] INLINE const std::vector<u32>& Changed() const { return changed_; }
+    // Boxes tested in last update
+    [[nodiscard]] INLINE u32 Tested() const { return tested_; }
+
+private:
+    static constexpr u32 maxEpochs = 16;
+    static constexpr u32 noEpoch = UINT_MAX;
+
+    struct Entry {
+        f32 rotation    { 0.0f }; // Motion allowed from the epoch frustum before a new test
+        f32 translation { 0.0f };
+        u32 version     { 0 };    // Heap entries with an older version are stale
+        u32 epoch       { noEpoch };
+        bool visible    { false };
+        bool pending    { false };
+    };
+
+    struct Candidate {
+        f32 tolerance;
+        u32 index;
+        u32 version;
+        bool operator>(const Candidate &other) const { return tolerance > other.tolerance; }
+    };
+
+    struct Epoch {
+        Frustum frustum {};
+        f32 apex[3] { 0.0f, 0.0f, 0.0f }; // Camera position, where side planes meet
+        std::vector<Candidate> rotationHeap;
+        std::vector<Candidate> translationHeap;
+        u32 live { 0 };
+        bool used { false };
+    };
+
+    void TestAll(const Frustum &frustum, const CullingBoxes &boxes);
+    u32 AcquireEpoch(const Frustum &frustum);
+    // Plane rotation and translation bounds between the epoch frustum and frustum
+    static void Motion(const Epoch &epoch, const Frustum &frustum, f32 &rotation, f32 &translation);
+    void Test(u32 index, const Epoch &epoch, const CullingBoxes &boxes);
+    void Pop(u32 epoch, std::vector<Candidate> &heap, f32 motion);
+    void Push(u32 index);
+    void Compact(u32 epoch);
+
+    std::vector<Entry> entries_;
+    std::array<Epoch, maxEpochs> epochs_;
+    std::vector<u32> pending_;
+    std::vector<u32> changed_;
+    std::vector<u8> flipped_;
+    Frustum last_ {};
+    u32 newest_ { noEpoch };
+    u32 tested_ { 0 };
+};
+
+}
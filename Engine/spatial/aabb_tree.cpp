@@ -0,0 +1,323 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file aabb_tree.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Dynamic AABB tree
+ *
+ * Longer description
+ */
+
+#include "aabb_tree.hpp"
+
+namespace reveal3d::spatial {
+
+void AabbTree::Insert(u32 id, const Aabb &box) {
+    if (Contains(id)) {
+        Update(id, box);
+        return;
+    }
+    if (id >= leaves_.size()) {
+        leaves_.resize(id + 1, null);
+    }
+
+    const u32 leaf = AllocateNode();
+    Node &node = nodes_[leaf];
+    node.box = Fatten(box, margin_);
+    node.id = id;
+    node.height = 0;
+
+    leaves_[id] = leaf;
+    InsertLeaf(leaf);
+    ++count_;
+}
+
+/**
+ * Boxes still inside their fat box are ignored. If the new box overlaps the old
+ * one the leaf keeps its place and ancestors are refitted, otherwise it has moved
+ * too far from its siblings and is reinserted
+ */
+bool AabbTree::Update(u32 id, const Aabb &box) {
+    if (!Contains(id)) {
+        Insert(id, box);
+        return true;
+    }
+
+    const u32 leaf = leaves_[id];
+    Node &node = nodes_[leaf];
+    if (spatial::Contains(node.box, box)) return false;
+
+    const bool nearby = Overlaps(node.box, box);
+    node.box = Fatten(box, margin_);
+    if (nearby) {
+        Refit(node.parent);
+    } else {
+        RemoveLeaf(leaf);
+        InsertLeaf(leaf);
+    }
+    return true;
+}
+
+void AabbTree::Remove(u32 id) {
+    if (!Contains(id)) return;
+
+    const u32 leaf = leaves_[id];
+    RemoveLeaf(leaf);
+    FreeNode(leaf);
+    leaves_[id] = null;
+    --count_;
+}
+
+void AabbTree::Clear() {
+    nodes_.clear();
+    leaves_.clear();
+    root_ = null;
+    freeList_ = null;
+    count_ = 0;
+}
+
+u32 AabbTree::Nearest(const math::vec3 &point, f32 maxDistance) const {
+    if (root_ == null) return null;
+
+    u32 best = null;
+    f32 bestSq = maxDistance == FLT_MAX ? FLT_MAX : maxDistance * maxDistance;
+    Stack stack(Height());
+    stack.Push(root_);
+
+    while (stack.Count() > 0) {
+        const Node &node = nodes_[stack.Pop()];
+        const f32 distanceSq = DistanceSq(node.box, point);
+        if (distanceSq >= bestSq) continue;
+
+        if (node.IsLeaf()) {
+            best = node.id;
+            bestSq = distanceSq;
+        } else {
+            // Closer child is visited first so the search bound shrinks sooner
+            const f32 d1 = DistanceSq(nodes_[node.child1].box, point);
+            const f32 d2 = DistanceSq(nodes_[node.child2].box, point);
+            stack.Push(d1 < d2 ? node.child2 : node.child1);
+            stack.Push(d1 < d2 ? node.child1 : node.child2);
+        }
+    }
+    return best;
+}
+
+f32 AabbTree::AreaRatio() const {
+    if (root_ == null) return 0.0f;
+
+    f32 total = 0.0f;
+    for (const Node &node : nodes_) {
+        if (node.height > 0) {
+            total += Area(node.box);
+        }
+    }
+    const f32 rootArea = Area(nodes_[root_].box);
+    return rootArea > 0.0f ? total / rootArea : 0.0f;
+}
+
+bool AabbTree::Validate() const {
+    u32 leaves = 0;
+    for (u32 i = 0; i < nodes_.size(); ++i) {
+        const Node &node = nodes_[i];
+        if (node.height < 0) continue;
+
+        if (i == root_ and node.parent != null) return false;
+        if (i != root_ and (node.parent == null or (nodes_[node.parent].child1 != i and nodes_[node.parent].child2 != i))) {
+            return false;
+        }
+
+        if (node.IsLeaf()) {
+            if (node.height != 0 or leaves_[node.id] != i) return false;
+            ++leaves;
+            continue;
+        }
+
+        const Node &child1 = nodes_[node.child1];
+        const Node &child2 = nodes_[node.child2];
+        if (child1.parent != i or child2.parent != i) return false;
+        if (node.height != 1 + std::max(child1.height, child2.height)) return false;
+        if (!spatial::Contains(node.box, child1.box) or !spatial::Contains(node.box, child2.box)) return false;
+    }
+    return leaves == count_;
+}
+
+u32 AabbTree::AllocateNode() {
+    if (freeList_ == null) {
+        nodes_.emplace_back();
+        return nodes_.size() - 1;
+    }
+
+    const u32 index = freeList_;
+    freeList_ = nodes_[index].parent;
+    nodes_[index] = Node();
+    return index;
+}
+
+void AabbTree::FreeNode(u32 index) {
+    nodes_[index].parent = freeList_;
+    nodes_[index].height = -1;
+    nodes_[index].child1 = null;
+    freeList_ = index;
+}
+
+void AabbTree::InsertLeaf(u32 leaf) {
+    if (root_ == null) {
+        root_ = leaf;
+        nodes_[leaf].parent = null;
+        return;
+    }
+
+    const u32 sibling = FindSibling(nodes_[leaf].box);
+    const u32 oldParent = nodes_[sibling].parent;
+    const u32 newParent = AllocateNode();
+
+    Node &parent = nodes_[newParent];
+    parent.parent = oldParent;
+    parent.child1 = sibling;
+    parent.child2 = leaf;
+    parent.box = Union(nodes_[leaf].box, nodes_[sibling].box);
+    parent.height = nodes_[sibling].height + 1;
+
+    if (oldParent == null) {
+        root_ = newParent;
+    } else if (nodes_[oldParent].child1 == sibling) {
+        nodes_[oldParent].child1 = newParent;
+    } else {
+        nodes_[oldParent].child2 = newParent;
+    }
+    nodes_[sibling].parent = newParent;
+    nodes_[leaf].parent = newParent;
+
+    Refit(oldParent);
+}
+
+void AabbTree::RemoveLeaf(u32 leaf) {
+    if (leaf == root_) {
+        root_ = null;
+        return;
+    }
+
+    const u32 parent = nodes_[leaf].parent;
+    const u32 grandParent = nodes_[parent].parent;
+    const u32 sibling = nodes_[parent].child1 == leaf ? nodes_[parent].child2 : nodes_[parent].child1;
+
+    if (grandParent == null) {
+        root_ = sibling;
+        nodes_[sibling].parent = null;
+        FreeNode(parent);
+        return;
+    }
+
+    if (nodes_[grandParent].child1 == parent) {
+        nodes_[grandParent].child1 = sibling;
+    } else {
+        nodes_[grandParent].child2 = sibling;
+    }
+    nodes_[sibling].parent = grandParent;
+    FreeNode(parent);
+    Refit(grandParent);
+}
+
+/**
+ * Descends choosing the child with lower surface area cost. Stops when creating
+ * a new parent at current node is cheaper than pushing the box further down
+ */
+u32 AabbTree::FindSibling(const Aabb &box) const {
+    u32 index = root_;
+
+    while (!nodes_[index].IsLeaf()) {
+        const Node &node = nodes_[index];
+        const f32 area = Area(node.box);
+        const f32 combinedArea = Area(Union(node.box, box));
+        const f32 cost = 2.0f * combinedArea;
+        const f32 inheritance = 2.0f * (combinedArea - area);
+
+        auto childCost = [&](u32 child) {
+            const Node &childNode = nodes_[child];
+            const f32 unionArea = Area(Union(childNode.box, box));
+            return childNode.IsLeaf() ? unionArea + inheritance : unionArea - Area(childNode.box) + inheritance;
+        };
+        const f32 cost1 = childCost(node.child1);
+        const f32 cost2 = childCost(node.child2);
+
+        if (cost < cost1 and cost < cost2) break;
+        index = cost1 < cost2 ? node.child1 : node.child2;
+    }
+    return index;
+}
+
+void AabbTree::Refit(u32 index) {
+    while (index != null) {
+        Node &node = nodes_[index];
+        const Node &child1 = nodes_[node.child1];
+        const Node &child2 = nodes_[node.child2];
+        node.box = Union(child1.box, child2.box);
+        node.height = 1 + std::max(child1.height, child2.height);
+        Rotate(index);
+        index = node.parent;
+    }
+}
+
+/**
+ *        A                 A
+ *      /   \             /   \
+ *     B     C    ->     F     C
+ *          / \               / \
+ *         F   G             B   G
+ *
+ * Swaps a child of A with a grandchild on the other side when it reduces the
+ * area of the node that changes. The four possible swaps are evaluated and the
+ * best one applied. A box doesn't change since it holds the same leaves
+ */
+void AabbTree::Rotate(u32 index) {
+    Node &a = nodes_[index];
+    if (a.height < 2) return;
+
+    enum swap : u8 { none, bf, bg, cd, ce };
+    swap best = none;
+    f32 bestGain = 0.0f;
+
+    const u32 b = a.child1;
+    const u32 c = a.child2;
+    const Node &nodeB = nodes_[b];
+    const Node &nodeC = nodes_[c];
+
+    if (!nodeC.IsLeaf()) {
+        const f32 areaC = Area(nodeC.box);
+        const f32 gainF = areaC - Area(Union(nodeB.box, nodes_[nodeC.child2].box));
+        const f32 gainG = areaC - Area(Union(nodeB.box, nodes_[nodeC.child1].box));
+        if (gainF > bestGain) { best = bf; bestGain = gainF; }
+        if (gainG > bestGain) { best = bg; bestGain = gainG; }
+    }
+    if (!nodeB.IsLeaf()) {
+        const f32 areaB = Area(nodeB.box);
+        const f32 gainD = areaB - Area(Union(nodeC.box, nodes_[nodeB.child2].box));
+        const f32 gainE = areaB - Area(Union(nodeC.box, nodes_[nodeB.child1].box));
+        if (gainD > bestGain) { best = cd; bestGain = gainD; }
+        if (gainE > bestGain) { best = ce; bestGain = gainE; }
+    }
+    if (best == none) return;
+
+    // child: direct child of A moving down, other: sibling receiving it, grandChild: moving up
+    const bool swapB = best == bf or best == bg;
+    const u32 child = swapB ? b : c;
+    const u32 other = swapB ? c : b;
+    Node &otherNode = nodes_[other];
+    const bool first = best == bf or best == cd;
+    const u32 grandChild = first ? otherNode.child1 : otherNode.child2;
+
+    if (a.child1 == child) a.child1 = grandChild; else a.child2 = grandChild;
+    if (first) otherNode.child1 = child; else otherNode.child2 = child;
+    nodes_[grandChild].parent = index;
+    nodes_[child].parent = other;
+
+    otherNode.box = Union(nodes_[otherNode.child1].box, nodes_[otherNode.child2].box);
+    otherNode.height = 1 + std::max(nodes_[otherNode.child1].height, nodes_[otherNode.child2].height);
+    a.height = 1 + std::max(nodes_[a.child1].height, nodes_[a.child2].height);
+}
+
+}
@@ -0,0 +1,180 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file aabb_tree.hpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Dynamic AABB tree
+ *
+ * Incremental bounding volume hierarchy. Leaves store fattened boxes so small
+ * movements don't touch the tree, larger ones refit the leaf in place and
+ * only far jumps reinsert it. Tree quality is kept with local rotations on
+ * the way up after every insertion, removal or refit.
+ */
+
+#pragma once
+
+#include "spatial.hpp"
+
+#include <vector>
+
+namespace reveal3d::spatial {
+
+class AabbTree {
+public:
+    explicit AabbTree(f32 margin = 0.1f) : margin_(margin) {}
+
+    void Insert(u32 id, const Aabb &box);
+    // Returns true if the tree changed
+    bool Update(u32 id, const Aabb &box);
+    void Remove(u32 id);
+    void Clear();
+
+    [[nodiscard]] INLINE bool Contains(u32 id) const { return id < leaves_.size() and leaves_[id] != null; }
+    [[nodiscard]] INLINE u32 Count() const { return count_; }
+    [[nodiscard]] INLINE u32 Height() const { return root_ == null ? 0 : nodes_[root_].height; }
+    // Fat box stored for id
+    [[nodiscard]] INLINE const Aabb& Box(u32 id) const { return nodes_[leaves_[id]].box; }
+    // Sum of internal node areas over root area, lower is better
+    [[nodiscard]] f32 AreaRatio() const;
+    [[nodiscard]] bool Validate() const;
+
+    template<typename Func> void Query(const Aabb &box, Func &&func) const;
+    template<typename Func> void Query(Planes planes, Func &&func) const;
+    template<typename Func> void Raycast(const Ray &ray, Func &&func) const;
+    [[nodiscard]] u32 Nearest(const math::vec3 &point, f32 maxDistance) const;
+
+private:
+    static constexpr u32 null = UINT_MAX;
+
+    // Depth first traversals never hold more than height + 1 nodes, trees taller than the
+    // local storage spill to the heap
+    class Stack {
+    public:
+        explicit Stack(u32 height) {
+            if (height + 1 > localSize) {
+                heap_.resize(height + 1);
+                data_ = heap_.data();
+            }
+        }
+        INLINE void Push(u32 index) { data_[count_++] = index; }
+        INLINE u32 Pop() { return data_[--count_]; }
+        [[nodiscard]] INLINE u32 Count() const { return count_; }
+
+    private:
+        static constexpr u32 localSize = 64;
+        u32 local_[localSize];
+        std::vector<u32> heap_;
+        u32 *data_ { local_ };
+        u32 count_ { 0 };
+    };
+
+    struct Node {
+        Aabb box;
+        u32 parent  { null }; // Next free node while in free list
+        u32 child1  { null };
+        u32 child2  { null };
+        u32 id      { null }; // Leaves only
+        i32 height  { 0 };    // Leaves 0, free nodes -1
+
+        [[nodiscard]] INLINE bool IsLeaf() const { return child1 == null; }
+    };
+
+    u32 AllocateNode();
+    void FreeNode(u32 index);
+    void InsertLeaf(u32 leaf);
+    void RemoveLeaf(u32 leaf);
+    [[nodiscard]] u32 FindSibling(const Aabb &box) const;
+    void Refit(u32 index);
+    void Rotate(u32 index);
+
+    std::vector<Node> nodes_;
+    std::vector<u32> leaves_; // Per id
+    u32 root_       { null };
+    u32 freeList_   { null };
+    u32 count_      { 0 };
+    f32 margin_;
+};
+
+template<typename Func>
+void AabbTree::Query(const Aabb &box, Func &&func) const {
+    if (root_ == null) return;
+
+    Stack stack(Height());
+    stack.Push(root_);
+
+    while (stack.Count() > 0) {
+        const Node &node = nodes_[stack.Pop()];
+        if (!Overlaps(node.box, box)) continue;
+
+        if (node.IsLeaf()) {
+            func(node.id);
+        } else {
+            stack.Push(node.child1);
+            stack.Push(node.child2);
+        }
+    }
+}
+
+// Sub trees fully inside the volume are reported without testing them
+template<typename Func>
+void AabbTree::Query(Planes planes, Func &&func) const {
+    if (root_ == null) return;
+
+    Stack stack(Height());
+    stack.Push(root_);
+
+    while (stack.Count() > 0) {
+        const Node &node = nodes_[stack.Pop()];
+        const Containment containment = Classify(node.box, planes);
+        if (containment == Containment::outside) continue;
+
+        if (node.IsLeaf()) {
+            func(node.id);
+        } else if (containment == Containment::intersects) {
+            stack.Push(node.child1);
+            stack.Push(node.child2);
+        } else {
+            const u32 base = stack.Count();
+            stack.Push(node.child1);
+            stack.Push(node.child2);
+            while (stack.Count() > base) {
+                const Node &inner = nodes_[stack.Pop()];
+                if (inner.IsLeaf()) {
+                    func(inner.id);
+                } else {
+                    stack.Push(inner.child1);
+                    stack.Push(inner.child2);
+                }
+            }
+        }
+    }
+}
+
+template<typename Func>
+void AabbTree::Raycast(const Ray &ray, Func &&func) const {
+    if (root_ == null) return;
+
+    const math::vec3 invDirection = InvDirection(ray.direction);
+    f32 maxDistance = ray.maxDistance;
+    Stack stack(Height());
+    stack.Push(root_);
+
+    while (stack.Count() > 0) {
+        const Node &node = nodes_[stack.Pop()];
+        const f32 distance = Intersect(node.box, ray.origin, invDirection, maxDistance);
+        if (distance == FLT_MAX) continue;
+
+        if (node.IsLeaf()) {
+            maxDistance = std::min(maxDistance, static_cast<f32>(func(node.id, distance)));
+            if (maxDistance <= 0.0f) return;
+        } else {
+            stack.Push(node.child1);
+            stack.Push(node.child2);
+        }
+    }
+}
+
+}
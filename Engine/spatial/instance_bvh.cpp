@@ -0,0 +1,216 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file instance_bvh.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Instance BVH
+ *
+ * Longer description
+ */
+
+#include "instance_bvh.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace reveal3d::spatial {
+
+namespace {
+
+// Inverse of an affine transform stored as 3 rows of 4, false if it collapses an axis
+bool InvertAffine(const f32 *m, f32 *out) {
+    const f32 c00 = m[5] * m[10] - m[6] * m[9];
+    const f32 c01 = m[6] * m[8] - m[4] * m[10];
+    const f32 c02 = m[4] * m[9] - m[5] * m[8];
+    const f32 det = m[0] * c00 + m[1] * c01 + m[2] * c02;
+    if (std::abs(det) < 1e-12f) return false;
+
+    const f32 inv = 1.0f / det;
+    const f32 r[9] = {
+        c00 * inv, (m[2] * m[9] - m[1] * m[10]) * inv, (m[1] * m[6] - m[2] * m[5]) * inv,
+        c01 * inv, (m[0] * m[10] - m[2] * m[8]) * inv, (m[2] * m[4] - m[0] * m[6]) * inv,
+        c02 * inv, (m[1] * m[8] - m[0] * m[9]) * inv, (m[0] * m[5] - m[1] * m[4]) * inv
+    };
+    for (u32 row = 0; row < 3; ++row) {
+        out[row * 4 + 0] = r[row * 3 + 0];
+        out[row * 4 + 1] = r[row * 3 + 1];
+        out[row * 4 + 2] = r[row * 3 + 2];
+        out[row * 4 + 3] = -(r[row * 3 + 0] * m[3] + r[row * 3 + 1] * m[7] + r[row * 3 + 2] * m[11]);
+    }
+    return true;
+}
+
+INLINE f32 Component(const math::vec3 &v, u32 axis) {
+    return axis == 0 ? v.x : axis == 1 ? v.y : v.z;
+}
+
+} // Anonymous namespace
+
+void InstanceBvh::Build(std::span<const Instance> instances) {
+    Clear();
+    leaves_.reserve(instances.size());
+    order_.reserve(instances.size());
+    for (u32 i = 0; i < instances.size(); ++i) {
+        Leaf leaf { instances[i].bvh, {}, i };
+        if (leaf.bvh == nullptr or leaf.bvh->TriangleCount() == 0 or !InvertAffine(instances[i].world, leaf.toObject)) continue;
+        leaves_.push_back(leaf);
+        order_.push_back(leaves_.size() - 1);
+    }
+    if (leaves_.empty()) return;
+
+    nodes_.reserve(leaves_.size() * 2);
+    nodes_.push_back({ {}, 0, {}, (u32) leaves_.size() });
+    UpdateBounds(0, instances);
+    Subdivide(0, instances, 0);
+
+    std::vector<Leaf> sorted(leaves_.size());
+    for (u32 i = 0; i < order_.size(); ++i) {
+        sorted[i] = leaves_[order_[i]];
+    }
+    leaves_ = std::move(sorted);
+    order_.clear();
+}
+
+void InstanceBvh::Clear() {
+    nodes_.clear();
+    leaves_.clear();
+    order_.clear();
+}
+
+/**
+ * Top level nodes are few, so they are tested lane by lane. Every instance reached gets
+ * the packet in its object space, with the world distances of the hits as limits
+ */
+u32 InstanceBvh::RaycastPacket(const RayPacket &packet, SceneHit &hit) const {
+    if (nodes_.empty()) return 0;
+
+    f32 inv[3][4];
+    u32 active = 0;
+    for (u32 lane = 0; lane < 4; ++lane) {
+        for (u32 i = 0; i < 3; ++i) {
+            inv[i][lane] = 1.0f / packet.direction[i][lane];
+        }
+        active |= (hit.distance[lane] > 0.0f ? 1U : 0U) << lane;
+    }
+    if (active == 0) return 0;
+
+    auto intersectNode = [&](const Node &node) {
+        f32 nearest = FLT_MAX;
+        for (u32 lane = 0; lane < 4; ++lane) {
+            if ((active & (1U << lane)) == 0) continue;
+            f32 tMin = 0.0f;
+            f32 tMax = hit.distance[lane];
+            for (u32 i = 0; i < 3; ++i) {
+                const f32 t1 = (node.min[i] - packet.origin[i][lane]) * inv[i][lane];
+                const f32 t2 = (node.max[i] - packet.origin[i][lane]) * inv[i][lane];
+                tMin = std::max(tMin, std::min(t1, t2));
+                tMax = std::min(tMax, std::max(t1, t2));
+            }
+            if (tMin <= tMax) nearest = std::min(nearest, tMin);
+        }
+        return nearest;
+    };
+    auto farthest = [&] {
+        f32 distance = 0.0f;
+        for (u32 lane = 0; lane < 4; ++lane) {
+            if (active & (1U << lane)) distance = std::max(distance, hit.distance[lane]);
+        }
+        return distance;
+    };
+
+    struct Entry {
+        u32 node;
+        f32 distance;
+    };
+    Entry stack[stackSize];
+    u32 count = 0;
+    u32 hitMask = 0;
+
+    const f32 rootDistance = intersectNode(nodes_[0]);
+    if (rootDistance == FLT_MAX) return 0;
+    stack[count++] = { 0, rootDistance };
+    f32 limit = farthest();
+
+    while (count > 0) {
+        const Entry entry = stack[--count];
+        if (entry.distance >= limit) continue;
+        const Node &node = nodes_[entry.node];
+
+        if (node.count > 0) {
+            for (u32 i = node.first; i < node.first + node.count; ++i) {
+                const Leaf &leaf = leaves_[i];
+                const f32 *m = leaf.toObject;
+                RayPacket local;
+                for (u32 lane = 0; lane < 4; ++lane) {
+                    const f32 o[3] = { packet.origin[0][lane], packet.origin[1][lane], packet.origin[2][lane] };
+                    const f32 d[3] = { packet.direction[0][lane], packet.direction[1][lane], packet.direction[2][lane] };
+                    for (u32 row = 0; row < 3; ++row) {
+                        local.origin[row][lane] = m[row * 4] * o[0] + m[row * 4 + 1] * o[1] + m[row * 4 + 2] * o[2] + m[row * 4 + 3];
+                        local.direction[row][lane] = m[row * 4] * d[0] + m[row * 4 + 1] * d[1] + m[row * 4 + 2] * d[2];
+                    }
+                }
+                const u32 lanes = leaf.bvh->RaycastPacket(local, hit);
+                if (lanes == 0) continue;
+                for (u32 lane = 0; lane < 4; ++lane) {
+                    if (lanes & (1U << lane)) hit.instance[lane] = leaf.id;
+                }
+                hitMask |= lanes;
+                limit = farthest();
+            }
+            continue;
+        }
+
+        Entry near { node.first, intersectNode(nodes_[node.first]) };
+        Entry far { node.first + 1, intersectNode(nodes_[node.first + 1]) };
+        if (far.distance < near.distance) std::swap(near, far);
+        if (far.distance != FLT_MAX) stack[count++] = far;
+        if (near.distance != FLT_MAX) stack[count++] = near;
+    }
+    return hitMask;
+}
+
+void InstanceBvh::UpdateBounds(u32 node, std::span<const Instance> instances) {
+    Node &n = nodes_[node];
+    Aabb bounds = instances[leaves_[order_[n.first]].id].bounds;
+    for (u32 i = n.first + 1; i < n.first + n.count; ++i) {
+        bounds = Union(bounds, instances[leaves_[order_[i]].id].bounds);
+    }
+    n.min[0] = bounds.min.x; n.min[1] = bounds.min.y; n.min[2] = bounds.min.z;
+    n.max[0] = bounds.max.x; n.max[1] = bounds.max.y; n.max[2] = bounds.max.z;
+}
+
+// Median split of the centers along the widest axis, instance counts are low enough
+void InstanceBvh::Subdivide(u32 node, std::span<const Instance> instances, u32 depth) {
+    const u32 first = nodes_[node].first;
+    const u32 count = nodes_[node].count;
+    if (count <= maxLeafSize or depth + 2 >= stackSize) return;
+
+    Aabb centers { { FLT_MAX, FLT_MAX, FLT_MAX }, { -FLT_MAX, -FLT_MAX, -FLT_MAX } };
+    for (u32 i = first; i < first + count; ++i) {
+        const math::vec3 center = Center(instances[leaves_[order_[i]].id].bounds);
+        centers = Union(centers, { center, center });
+    }
+    const math::vec3 extent { centers.max.x - centers.min.x, centers.max.y - centers.min.y, centers.max.z - centers.min.z };
+    const u32 axis = extent.x >= extent.y and extent.x >= extent.z ? 0 : extent.y >= extent.z ? 1 : 2;
+
+    const u32 leftCount = count / 2;
+    std::nth_element(order_.begin() + first, order_.begin() + first + leftCount, order_.begin() + first + count, [&](u32 a, u32 b) {
+        return Component(Center(instances[leaves_[a].id].bounds), axis) < Component(Center(instances[leaves_[b].id].bounds), axis);
+    });
+
+    const u32 left = nodes_.size();
+    nodes_.push_back({ {}, first, {}, leftCount });
+    nodes_.push_back({ {}, first + leftCount, {}, count - leftCount });
+    nodes_[node].first = left;
+    nodes_[node].count = 0;
+
+    UpdateBounds(left, instances);
+    UpdateBounds(left + 1, instances);
+    Subdivide(left, instances, depth + 1);
+    Subdivide(left + 1, instances, depth + 1);
+}
+
+}
@@ -0,0 +1,72 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file instance_bvh.hpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Instance BVH
+ *
+ * Top level of a two level hierarchy: a BVH over the world bounds of placed instances,
+ * each of them pointing to the triangle BVH of its mesh. Instances of the same mesh share
+ * the triangle BVH, rays are moved to object space when they reach an instance. Rebuilt
+ * from scratch when instances move, it's cheap next to the triangle BVHs.
+ */
+
+#pragma once
+
+#include "spatial.hpp"
+#include "triangle_bvh.hpp"
+
+#include <span>
+#include <vector>
+
+namespace reveal3d::spatial {
+
+struct SceneHit : PacketHit {
+    u32 instance[4] { UINT_MAX, UINT_MAX, UINT_MAX, UINT_MAX }; // Position in the built instances
+};
+
+class InstanceBvh {
+public:
+    struct Instance {
+        const TriangleBvh *bvh;
+        f32 world[12];  // Object to world rows, translation in the last column
+        Aabb bounds;    // World bounds
+    };
+
+    void Build(std::span<const Instance> instances);
+    void Clear();
+    // Same rules as TriangleBvh::RaycastPacket, distances are kept in world units
+    u32 RaycastPacket(const RayPacket &packet, SceneHit &hit) const;
+
+    [[nodiscard]] INLINE u32 InstanceCount() const { return leaves_.size(); }
+    [[nodiscard]] INLINE u32 NodeCount() const { return nodes_.size(); }
+
+private:
+    static constexpr u32 maxLeafSize = 2;
+    static constexpr u32 stackSize = 64;
+
+    struct Node {
+        f32 min[3];
+        u32 first;  // First leaf if leaf, left child otherwise (right is left + 1)
+        f32 max[3];
+        u32 count;  // 0 for internal nodes
+    };
+
+    struct Leaf {
+        const TriangleBvh *bvh;
+        f32 toObject[12]; // Inverse of the world rows
+        u32 id;
+    };
+
+    void UpdateBounds(u32 node, std::span<const Instance> instances);
+    void Subdivide(u32 node, std::span<const Instance> instances, u32 depth);
+
+    std::vector<Node> nodes_;
+    std::vector<Leaf> leaves_;
+    std::vector<u32> order_; // Build only, instances in leaf order
+};
+
+}
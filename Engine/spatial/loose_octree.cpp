@@ -0,0 +1,204 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file loose_octree.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Loose octree
+ *
+ * Longer description
+ */
+
+#include "loose_octree.hpp"
+
+#include <bit>
+
+namespace reveal3d::spatial {
+
+namespace {
+
+constexpr u64 rootKey = 1;
+
+u64 Morton(u32 x, u32 y, u32 z, u32 bits) {
+    u64 code = 0;
+    for (u32 i = 0; i < bits; ++i) {
+        code |= (u64) ((x >> i) & 1) << (3 * i);
+        code |= (u64) ((y >> i) & 1) << (3 * i + 1);
+        code |= (u64) ((z >> i) & 1) << (3 * i + 2);
+    }
+    return code;
+}
+
+} // Anonymous namespace
+
+LooseOctree::LooseOctree(math::vec3 center, f32 halfSize, u32 maxDepth) :
+        min_ { center.x - halfSize, center.y - halfSize, center.z - halfSize },
+        size_(halfSize * 2.0f),
+        maxDepth_(std::min(maxDepth, 16U))
+{
+
+}
+
+void LooseOctree::Insert(u32 id, const Aabb &box) {
+    if (Contains(id)) {
+        Update(id, box);
+        return;
+    }
+    if (id >= objects_.size()) {
+        objects_.resize(id + 1);
+    }
+
+    objects_[id].box = box;
+    Attach(id, GetNode(KeyFor(box)));
+    ++count_;
+}
+
+bool LooseOctree::Update(u32 id, const Aabb &box) {
+    if (!Contains(id)) {
+        Insert(id, box);
+        return true;
+    }
+
+    objects_[id].box = box;
+    const u32 node = GetNode(KeyFor(box));
+    if (node == objects_[id].node) return false;
+
+    Detach(id);
+    Attach(id, node);
+    return true;
+}
+
+void LooseOctree::Remove(u32 id) {
+    if (!Contains(id)) return;
+
+    Detach(id);
+    --count_;
+}
+
+void LooseOctree::Clear() {
+    keys_.clear();
+    nodes_.clear();
+    objects_.clear();
+    count_ = 0;
+}
+
+u32 LooseOctree::Nearest(const math::vec3 &point, f32 maxDistance) const {
+    if (nodes_.empty()) return null;
+
+    u32 best = null;
+    f32 bestSq = maxDistance == FLT_MAX ? FLT_MAX : maxDistance * maxDistance;
+    u32 stack[stackSize];
+    u32 count = 0;
+    stack[count++] = 0;
+
+    while (count > 0) {
+        const u32 index = stack[--count];
+        const Node &node = nodes_[index];
+        if (node.subtreeCount == 0) continue;
+        if (index != 0 and DistanceSq(node.looseBox, point) >= bestSq) continue;
+
+        for (const u32 id : node.objects) {
+            const f32 distanceSq = DistanceSq(objects_[id].box, point);
+            if (distanceSq < bestSq) {
+                best = id;
+                bestSq = distanceSq;
+            }
+        }
+        for (const u32 child : node.children) {
+            if (child != null) {
+                assert(count < stackSize);
+                stack[count++] = child;
+            }
+        }
+    }
+    return best;
+}
+
+/**
+ * Deepest level whose cell size is still bigger than the object, the cell is the
+ * one containing its center. Objects outside the bounds go to the root
+ */
+u64 LooseOctree::KeyFor(const Aabb &box) const {
+    const math::vec3 center = Center(box);
+    const f32 relative[3] = { (center.x - min_.x) / size_, (center.y - min_.y) / size_, (center.z - min_.z) / size_ };
+    for (const f32 value : relative) {
+        if (!(value >= 0.0f and value < 1.0f)) return rootKey;
+    }
+
+    const f32 extent = std::max({ box.max.x - box.min.x, box.max.y - box.min.y, box.max.z - box.min.z });
+    u32 level = maxDepth_;
+    if (extent > 0.0f) {
+        const f32 fit = std::floor(std::log2(size_ / extent));
+        level = fit <= 0.0f ? 0 : std::min(maxDepth_, (u32) fit);
+    }
+
+    const u32 cells = 1U << level;
+    u32 coords[3];
+    for (u32 i = 0; i < 3; ++i) {
+        coords[i] = std::min((u32) (relative[i] * (f32) cells), cells - 1);
+    }
+    return (rootKey << (3 * level)) | Morton(coords[0], coords[1], coords[2], level);
+}
+
+Aabb LooseOctree::LooseBox(u64 key) const {
+    const u32 level = (std::bit_width(key) - 1) / 3;
+    u32 coords[3] = { 0, 0, 0 };
+    for (u32 i = 0; i < level; ++i) {
+        coords[0] |= ((key >> (3 * i)) & 1) << i;
+        coords[1] |= ((key >> (3 * i + 1)) & 1) << i;
+        coords[2] |= ((key >> (3 * i + 2)) & 1) << i;
+    }
+
+    const f32 cell = size_ / (f32) (1U << level);
+    const math::vec3 min { min_.x + coords[0] * cell, min_.y + coords[1] * cell, min_.z + coords[2] * cell };
+    // Twice the cell size, centered on it
+    return Fatten({ min, { min.x + cell, min.y + cell, min.z + cell } }, cell * 0.5f);
+}
+
+u32 LooseOctree::GetNode(u64 key) {
+    if (auto it = keys_.find(key); it != keys_.end()) {
+        return it->second;
+    }
+
+    const u32 parent = key == rootKey ? null : GetNode(key >> 3);
+    const u32 index = nodes_.size();
+    Node &node = nodes_.emplace_back();
+    node.looseBox = LooseBox(key);
+    node.parent = parent;
+    keys_.emplace(key, index);
+
+    if (parent != null) {
+        nodes_[parent].children[key & 7] = index;
+    }
+    return index;
+}
+
+void LooseOctree::Attach(u32 id, u32 node) {
+    Object &object = objects_[id];
+    object.node = node;
+    object.slot = nodes_[node].objects.size();
+    nodes_[node].objects.push_back(id);
+
+    for (u32 current = node; current != null; current = nodes_[current].parent) {
+        ++nodes_[current].subtreeCount;
+    }
+}
+
+void LooseOctree::Detach(u32 id) {
+    Object &object = objects_[id];
+    std::vector<u32> &objects = nodes_[object.node].objects;
+
+    const u32 last = objects.back();
+    objects[object.slot] = last;
+    objects_[last].slot = object.slot;
+    objects.pop_back();
+
+    for (u32 current = object.node; current != null; current = nodes_[current].parent) {
+        --nodes_[current].subtreeCount;
+    }
+    object.node = null;
+}
+
+}
@@ -0,0 +1,196 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file loose_octree.hpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Loose octree
+ *
+ * Octree with nodes twice their cell size, so an object always fits in the node
+ * of the level matching its size that contains its center. That node is computed
+ * directly, no descent, so updates are O(1) amortized. Nodes are stored in a hash
+ * map keyed by their locational code (sentinel bit followed by morton code).
+ * Objects outside the octree bounds live in the root.
+ */
+
+#pragma once
+
+#include "spatial.hpp"
+
+#include <cassert>
+#include <unordered_map>
+#include <vector>
+
+namespace reveal3d::spatial {
+
+class LooseOctree {
+public:
+    explicit LooseOctree(math::vec3 center = { 0.0f, 0.0f, 0.0f }, f32 halfSize = 1024.0f, u32 maxDepth = 8);
+
+    void Insert(u32 id, const Aabb &box);
+    // Returns true if the object changed node
+    bool Update(u32 id, const Aabb &box);
+    void Remove(u32 id);
+    void Clear();
+
+    [[nodiscard]] INLINE bool Contains(u32 id) const { return id < objects_.size() and objects_[id].node != null; }
+    [[nodiscard]] INLINE u32 Count() const { return count_; }
+    [[nodiscard]] INLINE u32 NodeCount() const { return nodes_.size(); }
+
+    template<typename Func> void Query(const Aabb &box, Func &&func) const;
+    template<typename Func> void Query(Planes planes, Func &&func) const;
+    template<typename Func> void Raycast(const Ray &ray, Func &&func) const;
+    [[nodiscard]] u32 Nearest(const math::vec3 &point, f32 maxDistance) const;
+
+private:
+    static constexpr u32 null = UINT_MAX;
+    static constexpr u32 stackSize = 512;
+
+    struct Object {
+        Aabb box;
+        u32 node { null };
+        u32 slot { 0 };
+    };
+
+    struct Node {
+        Aabb looseBox;
+        std::vector<u32> objects;
+        u32 parent { null };
+        u32 children[8] { null, null, null, null, null, null, null, null };
+        u32 subtreeCount { 0 }; // Objects in this node and below
+    };
+
+    // Locational code of the node an object fits in
+    [[nodiscard]] u64 KeyFor(const Aabb &box) const;
+    [[nodiscard]] Aabb LooseBox(u64 key) const;
+    u32 GetNode(u64 key);
+    void Attach(u32 id, u32 node);
+    void Detach(u32 id);
+    template<typename Func> void ReportSubtree(u32 node, Func &func, u32 *stack, u32 count) const;
+
+    std::unordered_map<u64, u32> keys_;
+    std::vector<Node> nodes_;
+    std::vector<Object> objects_; // Per id
+    math::vec3 min_;
+    f32 size_;
+    u32 maxDepth_;
+    u32 count_ { 0 };
+};
+
+template<typename Func>
+void LooseOctree::Query(const Aabb &box, Func &&func) const {
+    if (nodes_.empty()) return;
+
+    u32 stack[stackSize];
+    u32 count = 0;
+    stack[count++] = 0;
+
+    while (count > 0) {
+        const u32 index = stack[--count];
+        const Node &node = nodes_[index];
+        if (node.subtreeCount == 0) continue;
+        // Root also holds objects outside the octree bounds, its box can't be trusted
+        if (index != 0 and !Overlaps(node.looseBox, box)) continue;
+
+        for (const u32 id : node.objects) {
+            if (Overlaps(objects_[id].box, box)) {
+                func(id);
+            }
+        }
+        for (const u32 child : node.children) {
+            if (child != null) {
+                assert(count < stackSize);
+                stack[count++] = child;
+            }
+        }
+    }
+}
+
+template<typename Func>
+void LooseOctree::Query(Planes planes, Func &&func) const {
+    if (nodes_.empty()) return;
+
+    u32 stack[stackSize];
+    u32 count = 0;
+    stack[count++] = 0;
+
+    while (count > 0) {
+        const u32 index = stack[--count];
+        const Node &node = nodes_[index];
+        if (node.subtreeCount == 0) continue;
+
+        const Containment containment = index == 0 ? Containment::intersects : Classify(node.looseBox, planes);
+        if (containment == Containment::outside) continue;
+        if (containment == Containment::inside) {
+            ReportSubtree(index, func, stack, count);
+            continue;
+        }
+
+        for (const u32 id : node.objects) {
+            if (Classify(objects_[id].box, planes) != Containment::outside) {
+                func(id);
+            }
+        }
+        for (const u32 child : node.children) {
+            if (child != null) {
+                assert(count < stackSize);
+                stack[count++] = child;
+            }
+        }
+    }
+}
+
+template<typename Func>
+void LooseOctree::Raycast(const Ray &ray, Func &&func) const {
+    if (nodes_.empty()) return;
+
+    const math::vec3 invDirection = InvDirection(ray.direction);
+    f32 maxDistance = ray.maxDistance;
+    u32 stack[stackSize];
+    u32 count = 0;
+    stack[count++] = 0;
+
+    while (count > 0) {
+        const u32 index = stack[--count];
+        const Node &node = nodes_[index];
+        if (node.subtreeCount == 0) continue;
+        if (index != 0 and Intersect(node.looseBox, ray.origin, invDirection, maxDistance) == FLT_MAX) continue;
+
+        for (const u32 id : node.objects) {
+            const f32 distance = Intersect(objects_[id].box, ray.origin, invDirection, maxDistance);
+            if (distance != FLT_MAX) {
+                maxDistance = std::min(maxDistance, static_cast<f32>(func(id, distance)));
+                if (maxDistance <= 0.0f) return;
+            }
+        }
+        for (const u32 child : node.children) {
+            if (child != null) {
+                assert(count < stackSize);
+                stack[count++] = child;
+            }
+        }
+    }
+}
+
+template<typename Func>
+void LooseOctree::ReportSubtree(u32 node, Func &func, u32 *stack, u32 count) const {
+    const u32 base = count;
+    stack[count++] = node;
+    while (count > base) {
+        const Node &current = nodes_[stack[--count]];
+        if (current.subtreeCount == 0) continue;
+        for (const u32 id : current.objects) {
+            func(id);
+        }
+        for (const u32 child : current.children) {
+            if (child != null) {
+                assert(count < stackSize);
+                stack[count++] = child;
+            }
+        }
+    }
+}
+
+}
@@ -0,0 +1,143 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file spatial.hpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Spatial index interface
+ *
+ * Every spatial index stores world AABBs keyed by a dense user id (entity index)
+ * and answers the same queries, so they can be swapped per scene. Query callbacks
+ * receive the id of every candidate whose AABB passes the test.
+ */
+
+#pragma once
+
+#include "render/mesh.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <concepts>
+#include <span>
+
+namespace reveal3d::spatial {
+
+struct Aabb {
+    math::vec3 min { 0.0f, 0.0f, 0.0f };
+    math::vec3 max { 0.0f, 0.0f, 0.0f };
+};
+
+struct Ray {
+    math::vec3 origin { 0.0f, 0.0f, 0.0f };
+    math::vec3 direction { 0.0f, 0.0f, 1.0f };
+    f32 maxDistance { FLT_MAX };
+};
+
+// Planes pointing inwards, xyz is the normal and w the distance
+using Planes = std::span<const math::vec4>;
+
+INLINE Aabb ToAabb(const render::Bounds &bounds) {
+    return {
+        { bounds.center.x - bounds.extents.x, bounds.center.y - bounds.extents.y, bounds.center.z - bounds.extents.z },
+        { bounds.center.x + bounds.extents.x, bounds.center.y + bounds.extents.y, bounds.center.z + bounds.extents.z }
+    };
+}
+
+INLINE Aabb Union(const Aabb &a, const Aabb &b) {
+    return {
+        { std::min(a.min.x, b.min.x), std::min(a.min.y, b.min.y), std::min(a.min.z, b.min.z) },
+        { std::max(a.max.x, b.max.x), std::max(a.max.y, b.max.y), std::max(a.max.z, b.max.z) }
+    };
+}
+
+INLINE Aabb Fatten(const Aabb &box, f32 margin) {
+    return {
+        { box.min.x - margin, box.min.y - margin, box.min.z - margin },
+        { box.max.x + margin, box.max.y + margin, box.max.z + margin }
+    };
+}
+
+INLINE math::vec3 Center(const Aabb &box) {
+    return { (box.min.x + box.max.x) * 0.5f, (box.min.y + box.max.y) * 0.5f, (box.min.z + box.max.z) * 0.5f };
+}
+
+// Half of the surface area, enough to compare costs
+INLINE f32 Area(const Aabb &box) {
+    const f32 x = box.max.x - box.min.x;
+    const f32 y = box.max.y - box.min.y;
+    const f32 z = box.max.z - box.min.z;
+    return x * y + y * z + z * x;
+}
+
+INLINE bool Contains(const Aabb &outer, const Aabb &inner) {
+    return outer.min.x <= inner.min.x and outer.min.y <= inner.min.y and outer.min.z <= inner.min.z and
+           outer.max.x >= inner.max.x and outer.max.y >= inner.max.y and outer.max.z >= inner.max.z;
+}
+
+INLINE bool Overlaps(const Aabb &a, const Aabb &b) {
+    return a.min.x <= b.max.x and a.max.x >= b.min.x and
+           a.min.y <= b.max.y and a.max.y >= b.min.y and
+           a.min.z <= b.max.z and a.max.z >= b.min.z;
+}
+
+INLINE f32 DistanceSq(const Aabb &box, const math::vec3 &point) {
+    const f32 x = std::max({ box.min.x - point.x, 0.0f, point.x - box.max.x });
+    const f32 y = std::max({ box.min.y - point.y, 0.0f, point.y - box.max.y });
+    const f32 z = std::max({ box.min.z - point.z, 0.0f, point.z - box.max.z });
+    return x * x + y * y + z * z;
+}
+
+enum class Containment : u8 { outside, intersects, inside };
+
+INLINE Containment Classify(const Aabb &box, Planes planes) {
+    const math::vec3 c = Center(box);
+    const math::vec3 e { box.max.x - c.x, box.max.y - c.y, box.max.z - c.z };
+    Containment result = Containment::inside;
+    for (const math::vec4 &plane : planes) {
+        const f32 distance = plane.x * c.x + plane.y * c.y + plane.z * c.z + plane.w;
+        const f32 radius = std::abs(plane.x) * e.x + std::abs(plane.y) * e.y + std::abs(plane.z) * e.z;
+        if (distance + radius < 0.0f) return Containment::outside;
+        if (distance - radius < 0.0f) result = Containment::intersects;
+    }
+    return result;
+}
+
+// Slab test, inverse direction is precomputed by the caller. Returns entry distance or FLT_MAX
+INLINE f32 Intersect(const Aabb &box, const math::vec3 &origin, const math::vec3 &invDirection, f32 maxDistance) {
+    const f32 tx1 = (box.min.x - origin.x) * invDirection.x;
+    const f32 tx2 = (box.max.x - origin.x) * invDirection.x;
+    const f32 ty1 = (box.min.y - origin.y) * invDirection.y;
+    const f32 ty2 = (box.max.y - origin.y) * invDirection.y;
+    const f32 tz1 = (box.min.z - origin.z) * invDirection.z;
+    const f32 tz2 = (box.max.z - origin.z) * invDirection.z;
+    const f32 tMin = std::max({ std::min(tx1, tx2), std::min(ty1, ty2), std::min(tz1, tz2), 0.0f });
+    const f32 tMax = std::min({ std::max(tx1, tx2), std::max(ty1, ty2), std::max(tz1, tz2), maxDistance });
+    return tMin <= tMax ? tMin : FLT_MAX;
+}
+
+INLINE math::vec3 InvDirection(const math::vec3 &direction) {
+    return { 1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z };
+}
+
+/**
+ * Raycast callbacks return the new max distance of the ray, so closest hit searches
+ * can clip it (return hit distance) and any hit searches can stop (return 0)
+ */
+template<typename T>
+concept Index = requires(T index, const T cIndex, u32 id, Aabb box, Ray ray, Planes planes, math::vec3 point) {
+    {index.Insert(id, box)} -> std::same_as<void>;
+    {index.Update(id, box)} -> std::same_as<bool>;
+    {index.Remove(id)} -> std::same_as<void>;
+    {index.Clear()} -> std::same_as<void>;
+    {cIndex.Contains(id)} -> std::same_as<bool>;
+    {cIndex.Count()} -> std::same_as<u32>;
+    {cIndex.Query(box, [](u32) {})} -> std::same_as<void>;
+    {cIndex.Query(planes, [](u32) {})} -> std::same_as<void>;
+    {cIndex.Raycast(ray, [](u32, f32 distance) { return distance; })} -> std::same_as<void>;
+    {cIndex.Nearest(point, FLT_MAX)} -> std::same_as<u32>;
+};
+
+}
@@ -0,0 +1,433 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file triangle_bvh.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Triangle BVH
+ *
+ * Longer description
+ */
+
+#include "triangle_bvh.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#ifdef REVEAL3D_SSE
+#include <emmintrin.h>
+#endif
+
+namespace reveal3d::spatial {
+
+namespace {
+
+constexpr f32 epsilon = 1e-8f;
+
+INLINE f32 Dot(const f32 *a, const f32 *b) {
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+INLINE void Cross(const f32 *a, const f32 *b, f32 *out) {
+    out[0] = a[1] * b[2] - a[2] * b[1];
+    out[1] = a[2] * b[0] - a[0] * b[2];
+    out[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+INLINE f32 HalfArea(const f32 *min, const f32 *max) {
+    const f32 x = max[0] - min[0];
+    const f32 y = max[1] - min[1];
+    const f32 z = max[2] - min[2];
+    return x * y + y * z + z * x;
+}
+
+struct Bin {
+    f32 min[3] { FLT_MAX, FLT_MAX, FLT_MAX };
+    f32 max[3] { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+    u32 count { 0 };
+
+    INLINE void Grow(const f32 *bounds) {
+        for (u32 i = 0; i < 3; ++i) {
+            min[i] = std::min(min[i], bounds[i]);
+            max[i] = std::max(max[i], bounds[i + 3]);
+        }
+    }
+
+    INLINE void Grow(const Bin &bin) {
+        for (u32 i = 0; i < 3; ++i) {
+            min[i] = std::min(min[i], bin.min[i]);
+            max[i] = std::max(max[i], bin.max[i]);
+        }
+        count += bin.count;
+    }
+};
+
+} // Anonymous namespace
+
+void TriangleBvh::Build(const render::Vertex *vertices, const u32 *indices, u32 indexCount) {
+    const u32 count = indexCount / 3;
+    std::vector<Triangle> source(count);
+    BuildData data;
+    data.centroids.resize(count * 3);
+    data.bounds.resize(count * 6);
+    data.order.resize(count);
+
+    nodes_.clear();
+    triangles_.clear();
+    ids_.clear();
+    if (count == 0) return;
+
+    for (u32 t = 0; t < count; ++t) {
+        const math::vec3 &p0 = vertices[indices[t * 3 + 0]].pos;
+        const math::vec3 &p1 = vertices[indices[t * 3 + 1]].pos;
+        const math::vec3 &p2 = vertices[indices[t * 3 + 2]].pos;
+        const f32 points[3][3] = { { p0.x, p0.y, p0.z }, { p1.x, p1.y, p1.z }, { p2.x, p2.y, p2.z } };
+
+        Triangle &triangle = source[t];
+        for (u32 i = 0; i < 3; ++i) {
+            triangle.v0[i] = points[0][i];
+            triangle.edge1[i] = points[1][i] - points[0][i];
+            triangle.edge2[i] = points[2][i] - points[0][i];
+            data.centroids[t * 3 + i] = (points[0][i] + points[1][i] + points[2][i]) * (1.0f / 3.0f);
+            data.bounds[t * 6 + i] = std::min({ points[0][i], points[1][i], points[2][i] });
+            data.bounds[t * 6 + i + 3] = std::max({ points[0][i], points[1][i], points[2][i] });
+        }
+        data.order[t] = t;
+    }
+
+    nodes_.reserve(count * 2);
+    nodes_.push_back({ {}, 0, {}, count });
+    UpdateBounds(0, data);
+    Subdivide(0, data, 0);
+
+    triangles_.resize(count);
+    ids_ = std::move(data.order);
+    for (u32 i = 0; i < count; ++i) {
+        triangles_[i] = source[ids_[i]];
+    }
+    nodes_.shrink_to_fit();
+}
+
+/**
+ * Nearest child first traversal, the other one is pushed and skipped later if
+ * a closer hit was found meanwhile
+ */
+bool TriangleBvh::Raycast(const math::vec3 &origin, const math::vec3 &direction, f32 maxDistance, TriangleHit &hit) const {
+    if (nodes_.empty()) return false;
+
+    const f32 o[3] = { origin.x, origin.y, origin.z };
+    const f32 d[3] = { direction.x, direction.y, direction.z };
+    const f32 inv[3] = { 1.0f / d[0], 1.0f / d[1], 1.0f / d[2] };
+    f32 closest = maxDistance;
+    bool found = false;
+
+    auto intersectNode = [&](const Node &node) {
+        f32 tMin = 0.0f;
+        f32 tMax = closest;
+        for (u32 i = 0; i < 3; ++i) {
+            const f32 t1 = (node.min[i] - o[i]) * inv[i];
+            const f32 t2 = (node.max[i] - o[i]) * inv[i];
+            tMin = std::max(tMin, std::min(t1, t2));
+            tMax = std::min(tMax, std::max(t1, t2));
+        }
+        return tMin <= tMax ? tMin : FLT_MAX;
+    };
+
+    struct Entry {
+        u32 node;
+        f32 distance;
+    };
+    Entry stack[stackSize];
+    u32 count = 0;
+
+    const f32 rootDistance = intersectNode(nodes_[0]);
+    if (rootDistance == FLT_MAX) return false;
+    stack[count++] = { 0, rootDistance };
+
+    while (count > 0) {
+        const Entry entry = stack[--count];
+        if (entry.distance >= closest) continue;
+        const Node &node = nodes_[entry.node];
+
+        if (node.count > 0) {
+            for (u32 i = node.first; i < node.first + node.count; ++i) {
+                const Triangle &triangle = triangles_[i];
+                f32 h[3];
+                Cross(d, triangle.edge2, h);
+                const f32 a = Dot(triangle.edge1, h);
+                if (std::abs(a) < epsilon) continue;
+
+                const f32 f = 1.0f / a;
+                const f32 s[3] = { o[0] - triangle.v0[0], o[1] - triangle.v0[1], o[2] - triangle.v0[2] };
+                const f32 u = f * Dot(s, h);
+                if (u < 0.0f or u > 1.0f) continue;
+
+                f32 q[3];
+                Cross(s, triangle.edge1, q);
+                const f32 v = f * Dot(d, q);
+                if (v < 0.0f or u + v > 1.0f) continue;
+
+                const f32 t = f * Dot(triangle.edge2, q);
+                if (t > epsilon and t < closest) {
+                    closest = t;
+                    hit = { t, ids_[i], u, v };
+                    found = true;
+                }
+            }
+            continue;
+        }
+
+        Entry near { node.first, intersectNode(nodes_[node.first]) };
+        Entry far { node.first + 1, intersectNode(nodes_[node.first + 1]) };
+        if (far.distance < near.distance) std::swap(near, far);
+        if (far.distance != FLT_MAX) stack[count++] = far;
+        if (near.distance != FLT_MAX) stack[count++] = near;
+    }
+    return found;
+}
+
+#ifdef REVEAL3D_SSE
+
+/**
+ * Same traversal as Raycast with four lanes at once. A node is visited while any lane
+ * crosses it, entries keep the nearest lane distance and are skipped once it's behind
+ * the hits of every lane
+ */
+u32 TriangleBvh::RaycastPacket(const RayPacket &packet, PacketHit &hit) const {
+    if (nodes_.empty()) return 0;
+
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    __m128 o[3], d[3], inv[3];
+    for (u32 i = 0; i < 3; ++i) {
+        o[i] = _mm_loadu_ps(packet.origin[i]);
+        d[i] = _mm_loadu_ps(packet.direction[i]);
+        inv[i] = _mm_div_ps(one, d[i]);
+    }
+    __m128 closest = _mm_loadu_ps(hit.distance);
+    __m128 hitU = _mm_loadu_ps(hit.u);
+    __m128 hitV = _mm_loadu_ps(hit.v);
+    __m128i hitTriangle = _mm_loadu_si128((const __m128i *) hit.triangle);
+    const __m128 active = _mm_cmpgt_ps(closest, zero);
+    if (_mm_movemask_ps(active) == 0) return 0;
+    u32 hitMask = 0;
+
+    auto horizontalMin = [](__m128 x) {
+        x = _mm_min_ps(x, _mm_shuffle_ps(x, x, _MM_SHUFFLE(2, 3, 0, 1)));
+        x = _mm_min_ps(x, _mm_shuffle_ps(x, x, _MM_SHUFFLE(1, 0, 3, 2)));
+        return _mm_cvtss_f32(x);
+    };
+    auto horizontalMax = [](__m128 x) {
+        x = _mm_max_ps(x, _mm_shuffle_ps(x, x, _MM_SHUFFLE(2, 3, 0, 1)));
+        x = _mm_max_ps(x, _mm_shuffle_ps(x, x, _MM_SHUFFLE(1, 0, 3, 2)));
+        return _mm_cvtss_f32(x);
+    };
+
+    // Nearest entry distance of the lanes crossing the node. Operand order drops NaNs
+    // from rays parallel to a slab
+    auto intersectNode = [&](const Node &node) {
+        __m128 tMin = zero;
+        __m128 tMax = closest;
+        for (u32 i = 0; i < 3; ++i) {
+            const __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.min[i]), o[i]), inv[i]);
+            const __m128 t2 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.max[i]), o[i]), inv[i]);
+            tMin = _mm_max_ps(_mm_min_ps(t1, t2), tMin);
+            tMax = _mm_min_ps(_mm_max_ps(t1, t2), tMax);
+        }
+        const __m128 crossed = _mm_and_ps(_mm_cmple_ps(tMin, tMax), active);
+        const __m128 distance = _mm_or_ps(_mm_and_ps(crossed, tMin), _mm_andnot_ps(crossed, _mm_set1_ps(FLT_MAX)));
+        return horizontalMin(distance);
+    };
+
+    struct Entry {
+        u32 node;
+        f32 distance;
+    };
+    Entry stack[stackSize];
+    u32 count = 0;
+
+    const f32 rootDistance = intersectNode(nodes_[0]);
+    if (rootDistance == FLT_MAX) return 0;
+    stack[count++] = { 0, rootDistance };
+    f32 farthest = horizontalMax(_mm_and_ps(closest, active));
+
+    while (count > 0) {
+        const Entry entry = stack[--count];
+        if (entry.distance >= farthest) continue;
+        const Node &node = nodes_[entry.node];
+
+        if (node.count > 0) {
+            for (u32 i = node.first; i < node.first + node.count; ++i) {
+                const Triangle &triangle = triangles_[i];
+                const __m128 e1[3] = { _mm_set1_ps(triangle.edge1[0]), _mm_set1_ps(triangle.edge1[1]), _mm_set1_ps(triangle.edge1[2]) };
+                const __m128 e2[3] = { _mm_set1_ps(triangle.edge2[0]), _mm_set1_ps(triangle.edge2[1]), _mm_set1_ps(triangle.edge2[2]) };
+
+                const __m128 h[3] = {
+                    _mm_sub_ps(_mm_mul_ps(d[1], e2[2]), _mm_mul_ps(d[2], e2[1])),
+                    _mm_sub_ps(_mm_mul_ps(d[2], e2[0]), _mm_mul_ps(d[0], e2[2])),
+                    _mm_sub_ps(_mm_mul_ps(d[0], e2[1]), _mm_mul_ps(d[1], e2[0]))
+                };
+                const __m128 a = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1[0], h[0]), _mm_mul_ps(e1[1], h[1])), _mm_mul_ps(e1[2], h[2]));
+                const __m128 absA = _mm_andnot_ps(_mm_set1_ps(-0.0f), a);
+                __m128 mask = _mm_and_ps(_mm_cmpge_ps(absA, _mm_set1_ps(epsilon)), active);
+                if (_mm_movemask_ps(mask) == 0) continue;
+
+                const __m128 f = _mm_div_ps(one, a);
+                const __m128 s[3] = {
+                    _mm_sub_ps(o[0], _mm_set1_ps(triangle.v0[0])),
+                    _mm_sub_ps(o[1], _mm_set1_ps(triangle.v0[1])),
+                    _mm_sub_ps(o[2], _mm_set1_ps(triangle.v0[2]))
+                };
+                const __m128 u = _mm_mul_ps(f, _mm_add_ps(_mm_add_ps(_mm_mul_ps(s[0], h[0]), _mm_mul_ps(s[1], h[1])), _mm_mul_ps(s[2], h[2])));
+                mask = _mm_and_ps(mask, _mm_and_ps(_mm_cmpge_ps(u, zero), _mm_cmple_ps(u, one)));
+                if (_mm_movemask_ps(mask) == 0) continue;
+
+                const __m128 q[3] = {
+                    _mm_sub_ps(_mm_mul_ps(s[1], e1[2]), _mm_mul_ps(s[2], e1[1])),
+                    _mm_sub_ps(_mm_mul_ps(s[2], e1[0]), _mm_mul_ps(s[0], e1[2])),
+                    _mm_sub_ps(_mm_mul_ps(s[0], e1[1]), _mm_mul_ps(s[1], e1[0]))
+                };
+                const __m128 v = _mm_mul_ps(f, _mm_add_ps(_mm_add_ps(_mm_mul_ps(d[0], q[0]), _mm_mul_ps(d[1], q[1])), _mm_mul_ps(d[2], q[2])));
+                mask = _mm_and_ps(mask, _mm_and_ps(_mm_cmpge_ps(v, zero), _mm_cmple_ps(_mm_add_ps(u, v), one)));
+
+                const __m128 t = _mm_mul_ps(f, _mm_add_ps(_mm_add_ps(_mm_mul_ps(e2[0], q[0]), _mm_mul_ps(e2[1], q[1])), _mm_mul_ps(e2[2], q[2])));
+                mask = _mm_and_ps(mask, _mm_and_ps(_mm_cmpgt_ps(t, _mm_set1_ps(epsilon)), _mm_cmplt_ps(t, closest)));
+                const u32 lanes = _mm_movemask_ps(mask);
+                if (lanes == 0) continue;
+
+                closest = _mm_or_ps(_mm_and_ps(mask, t), _mm_andnot_ps(mask, closest));
+                hitU = _mm_or_ps(_mm_and_ps(mask, u), _mm_andnot_ps(mask, hitU));
+                hitV = _mm_or_ps(_mm_and_ps(mask, v), _mm_andnot_ps(mask, hitV));
+                const __m128i laneMask = _mm_castps_si128(mask);
+                hitTriangle = _mm_or_si128(_mm_and_si128(laneMask, _mm_set1_epi32((i32) ids_[i])), _mm_andnot_si128(laneMask, hitTriangle));
+                hitMask |= lanes;
+                farthest = horizontalMax(_mm_and_ps(closest, active));
+            }
+            continue;
+        }
+
+        Entry near { node.first, intersectNode(nodes_[node.first]) };
+        Entry far { node.first + 1, intersectNode(nodes_[node.first + 1]) };
+        if (far.distance < near.distance) std::swap(near, far);
+        if (far.distance != FLT_MAX) stack[count++] = far;
+        if (near.distance != FLT_MAX) stack[count++] = near;
+    }
+
+    _mm_storeu_ps(hit.distance, closest);
+    _mm_storeu_ps(hit.u, hitU);
+    _mm_storeu_ps(hit.v, hitV);
+    _mm_storeu_si128((__m128i *) hit.triangle, hitTriangle);
+    return hitMask;
+}
+
+#else
+
+u32 TriangleBvh::RaycastPacket(const RayPacket &packet, PacketHit &hit) const {
+    u32 hitMask = 0;
+    for (u32 lane = 0; lane < 4; ++lane) {
+        if (hit.distance[lane] <= 0.0f) continue;
+        const math::vec3 origin = { packet.origin[0][lane], packet.origin[1][lane], packet.origin[2][lane] };
+        const math::vec3 direction = { packet.direction[0][lane], packet.direction[1][lane], packet.direction[2][lane] };
+        TriangleHit laneHit;
+        if (Raycast(origin, direction, hit.distance[lane], laneHit)) {
+            hit.distance[lane] = laneHit.distance;
+            hit.triangle[lane] = laneHit.triangle;
+            hit.u[lane] = laneHit.u;
+            hit.v[lane] = laneHit.v;
+            hitMask |= 1U << lane;
+        }
+    }
+    return hitMask;
+}
+
+#endif
+
+void TriangleBvh::UpdateBounds(u32 node, const BuildData &data) {
+    Bin bounds;
+    for (u32 i = nodes_[node].first; i < nodes_[node].first + nodes_[node].count; ++i) {
+        bounds.Grow(&data.bounds[data.order[i] * 6]);
+    }
+    std::copy(bounds.min, bounds.min + 3, nodes_[node].min);
+    std::copy(bounds.max, bounds.max + 3, nodes_[node].max);
+}
+
+/**
+ * Centroids are binned along every axis and the split plane with lowest surface
+ * area cost is taken. Node stays a leaf if splitting costs more than not doing it
+ */
+void TriangleBvh::Subdivide(u32 node, BuildData &data, u32 depth) {
+    const u32 first = nodes_[node].first;
+    const u32 count = nodes_[node].count;
+    if (count <= maxLeafSize or depth + 2 >= stackSize) return;
+
+    f32 cMin[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+    f32 cMax[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+    for (u32 i = first; i < first + count; ++i) {
+        const f32 *centroid = &data.centroids[data.order[i] * 3];
+        for (u32 a = 0; a < 3; ++a) {
+            cMin[a] = std::min(cMin[a], centroid[a]);
+            cMax[a] = std::max(cMax[a], centroid[a]);
+        }
+    }
+
+    f32 bestCost = FLT_MAX;
+    u32 bestAxis = 0;
+    u32 bestSplit = 0;
+
+    for (u32 axis = 0; axis < 3; ++axis) {
+        const f32 extent = cMax[axis] - cMin[axis];
+        if (extent <= 0.0f) continue;
+
+        Bin bins[binCount];
+        const f32 scale = (f32) binCount / extent;
+        for (u32 i = first; i < first + count; ++i) {
+            const u32 triangle = data.order[i];
+            const u32 bin = std::min(binCount - 1, (u32) ((data.centroids[triangle * 3 + axis] - cMin[axis]) * scale));
+            bins[bin].Grow(&data.bounds[triangle * 6]);
+            ++bins[bin].count;
+        }
+
+        // Cost of splitting after every bin, sweeping from both sides
+        f32 leftCost[binCount - 1];
+        Bin left;
+        Bin right;
+        for (u32 i = 0; i < binCount - 1; ++i) {
+            left.Grow(bins[i]);
+            leftCost[i] = left.count > 0 ? left.count * HalfArea(left.min, left.max) : 0.0f;
+        }
+        for (u32 i = binCount - 1; i > 0; --i) {
+            right.Grow(bins[i]);
+            const f32 cost = leftCost[i - 1] + (right.count > 0 ? right.count * HalfArea(right.min, right.max) : 0.0f);
+            if (cost < bestCost) {
+                bestCost = cost;
+                bestAxis = axis;
+                bestSplit = i;
+            }
+        }
+    }
+
+    const f32 leafCost = count * HalfArea(nodes_[node].min, nodes_[node].max);
+    if (bestCost >= leafCost) return;
+
+    const f32 scale = (f32) binCount / (cMax[bestAxis] - cMin[bestAxis]);
+    const auto middle = std::partition(data.order.begin() + first, data.order.begin() + first + count, [&](u32 triangle) {
+        return std::min(binCount - 1, (u32) ((data.centroids[triangle * 3 + bestAxis] - cMin[bestAxis]) * scale)) < bestSplit;
+    });
+    const u32 leftCount = middle - (data.order.begin() + first);
+    if (leftCount == 0 or leftCount == count) return;
+
+    const u32 left = nodes_.size();
+    nodes_.push_back({ {}, first, {}, leftCount });
+    nodes_.push_back({ {}, first + leftCount, {}, count - leftCount });
+    nodes_[node].first = left;
+    nodes_[node].count = 0;
+
+    UpdateBounds(left, data);
+    UpdateBounds(left + 1, data);
+    Subdivide(left, data, depth + 1);
+    Subdivide(left + 1, data, depth + 1);
+}
+
+}
@@ -0,0 +1,96 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file triangle_bvh.hpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Triangle BVH
+ *
+ * Static bounding volume hierarchy over the triangles of a sub mesh, built once
+ * with binned SAH. Triangles are copied (first vertex and two edges) in leaf
+ * order, so rays don't touch the vertex stream. Used for exact ray hits, single
+ * rays or packets of four traced together with SSE (coherent rays, like the ones of
+ * neighbour pixels, visit almost the same nodes).
+ */
+
+#pragma once
+
+#include "render/vertex.hpp"
+
+#include <cfloat>
+#include <vector>
+
+namespace reveal3d::spatial {
+
+struct TriangleHit {
+    f32 distance { FLT_MAX };
+    u32 triangle { UINT_MAX }; // In index buffer order
+    f32 u { 0.0f };            // Barycentrics of second and third vertices
+    f32 v { 0.0f };
+};
+
+// Four rays in structure of arrays layout, directions don't need to be normalized
+struct RayPacket {
+    f32 origin[3][4];
+    f32 direction[3][4];
+};
+
+// Closest hit of every ray. Distance is also the input limit, lanes with 0 are not traced
+struct PacketHit {
+    f32 distance[4] { FLT_MAX, FLT_MAX, FLT_MAX, FLT_MAX };
+    u32 triangle[4] { UINT_MAX, UINT_MAX, UINT_MAX, UINT_MAX };
+    f32 u[4] {};
+    f32 v[4] {};
+};
+
+class TriangleBvh {
+public:
+    // Indices are relative to vertices
+    void Build(const render::Vertex *vertices, const u32 *indices, u32 indexCount);
+    // Closest hit closer than maxDistance, direction doesn't need to be normalized
+    bool Raycast(const math::vec3 &origin, const math::vec3 &direction, f32 maxDistance, TriangleHit &hit) const;
+    // Lanes hit closer than their distance are updated, returns their mask (bit i for lane i)
+    u32 RaycastPacket(const RayPacket &packet, PacketHit &hit) const;
+
+    [[nodiscard]] INLINE u32 TriangleCount() const { return triangles_.size(); }
+    [[nodiscard]] INLINE u32 NodeCount() const { return nodes_.size(); }
+    [[nodiscard]] INLINE u64 MemorySize() const {
+        return nodes_.capacity() * sizeof(Node) + triangles_.capacity() * sizeof(Triangle) + ids_.capacity() * sizeof(u32);
+    }
+
+private:
+    static constexpr u32 maxLeafSize = 4;
+    static constexpr u32 binCount = 16;
+    static constexpr u32 stackSize = 64;
+
+    struct Node {
+        f32 min[3];
+        u32 first;  // First triangle if leaf, left child otherwise (right is left + 1)
+        f32 max[3];
+        u32 count;  // 0 for internal nodes
+    };
+
+    struct Triangle {
+        f32 v0[3];
+        f32 edge1[3];
+        f32 edge2[3];
+    };
+
+    // Build data, 3 floats per triangle centroid and 6 per triangle bounds (min, max)
+    struct BuildData {
+        std::vector<f32> centroids;
+        std::vector<f32> bounds;
+        std::vector<u32> order;
+    };
+
+    void UpdateBounds(u32 node, const BuildData &data);
+    void Subdivide(u32 node, BuildData &data, u32 depth);
+
+    std::vector<Node> nodes_;
+    std::vector<Triangle> triangles_;
+    std::vector<u32> ids_;  // Original triangle of every stored one
+};
+
+}
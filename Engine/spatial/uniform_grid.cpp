@@ -0,0 +1,234 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file uniform_grid.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Hashed uniform grid
+ *
+ * Longer description
+ */
+
+#include "uniform_grid.hpp"
+
+namespace reveal3d::spatial {
+
+void UniformGrid::Insert(u32 id, const Aabb &box) {
+    if (Contains(id)) {
+        Update(id, box);
+        return;
+    }
+    if (id >= objects_.size()) {
+        objects_.resize(id + 1);
+    }
+
+    objects_[id].box = box;
+    maxHalfSize_ = std::max({ maxHalfSize_, (box.max.x - box.min.x) * 0.5f, (box.max.y - box.min.y) * 0.5f,
+                              (box.max.z - box.min.z) * 0.5f });
+    Attach(id, GetCell(CoordsOf(Center(box))));
+    ++count_;
+}
+
+bool UniformGrid::Update(u32 id, const Aabb &box) {
+    if (!Contains(id)) {
+        Insert(id, box);
+        return true;
+    }
+
+    objects_[id].box = box;
+    maxHalfSize_ = std::max({ maxHalfSize_, (box.max.x - box.min.x) * 0.5f, (box.max.y - box.min.y) * 0.5f,
+                              (box.max.z - box.min.z) * 0.5f });
+
+    const Coords coords = CoordsOf(Center(box));
+    const Coords &current = cells_[objects_[id].cell].coords;
+    if (coords.x == current.x and coords.y == current.y and coords.z == current.z) return false;
+
+    Detach(id);
+    Attach(id, GetCell(coords));
+    return true;
+}
+
+void UniformGrid::Remove(u32 id) {
+    if (!Contains(id)) return;
+
+    Detach(id);
+    --count_;
+}
+
+void UniformGrid::Clear() {
+    std::fill(keys_.begin(), keys_.end(), std::pair { emptyKey, 0u });
+    keyCount_ = 0;
+    cells_.clear();
+    freeCells_.clear();
+    objects_.clear();
+    maxHalfSize_ = 0.0f;
+    boundsMin_ = { 0, 0, 0 };
+    boundsMax_ = { -1, -1, -1 };
+    count_ = 0;
+}
+
+/**
+ * Visits cells in shells of growing distance around the point cell, stops when the
+ * closest possible object of next shell is farther than the best found
+ */
+u32 UniformGrid::Nearest(const math::vec3 &point, f32 maxDistance) const {
+    if (count_ == 0) return null;
+
+    const Coords center = CoordsOf(point);
+    const i32 radius = (i32) std::ceil(maxHalfSize_ * invCellSize_);
+    const i32 toBounds = std::max({ std::abs(center.x - boundsMin_.x), std::abs(center.x - boundsMax_.x),
+                                    std::abs(center.y - boundsMin_.y), std::abs(center.y - boundsMax_.y),
+                                    std::abs(center.z - boundsMin_.z), std::abs(center.z - boundsMax_.z) });
+    i32 maxShell = toBounds;
+    if (maxDistance != FLT_MAX) {
+        maxShell = std::min(maxShell, (i32) std::ceil(maxDistance * invCellSize_) + radius + 1);
+    }
+
+    u32 best = null;
+    f32 bestSq = maxDistance == FLT_MAX ? FLT_MAX : maxDistance * maxDistance;
+
+    auto visit = [&](i32 x, i32 y, i32 z) {
+        const u32 cell = FindCell({ x, y, z });
+        if (cell == null) return;
+        for (const u32 id : cells_[cell].objects) {
+            const f32 distanceSq = DistanceSq(objects_[id].box, point);
+            if (distanceSq < bestSq) {
+                best = id;
+                bestSq = distanceSq;
+            }
+        }
+    };
+
+    for (i32 k = 0; k <= maxShell; ++k) {
+        const f32 shellDistance = (f32) (k - radius - 1) * cellSize_;
+        if (shellDistance > 0.0f and shellDistance * shellDistance >= bestSq) break;
+
+        for (i32 dz = -k; dz <= k; ++dz) {
+            for (i32 dy = -k; dy <= k; ++dy) {
+                if (std::abs(dz) == k or std::abs(dy) == k) {
+                    for (i32 dx = -k; dx <= k; ++dx) {
+                        visit(center.x + dx, center.y + dy, center.z + dz);
+                    }
+                } else {
+                    visit(center.x - k, center.y + dy, center.z + dz);
+                    if (k > 0) visit(center.x + k, center.y + dy, center.z + dz);
+                }
+            }
+        }
+    }
+    return best;
+}
+
+Aabb UniformGrid::LooseBox(const Coords &coords) const {
+    const math::vec3 min { coords.x * cellSize_, coords.y * cellSize_, coords.z * cellSize_ };
+    return Fatten({ min, { min.x + cellSize_, min.y + cellSize_, min.z + cellSize_ } }, maxHalfSize_);
+}
+
+u32 UniformGrid::FindCell(const Coords &coords) const {
+    if (keyCount_ == 0) return null;
+
+    const u64 key = Key(coords);
+    const u32 mask = keys_.size() - 1;
+    for (u32 slot = HomeSlot(key); keys_[slot].first != emptyKey; slot = (slot + 1) & mask) {
+        if (keys_[slot].first == key) return keys_[slot].second;
+    }
+    return null;
+}
+
+u32 UniformGrid::GetCell(const Coords &coords) {
+    const u64 key = Key(coords);
+    if (const u32 cell = FindCell(coords); cell != null) {
+        return cell;
+    }
+
+    u32 index;
+    if (freeCells_.empty()) {
+        index = cells_.size();
+        cells_.emplace_back();
+    } else {
+        index = freeCells_.back();
+        freeCells_.pop_back();
+    }
+    cells_[index].coords = coords;
+    InsertKey(key, index);
+
+    if (boundsMax_.x < boundsMin_.x) {
+        boundsMin_ = coords;
+        boundsMax_ = coords;
+    } else {
+        boundsMin_ = { std::min(boundsMin_.x, coords.x), std::min(boundsMin_.y, coords.y), std::min(boundsMin_.z, coords.z) };
+        boundsMax_ = { std::max(boundsMax_.x, coords.x), std::max(boundsMax_.y, coords.y), std::max(boundsMax_.z, coords.z) };
+    }
+    return index;
+}
+
+// Keeps the load under a half so probe chains stay short
+void UniformGrid::InsertKey(u64 key, u32 cell) {
+    if ((keyCount_ + 1) * 2 > keys_.size()) {
+        std::vector<std::pair<u64, u32>> old(std::max<size_t>(keys_.size() * 2, 64), { emptyKey, 0 });
+        keys_.swap(old);
+        keyCount_ = 0;
+        for (const auto &[oldKey, oldCell] : old) {
+            if (oldKey != emptyKey) InsertKey(oldKey, oldCell);
+        }
+    }
+
+    const u32 mask = keys_.size() - 1;
+    u32 slot = HomeSlot(key);
+    while (keys_[slot].first != emptyKey) {
+        slot = (slot + 1) & mask;
+    }
+    keys_[slot] = { key, cell };
+    ++keyCount_;
+}
+
+/**
+ * Backward shift delete, entries after the hole move back unless that would put them
+ * before their home slot. Leaves no tombstones, lookups never slow down with churn
+ */
+void UniformGrid::EraseKey(u64 key) {
+    const u32 mask = keys_.size() - 1;
+    u32 hole = HomeSlot(key);
+    while (keys_[hole].first != key) {
+        hole = (hole + 1) & mask;
+    }
+
+    for (u32 slot = (hole + 1) & mask; keys_[slot].first != emptyKey; slot = (slot + 1) & mask) {
+        const u32 home = HomeSlot(keys_[slot].first);
+        // Distance from home to slot must be at least the distance from home to hole
+        if (((slot - home) & mask) >= ((slot - hole) & mask)) {
+            keys_[hole] = keys_[slot];
+            hole = slot;
+        }
+    }
+    keys_[hole].first = emptyKey;
+    --keyCount_;
+}
+
+void UniformGrid::Attach(u32 id, u32 cell) {
+    Object &object = objects_[id];
+    object.cell = cell;
+    object.slot = cells_[cell].objects.size();
+    cells_[cell].objects.push_back(id);
+}
+
+void UniformGrid::Detach(u32 id) {
+    Object &object = objects_[id];
+    Cell &cell = cells_[object.cell];
+
+    const u32 last = cell.objects.back();
+    cell.objects[object.slot] = last;
+    objects_[last].slot = object.slot;
+    cell.objects.pop_back();
+
+    // Empty cells are recycled, bounds are kept as they only bound the search
+    if (cell.objects.empty()) {
+        EraseKey(Key(cell.coords));
+        freeCells_.push_back(object.cell);
+    }
+    object.cell = null;
+}
+
+}
@@ -0,0 +1,236 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file uniform_grid.hpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Hashed uniform grid
+ *
+ * Unbounded grid of equally sized cells, only occupied cells are stored in a hash
+ * table. Every object lives in the cell of its center so updates are O(1) amortized,
+ * queries widen their range by the biggest object half size seen. Works best when
+ * objects are similar in size and cell size is close to them.
+ */
+
+#pragma once
+
+#include "spatial.hpp"
+
+#include <vector>
+
+namespace reveal3d::spatial {
+
+class UniformGrid {
+public:
+    explicit UniformGrid(f32 cellSize = 4.0f) : cellSize_(cellSize), invCellSize_(1.0f / cellSize) {}
+
+    void Insert(u32 id, const Aabb &box);
+    // Returns true if the object changed cell
+    bool Update(u32 id, const Aabb &box);
+    void Remove(u32 id);
+    void Clear();
+
+    [[nodiscard]] INLINE bool Contains(u32 id) const { return id < objects_.size() and objects_[id].cell != null; }
+    [[nodiscard]] INLINE u32 Count() const { return count_; }
+    [[nodiscard]] INLINE u32 CellCount() const { return cells_.size(); }
+
+    template<typename Func> void Query(const Aabb &box, Func &&func) const;
+    template<typename Func> void Query(Planes planes, Func &&func) const;
+    template<typename Func> void Raycast(const Ray &ray, Func &&func) const;
+    [[nodiscard]] u32 Nearest(const math::vec3 &point, f32 maxDistance) const;
+
+private:
+    static constexpr u32 null = UINT_MAX;
+
+    struct Coords {
+        i32 x, y, z;
+    };
+
+    struct Object {
+        Aabb box;
+        u32 cell { null };
+        u32 slot { 0 };
+    };
+
+    struct Cell {
+        Coords coords;
+        std::vector<u32> objects;
+    };
+
+    [[nodiscard]] INLINE Coords CoordsOf(const math::vec3 &point) const {
+        return { (i32) std::floor(point.x * invCellSize_), (i32) std::floor(point.y * invCellSize_),
+                 (i32) std::floor(point.z * invCellSize_) };
+    }
+    // 21 bits per axis
+    [[nodiscard]] static INLINE u64 Key(const Coords &coords) {
+        constexpr u64 mask = (1ULL << 21) - 1;
+        return ((u64) coords.x & mask) | (((u64) coords.y & mask) << 21) | (((u64) coords.z & mask) << 42);
+    }
+    // Cell box grown by the biggest object half size, contains every object of the cell
+    [[nodiscard]] Aabb LooseBox(const Coords &coords) const;
+    [[nodiscard]] u32 FindCell(const Coords &coords) const;
+    [[nodiscard]] INLINE u32 HomeSlot(u64 key) const {
+        return (u32) ((key * 0x9E3779B97F4A7C15ULL) >> 32) & (keys_.size() - 1);
+    }
+    void InsertKey(u64 key, u32 cell);
+    void EraseKey(u64 key);
+    // Cells overlapping box, iterating occupied cells when that is cheaper
+    template<typename Func> void ForEachCell(const Aabb &box, Func &&func) const;
+    u32 GetCell(const Coords &coords);
+    void Attach(u32 id, u32 cell);
+    void Detach(u32 id);
+
+    static constexpr u64 emptyKey = UINT64_MAX; // Keys only use 63 bits
+
+    // Coords to cell, open addressing with backward shift delete. Never shrinks, cells
+    // emptied and filled again every frame by moving objects do not touch the heap
+    std::vector<std::pair<u64, u32>> keys_;
+    u32 keyCount_ { 0 };
+    std::vector<Cell> cells_;
+    std::vector<u32> freeCells_;
+    std::vector<Object> objects_; // Per id
+    f32 cellSize_;
+    f32 invCellSize_;
+    f32 maxHalfSize_ { 0.0f };
+    Coords boundsMin_ { 0, 0, 0 };   // Of every cell created
+    Coords boundsMax_ { -1, -1, -1 };
+    u32 count_ { 0 };
+};
+
+template<typename Func>
+void UniformGrid::ForEachCell(const Aabb &box, Func &&func) const {
+    const Aabb range = Fatten(box, maxHalfSize_);
+    const Coords min = CoordsOf(range.min);
+    const Coords max = CoordsOf(range.max);
+    const f64 rangeCells = (f64) (max.x - min.x + 1) * (max.y - min.y + 1) * (max.z - min.z + 1);
+
+    if (rangeCells > (f64) keyCount_) {
+        for (const Cell &cell : cells_) {
+            const Coords &c = cell.coords;
+            if (!cell.objects.empty() and c.x >= min.x and c.x <= max.x and c.y >= min.y and c.y <= max.y and
+                c.z >= min.z and c.z <= max.z) {
+                func(cell);
+            }
+        }
+        return;
+    }
+
+    for (i32 z = min.z; z <= max.z; ++z) {
+        for (i32 y = min.y; y <= max.y; ++y) {
+            for (i32 x = min.x; x <= max.x; ++x) {
+                const u32 cell = FindCell({ x, y, z });
+                if (cell != null) {
+                    func(cells_[cell]);
+                }
+            }
+        }
+    }
+}
+
+template<typename Func>
+void UniformGrid::Query(const Aabb &box, Func &&func) const {
+    ForEachCell(box, [&](const Cell &cell) {
+        for (const u32 id : cell.objects) {
+            if (Overlaps(objects_[id].box, box)) {
+                func(id);
+            }
+        }
+    });
+}
+
+// Volumes are unbounded, every occupied cell is classified
+template<typename Func>
+void UniformGrid::Query(Planes planes, Func &&func) const {
+    for (const Cell &cell : cells_) {
+        if (cell.objects.empty()) continue;
+
+        const Containment containment = Classify(LooseBox(cell.coords), planes);
+        if (containment == Containment::outside) continue;
+
+        for (const u32 id : cell.objects) {
+            if (containment == Containment::inside or Classify(objects_[id].box, planes) != Containment::outside) {
+                func(id);
+            }
+        }
+    }
+}
+
+/**
+ * Walks the cells crossed by the ray (Amanatides-Woo). Objects may stick out of
+ * their cell up to the biggest half size, so neighbours in that radius are also
+ * visited. The walk never goes back on an axis, after the first cell only the slab
+ * entering the neighbourhood is new, so each cell is visited once without a set
+ */
+template<typename Func>
+void UniformGrid::Raycast(const Ray &ray, Func &&func) const {
+    if (count_ == 0) return;
+
+    const math::vec3 invDirection = InvDirection(ray.direction);
+    const f32 direction[3] = { ray.direction.x, ray.direction.y, ray.direction.z };
+    const f32 origin[3] = { ray.origin.x, ray.origin.y, ray.origin.z };
+    const f32 inv[3] = { invDirection.x, invDirection.y, invDirection.z };
+    const i32 radius = (i32) std::ceil(maxHalfSize_ * invCellSize_);
+    f32 maxDistance = ray.maxDistance;
+
+    // Clip the ray to the occupied region, walk starts where it enters
+    const Aabb occupied = Fatten({ { boundsMin_.x * cellSize_, boundsMin_.y * cellSize_, boundsMin_.z * cellSize_ },
+                                   { (boundsMax_.x + 1) * cellSize_, (boundsMax_.y + 1) * cellSize_,
+                                     (boundsMax_.z + 1) * cellSize_ } }, maxHalfSize_);
+    const f32 enter = Intersect(occupied, ray.origin, invDirection, maxDistance);
+    if (enter == FLT_MAX) return;
+    const f32 exit = std::min({ std::max((occupied.min.x - origin[0]) * inv[0], (occupied.max.x - origin[0]) * inv[0]),
+                                std::max((occupied.min.y - origin[1]) * inv[1], (occupied.max.y - origin[1]) * inv[1]),
+                                std::max((occupied.min.z - origin[2]) * inv[2], (occupied.max.z - origin[2]) * inv[2]) });
+
+    const Coords start = CoordsOf({ origin[0] + direction[0] * enter, origin[1] + direction[1] * enter,
+                                    origin[2] + direction[2] * enter });
+    i32 cell[3] = { start.x, start.y, start.z };
+    i32 step[3];
+    f32 next[3];
+    f32 delta[3];
+    for (u32 i = 0; i < 3; ++i) {
+        step[i] = direction[i] > 0.0f ? 1 : -1;
+        delta[i] = direction[i] == 0.0f ? FLT_MAX : std::abs(cellSize_ * inv[i]);
+        const f32 boundary = (f32) (cell[i] + (step[i] > 0 ? 1 : 0)) * cellSize_;
+        next[i] = direction[i] == 0.0f ? FLT_MAX : (boundary - origin[i]) * inv[i];
+    }
+
+    f32 distance = enter;
+    u32 axis = 3; // Axis of the last step, none for the first cell
+
+    while (distance <= std::min(maxDistance, exit)) {
+        i32 from[3], to[3];
+        for (u32 i = 0; i < 3; ++i) {
+            from[i] = cell[i] - radius;
+            to[i] = cell[i] + radius;
+        }
+        if (axis < 3) {
+            from[axis] = to[axis] = cell[axis] + step[axis] * radius;
+        }
+
+        for (i32 z = from[2]; z <= to[2]; ++z) {
+            for (i32 y = from[1]; y <= to[1]; ++y) {
+                for (i32 x = from[0]; x <= to[0]; ++x) {
+                    const u32 index = FindCell({ x, y, z });
+                    if (index == null) continue;
+
+                    for (const u32 id : cells_[index].objects) {
+                        const f32 hit = Intersect(objects_[id].box, ray.origin, invDirection, maxDistance);
+                        if (hit != FLT_MAX) {
+                            maxDistance = std::min(maxDistance, static_cast<f32>(func(id, hit)));
+                            if (maxDistance <= 0.0f) return;
+                        }
+                    }
+                }
+            }
+        }
+        axis = next[0] < next[1] ? (next[0] < next[2] ? 0 : 2) : (next[1] < next[2] ? 1 : 2);
+        distance = next[axis];
+        next[axis] += delta[axis];
+        cell[axis] += step[axis];
+    }
+}
+
+}
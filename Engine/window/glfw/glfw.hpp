@@ -18,7 +18,10 @@
 #include "input/input.hpp"
 
 #include "GLFW/glfw3.h"
+#ifdef WIN32
 #include <glfw/glfw3native.h>
+#endif
+#include <iostream>
 
 
 namespace reveal3d::window {
@@ -47,8 +50,8 @@ private:
 template<graphics::HRI Gfx>
 void Glfw::Create(render::Renderer<Gfx> &renderer) {
     glfwInit();
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 5); // Direct state access and persistent mapping
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 
 #ifdef WIN32
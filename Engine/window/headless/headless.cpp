@@ -0,0 +1,35 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file headless.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Window manager without window
+ *
+ * Longer description
+ */
+
+#include "headless.hpp"
+
+namespace reveal3d::window {
+
+Headless::Headless(InitInfo &info) : info_(info) {
+
+}
+
+void Headless::Show() {
+    // Nothing to show
+}
+
+// No events to poll, every call is a presented frame
+void Headless::Update() {
+    ++frames_;
+}
+
+bool Headless::ShouldClose() {
+    return closed_ or (frameLimit_ > 0 and frames_ >= frameLimit_);
+}
+
+}
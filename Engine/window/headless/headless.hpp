@@ -0,0 +1,48 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file headless.hpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Window manager without window
+ *
+ * Satisfies window::Mng for machines without display (CI, perf machines). Resolution
+ * is the fixed one of the init info, there are no events to wait for and the handle is
+ * empty, so it goes with backends that don't present (Null, Software, PathTracer).
+ * Optionally closes itself after a number of frames so Viewport::Run returns.
+ */
+
+#pragma once
+
+#include "render/renderer.hpp"
+#include "window/window_info.hpp"
+
+namespace reveal3d::window {
+
+class Headless {
+public:
+    explicit Headless(InitInfo &info);
+
+    template<graphics::HRI Gfx> INLINE void Create(render::Renderer<Gfx> &renderer) {}
+    void Show();
+    void Update();
+    template<graphics::HRI Gfx> INLINE void ClipMouse(render::Renderer<Gfx> &renderer) {}
+    bool ShouldClose();
+    INLINE void Close() { closed_ = true; }
+    // 0 runs until Close is called
+    INLINE void SetFrameLimit(u32 frames) { frameLimit_ = frames; }
+
+    [[nodiscard]] INLINE Resolution& GetRes() { return info_.res; }
+    [[nodiscard]] INLINE WHandle GetHandle() const { return info_.handle; }
+    [[nodiscard]] INLINE u32 Frames() const { return frames_; }
+
+private:
+    InitInfo info_;
+    u32 frames_ { 0 };
+    u32 frameLimit_ { 0 };
+    bool closed_ { false };
+};
+
+}
@@ -17,6 +17,7 @@
 #include "win32/win32.hpp"
 #endif
 #include "glfw/glfw.hpp"
+#include "headless/headless.hpp"
 
 #include "window_info.hpp"
 #include <concepts>
@@ -33,4 +34,6 @@ concept Mng = requires(T window, render::Renderer<Gfx> renderer) {
     {window.GetHandle()} ->  std::same_as<WHandle>;
 };
 
+static_assert(Mng<Headless, graphics::Software>);
+
 }
\ No newline at end of file
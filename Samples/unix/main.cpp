@@ -49,7 +49,7 @@ int  main() {
     }
 
     viewport.Init();
-    log(logDEBUG) << "Total Init time: " << timer.Diff(time);
+    LOG(logDEBUG) << "Total Init time: " << timer.Diff(time);
     viewport.Run();
 
     return 0;
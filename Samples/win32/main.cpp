@@ -74,7 +74,7 @@ i32 main() {
         ImGui::DestroyContext();
     } catch(std::exception &e) {
         viewport.renderer.Destroy();
-        log(logERROR) << e.what();
+        LOG(logERROR) << e.what();
         //        MessageBoxA(window.GetHandle().hwnd, e.what(), NULL, MB_ICONERROR | MB_SETFOREGROUND);
     }
 }
\ No newline at end of file
@@ -0,0 +1,188 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file aabb_tree_test.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Dynamic AABB tree unit testing
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+
+#include "spatial/aabb_tree.hpp"
+
+namespace reveal3d {
+
+class AabbTreeTest : public testing::Test {
+protected:
+    static constexpr u32 count = 2000;
+
+    AabbTreeTest() : tree_(0.1f), generator_(7), position_(-50.0f, 50.0f), size_(0.1f, 2.0f) {
+        boxes_.resize(count);
+        for (u32 i = 0; i < count; ++i) {
+            boxes_[i] = RandomBox();
+            tree_.Insert(i, boxes_[i]);
+        }
+    }
+
+    spatial::Aabb RandomBox() {
+        const math::vec3 min { position_(generator_), position_(generator_), position_(generator_) };
+        return { min, { min.x + size_(generator_), min.y + size_(generator_), min.z + size_(generator_) } };
+    }
+
+    std::vector<u32> Query(const spatial::Aabb &box) {
+        std::vector<u32> result;
+        tree_.Query(box, [&](u32 id) { result.push_back(id); });
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    // Fat boxes may report a few extra candidates, never miss one
+    void ExpectQueryMatches(const spatial::Aabb &box) {
+        const std::vector<u32> result = Query(box);
+        for (u32 i = 0; i < boxes_.size(); ++i) {
+            if (tree_.Contains(i) and spatial::Overlaps(boxes_[i], box)) {
+                EXPECT_TRUE(std::binary_search(result.begin(), result.end(), i));
+            }
+        }
+        for (const u32 id : result) {
+            EXPECT_TRUE(spatial::Overlaps(tree_.Box(id), box));
+        }
+    }
+
+    spatial::AabbTree tree_;
+    std::vector<spatial::Aabb> boxes_;
+    std::mt19937 generator_;
+    std::uniform_real_distribution<f32> position_;
+    std::uniform_real_distribution<f32> size_;
+};
+
+TEST_F(AabbTreeTest, Insert) {
+    EXPECT_EQ(tree_.Count(), count);
+    EXPECT_TRUE(tree_.Validate());
+    // Balanced enough by rotations, a degenerated tree would be much deeper
+    EXPECT_LT(tree_.Height(), 40);
+    ExpectQueryMatches({ { -10.0f, -10.0f, -10.0f }, { 10.0f, 10.0f, 10.0f } });
+}
+
+TEST_F(AabbTreeTest, Update) {
+    for (u32 frame = 0; frame < 10; ++frame) {
+        for (u32 i = frame; i < count; i += 10) {
+            const f32 x = position_(generator_) * 0.02f;
+            const f32 z = position_(generator_) * 0.02f;
+            boxes_[i].min = { boxes_[i].min.x + x, boxes_[i].min.y, boxes_[i].min.z + z };
+            boxes_[i].max = { boxes_[i].max.x + x, boxes_[i].max.y, boxes_[i].max.z + z };
+            tree_.Update(i, boxes_[i]);
+        }
+        boxes_[frame * 7] = RandomBox(); // Teleport
+        tree_.Update(frame * 7, boxes_[frame * 7]);
+    }
+    EXPECT_TRUE(tree_.Validate());
+    ExpectQueryMatches({ { -20.0f, -5.0f, 0.0f }, { 5.0f, 20.0f, 30.0f } });
+}
+
+TEST_F(AabbTreeTest, Remove) {
+    for (u32 i = 0; i < count; i += 2) {
+        tree_.Remove(i);
+    }
+    EXPECT_EQ(tree_.Count(), count / 2);
+    EXPECT_FALSE(tree_.Contains(0));
+    EXPECT_TRUE(tree_.Contains(1));
+    EXPECT_TRUE(tree_.Validate());
+    ExpectQueryMatches({ { -50.0f, -50.0f, -50.0f }, { 0.0f, 0.0f, 0.0f } });
+}
+
+TEST_F(AabbTreeTest, Raycast) {
+    spatial::AabbTree tree;
+    tree.Insert(0, { { 4.0f, -1.0f, -1.0f }, { 5.0f, 1.0f, 1.0f } });
+    tree.Insert(1, { { 9.0f, -1.0f, -1.0f }, { 10.0f, 1.0f, 1.0f } });
+    tree.Insert(2, { { 4.0f, 5.0f, -1.0f }, { 5.0f, 6.0f, 1.0f } });
+
+    u32 closest = UINT_MAX;
+    spatial::Ray ray { { 0.0f, 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f }, 100.0f };
+    tree.Raycast(ray, [&](u32 id, f32 distance) {
+        closest = id;
+        return distance;
+    });
+    EXPECT_EQ(closest, 0);
+
+    ray.direction = { -1.0f, 0.0f, 0.0f };
+    closest = UINT_MAX;
+    tree.Raycast(ray, [&](u32 id, f32 distance) {
+        closest = id;
+        return distance;
+    });
+    EXPECT_EQ(closest, UINT_MAX);
+}
+
+TEST_F(AabbTreeTest, Nearest) {
+    const math::vec3 point { 3.0f, -7.0f, 12.0f };
+    u32 expected = UINT_MAX;
+    f32 bestSq = FLT_MAX;
+    for (u32 i = 0; i < count; ++i) {
+        const f32 distanceSq = spatial::DistanceSq(tree_.Box(i), point);
+        if (distanceSq < bestSq) {
+            bestSq = distanceSq;
+            expected = i;
+        }
+    }
+    EXPECT_EQ(tree_.Nearest(point, FLT_MAX), expected);
+}
+
+TEST_F(AabbTreeTest, Frustum) {
+    // x > 0, y > 0 and z > 0 half spaces
+    const math::vec4 planes[] = { { 1.0f, 0.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 1.0f, 0.0f } };
+    std::vector<u32> result;
+    tree_.Query(spatial::Planes(planes), [&](u32 id) { result.push_back(id); });
+    std::sort(result.begin(), result.end());
+
+    for (u32 i = 0; i < count; ++i) {
+        const spatial::Aabb &box = tree_.Box(i);
+        const bool inside = box.max.x >= 0.0f and box.max.y >= 0.0f and box.max.z >= 0.0f;
+        EXPECT_EQ(std::binary_search(result.begin(), result.end(), i), inside);
+    }
+}
+
+// Nested boxes can't be balanced, traversals deeper than any fixed stack still visit every leaf
+TEST_F(AabbTreeTest, Degenerate) {
+    constexpr u32 depth = 2000;
+    spatial::AabbTree tree(0.0f);
+    for (u32 i = 0; i < depth; ++i) {
+        const f32 size = (f32)(i + 1);
+        tree.Insert(i, { { -size, -size, -size }, { size, size, size } });
+    }
+    EXPECT_GT(tree.Height(), 1024);
+    EXPECT_TRUE(tree.Validate());
+
+    u32 found = 0;
+    tree.Query(spatial::Aabb { { -0.5f, -0.5f, -0.5f }, { 0.5f, 0.5f, 0.5f } }, [&](u32) { ++found; });
+    EXPECT_EQ(found, depth);
+
+    // Every box crosses x = 0, all of them are inside x > -10000
+    const math::vec4 crossing[] = { { 1.0f, 0.0f, 0.0f, 0.0f } };
+    const math::vec4 containing[] = { { 1.0f, 0.0f, 0.0f, 10000.0f } };
+    found = 0;
+    tree.Query(spatial::Planes(crossing), [&](u32) { ++found; });
+    EXPECT_EQ(found, depth);
+    found = 0;
+    tree.Query(spatial::Planes(containing), [&](u32) { ++found; });
+    EXPECT_EQ(found, depth);
+
+    found = 0;
+    const spatial::Ray ray { { -5000.0f, 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f }, 10000.0f };
+    tree.Raycast(ray, [&](u32, f32) {
+        ++found;
+        return ray.maxDistance;
+    });
+    EXPECT_EQ(found, depth);
+
+    EXPECT_EQ(tree.Nearest({ 0.0f, 0.0f, 5000.0f }, FLT_MAX), depth - 1);
+}
+
+}
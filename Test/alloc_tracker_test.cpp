@@ -0,0 +1,170 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file alloc_tracker_test.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Allocation tracker unit testing
+ *
+ * Allocations call ::operator new directly, new expressions can be elided by the compiler.
+ * The last tests run the viewport headless and fail if any frame after warm up allocates.
+ */
+
+#include <gtest/gtest.h>
+#include "common/alloc_tracker.hpp"
+#include "render/viewport.hpp"
+#include "spatial/uniform_grid.hpp"
+#include "window/headless/headless.hpp"
+
+#include <functional>
+#include <new>
+#include <thread>
+#include <vector>
+
+namespace reveal3d {
+
+namespace {
+
+[[gnu::noinline]] void Allocate(u32 count, size_t size) {
+    for (u32 i = 0; i < count; ++i) {
+        ::operator delete(::operator new(size));
+    }
+}
+
+u64 SteadyStateAllocations(const std::function<void(u32)> &update) {
+    window::InitInfo info(L"AllocTrackerTest", 640, 480);
+    render::Viewport<graphics::Null, window::Headless> viewport(info);
+    viewport.renderer.Graphics().SetRecording(false);
+    viewport.window.SetFrameLimit(60);
+    viewport.CheckAllocations(20);
+    viewport.Init();
+
+    // Run only logs where the allocations come from, the count is what fails the test
+    memory::SetSampleRate(1);
+    viewport.Run(update);
+    memory::SetSampleRate(0);
+    memory::ClearCallSites();
+    return viewport.FrameAllocations();
+}
+
+}
+
+TEST(AllocTrackerTest, ThreadCounts) {
+    const memory::AllocationCounts before = memory::ThreadAllocations();
+    Allocate(3, 32);
+    const memory::AllocationCounts after = memory::ThreadAllocations();
+    EXPECT_EQ(after.allocations - before.allocations, 3u);
+    EXPECT_EQ(after.frees - before.frees, 3u);
+    EXPECT_EQ(after.bytes - before.bytes, 96u);
+}
+
+TEST(AllocTrackerTest, ReservedVector) {
+    std::vector<u32> values;
+    values.reserve(64);
+    const u64 before = memory::ThreadAllocations().allocations;
+    for (u32 i = 0; i < 64; ++i) {
+        values.push_back(i);
+    }
+    EXPECT_EQ(memory::ThreadAllocations().allocations, before);
+    values.push_back(64);
+    EXPECT_EQ(memory::ThreadAllocations().allocations, before + 1);
+}
+
+TEST(AllocTrackerTest, TotalCountsEveryThread) {
+    const u64 before = memory::TotalAllocations().allocations;
+    u64 threadAllocations = 0;
+    std::thread thread([&] {
+        Allocate(100, 16);
+        threadAllocations = memory::ThreadAllocations().allocations;
+    });
+    thread.join();
+    EXPECT_GE(threadAllocations, 100u);
+    EXPECT_GE(memory::TotalAllocations().allocations - before, threadAllocations);
+}
+
+// Failed allocations call the handler until it gives up, nothrow ones return null
+TEST(AllocTrackerTest, NewHandler) {
+    static u32 calls = 0;
+    calls = 0;
+    std::set_new_handler([] {
+        if (++calls == 2) std::set_new_handler(nullptr);
+    });
+    EXPECT_THROW(::operator delete(::operator new(SIZE_MAX / 2)), std::bad_alloc);
+    EXPECT_EQ(calls, 2u);
+    EXPECT_EQ(::operator new(SIZE_MAX / 2, std::nothrow), nullptr);
+}
+
+TEST(AllocTrackerTest, CallSites) {
+#if defined(__linux__) or defined(__APPLE__)
+    memory::ClearCallSites();
+    memory::SetSampleRate(1);
+    Allocate(100, 48);
+    memory::SetSampleRate(0);
+
+    const std::vector<memory::CallSite> sites = memory::TopCallSites(3);
+    ASSERT_FALSE(sites.empty());
+    EXPECT_EQ(sites[0].allocations, 100u);
+    EXPECT_EQ(sites[0].bytes, 4800u);
+    EXPECT_FALSE(sites[0].frames.empty());
+
+    memory::ClearCallSites();
+    EXPECT_TRUE(memory::TopCallSites(3).empty());
+#else
+    GTEST_SKIP() << "No call stacks on this platform";
+#endif
+}
+
+TEST(AllocTrackerTest, SampleRate) {
+    memory::ClearCallSites();
+    memory::SetSampleRate(10);
+    EXPECT_EQ(memory::SampleRate(), 10u);
+    Allocate(100, 8);
+    memory::SetSampleRate(0);
+
+    u64 sampled = 0;
+    for (const memory::CallSite &site : memory::TopCallSites(16)) {
+        sampled += site.allocations;
+    }
+#if defined(__linux__) or defined(__APPLE__)
+    EXPECT_GE(sampled, 9u);
+    EXPECT_LE(sampled, 11u);
+#endif
+    memory::ClearCallSites();
+}
+
+TEST(AllocTrackerTest, SteadyStateFrames) {
+    core::scene.Clear();
+    for (u32 i = 0; i < 64; ++i) {
+        core::Entity entity = core::scene.AddPrimitive(i % 2 ? core::Geometry::cube : core::Geometry::sphere);
+        entity.Transform().SetPosition({ (f32)(i % 8) * 3.0f, (f32)(i / 8) * 3.0f, -10.0f });
+    }
+
+    EXPECT_EQ(SteadyStateAllocations({}), 0u);
+    core::scene.Clear();
+}
+
+// Every entity steps into the next cell each frame, emptied cells are freed and their keys
+// erased. Each entity owns a run of four cells so no cell ever holds two of them
+TEST(AllocTrackerTest, SteadyStateMovingGrid) {
+    core::scene.Clear();
+    core::scene.SetIndex(spatial::UniformGrid(2.0f));
+    std::vector<core::Entity> entities;
+    for (u32 i = 0; i < 64; ++i) {
+        entities.push_back(core::scene.AddPrimitive(i % 2 ? core::Geometry::cube : core::Geometry::sphere));
+    }
+
+    const u64 allocations = SteadyStateAllocations([&](u32 frame) {
+        for (u32 i = 0; i < entities.size(); ++i) {
+            const f32 x = (f32)(i % 8) * 8.0f + (f32)(frame % 4) * 2.0f + 1.0f;
+            entities[i].Transform().SetPosition({ x, (f32)(i / 8) * 3.0f, -10.0f });
+        }
+    });
+    EXPECT_EQ(allocations, 0u);
+
+    core::scene.SetIndex(spatial::AabbTree());
+    core::scene.Clear();
+}
+
+}
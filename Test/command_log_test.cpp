@@ -0,0 +1,128 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file command_log_test.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Null backend command log unit testing
+ *
+ */
+
+#include <gtest/gtest.h>
+#include "graphics/null/null_command_log.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace reveal3d {
+
+using graphics::null::Command;
+using graphics::null::CommandLog;
+
+namespace {
+
+CommandLog MakeFrame(u32 frame, u32 instances) {
+    CommandLog log;
+    const u32 data[3] = { 1, 2, frame };
+    log.Record({ Command::beginFrame, { frame } });
+    log.Record({ .op = Command::uploadInstances, .args = { instances }, .hash = CommandLog::Hash(data, sizeof(data)) });
+    log.Record({ Command::pipeline, { 0 } });
+    log.Record({ Command::draw, { 36, instances, 0, 0, 0 } });
+    log.Record({ Command::draw, { 120, 1, 36, 8, instances } });
+    log.Record({ Command::endFrame });
+    return log;
+}
+
+}
+
+TEST(CommandLogTest, CompactEncoding) {
+    const CommandLog log = MakeFrame(0, 10);
+    EXPECT_EQ(log.Count(), 6);
+    // Opcode and arguments, hashes take two words
+    EXPECT_EQ(log.Words().size(), 2 + 4 + 2 + 6 + 6 + 1);
+}
+
+TEST(CommandLogTest, ReplayKeepsCommands) {
+    const CommandLog log = MakeFrame(3, 10);
+    std::vector<Command> commands;
+    log.Replay([&](const Command &command) { commands.push_back(command); });
+
+    ASSERT_EQ(commands.size(), 6);
+    EXPECT_EQ(commands[0].op, Command::beginFrame);
+    EXPECT_EQ(commands[0].args[0], 3);
+    EXPECT_EQ(commands[1].hash, CommandLog::Hash((const u32[]) { 1, 2, 3 }, 3 * sizeof(u32)));
+    EXPECT_EQ(commands[4].op, Command::draw);
+    EXPECT_EQ(commands[4].args[0], 120);
+    EXPECT_EQ(commands[4].args[3], 8);
+    EXPECT_EQ(commands[4].args[4], 10);
+    EXPECT_EQ(commands[5].op, Command::endFrame);
+
+    // Replaying into another log gives the same stream
+    CommandLog copy;
+    log.Replay([&](const Command &command) { copy.Record(command); });
+    EXPECT_TRUE(std::equal(log.Words().begin(), log.Words().end(), copy.Words().begin(), copy.Words().end()));
+}
+
+TEST(CommandLogTest, SaveAndLoad) {
+    const CommandLog log = MakeFrame(1, 5);
+    const std::string path = (std::filesystem::temp_directory_path() / "reveal3d_command_log_test.bin").string();
+    ASSERT_TRUE(log.Save(path.c_str()));
+
+    CommandLog loaded;
+    ASSERT_TRUE(loaded.Load(path.c_str()));
+    EXPECT_EQ(loaded.Count(), log.Count());
+    EXPECT_EQ(loaded.FirstDifference(log), log.Count());
+
+    // Truncated file is rejected
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - sizeof(u32));
+    EXPECT_FALSE(loaded.Load(path.c_str()));
+    EXPECT_EQ(loaded.Count(), 0);
+    std::remove(path.c_str());
+}
+
+// Word count of the header must match the rest of the file, it is read before anything is sized
+TEST(CommandLogTest, LoadChecksWordCount) {
+    const CommandLog log = MakeFrame(2, 5);
+    const std::string path = (std::filesystem::temp_directory_path() / "reveal3d_command_log_count_test.bin").string();
+    ASSERT_TRUE(log.Save(path.c_str()));
+
+    const u32 huge = 0x40000000;
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(3 * sizeof(u32));
+        file.write((const char *) &huge, sizeof(huge));
+    }
+    CommandLog loaded;
+    EXPECT_FALSE(loaded.Load(path.c_str()));
+    EXPECT_EQ(loaded.Count(), 0);
+
+    // Trailing words after a valid stream are rejected too
+    ASSERT_TRUE(log.Save(path.c_str()));
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::app);
+        file.write((const char *) &huge, sizeof(huge));
+    }
+    EXPECT_FALSE(loaded.Load(path.c_str()));
+    std::remove(path.c_str());
+}
+
+TEST(CommandLogTest, DiffAndText) {
+    const CommandLog a = MakeFrame(0, 10);
+    const CommandLog b = MakeFrame(0, 11);
+    // Instance count changes the upload, first difference is there
+    EXPECT_EQ(a.FirstDifference(b), 1);
+    EXPECT_EQ(a.FirstDifference(a), a.Count());
+
+    std::ostringstream text;
+    a.Print(text);
+    const std::string lines = text.str();
+    EXPECT_EQ(std::count(lines.begin(), lines.end(), '\n'), 6);
+    EXPECT_NE(lines.find("draw 120 1 36 8 10\n"), std::string::npos);
+    EXPECT_EQ(lines.rfind("endFrame\n"), lines.size() - 9);
+}
+
+}
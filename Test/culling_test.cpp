@@ -0,0 +1,106 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file culling_test.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Frustum culling unit testing
+ *
+ */
+
+#include <gtest/gtest.h>
+#include "render/camera.hpp"
+#include "render/culling.hpp"
+
+namespace reveal3d {
+
+class CullingTest : public testing::Test {
+protected:
+    CullingTest() {
+        // Axis aligned [-1, 1] cube
+        frustum_.planes[render::Frustum::left]   = {  1.0f,  0.0f,  0.0f, 1.0f };
+        frustum_.planes[render::Frustum::right]  = { -1.0f,  0.0f,  0.0f, 1.0f };
+        frustum_.planes[render::Frustum::bottom] = {  0.0f,  1.0f,  0.0f, 1.0f };
+        frustum_.planes[render::Frustum::top]    = {  0.0f, -1.0f,  0.0f, 1.0f };
+        frustum_.planes[render::Frustum::zNear]  = {  0.0f,  0.0f,  1.0f, 1.0f };
+        frustum_.planes[render::Frustum::zFar]   = {  0.0f,  0.0f, -1.0f, 1.0f };
+    }
+
+    void Add(math::vec3 center, math::vec3 extents) {
+        render::Bounds bounds;
+        bounds.center = center;
+        bounds.extents = extents;
+        boxes_.Resize(boxes_.Count() + 1);
+        boxes_.Set(boxes_.Count() - 1, bounds);
+    }
+
+    render::Frustum frustum_;
+    render::CullingBoxes boxes_;
+};
+
+TEST_F(CullingTest, InsideOutside) {
+    Add({ 0.0f, 0.0f, 0.0f }, { 0.5f, 0.5f, 0.5f });    // Inside
+    Add({ 5.0f, 0.0f, 0.0f }, { 0.5f, 0.5f, 0.5f });    // Right
+    Add({ 1.2f, 0.0f, 0.0f }, { 0.5f, 0.5f, 0.5f });    // Intersecting right
+    Add({ 0.0f, 0.0f, -3.0f }, { 1.0f, 1.0f, 1.0f });   // Behind near
+    Add({ 0.0f, 0.0f, 0.0f }, { 10.0f, 10.0f, 10.0f }); // Containing frustum
+
+    std::vector<u8> visible(boxes_.Count());
+    render::FrustumCull(frustum_, boxes_, 0, boxes_.Count(), visible.data());
+
+    EXPECT_EQ(visible[0], 1);
+    EXPECT_EQ(visible[1], 0);
+    EXPECT_EQ(visible[2], 1);
+    EXPECT_EQ(visible[3], 0);
+    EXPECT_EQ(visible[4], 1);
+}
+
+TEST_F(CullingTest, Tail) {
+    // Count not multiple of four, last boxes take the scalar path
+    for (u32 i = 0; i < 7; ++i) {
+        Add({ (f32) i, 0.0f, 0.0f }, { 0.1f, 0.1f, 0.1f });
+    }
+
+    std::vector<u8> visible(boxes_.Count());
+    render::FrustumCull(frustum_, boxes_, 0, boxes_.Count(), visible.data());
+
+    for (u32 i = 0; i < 7; ++i) {
+        EXPECT_EQ(visible[i], i < 2 ? 1 : 0);
+    }
+}
+
+// Planes extracted from a real camera, covers the unix and win32 matrix layouts
+TEST_F(CullingTest, CameraFrustum) {
+    const window::Resolution res(640, 480);
+    render::Camera camera(res);
+    camera.LookAt({ 0.0f, 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f });
+    camera.Resize(res);
+    Timer timer;
+    camera.Update(timer);
+    frustum_ = camera.GetFrustum();
+
+    Add({ 10.0f, 0.0f, 0.0f }, { 1.0f, 1.0f, 1.0f });    // In front
+    Add({ -10.0f, 0.0f, 0.0f }, { 1.0f, 1.0f, 1.0f });   // Behind
+    Add({ 10.0f, 30.0f, 0.0f }, { 1.0f, 1.0f, 1.0f });   // Left side
+    Add({ 10.0f, -30.0f, 0.0f }, { 1.0f, 1.0f, 1.0f });  // Right side
+    Add({ 10.0f, 0.0f, 30.0f }, { 1.0f, 1.0f, 1.0f });   // Above
+    Add({ 150.0f, 0.0f, 0.0f }, { 1.0f, 1.0f, 1.0f });   // Past far plane
+    Add({ 10.0f, 7.5f, 0.0f }, { 1.0f, 1.0f, 1.0f });    // Crossing the left plane
+    Add({ 10.0f, 0.0f, 9.0f }, { 1.0f, 1.0f, 1.0f });    // Just above, 65 degrees vertical fov
+
+    std::vector<u8> visible(boxes_.Count());
+    render::FrustumCull(frustum_, boxes_, 0, boxes_.Count(), visible.data());
+
+    EXPECT_EQ(visible[0], 1);
+    EXPECT_EQ(visible[1], 0);
+    EXPECT_EQ(visible[2], 0);
+    EXPECT_EQ(visible[3], 0);
+    EXPECT_EQ(visible[4], 0);
+    EXPECT_EQ(visible[5], 0);
+    EXPECT_EQ(visible[6], 1);
+    EXPECT_EQ(visible[7], 0);
+}
+
+}
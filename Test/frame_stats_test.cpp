@@ -0,0 +1,69 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file frame_stats_test.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Frame stats unit testing
+ *
+ */
+
+#include <gtest/gtest.h>
+#include "common/frame_stats.hpp"
+
+#include <algorithm>
+#include <random>
+
+namespace reveal3d {
+
+TEST(FrameStatsTest, Empty) {
+    FrameStats stats;
+    const FrameStats::Summary summary = stats.Summarize(StageTimes::frame);
+    EXPECT_EQ(summary.mean, 0.0);
+    EXPECT_EQ(summary.p99, 0.0);
+    EXPECT_EQ(Percentile({}, 50.0), 0.0);
+}
+
+// Frames 1 to 100 ms in random order, nearest rank gives back the percent itself
+TEST(FrameStatsTest, Percentiles) {
+    std::vector<f64> times(100);
+    for (u32 i = 0; i < times.size(); ++i) {
+        times[i] = (f64)(i + 1);
+    }
+    std::shuffle(times.begin(), times.end(), std::mt19937(7));
+
+    FrameStats stats;
+    for (f64 time : times) {
+        StageTimes frame;
+        frame.time[StageTimes::culling] = time;
+        frame.time[StageTimes::frame] = 2.0;
+        stats.Add(frame);
+    }
+    const FrameStats::Summary culling = stats.Summarize(StageTimes::culling);
+    EXPECT_DOUBLE_EQ(culling.mean, 50.5);
+    EXPECT_EQ(culling.p50, 50.0);
+    EXPECT_EQ(culling.p95, 95.0);
+    EXPECT_EQ(culling.p99, 99.0);
+    EXPECT_EQ(culling.max, 100.0);
+    EXPECT_EQ(stats.Summarize(StageTimes::frame).p99, 2.0);
+    EXPECT_EQ(stats.Summarize(StageTimes::submission).max, 0.0);
+}
+
+TEST(FrameStatsTest, SingleSample) {
+    EXPECT_EQ(Percentile({ 4.0 }, 0.0), 4.0);
+    EXPECT_EQ(Percentile({ 4.0 }, 100.0), 4.0);
+    EXPECT_EQ(Percentile({ 1.0, 2.0, 3.0 }, 100.0), 3.0);
+}
+
+TEST(FrameStatsTest, StopwatchLaps) {
+    Stopwatch watch;
+    const f64 first = watch.Lap();
+    const f64 second = watch.Lap();
+    EXPECT_GE(first, 0.0);
+    EXPECT_GE(second, 0.0);
+    EXPECT_GE(watch.Elapsed(), first + second);
+}
+
+}
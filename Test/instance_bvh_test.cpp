@@ -0,0 +1,131 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file instance_bvh_test.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Instance BVH unit testing
+ *
+ * Results are checked against one triangle BVH built over the instances already moved
+ * to world space.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+
+#include "spatial/instance_bvh.hpp"
+
+namespace reveal3d {
+
+class InstanceBvhTest : public testing::Test {
+protected:
+    static constexpr u32 count = 200;
+
+    InstanceBvhTest() : generator_(7) {
+        // Unit cube, 12 triangles
+        for (u32 i = 0; i < 8; ++i) {
+            render::Vertex &vertex = cube_.emplace_back();
+            vertex.pos = { i & 1 ? 0.5f : -0.5f, i & 2 ? 0.5f : -0.5f, i & 4 ? 0.5f : -0.5f };
+        }
+        cubeIndices_ = { 0, 1, 3, 0, 3, 2, 4, 6, 7, 4, 7, 5, 0, 4, 5, 0, 5, 1,
+                         2, 3, 7, 2, 7, 6, 0, 2, 6, 0, 6, 4, 1, 5, 7, 1, 7, 3 };
+        bvh_.Build(cube_.data(), cubeIndices_.data(), cubeIndices_.size());
+
+        std::uniform_real_distribution<f32> position(-20.0f, 20.0f);
+        std::uniform_real_distribution<f32> scale(0.5f, 2.0f);
+        std::uniform_real_distribution<f32> angle(0.0f, 6.28f);
+        for (u32 i = 0; i < count; ++i) {
+            spatial::InstanceBvh::Instance &instance = instances_.emplace_back();
+            instance.bvh = &bvh_;
+            const f32 s = scale(generator_);
+            const f32 c = std::cos(angle(generator_)) * s;
+            const f32 n = std::sin(angle(generator_)) * s;
+            const f32 world[12] = { c, -n, 0.0f, position(generator_),
+                                    n, c, 0.0f, position(generator_),
+                                    0.0f, 0.0f, s * 0.5f, position(generator_) };
+            std::copy(world, world + 12, instance.world);
+
+            instance.bounds = { { FLT_MAX, FLT_MAX, FLT_MAX }, { -FLT_MAX, -FLT_MAX, -FLT_MAX } };
+            for (const render::Vertex &local : cube_) {
+                render::Vertex &vertex = worldVertices_.emplace_back();
+                vertex.pos = { world[0] * local.pos.x + world[1] * local.pos.y + world[2] * local.pos.z + world[3],
+                               world[4] * local.pos.x + world[5] * local.pos.y + world[6] * local.pos.z + world[7],
+                               world[8] * local.pos.x + world[9] * local.pos.y + world[10] * local.pos.z + world[11] };
+                instance.bounds = spatial::Union(instance.bounds, { vertex.pos, vertex.pos });
+            }
+            for (const u32 index : cubeIndices_) {
+                worldIndices_.push_back(index + i * 8);
+            }
+        }
+        worldBvh_.Build(worldVertices_.data(), worldIndices_.data(), worldIndices_.size());
+        scene_.Build(instances_);
+    }
+
+    std::vector<render::Vertex> cube_;
+    std::vector<u32> cubeIndices_;
+    spatial::TriangleBvh bvh_;
+    std::vector<spatial::InstanceBvh::Instance> instances_;
+    std::vector<render::Vertex> worldVertices_;
+    std::vector<u32> worldIndices_;
+    spatial::TriangleBvh worldBvh_;
+    spatial::InstanceBvh scene_;
+    std::mt19937 generator_;
+};
+
+TEST_F(InstanceBvhTest, Build) {
+    EXPECT_EQ(scene_.InstanceCount(), count);
+    EXPECT_GT(scene_.NodeCount(), 1);
+
+    // Collapsed instances can't be hit and are left out
+    instances_[0].world[0] = instances_[0].world[1] = instances_[0].world[2] = 0.0f;
+    scene_.Build(instances_);
+    EXPECT_EQ(scene_.InstanceCount(), count - 1);
+}
+
+TEST_F(InstanceBvhTest, MatchesFlattenedScene) {
+    std::uniform_real_distribution<f32> target(-20.0f, 20.0f);
+    u32 hits = 0;
+
+    for (u32 i = 0; i < 200; ++i) {
+        spatial::RayPacket packet;
+        for (u32 lane = 0; lane < 4; ++lane) {
+            packet.origin[0][lane] = -40.0f;
+            packet.origin[1][lane] = target(generator_);
+            packet.origin[2][lane] = target(generator_);
+            packet.direction[0][lane] = 80.0f;
+            packet.direction[1][lane] = target(generator_) - packet.origin[1][lane];
+            packet.direction[2][lane] = target(generator_) - packet.origin[2][lane];
+        }
+        spatial::SceneHit hit;
+        const u32 mask = scene_.RaycastPacket(packet, hit);
+
+        for (u32 lane = 0; lane < 4; ++lane) {
+            const math::vec3 origin { packet.origin[0][lane], packet.origin[1][lane], packet.origin[2][lane] };
+            const math::vec3 direction { packet.direction[0][lane], packet.direction[1][lane], packet.direction[2][lane] };
+            spatial::TriangleHit expected;
+            const bool found = worldBvh_.Raycast(origin, direction, FLT_MAX, expected);
+
+            EXPECT_EQ((mask >> lane) & 1, found ? 1u : 0u);
+            if (found) {
+                ++hits;
+                EXPECT_EQ(hit.instance[lane], expected.triangle / 12);
+                EXPECT_EQ(hit.triangle[lane], expected.triangle % 12);
+                EXPECT_NEAR(hit.distance[lane], expected.distance, 1e-4f);
+            }
+        }
+    }
+    EXPECT_GT(hits, 0);
+}
+
+TEST_F(InstanceBvhTest, Empty) {
+    scene_.Clear();
+    spatial::RayPacket packet {};
+    spatial::SceneHit hit;
+    EXPECT_EQ(scene_.RaycastPacket(packet, hit), 0u);
+}
+
+}
@@ -0,0 +1,76 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file job_system_test.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Job system unit testing
+ *
+ */
+
+#include <gtest/gtest.h>
+#include "common/job_system.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace reveal3d {
+
+class JobSystemTest : public testing::Test {
+protected:
+    // Other tests may have started the default pool, which has no workers on one core
+    static void SetUpTestSuite() {
+        jobs::Shutdown();
+        jobs::Init(4);
+    }
+    static void TearDownTestSuite() { jobs::Shutdown(); }
+};
+
+TEST_F(JobSystemTest, EveryIndexOnce) {
+    std::vector<std::atomic<u32>> visits(10007);
+    jobs::ParallelFor(visits.size(), 16, [&](u32 begin, u32 end) {
+        for (u32 i = begin; i < end; ++i) {
+            visits[i].fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+    for (auto &visit : visits) {
+        EXPECT_EQ(visit.load(), 1u);
+    }
+}
+
+TEST_F(JobSystemTest, RangesAreGrainAligned) {
+    std::atomic<u32> misaligned { 0 };
+    std::atomic<u32> total { 0 };
+    jobs::ParallelFor(1000, 7, [&](u32 begin, u32 end) {
+        misaligned += begin % 7 != 0 or end - begin > 7 or (end - begin < 7 and end != 1000);
+        total += end - begin;
+    });
+    EXPECT_EQ(misaligned.load(), 0u);
+    EXPECT_EQ(total.load(), 1000u);
+}
+
+// All the slow ranges are in the first share, the rest of the threads have to steal them
+TEST_F(JobSystemTest, UnevenWork) {
+    std::atomic<u32> total { 0 };
+    jobs::ParallelFor(64, 1, [&](u32 begin, u32 end) {
+        if (begin < 16) std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        total += end - begin;
+    });
+    EXPECT_EQ(total.load(), 64u);
+}
+
+TEST_F(JobSystemTest, NestedRunsSerially) {
+    std::atomic<u32> total { 0 };
+    jobs::ParallelFor(8, 1, [&](u32, u32) {
+        jobs::ParallelFor(100, 10, [&](u32 begin, u32 end) {
+            total += end - begin;
+        });
+    });
+    EXPECT_EQ(total.load(), 800u);
+}
+
+}
@@ -0,0 +1,106 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file logger_test.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Logger unit testing
+ *
+ * Debug messages are compiled out of this file, the other levels go through the ring.
+ */
+
+#define LOG_MAX_LEVEL logWARNING
+
+#include <gtest/gtest.h>
+#include "common/logger.hpp"
+#include "common/primitive_types.hpp"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace reveal3d {
+
+class LoggerTest : public testing::Test {
+protected:
+    void SetUp() override {
+        Logger::SetConsole(false);
+        Logger::Clear(logERROR);
+        Logger::Clear(logWARNING);
+        Logger::Clear(logDEBUG);
+    }
+    void TearDown() override { Logger::SetConsole(true); }
+};
+
+TEST_F(LoggerTest, Format) {
+    enum { first, second };
+    const std::string name = "mesh";
+    LOG(logWARNING) << "Loaded " << name << ' ' << 42 << ' ' << -7 << ' ' << 3000000000u << ' ' << 1.5f
+                    << ' ' << true << ' ' << second;
+    EXPECT_EQ(Logger::Log(logWARNING), "WARNING MSG: Loaded mesh 42 -7 3000000000 1.5 1 1\n");
+    EXPECT_EQ(Logger::Log(logERROR), "");
+}
+
+TEST_F(LoggerTest, LongText) {
+    const std::string path(1000, 'a');
+    LOG(logERROR) << "File " << path << " not found";
+    EXPECT_EQ(Logger::Log(logERROR), "ERROR MSG: File " + path + " not found\n");
+}
+
+TEST_F(LoggerTest, Threads) {
+    constexpr u32 threads = 4;
+    constexpr u32 messages = 100;
+    std::vector<std::thread> workers;
+    for (u32 t = 0; t < threads; ++t) {
+        workers.emplace_back([t] {
+            for (u32 i = 0; i < messages; ++i) {
+                LOG(logERROR) << "Thread " << t << " message " << i;
+            }
+        });
+    }
+    for (std::thread &worker : workers) worker.join();
+
+    // Errors are never dropped and every thread keeps its order
+    const std::string history = Logger::Log(logERROR);
+    for (u32 t = 0; t < threads; ++t) {
+        size_t last = 0;
+        for (u32 i = 0; i < messages; ++i) {
+            const std::string line = "ERROR MSG: Thread " + std::to_string(t) + " message " + std::to_string(i) + "\n";
+            const size_t at = history.find(line);
+            ASSERT_NE(at, std::string::npos) << line;
+            EXPECT_GE(at, last);
+            last = at;
+        }
+    }
+}
+
+TEST_F(LoggerTest, BoundedHistory) {
+    for (u32 i = 0; i < 4000; ++i) {
+        LOG(logERROR) << "History line " << i;
+        if (i % 200 == 0) Logger::Flush();
+    }
+    const std::string history = Logger::Log(logERROR);
+    EXPECT_LE(history.size(), Logger::historyCapacity);
+    EXPECT_GT(history.size(), Logger::historyCapacity / 2);
+    EXPECT_EQ(history.rfind("ERROR MSG: History line ", 0), 0u);
+    EXPECT_NE(history.find("ERROR MSG: History line 3999\n"), std::string::npos);
+}
+
+TEST_F(LoggerTest, CompiledOut) {
+    const LogLevel previous = loglevel;
+    loglevel = logDEBUG;
+    u32 evaluated = 0;
+    LOG(logDEBUG) << ++evaluated;
+    LOG(logWARNING) << ++evaluated;
+    loglevel = logERROR;
+    LOG(logWARNING) << ++evaluated;
+    loglevel = previous;
+
+    EXPECT_EQ(evaluated, 1u);
+    EXPECT_EQ(Logger::Log(logDEBUG), "");
+    EXPECT_EQ(Logger::Log(logWARNING), "WARNING MSG: 1\n");
+}
+
+}
@@ -14,8 +14,6 @@
 #include <gtest/gtest.h>
 #include "math/math.hpp"
 
-LogLevel loglevel = logDEBUG;
-
 namespace reveal3d {
 
 
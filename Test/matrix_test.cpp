@@ -14,7 +14,7 @@
 #include <gtest/gtest.h>
 #include "math/math.hpp"
 
-LogLevel loglevel = logDEBUG;
+LogLevel loglevel = logDEBUG; // One definition for the whole Test executable
 
 namespace reveal3d {
 
@@ -78,4 +78,33 @@ TEST(Matrix4Test, Div) {
 
 }
 
+#ifndef WIN32
+// Worlds are built as in core::Transform, the accessors have to give back what went in
+TEST(Matrix4Test, Decompose) {
+    const math::xvec3 position(1.0f, -2.0f, 3.0f);
+    const math::xvec3 scale(2.0f, 0.5f, 3.0f);
+    const math::xvec3 rotation(0.3f, -0.7f, 1.2f);
+    const math::mat4 world = math::Transpose(math::AffineTransformation(position, scale, rotation));
+
+    const math::xvec3 outPosition = world.GetTranslation();
+    const math::xvec3 outScale = world.GetScale();
+    const math::xvec3 outRotation = world.GetRotation();
+    EXPECT_NEAR(outPosition.GetX(), 1.0f, 1e-5f);
+    EXPECT_NEAR(outPosition.GetY(), -2.0f, 1e-5f);
+    EXPECT_NEAR(outPosition.GetZ(), 3.0f, 1e-5f);
+    EXPECT_NEAR(outScale.GetX(), 2.0f, 1e-5f);
+    EXPECT_NEAR(outScale.GetY(), 0.5f, 1e-5f);
+    EXPECT_NEAR(outScale.GetZ(), 3.0f, 1e-5f);
+    EXPECT_NEAR(outRotation.GetX(), 0.3f, 1e-5f);
+    EXPECT_NEAR(outRotation.GetY(), -0.7f, 1e-5f);
+    EXPECT_NEAR(outRotation.GetZ(), 1.2f, 1e-5f);
+
+    // Gimbal lock, only the sum of x and z is recoverable
+    const math::mat4 locked = math::Transpose(math::AffineTransformation(position, scale, { 0.2f, 1.5707964f, 0.5f }));
+    EXPECT_NEAR(locked.GetRotation().GetX(), 0.7f, 1e-3f);
+    EXPECT_NEAR(locked.GetRotation().GetY(), 1.5707964f, 1e-3f);
+    EXPECT_NEAR(locked.GetRotation().GetZ(), 0.0f, 1e-3f);
+}
+#endif
+
 }
@@ -0,0 +1,105 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file memory_report_test.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Memory report unit testing
+ *
+ * Tags are shared by the whole engine, tests check differences, not totals.
+ */
+
+#include <gtest/gtest.h>
+#include "common/memory_report.hpp"
+
+#include <utility>
+
+namespace reveal3d {
+
+namespace {
+
+u64 evictedBytes = 0;
+
+void Evict(memory::tag, u64 bytes) {
+    evictedBytes = bytes;
+}
+
+}
+
+TEST(MemoryReportTest, AllocatorCounts) {
+    const u64 before = memory::TagUsage(memory::content).bytes;
+    {
+        memory::Vector<u32, memory::content> values;
+        values.reserve(100);
+        EXPECT_EQ(memory::TagUsage(memory::content).bytes - before, 400u);
+        memory::Deque<u64, memory::content> queue;
+        queue.push_back(1);
+        EXPECT_GT(memory::TagUsage(memory::content).bytes - before, 400u);
+    }
+    EXPECT_EQ(memory::TagUsage(memory::content).bytes, before);
+    EXPECT_GE(memory::TagUsage(memory::content).peak, before + 400);
+}
+
+TEST(MemoryReportTest, Tracked) {
+    const u64 before = memory::TagUsage(memory::buffers).bytes;
+    {
+        memory::Tracked<memory::buffers> a;
+        a.Set(1000);
+        EXPECT_EQ(memory::TagUsage(memory::buffers).bytes - before, 1000u);
+
+        // Copies own nothing yet, moves take the bytes over
+        memory::Tracked<memory::buffers> copy(a);
+        EXPECT_EQ(copy.Bytes(), 0u);
+        memory::Tracked<memory::buffers> moved(std::move(a));
+        EXPECT_EQ(moved.Bytes(), 1000u);
+        EXPECT_EQ(memory::TagUsage(memory::buffers).bytes - before, 1000u);
+
+        memory::Tracked<memory::buffers> b;
+        b.Set(500);
+        moved = std::move(b);
+        EXPECT_EQ(memory::TagUsage(memory::buffers).bytes - before, 500u);
+    }
+    EXPECT_EQ(memory::TagUsage(memory::buffers).bytes, before);
+}
+
+TEST(MemoryReportTest, Budget) {
+    const u64 before = memory::TagUsage(memory::content).bytes;
+    evictedBytes = 0;
+    memory::SetBudget(memory::content, before + 1000, Evict);
+    EXPECT_EQ(memory::Budget(memory::content), before + 1000);
+
+    memory::Track(memory::content, 800);
+    EXPECT_EQ(evictedBytes, 0u);
+    memory::Track(memory::content, 400);
+    EXPECT_EQ(evictedBytes, before + 1200);
+
+    // Once per crossing, going under the budget arms it again
+    evictedBytes = 0;
+    memory::Track(memory::content, 10);
+    EXPECT_EQ(evictedBytes, 0u);
+    memory::Track(memory::content, -710);
+    memory::Track(memory::content, 600);
+    EXPECT_EQ(evictedBytes, before + 1100);
+
+    memory::SetBudget(memory::content, 0);
+    memory::Track(memory::content, -1100);
+    EXPECT_EQ(memory::TagUsage(memory::content).bytes, before);
+}
+
+TEST(MemoryReportTest, Report) {
+    const std::vector<memory::Usage> report = memory::MemoryReport();
+    ASSERT_EQ(report.size(), (u32) memory::tag::count);
+    for (u32 i = 0; i < memory::tag::count; ++i) {
+        EXPECT_STREQ(report[i].name, memory::tagNames[i]);
+        EXPECT_GE(report[i].peak, report[i].bytes);
+    }
+
+    memory::ResetPeaks();
+    for (const memory::Usage &usage : memory::MemoryReport()) {
+        EXPECT_EQ(usage.peak, usage.bytes);
+    }
+}
+
+}
@@ -0,0 +1,89 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file occlusion_test.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Software occlusion culling unit testing
+ *
+ * Camera sits at the origin looking down +z with a 90 degree field of view,
+ * clip space x and y are world x and y and w is the distance along z.
+ */
+
+#include <gtest/gtest.h>
+#include "render/occlusion.hpp"
+
+namespace reveal3d {
+
+class OcclusionTest : public testing::Test {
+protected:
+    OcclusionTest() {
+        frustum_.clip[0] = { 1.0f, 0.0f, 0.0f, 0.0f };
+        frustum_.clip[1] = { 0.0f, 1.0f, 0.0f, 0.0f };
+        frustum_.clip[2] = { 0.0f, 0.0f, 1.0f, -0.1f };
+        frustum_.clip[3] = { 0.0f, 0.0f, 1.0f, 0.0f };
+        buffer_.Resize(128, 72);
+    }
+
+    // Square wall facing the camera
+    void AddWall(f32 halfSize, f32 z) {
+        const math::vec3 corners[4] = { { -halfSize, -halfSize, z }, { halfSize, -halfSize, z },
+                                        { halfSize, halfSize, z }, { -halfSize, halfSize, z } };
+        triangles_.insert(triangles_.end(), { corners[0], corners[1], corners[2], corners[0], corners[2], corners[3] });
+    }
+
+    static render::Bounds Box(f32 x, f32 y, f32 z, f32 extent) {
+        render::Bounds bounds;
+        bounds.center = { x, y, z };
+        bounds.extents = { extent, extent, extent };
+        return bounds;
+    }
+
+    render::Frustum frustum_;
+    render::OcclusionBuffer buffer_;
+    std::vector<math::vec3> triangles_;
+};
+
+TEST_F(OcclusionTest, Empty) {
+    buffer_.Render(frustum_, triangles_);
+    EXPECT_TRUE(buffer_.Test(frustum_, Box(0.0f, 0.0f, 10.0f, 1.0f)));
+    EXPECT_EQ(buffer_.Depth(64, 36), 0.0f);
+}
+
+TEST_F(OcclusionTest, Depth) {
+    AddWall(4.0f, 5.0f);
+    buffer_.Render(frustum_, triangles_);
+    EXPECT_NEAR(buffer_.Depth(64, 36), 1.0f / 5.0f, 1e-5f);
+    EXPECT_NEAR(buffer_.TileDepth(2, 4), 1.0f / 5.0f, 1e-5f);
+    EXPECT_EQ(buffer_.Depth(0, 0), 0.0f);
+}
+
+TEST_F(OcclusionTest, Occluded) {
+    AddWall(4.0f, 5.0f);
+    buffer_.Render(frustum_, triangles_);
+    EXPECT_FALSE(buffer_.Test(frustum_, Box(0.0f, 0.0f, 10.0f, 1.0f)));
+    EXPECT_FALSE(buffer_.Test(frustum_, Box(-2.0f, 3.0f, 30.0f, 2.0f)));
+}
+
+TEST_F(OcclusionTest, Visible) {
+    AddWall(4.0f, 5.0f);
+    buffer_.Render(frustum_, triangles_);
+    EXPECT_TRUE(buffer_.Test(frustum_, Box(0.0f, 0.0f, 2.0f, 1.0f)));   // In front of the wall
+    EXPECT_TRUE(buffer_.Test(frustum_, Box(8.0f, 0.0f, 10.0f, 1.0f)));  // Partially behind the wall edge
+    EXPECT_TRUE(buffer_.Test(frustum_, Box(0.0f, 0.0f, 4.5f, 1.0f)));   // Intersecting the wall
+    EXPECT_TRUE(buffer_.Test(frustum_, Box(0.0f, 0.0f, 0.0f, 1.0f)));   // Crossing the near plane
+}
+
+TEST_F(OcclusionTest, ClosestOccluderWins) {
+    AddWall(4.0f, 8.0f);
+    AddWall(1.0f, 3.0f);
+    buffer_.Render(frustum_, triangles_);
+    EXPECT_NEAR(buffer_.Depth(64, 36), 1.0f / 3.0f, 1e-5f);
+    EXPECT_FALSE(buffer_.Test(frustum_, Box(0.0f, 0.0f, 12.0f, 1.0f)));
+    EXPECT_FALSE(buffer_.Test(frustum_, Box(0.0f, 0.0f, 6.0f, 0.5f)));  // Behind the small wall
+    EXPECT_TRUE(buffer_.Test(frustum_, Box(2.5f, 0.0f, 6.0f, 0.5f)));   // Between both walls
+}
+
+}
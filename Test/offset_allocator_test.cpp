@@ -0,0 +1,183 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file offset_allocator_test.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Offset allocator unit testing
+ *
+ */
+
+#include <gtest/gtest.h>
+#include "common/offset_allocator.hpp"
+
+#include <algorithm>
+#include <random>
+
+namespace reveal3d {
+
+TEST(OffsetAllocatorTest, AllocateAndFree) {
+    OffsetAllocator allocator(1024);
+    auto a = allocator.Allocate(100);
+    auto b = allocator.Allocate(200);
+    auto c = allocator.Allocate(300);
+    ASSERT_TRUE(a.Valid() and b.Valid() and c.Valid());
+    EXPECT_EQ(a.offset, 0);
+    EXPECT_EQ(b.offset, 100);
+    EXPECT_EQ(c.offset, 300);
+    EXPECT_EQ(allocator.AllocationSize(b), 200);
+    EXPECT_EQ(allocator.FreeSize(), 424);
+    EXPECT_EQ(allocator.Statistics().allocations, 3);
+
+    allocator.Free(b);
+    EXPECT_EQ(allocator.FreeSize(), 624);
+    EXPECT_EQ(allocator.Statistics().freeRegions, 2);
+
+    // The hole is reused by an allocation that fits it
+    auto d = allocator.Allocate(150);
+    ASSERT_TRUE(d.Valid());
+    EXPECT_GE(d.offset, 100);
+    EXPECT_TRUE(d.offset + 150 <= 300 or d.offset >= 600);
+}
+
+TEST(OffsetAllocatorTest, FreeMergesNeighbors) {
+    OffsetAllocator allocator(1000);
+    OffsetAllocator::Allocation allocations[10];
+    for (auto &allocation : allocations) {
+        allocation = allocator.Allocate(100);
+        ASSERT_TRUE(allocation.Valid());
+    }
+    EXPECT_EQ(allocator.FreeSize(), 0);
+    EXPECT_FALSE(allocator.Allocate(1).Valid());
+
+    // Every other one first, then the rest, leaving a single range
+    for (u32 i = 0; i < 10; i += 2) allocator.Free(allocations[i]);
+    EXPECT_EQ(allocator.Statistics().freeRegions, 5);
+    for (u32 i = 1; i < 10; i += 2) allocator.Free(allocations[i]);
+
+    const auto stats = allocator.Statistics();
+    EXPECT_EQ(stats.freeRegions, 1);
+    EXPECT_EQ(stats.largestFree, 1000);
+    EXPECT_EQ(stats.allocations, 0);
+    EXPECT_FLOAT_EQ(stats.Fragmentation(), 0.0f);
+
+    auto whole = allocator.Allocate(1000);
+    ASSERT_TRUE(whole.Valid());
+    EXPECT_EQ(whole.offset, 0);
+}
+
+TEST(OffsetAllocatorTest, NoSpace) {
+    OffsetAllocator allocator(256);
+    EXPECT_FALSE(allocator.Allocate(257).Valid());
+    EXPECT_FALSE(allocator.Allocate(0).Valid());
+
+    auto a = allocator.Allocate(128);
+    auto b = allocator.Allocate(64);
+    ASSERT_TRUE(a.Valid() and b.Valid());
+    allocator.Free(a);
+    // 192 bytes are free but split in two ranges
+    EXPECT_EQ(allocator.FreeSize(), 192);
+    EXPECT_FALSE(allocator.Allocate(192).Valid());
+}
+
+TEST(OffsetAllocatorTest, Grow) {
+    OffsetAllocator allocator(100);
+    auto a = allocator.Allocate(60);
+    ASSERT_TRUE(a.Valid());
+    EXPECT_FALSE(allocator.Allocate(100).Valid());
+
+    // Free tail merges with the added space
+    allocator.Grow(200);
+    EXPECT_EQ(allocator.Size(), 200);
+    EXPECT_EQ(allocator.Statistics().freeRegions, 1);
+    auto b = allocator.Allocate(140);
+    ASSERT_TRUE(b.Valid());
+    EXPECT_EQ(b.offset, 60);
+    EXPECT_EQ(allocator.FreeSize(), 0);
+
+    // Used tail, the added space is a new range that merges on free
+    allocator.Grow(300);
+    auto c = allocator.Allocate(100);
+    ASSERT_TRUE(c.Valid());
+    EXPECT_EQ(c.offset, 200);
+    allocator.Free(a);
+    allocator.Free(c);
+    allocator.Free(b);
+    EXPECT_EQ(allocator.Statistics().freeRegions, 1);
+    EXPECT_EQ(allocator.Statistics().largestFree, 300);
+
+    OffsetAllocator empty;
+    empty.Grow(64);
+    EXPECT_TRUE(empty.Allocate(64).Valid());
+}
+
+TEST(OffsetAllocatorTest, Fragmentation) {
+    OffsetAllocator allocator(1024);
+    std::vector<OffsetAllocator::Allocation> allocations;
+    for (u32 i = 0; i < 16; ++i) {
+        allocations.push_back(allocator.Allocate(64));
+    }
+    for (u32 i = 0; i < 16; i += 2) {
+        allocator.Free(allocations[i]);
+    }
+
+    const auto stats = allocator.Statistics();
+    EXPECT_EQ(stats.free, 512);
+    EXPECT_EQ(stats.largestFree, 64);
+    EXPECT_EQ(stats.freeRegions, 8);
+    EXPECT_FLOAT_EQ(stats.Fragmentation(), 1.0f - 64.0f / 512.0f);
+}
+
+TEST(OffsetAllocatorTest, RandomNoOverlap) {
+    constexpr u32 size = 1 << 20;
+    std::mt19937 generator(7);
+    std::uniform_int_distribution<u32> sizes(1, 4096);
+    std::uniform_int_distribution<u32> coin(0, 2);
+
+    OffsetAllocator allocator(size);
+    std::vector<OffsetAllocator::Allocation> live;
+    std::vector<u32> liveSizes;
+    u32 used = 0;
+
+    for (u32 step = 0; step < 20000; ++step) {
+        if (live.empty() or coin(generator) != 0) {
+            const u32 request = sizes(generator);
+            auto allocation = allocator.Allocate(request);
+            if (!allocation.Valid()) continue;
+            ASSERT_LE(allocation.offset + request, size);
+            live.push_back(allocation);
+            liveSizes.push_back(request);
+            used += request;
+        } else {
+            const u32 i = generator() % live.size();
+            allocator.Free(live[i]);
+            used -= liveSizes[i];
+            live[i] = live.back();
+            liveSizes[i] = liveSizes.back();
+            live.pop_back();
+            liveSizes.pop_back();
+        }
+        ASSERT_EQ(allocator.FreeSize(), size - used);
+
+        if (step % 1000 == 0) {
+            std::vector<std::pair<u32, u32>> ranges;
+            for (u32 i = 0; i < live.size(); ++i) {
+                ranges.emplace_back(live[i].offset, liveSizes[i]);
+            }
+            std::sort(ranges.begin(), ranges.end());
+            for (u32 i = 1; i < ranges.size(); ++i) {
+                ASSERT_LE(ranges[i - 1].first + ranges[i - 1].second, ranges[i].first);
+            }
+        }
+    }
+
+    for (const auto &allocation : live) {
+        allocator.Free(allocation);
+    }
+    EXPECT_EQ(allocator.Statistics().freeRegions, 1);
+    EXPECT_EQ(allocator.FreeSize(), size);
+}
+
+}
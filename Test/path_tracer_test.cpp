@@ -0,0 +1,131 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file path_tracer_test.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Path tracer unit testing
+ *
+ * Same camera as the rasterizer tests: at the origin looking down +z with a 90 degree
+ * field of view. A single quad facing the camera sends every bounce to the sky, so its
+ * color has no noise.
+ */
+
+#include <gtest/gtest.h>
+#include "graphics/pathtracer/pt_tracer.hpp"
+
+namespace reveal3d {
+
+using namespace graphics;
+using namespace graphics::pathtracer;
+
+class PathTracerTest : public testing::Test {
+protected:
+    PathTracerTest() {
+        frustum_.clip[0] = { 1.0f, 0.0f, 0.0f, 0.0f };
+        frustum_.clip[1] = { 0.0f, 1.0f, 0.0f, 0.0f };
+        frustum_.clip[2] = { 0.0f, 0.0f, 1.0f, -0.2f };
+        frustum_.clip[3] = { 0.0f, 0.0f, 1.0f, 0.0f };
+        tracer_.Resize(64, 36);
+        tracer_.SetCamera(frustum_);
+
+        for (u32 i = 0; i < 4; ++i) {
+            render::Vertex &vertex = quad_.emplace_back();
+            vertex.pos = { i & 1 ? 1.0f : -1.0f, i & 2 ? 1.0f : -1.0f, 0.0f };
+            vertex.color = { 0.5f, 0.5f, 0.5f, 1.0f };
+            vertex.normal = { 0.0f, 0.0f, -1.0f };
+        }
+        bvh_.Build(quad_.data(), indices_, 6);
+    }
+
+    // Quad scaled by size, centered at (x, y, z) facing the camera
+    TraceItem Item(f32 size, f32 x, f32 y, f32 z, render::Shader shader, math::vec4 color = { 1.0f, 1.0f, 1.0f, 1.0f }) {
+        TraceItem item;
+        item.bvh = &bvh_;
+        item.vertices = quad_.data();
+        item.indices = indices_;
+        f32 *world = (f32 *) &item.instance.world;
+        std::fill(world, world + 16, 0.0f);
+        world[0] = world[5] = size;
+        world[10] = world[15] = 1.0f;
+        world[3] = x;
+        world[7] = y;
+        world[11] = z;
+        item.instance.color = color;
+        item.bounds.center = { x, y, z };
+        item.bounds.extents = { size, size, 0.0f };
+        item.shader = shader;
+        return item;
+    }
+
+    static u32 Channel(u32 color, u32 channel) { return (color >> (channel * 8)) & 0xFF; }
+
+    render::Frustum frustum_;
+    Tracer tracer_;
+    std::vector<render::Vertex> quad_;
+    const u32 indices_[6] = { 0, 1, 3, 0, 3, 2 };
+    spatial::TriangleBvh bvh_;
+};
+
+TEST_F(PathTracerTest, Background) {
+    tracer_.Trace();
+    EXPECT_EQ(tracer_.Samples(), 1u);
+    EXPECT_EQ(tracer_.Rays(), 64u * 36u);
+    EXPECT_EQ(Channel(tracer_.Target().Color(32, 18), 0), 51u);
+}
+
+TEST_F(PathTracerTest, Emissive) {
+    std::vector<TraceItem> items = { Item(1.0f, 0.0f, 0.0f, 5.0f, render::flat, { 1.0f, 0.0f, 0.0f, 1.0f }) };
+    tracer_.SetScene(std::move(items));
+    tracer_.Trace();
+    EXPECT_EQ(tracer_.Target().Color(32, 18), software::Framebuffer::Pack(128, 0, 0));
+    EXPECT_EQ(Channel(tracer_.Target().Color(2, 2), 0), 51u);
+}
+
+// Sky 0.7 plus 0.9 times the cosine with the sun, like the ambient of the solid shader
+TEST_F(PathTracerTest, Lighting) {
+    std::vector<TraceItem> items = { Item(1.0f, 0.0f, 0.0f, 5.0f, render::opaque) };
+    tracer_.SetScene(std::move(items));
+    for (u32 i = 0; i < 4; ++i) {
+        tracer_.Trace();
+    }
+    const f32 cosine = 1.0f / std::sqrt(1.25f);
+    const u32 expected = (u32)((0.7f + 0.9f * cosine) * 0.5f * 255.0f + 0.5f);
+    EXPECT_NEAR(Channel(tracer_.Target().Color(32, 18), 1), expected, 1);
+    // Camera rays and shadow rays of the quad, bounces all reach the sky
+    EXPECT_GT(tracer_.Rays(), 64u * 36u);
+}
+
+// Quad between the sun and the lit one takes away the sun, not the sky
+TEST_F(PathTracerTest, Shadow) {
+    std::vector<TraceItem> items = { Item(1.0f, 0.0f, 0.0f, 5.0f, render::opaque), Item(1.0f, 0.0f, 2.0f, 1.0f, render::opaque) };
+    tracer_.SetScene(std::move(items));
+    tracer_.Trace();
+    const u32 lit = Channel(tracer_.Target().Color(32, 18), 1);
+    EXPECT_LT(lit, (u32)((0.7f + 0.9f * 0.894f) * 0.5f * 255.0f));
+    EXPECT_GT(lit, 0u);
+}
+
+TEST_F(PathTracerTest, ResetOnCameraChange) {
+    tracer_.Trace();
+    tracer_.Trace();
+    tracer_.SetCamera(frustum_);
+    EXPECT_EQ(tracer_.Samples(), 2u);
+    frustum_.clip[3].w = 1.0f;
+    tracer_.SetCamera(frustum_);
+    EXPECT_EQ(tracer_.Samples(), 0u);
+}
+
+TEST_F(PathTracerTest, Resize) {
+    EXPECT_EQ(tracer_.TileCount(), 4u * 3u);
+    tracer_.Trace();
+    tracer_.Resize(48, 48);
+    EXPECT_EQ(tracer_.Samples(), 0u);
+    EXPECT_EQ(tracer_.TileCount(), 9u);
+    tracer_.Trace();
+    EXPECT_EQ(tracer_.Samples(), 1u);
+}
+
+}
@@ -0,0 +1,83 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file perf_counters_test.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Hardware counters unit testing
+ *
+ * Virtual machines and containers often have no PMU, counting tests skip there.
+ */
+
+#include <gtest/gtest.h>
+#include "common/perf_counters.hpp"
+
+#include <cstring>
+
+namespace reveal3d {
+
+class PerfCountersTest : public testing::Test {
+protected:
+    void SetUp() override { perf::Reset(); }
+    void TearDown() override { perf::SetEnabled(false); }
+
+    static u64 Work(u32 iterations) {
+        volatile u64 sum = 0;
+        for (u32 i = 0; i < iterations; ++i) {
+            sum = sum + i;
+        }
+        return sum;
+    }
+};
+
+#ifndef SHIPPING
+
+TEST_F(PerfCountersTest, DisabledRecordsNothing) {
+    perf::Init();
+    perf::SetEnabled(false);
+    {
+        PERF_SCOPE("Disabled");
+        Work(1000);
+    }
+    EXPECT_TRUE(perf::Report().empty());
+}
+
+TEST_F(PerfCountersTest, SystemsAccumulate) {
+    if (!perf::Init()) GTEST_SKIP() << "No hardware counters";
+    for (u32 i = 0; i < 3; ++i) {
+        PERF_SCOPE("Small");
+        Work(10000);
+    }
+    {
+        PERF_SCOPE("Large");
+        Work(1000000);
+    }
+
+    const std::vector<perf::System> systems = perf::Report();
+    ASSERT_EQ(systems.size(), 2u);
+    EXPECT_STREQ(systems[0].name, "Small");
+    EXPECT_EQ(systems[0].calls, 3u);
+    EXPECT_GT(systems[0].counters.value[perf::Counters::cycles], 0u);
+    if (perf::Supported() & (1u << perf::Counters::instructions)) {
+        EXPECT_GT(systems[0].counters.value[perf::Counters::instructions], 30000u);
+        EXPECT_GT(systems[1].counters.value[perf::Counters::instructions],
+                  systems[0].counters.value[perf::Counters::instructions]);
+    }
+}
+
+// Names are compared by content, the same system from two translation units is one entry
+TEST_F(PerfCountersTest, SameNameSameSystem) {
+    if (!perf::Init()) GTEST_SKIP() << "No hardware counters";
+    char name[] = "Shared";
+    { PERF_SCOPE("Shared"); }
+    { PERF_SCOPE(name); }
+    const std::vector<perf::System> systems = perf::Report();
+    ASSERT_EQ(systems.size(), 1u);
+    EXPECT_EQ(systems[0].calls, 2u);
+}
+
+#endif
+
+}
@@ -0,0 +1,130 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file profiler_test.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Profiler unit testing
+ *
+ */
+
+#include <gtest/gtest.h>
+#include "common/profiler.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+namespace reveal3d {
+
+class ProfilerTest : public testing::Test {
+protected:
+    void SetUp() override {
+        profiler::Clear();
+        profiler::SetEnabled(true);
+    }
+    void TearDown() override { profiler::SetEnabled(false); }
+
+    static std::vector<profiler::Zone> Named(const std::string &name) {
+        std::vector<profiler::Zone> zones = profiler::Collect();
+        std::erase_if(zones, [&](const profiler::Zone &zone) { return name != zone.name; });
+        return zones;
+    }
+};
+
+#ifndef SHIPPING
+
+TEST_F(ProfilerTest, Disabled) {
+    profiler::SetEnabled(false);
+    {
+        PROFILE_SCOPE("Disabled");
+    }
+    EXPECT_TRUE(Named("Disabled").empty());
+}
+
+TEST_F(ProfilerTest, Nested) {
+    {
+        PROFILE_SCOPE("Outer");
+        for (u32 i = 0; i < 3; ++i) {
+            PROFILE_SCOPE("Inner");
+        }
+    }
+    const std::vector<profiler::Zone> zones = profiler::Collect();
+    ASSERT_EQ(zones.size(), 4u);
+    EXPECT_STREQ(zones[0].name, "Outer");
+    for (u32 i = 1; i < 4; ++i) {
+        EXPECT_STREQ(zones[i].name, "Inner");
+        EXPECT_GE(zones[i].begin, zones[0].begin);
+        EXPECT_LE(zones[i].end, zones[0].end);
+        EXPECT_GE(zones[i].begin, zones[i - 1].begin);
+    }
+}
+
+TEST_F(ProfilerTest, Threads) {
+    { PROFILE_SCOPE("Main"); }
+    std::thread thread([] {
+        PROFILE_THREAD("Loader");
+        PROFILE_SCOPE("Load");
+    });
+    thread.join();
+
+    const std::vector<profiler::Zone> main = Named("Main");
+    const std::vector<profiler::Zone> load = Named("Load");
+    ASSERT_EQ(main.size(), 1u);
+    ASSERT_EQ(load.size(), 1u);
+    EXPECT_NE(main[0].thread, load[0].thread);
+}
+
+TEST_F(ProfilerTest, RingKeepsLatest) {
+    for (u32 i = 0; i < profiler::zoneCapacity + 10; ++i) {
+        profiler::Record(i < 10 ? "Old" : "New", profiler::Now(), profiler::Now());
+    }
+    EXPECT_TRUE(Named("Old").empty());
+    EXPECT_EQ(Named("New").size(), profiler::zoneCapacity);
+}
+
+// Zones collected while a thread keeps writing are whole, never a mix of two of them
+TEST_F(ProfilerTest, CollectWhileRecording) {
+    std::atomic<bool> stop { false };
+    std::thread writer([&] {
+        while (!stop) {
+            PROFILE_SCOPE("Busy");
+        }
+    });
+    for (u32 i = 0; i < 5; ++i) {
+        for (const profiler::Zone &zone : profiler::Collect()) {
+            ASSERT_NE(zone.name, nullptr);
+            EXPECT_LE(zone.begin, zone.end);
+        }
+    }
+    stop = true;
+    writer.join();
+}
+
+TEST_F(ProfilerTest, ChromeTrace) {
+    {
+        PROFILE_SCOPE("Traced \"zone\"");
+    }
+    const std::string path = testing::TempDir() + "profiler_trace.json";
+    ASSERT_TRUE(profiler::ExportChromeTrace(path));
+
+    std::ifstream file(path);
+    std::stringstream json;
+    json << file.rdbuf();
+    const std::string text = json.str();
+    EXPECT_EQ(text.find("{\"displayTimeUnit\":\"ns\",\"traceEvents\":["), 0u);
+    EXPECT_NE(text.find("\"name\":\"Traced \\\"zone\\\"\",\"ph\":\"X\""), std::string::npos);
+    EXPECT_NE(text.find("\"ph\":\"M\""), std::string::npos);
+    EXPECT_EQ(std::count(text.begin(), text.end(), '{'), std::count(text.begin(), text.end(), '}'));
+    EXPECT_EQ(text.find(",\n]"), std::string::npos);
+    std::remove(path.c_str());
+}
+
+#endif
+
+}
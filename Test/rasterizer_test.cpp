@@ -0,0 +1,173 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file rasterizer_test.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Software rasterizer unit testing
+ *
+ * Camera sits at the origin looking down +z with a 90 degree field of view,
+ * clip space x and y are world x and y and w is the distance along z.
+ */
+
+#include <gtest/gtest.h>
+#include "graphics/software/sw_rasterizer.hpp"
+
+#include <cstdio>
+#include <fstream>
+
+namespace reveal3d {
+
+using namespace graphics::software;
+
+class RasterizerTest : public testing::Test {
+protected:
+    RasterizerTest() {
+        frustum_.clip[0] = { 1.0f, 0.0f, 0.0f, 0.0f };
+        frustum_.clip[1] = { 0.0f, 1.0f, 0.0f, 0.0f };
+        frustum_.clip[2] = { 0.0f, 0.0f, 1.0f, -0.2f };
+        frustum_.clip[3] = { 0.0f, 0.0f, 1.0f, 0.0f };
+        rasterizer_.Resize(160, 90);
+        quad_.resize(4);
+        for (u32 i = 0; i < 4; ++i) {
+            quad_[i].pos = { i & 1 ? 1.0f : -1.0f, i & 2 ? 1.0f : -1.0f, 0.0f };
+            quad_[i].color = { 1.0f, 1.0f, 1.0f, 1.0f };
+            quad_[i].normal = { 0.0f, 0.0f, -1.0f };
+        }
+    }
+
+    // Instance of the quad scaled by size, centered at z facing the camera
+    render::Instance& AddInstance(f32 size, f32 z, math::vec4 color) {
+        render::Instance &instance = instances_.emplace_back();
+        f32 *world = (f32 *) &instance.world;
+        std::fill(world, world + 16, 0.0f);
+        world[0] = world[5] = size;
+        world[10] = world[15] = 1.0f;
+        world[11] = z;
+        instance.color = color;
+        return instance;
+    }
+
+    void Submit(const render::Instance &instance, render::Shader shader) {
+        rasterizer_.Submit({ quad_.data(), indices_, &instance, (u32)quad_.size(), 6, shader });
+    }
+
+    static u32 Channel(u32 color, u32 channel) { return (color >> (channel * 8)) & 0xFF; }
+
+    render::Frustum frustum_;
+    Rasterizer rasterizer_;
+    std::vector<render::Vertex> quad_;
+    const u32 indices_[6] = { 0, 1, 3, 0, 3, 2 };
+    std::vector<render::Instance> instances_;
+};
+
+TEST_F(RasterizerTest, Clear) {
+    rasterizer_.Render(frustum_);
+    const Framebuffer &target = rasterizer_.Target();
+    EXPECT_EQ(target.Width(), 160u);
+    EXPECT_EQ(target.Stride() % Rasterizer::tileWidth, 0u);
+    EXPECT_EQ(rasterizer_.Triangles(), 0u);
+    EXPECT_EQ(target.Depth(80, 45), 0.0f);
+    EXPECT_EQ(Channel(target.Color(80, 45), 0), 51u);
+    EXPECT_EQ(Channel(target.Color(80, 45), 3), 255u);
+}
+
+TEST_F(RasterizerTest, FlatColor) {
+    instances_.reserve(4);
+    Submit(AddInstance(1.0f, 5.0f, { 1.0f, 0.0f, 0.0f, 1.0f }), render::flat);
+    rasterizer_.Render(frustum_);
+    const Framebuffer &target = rasterizer_.Target();
+    EXPECT_EQ(rasterizer_.Triangles(), 2u);
+    EXPECT_EQ(target.Color(80, 45), Framebuffer::Pack(255, 0, 0));
+    EXPECT_NEAR(target.Depth(80, 45), 1.0f / 5.0f, 1e-5f);
+    // Quad covers 16 of the 80 pixels from the center to the edge
+    EXPECT_EQ(target.Color(90, 45), Framebuffer::Pack(255, 0, 0));
+    EXPECT_EQ(Channel(target.Color(100, 45), 0), 51u);
+}
+
+TEST_F(RasterizerTest, Lighting) {
+    instances_.reserve(4);
+    Submit(AddInstance(1.0f, 5.0f, { 1.0f, 1.0f, 1.0f, 1.0f }), render::opaque);
+    rasterizer_.Render(frustum_);
+    // Ambient 0.7 plus 0.9 times the cosine with the sun, clamped to one
+    EXPECT_EQ(rasterizer_.Target().Color(80, 45), Framebuffer::Pack(255, 255, 255));
+
+    quad_[0].color = quad_[1].color = quad_[2].color = quad_[3].color = { 0.5f, 0.5f, 0.5f, 1.0f };
+    for (auto &vertex : quad_) {
+        vertex.normal = { 1.0f, 0.0f, 0.0f };
+    }
+    rasterizer_.Render(frustum_);
+    EXPECT_EQ(rasterizer_.Target().Color(80, 45), Framebuffer::Pack(89, 89, 89));
+}
+
+TEST_F(RasterizerTest, DepthOrder) {
+    instances_.reserve(4);
+    const render::Instance &near = AddInstance(1.0f, 4.0f, { 0.0f, 1.0f, 0.0f, 1.0f });
+    const render::Instance &far = AddInstance(4.0f, 8.0f, { 0.0f, 0.0f, 1.0f, 1.0f });
+    Submit(near, render::flat);
+    Submit(far, render::flat);
+    rasterizer_.Render(frustum_);
+    EXPECT_EQ(rasterizer_.Target().Color(80, 45), Framebuffer::Pack(0, 255, 0));
+
+    rasterizer_.Clear();
+    Submit(far, render::flat);
+    Submit(near, render::flat);
+    rasterizer_.Render(frustum_);
+    EXPECT_EQ(rasterizer_.Target().Color(80, 45), Framebuffer::Pack(0, 255, 0));
+    // Far quad is visible around the near one
+    EXPECT_EQ(rasterizer_.Target().Color(110, 45), Framebuffer::Pack(0, 0, 255));
+}
+
+// Wall going from behind the camera to z = 4 is cut at the near plane, not dropped
+TEST_F(RasterizerTest, NearPlaneClipping) {
+    for (u32 i = 0; i < 4; ++i) {
+        quad_[i].pos = { i & 1 ? 1.0f : -1.0f, -1.0f, i & 2 ? 4.0f : -4.0f };
+    }
+    instances_.reserve(4);
+    Submit(AddInstance(1.0f, 0.0f, { 1.0f, 1.0f, 0.0f, 1.0f }), render::flat);
+    rasterizer_.Render(frustum_);
+    EXPECT_GE(rasterizer_.Triangles(), 2u);
+    EXPECT_EQ(rasterizer_.Target().Color(80, 80), Framebuffer::Pack(255, 255, 0));
+    EXPECT_EQ(rasterizer_.Target().Depth(80, 50), 0.0f); // Beyond the end of the wall
+}
+
+TEST_F(RasterizerTest, ManyChunks) {
+    instances_.reserve(Rasterizer::chunkTriangles);
+    for (u32 i = 0; i < Rasterizer::chunkTriangles; ++i) {
+        Submit(AddInstance(20.0f, 100.0f - (f32)i * 0.001f, { 0.0f, 0.0f, (f32)(i & 1), 1.0f }), render::flat);
+    }
+    rasterizer_.Render(frustum_);
+    EXPECT_EQ(rasterizer_.Triangles(), Rasterizer::chunkTriangles * 2);
+    // Last instance is the nearest
+    EXPECT_EQ(rasterizer_.Target().Color(80, 45), Framebuffer::Pack(0, 0, 255));
+}
+
+TEST_F(RasterizerTest, Grid) {
+    // Camera above the z = 0 plane looking down
+    frustum_.clip[2] = { 0.0f, 0.0f, -1.0f, 1.8f };
+    frustum_.clip[3] = { 0.0f, 0.0f, -1.0f, 2.0f };
+    rasterizer_.SetGrid(true);
+    rasterizer_.Render(frustum_);
+    u32 changed = 0;
+    for (u32 y = 0; y < 90; ++y) {
+        for (u32 x = 0; x < 160; ++x) {
+            changed += Channel(rasterizer_.Target().Color(x, y), 0) != 51u;
+        }
+    }
+    EXPECT_GT(changed, 0u);
+    EXPECT_LT(changed, 160u * 90u);
+}
+
+TEST_F(RasterizerTest, Save) {
+    rasterizer_.Render(frustum_);
+    const char *path = "rasterizer_test.ppm";
+    ASSERT_TRUE(rasterizer_.Target().Save(path));
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    EXPECT_EQ((u32)file.tellg(), 14u + 160u * 90u * 3u);
+    file.close();
+    std::remove(path);
+}
+
+}
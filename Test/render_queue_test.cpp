@@ -0,0 +1,98 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file render_queue_test.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Render queue unit testing
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+
+#include "render/render_queue.hpp"
+
+namespace reveal3d {
+
+using render::RenderQueue;
+
+TEST(RenderQueueTest, KeyOrder) {
+    // Layer wins over everything else
+    EXPECT_LT(RenderQueue::MakeKey(0, 9, 9, 9, 90.0f), RenderQueue::MakeKey(1, 0, 0, 0, 1.0f));
+    // Pipeline and material win over mesh and depth
+    EXPECT_LT(RenderQueue::MakeKey(0, 1, 9, 9, 90.0f), RenderQueue::MakeKey(0, 2, 0, 0, 1.0f));
+    EXPECT_LT(RenderQueue::MakeKey(0, 1, 1, 9, 90.0f), RenderQueue::MakeKey(0, 1, 2, 0, 1.0f));
+    // Depth buckets go before mesh, close items first
+    EXPECT_LT(RenderQueue::MakeKey(0, 1, 1, 9, 1.0f), RenderQueue::MakeKey(0, 1, 1, 0, 10.0f));
+    // Inside a bucket items of a mesh stay together
+    EXPECT_LT(RenderQueue::MakeKey(0, 1, 1, 0, 7.5f), RenderQueue::MakeKey(0, 1, 1, 1, 4.5f));
+    EXPECT_LT(RenderQueue::MakeKey(0, 1, 1, 0, 4.5f), RenderQueue::MakeKey(0, 1, 1, 0, 7.5f));
+    // Back to front
+    EXPECT_GT(RenderQueue::MakeKey(0, 1, 1, 0, 1.0f, true), RenderQueue::MakeKey(0, 1, 1, 0, 10.0f, true));
+    EXPECT_GT(RenderQueue::MakeKey(0, 1, 1, 0, 4.5f, true), RenderQueue::MakeKey(0, 1, 1, 0, 7.5f, true));
+}
+
+TEST(RenderQueueTest, SortMatchesStdSort) {
+    std::mt19937 generator(3);
+    std::uniform_int_distribution<u32> layer(0, 2);
+    std::uniform_int_distribution<u32> mesh(0, 500);
+    std::uniform_real_distribution<f32> depth(0.1f, 200.0f);
+
+    RenderQueue queue;
+    std::vector<u64> keys;
+    for (u32 i = 0; i < 50000; ++i) {
+        const u32 l = layer(generator);
+        keys.push_back(RenderQueue::MakeKey(l, l, 0, mesh(generator), depth(generator)));
+        queue.Push(keys.back(), i);
+    }
+    queue.Sort();
+
+    std::vector<u64> expected = keys;
+    std::sort(expected.begin(), expected.end());
+    ASSERT_EQ(queue.Count(), expected.size());
+    for (u32 i = 0; i < queue.Count(); ++i) {
+        EXPECT_EQ(queue.Key(i), expected[i]);
+        EXPECT_EQ(keys[queue.Item(i)], queue.Key(i));
+    }
+}
+
+TEST(RenderQueueTest, Layers) {
+    RenderQueue queue;
+    queue.Push(RenderQueue::MakeKey(2, 0, 0, 0, 1.0f), 10);
+    queue.Push(RenderQueue::MakeKey(0, 0, 0, 0, 1.0f), 11);
+    queue.Push(RenderQueue::MakeKey(2, 0, 0, 0, 0.5f), 12);
+    queue.Sort();
+
+    ASSERT_EQ(queue.Layer(0).size(), 1);
+    EXPECT_EQ(queue.Layer(0)[0], 11);
+    EXPECT_TRUE(queue.Layer(1).empty());
+    ASSERT_EQ(queue.Layer(2).size(), 2);
+    EXPECT_EQ(queue.Layer(2)[0], 12);
+    EXPECT_EQ(queue.Layer(2)[1], 10);
+}
+
+TEST(RenderQueueTest, StateChanges) {
+    RenderQueue queue;
+    for (u32 i = 0; i < 100; ++i) {
+        queue.Push(RenderQueue::MakeKey(0, 0, 0, i % 4, (f32)i), i);
+    }
+    EXPECT_EQ(queue.StateChanges(RenderQueue::meshMask), 100);
+    queue.Sort();
+    // Every depth bucket holds the four meshes
+    EXPECT_LE(queue.StateChanges(RenderQueue::meshMask), 4 * 8);
+    EXPECT_EQ(queue.StateChanges(RenderQueue::layerMask), 1);
+}
+
+TEST(RenderQueueTest, Empty) {
+    RenderQueue queue;
+    queue.Sort();
+    EXPECT_EQ(queue.StateChanges(), 0);
+    EXPECT_TRUE(queue.Layer(0).empty());
+}
+
+}
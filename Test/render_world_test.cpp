@@ -0,0 +1,184 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file render_world_test.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Render world unit testing
+ *
+ * Frames run through the headless viewport, so extraction sees the scene in the same
+ * order as the engine main loop. A moved entity is extracted in the frame it moves, once.
+ */
+
+#include <gtest/gtest.h>
+#include "render/viewport.hpp"
+#include "window/headless/headless.hpp"
+
+#include <algorithm>
+
+namespace reveal3d {
+
+namespace {
+
+u32 ProxyIndex(const render::RenderWorld &world, core::Entity entity) {
+    for (u32 i = 0; i < world.Count(); ++i) {
+        if (world[i].entity == id::index(entity.Id())) return i;
+    }
+    return UINT_MAX;
+}
+
+const render::Proxy& EntityProxy(const render::RenderWorld &world, core::Entity entity) {
+    const u32 index = ProxyIndex(world, entity);
+    if (index != UINT_MAX) return world[index];
+    static const render::Proxy missing;
+    ADD_FAILURE() << "Entity has no proxy";
+    return missing;
+}
+
+}
+
+TEST(RenderWorldTest, MovedEveryFrame) {
+    core::scene.Clear();
+    core::Entity moving = core::scene.AddPrimitive(core::Geometry::cube);
+    core::Entity still = core::scene.AddPrimitive(core::Geometry::cube);
+    still.Transform().SetPosition({ 0.0f, 5.0f, -10.0f });
+
+    window::InitInfo info(L"RenderWorldTest", 640, 480);
+    render::Viewport<graphics::Null, window::Headless> viewport(info);
+    viewport.renderer.Graphics().SetRecording(false);
+    viewport.Init();
+
+    // Every frame the proxy has to be where the entity was put in the previous one
+    constexpr u32 frames = 10;
+    u32 checked = 0;
+    FrameStats stats;
+    viewport.BenchMark(0, frames, stats, [&](u32 frame) {
+        if (frame > 0) {
+            const render::Proxy &proxy = EntityProxy(viewport.renderer.World(), moving);
+            EXPECT_NEAR(proxy.world.GetTranslation().GetX(), (f32)(frame - 1), 1e-4f) << "Frame " << frame;
+            EXPECT_NEAR(proxy.bounds.center.x, (f32)(frame - 1), 1e-4f) << "Frame " << frame;
+            ++checked;
+        }
+        moving.Transform().SetPosition({ (f32)frame, 0.0f, -10.0f });
+    });
+    EXPECT_EQ(checked, frames - 1);
+
+    const render::RenderWorld &world = viewport.renderer.World();
+    const render::Proxy &proxy = EntityProxy(world, moving);
+    EXPECT_NEAR(proxy.world.GetTranslation().GetX(), (f32)(frames - 1), 1e-4f);
+    EXPECT_NEAR(proxy.bounds.center.x, (f32)(frames - 1), 1e-4f);
+    EXPECT_NEAR(proxy.bounds.center.z, -10.0f, 1e-4f);
+
+    const render::Proxy &stillProxy = EntityProxy(world, still);
+    EXPECT_NEAR(stillProxy.world.GetTranslation().GetY(), 5.0f, 1e-4f);
+    EXPECT_NEAR(stillProxy.bounds.center.y, 5.0f, 1e-4f);
+
+    core::scene.Clear();
+}
+
+TEST(RenderWorldTest, MovedOnce) {
+    core::scene.Clear();
+    core::Entity moving = core::scene.AddPrimitive(core::Geometry::cube);
+    core::scene.AddPrimitive(core::Geometry::cube);
+
+    window::InitInfo info(L"RenderWorldTest", 640, 480);
+    render::Viewport<graphics::Null, window::Headless> viewport(info);
+    viewport.renderer.Graphics().SetRecording(false);
+    viewport.Init();
+
+    // Updated() still holds what the previous frame extracted
+    constexpr u32 moveFrame = 3;
+    u32 extracted = 0;
+    FrameStats stats;
+    viewport.BenchMark(0, 10, stats, [&](u32 frame) {
+        const render::RenderWorld &world = viewport.renderer.World();
+        const u32 index = ProxyIndex(world, moving);
+        const std::vector<u32> &updated = world.Updated();
+        if (frame > moveFrame and std::find(updated.begin(), updated.end(), index) != updated.end()) {
+            EXPECT_EQ(frame, moveFrame + 1);
+            ++extracted;
+        }
+        if (frame == moveFrame) {
+            moving.Transform().SetPosition({ 4.0f, 0.0f, -10.0f });
+        }
+    });
+    EXPECT_EQ(extracted, 1u);
+    EXPECT_NEAR(EntityProxy(viewport.renderer.World(), moving).bounds.center.x, 4.0f, 1e-4f);
+
+    core::scene.Clear();
+}
+
+// Element indices count meshes, not entities, a mesh after a shared one gets the next one
+TEST(RenderWorldTest, SharedMeshElements) {
+    core::scene.Clear();
+    core::Entity first = core::scene.AddPrimitive(core::Geometry::cube);
+    core::Entity shared = core::scene.AddPrimitive(core::Geometry::cube);
+    shared.Geometry() = first.Geometry();
+    core::Entity distinct = core::scene.AddPrimitive(core::Geometry::sphere);
+    shared.Transform().SetPosition({ 3.0f, 0.0f, -10.0f });
+    distinct.Transform().SetPosition({ -3.0f, 0.0f, -10.0f });
+    first.Transform().SetPosition({ 0.0f, 0.0f, -10.0f });
+
+    window::InitInfo info(L"RenderWorldTest", 640, 480);
+    render::Viewport<graphics::Null, window::Headless> viewport(info);
+    viewport.Init();
+    FrameStats stats;
+    viewport.BenchMark(0, 1, stats, {});
+
+    EXPECT_EQ(first.Geometry().RenderInfo(), 0u);
+    EXPECT_EQ(shared.Geometry().RenderInfo(), 0u);
+    EXPECT_EQ(distinct.Geometry().RenderInfo(), 1u);
+
+    u32 uploads = 0;
+    viewport.renderer.Graphics().Log().Replay([&](const graphics::null::Command &command) {
+        if (command.op == graphics::null::Command::uploadGeometry) ++uploads;
+    });
+    EXPECT_EQ(uploads, 4u); // Vertices and indices of two meshes
+
+    const render::RenderWorld &world = viewport.renderer.World();
+    for (u32 layer = 0; layer < render::Shader::count; ++layer) {
+        for (const render::InstanceBatch &batch : world.Batches(layer)) {
+            EXPECT_LT(batch.mesh, 2u);
+        }
+    }
+
+    core::scene.Clear();
+}
+
+// Proxies and batches of entities gone from the scene are dropped in the next extraction
+TEST(RenderWorldTest, ClearedScene) {
+    core::scene.Clear();
+    // In front of the default camera
+    for (u32 i = 0; i < 3; ++i) {
+        core::scene.AddPrimitive(core::Geometry::cube).Transform().SetPosition({ 10.0f, (f32)i * 3.0f - 3.0f, 2.0f });
+    }
+
+    window::InitInfo info(L"RenderWorldTest", 640, 480);
+    render::Viewport<graphics::Null, window::Headless> viewport(info);
+    viewport.renderer.Graphics().SetRecording(false);
+    viewport.Init();
+
+    constexpr u32 clearFrame = 3;
+    FrameStats stats;
+    viewport.BenchMark(0, 6, stats, [&](u32 frame) {
+        const render::RenderWorld &world = viewport.renderer.World();
+        if (frame == clearFrame) {
+            EXPECT_EQ(world.Count(), 3u);
+            EXPECT_FALSE(world.Batches(render::Shader::opaque).empty());
+            core::scene.Clear();
+        }
+    });
+
+    const render::RenderWorld &world = viewport.renderer.World();
+    EXPECT_EQ(world.Count(), 0u);
+    EXPECT_EQ(world.Instances().size(), 0u);
+    for (u32 layer = 0; layer < render::Shader::count; ++layer) {
+        EXPECT_TRUE(world.Layer(layer).empty());
+        EXPECT_TRUE(world.Visible(layer).empty());
+        EXPECT_TRUE(world.Batches(layer).empty());
+    }
+}
+
+}
@@ -0,0 +1,48 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file scene_test.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Scene graph unit testing
+ *
+ */
+
+#include <gtest/gtest.h>
+#include "core/scene.hpp"
+
+#include <vector>
+
+namespace reveal3d {
+
+// Children grow the graph between roots, the root list must survive the reallocations
+TEST(SceneTest, RootsBetweenChildren) {
+    core::scene.Clear();
+    std::vector<core::Entity> roots;
+    for (u32 i = 0; i < 100; ++i) {
+        core::Entity root = core::scene.AddPrimitive(core::Geometry::cube);
+        core::Entity child = core::scene.AddPrimitive(core::Geometry::cube, root);
+        core::scene.AddPrimitive(core::Geometry::cube, child);
+        roots.push_back(root);
+    }
+
+    core::Entity previous;
+    for (const core::Entity &root : roots) {
+        core::Scene::Node &node = core::scene.GetNode(root.Id());
+        EXPECT_FALSE(node.parent.IsAlive());
+        EXPECT_EQ(node.prev.Id(), previous.Id());
+        if (previous.IsAlive()) {
+            EXPECT_EQ(core::scene.GetNode(previous.Id()).next.Id(), root.Id());
+        }
+        ASSERT_TRUE(node.firstChild.IsAlive());
+        EXPECT_EQ(core::scene.GetNode(node.firstChild.Id()).parent.Id(), root.Id());
+        previous = root;
+    }
+    EXPECT_FALSE(core::scene.GetNode(roots.back().Id()).next.IsAlive());
+
+    core::scene.Clear();
+}
+
+}
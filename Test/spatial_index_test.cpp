@@ -0,0 +1,146 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file spatial_index_test.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Loose octree and uniform grid unit testing
+ *
+ * Both store exact boxes, so queries are checked against brute force
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+
+#include "spatial/loose_octree.hpp"
+#include "spatial/uniform_grid.hpp"
+
+namespace reveal3d {
+
+template<spatial::Index T>
+class SpatialIndexTest : public testing::Test {
+protected:
+    static constexpr u32 count = 3000;
+
+    SpatialIndexTest() : generator_(11), position_(-60.0f, 60.0f), size_(0.2f, 3.0f) {
+        boxes_.resize(count);
+        for (u32 i = 0; i < count; ++i) {
+            boxes_[i] = RandomBox();
+            index_.Insert(i, boxes_[i]);
+        }
+    }
+
+    spatial::Aabb RandomBox() {
+        const math::vec3 min { position_(generator_), position_(generator_), position_(generator_) };
+        return { min, { min.x + size_(generator_), min.y + size_(generator_), min.z + size_(generator_) } };
+    }
+
+    void Move() {
+        for (u32 i = 0; i < count; i += 3) {
+            const f32 x = position_(generator_) * 0.05f;
+            boxes_[i].min = { boxes_[i].min.x + x, boxes_[i].min.y, boxes_[i].min.z - x };
+            boxes_[i].max = { boxes_[i].max.x + x, boxes_[i].max.y, boxes_[i].max.z - x };
+            if (index_.Contains(i)) index_.Update(i, boxes_[i]);
+        }
+        if (!removed_.empty()) return;
+        for (u32 i = 1; i < count; i += 50) {
+            index_.Remove(i);
+            removed_.push_back(i);
+        }
+    }
+
+    template<typename Test>
+    void ExpectMatches(const std::vector<u32> &result, Test &&test) {
+        std::vector<u32> expected;
+        for (u32 i = 0; i < count; ++i) {
+            if (index_.Contains(i) and test(boxes_[i])) {
+                expected.push_back(i);
+            }
+        }
+        std::vector<u32> sorted = result;
+        std::sort(sorted.begin(), sorted.end());
+        EXPECT_EQ(sorted, expected);
+    }
+
+    T index_;
+    std::vector<spatial::Aabb> boxes_;
+    std::vector<u32> removed_;
+    std::mt19937 generator_;
+    std::uniform_real_distribution<f32> position_;
+    std::uniform_real_distribution<f32> size_;
+};
+
+using Indices = testing::Types<spatial::LooseOctree, spatial::UniformGrid>;
+TYPED_TEST_SUITE(SpatialIndexTest, Indices);
+
+TYPED_TEST(SpatialIndexTest, Query) {
+    for (u32 pass = 0; pass < 2; ++pass) {
+        const spatial::Aabb box { { -15.0f, -30.0f, 0.0f }, { 20.0f, 5.0f, 12.0f } };
+        std::vector<u32> result;
+        this->index_.Query(box, [&](u32 id) { result.push_back(id); });
+        this->ExpectMatches(result, [&](const spatial::Aabb &other) { return spatial::Overlaps(other, box); });
+        this->Move();
+    }
+    EXPECT_EQ(this->index_.Count(), this->count - this->removed_.size());
+}
+
+TYPED_TEST(SpatialIndexTest, Frustum) {
+    const math::vec4 planes[] = { { 1.0f, 0.0f, 0.0f, 10.0f }, { 0.0f, -1.0f, 0.0f, 0.0f }, { 0.0f, 0.6f, 0.8f, 4.0f } };
+    this->Move();
+
+    std::vector<u32> result;
+    this->index_.Query(spatial::Planes(planes), [&](u32 id) { result.push_back(id); });
+    this->ExpectMatches(result, [&](const spatial::Aabb &box) {
+        return spatial::Classify(box, spatial::Planes(planes)) != spatial::Containment::outside;
+    });
+}
+
+TYPED_TEST(SpatialIndexTest, Raycast) {
+    this->Move();
+    const spatial::Ray ray { { -70.0f, 1.0f, -2.0f }, { 0.96f, 0.0f, 0.28f }, 200.0f };
+    const math::vec3 invDirection = spatial::InvDirection(ray.direction);
+
+    u32 expected = UINT_MAX;
+    f32 closest = FLT_MAX;
+    for (u32 i = 0; i < this->count; ++i) {
+        if (!this->index_.Contains(i)) continue;
+        const f32 distance = spatial::Intersect(this->boxes_[i], ray.origin, invDirection, ray.maxDistance);
+        if (distance < closest) {
+            closest = distance;
+            expected = i;
+        }
+    }
+
+    u32 hit = UINT_MAX;
+    f32 hitDistance = FLT_MAX;
+    this->index_.Raycast(ray, [&](u32 id, f32 distance) {
+        if (distance < hitDistance) {
+            hit = id;
+            hitDistance = distance;
+        }
+        return hitDistance;
+    });
+    EXPECT_EQ(hit, expected);
+}
+
+TYPED_TEST(SpatialIndexTest, Nearest) {
+    this->Move();
+    const math::vec3 point { 12.0f, -3.0f, 40.0f };
+
+    f32 bestSq = FLT_MAX;
+    for (u32 i = 0; i < this->count; ++i) {
+        if (this->index_.Contains(i)) {
+            bestSq = std::min(bestSq, spatial::DistanceSq(this->boxes_[i], point));
+        }
+    }
+
+    const u32 nearest = this->index_.Nearest(point, FLT_MAX);
+    ASSERT_NE(nearest, UINT_MAX);
+    EXPECT_FLOAT_EQ(spatial::DistanceSq(this->boxes_[nearest], point), bestSq);
+}
+
+}
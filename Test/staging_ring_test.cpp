@@ -0,0 +1,221 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file staging_ring_test.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Staging ring and upload queue unit testing
+ *
+ */
+
+#include <gtest/gtest.h>
+#include "render/staging_ring.hpp"
+
+#include <numeric>
+
+namespace reveal3d {
+
+using render::StagingCopy;
+using render::StagingRing;
+using render::UploadQueue;
+
+namespace {
+
+// Copies run when the test completes their fence, reading staging memory at that moment
+struct MockBackend {
+    u8* MapStaging(u32 size) {
+        EXPECT_TRUE(inFlight.empty()) << "Staging memory replaced while copies read it";
+        staging.assign(size, 0);
+        ++maps;
+        return staging.data();
+    }
+
+    u64 CompletedFence() { return completed; }
+
+    u64 Submit(std::span<const StagingCopy> copies) {
+        inFlight.push_back({ ++fence, { copies.begin(), copies.end() } });
+        return fence;
+    }
+
+    void Complete(u64 value) {
+        while (!inFlight.empty() and inFlight.front().first <= value) {
+            for (const StagingCopy &copy : inFlight.front().second) {
+                std::memcpy(targets[copy.target].data() + copy.targetOffset, staging.data() + copy.stagingOffset, copy.size);
+            }
+            inFlight.erase(inFlight.begin());
+        }
+        completed = value;
+    }
+
+    std::vector<u8> staging;
+    std::vector<u8> targets[2] { std::vector<u8>(1 << 16), std::vector<u8>(1 << 16) };
+    std::vector<std::pair<u64, std::vector<StagingCopy>>> inFlight;
+    u64 fence { 0 };
+    u64 completed { 0 };
+    u32 maps { 0 };
+};
+
+static_assert(render::StagingBackend<MockBackend>);
+
+std::vector<u8> Pattern(u32 size, u8 seed) {
+    std::vector<u8> data(size);
+    std::iota(data.begin(), data.end(), seed);
+    return data;
+}
+
+}
+
+TEST(StagingRingTest, AllocateWrapAndRetire) {
+    StagingRing ring;
+    ring.Reset(256);
+    EXPECT_EQ(ring.Allocate(100), 0);
+    EXPECT_EQ(ring.Allocate(100), 100);
+    ring.Close(1);
+    EXPECT_EQ(ring.Used(), 200);
+
+    // End of the ring is too small and its start is still in use
+    EXPECT_EQ(ring.Allocate(100), StagingRing::noSpace);
+    EXPECT_EQ(ring.Allocate(56), 200);
+    ring.Close(2);
+    EXPECT_EQ(ring.Allocate(1), StagingRing::noSpace);
+
+    ring.Retire(1);
+    EXPECT_EQ(ring.Used(), 56);
+    EXPECT_EQ(ring.Allocate(150), 0);
+    EXPECT_EQ(ring.Allocate(60), StagingRing::noSpace);
+    EXPECT_EQ(ring.Allocate(50), 150);
+    ring.Close(3);
+
+    ring.Retire(3);
+    EXPECT_EQ(ring.Used(), 0);
+    EXPECT_EQ(ring.InFlight(), 0);
+    EXPECT_EQ(ring.Allocate(256), 0);
+}
+
+TEST(StagingRingTest, AlignmentAndSkippedEnd) {
+    StagingRing ring;
+    ring.Reset(128);
+    EXPECT_EQ(ring.Allocate(10, 16), 0);
+    EXPECT_EQ(ring.Allocate(10, 16), 16);
+    ring.Close(1);
+    EXPECT_EQ(ring.Used(), 26);
+
+    EXPECT_EQ(ring.Allocate(90, 16), 32);
+    ring.Close(2);
+    ring.Retire(1);
+    // Padding before the second batch and the 6 bytes skipped at the end stay used
+    EXPECT_EQ(ring.Allocate(20, 16), 0);
+    EXPECT_EQ(ring.Used(), 6 + 90 + 6 + 20);
+    ring.Close(3);
+    ring.Retire(3);
+    EXPECT_EQ(ring.Used(), 0);
+}
+
+TEST(UploadQueueTest, OneBatchPerFlush) {
+    MockBackend backend;
+    UploadQueue<MockBackend> queue;
+    queue.Init(&backend, 4096);
+
+    const auto a = Pattern(300, 1);
+    const auto b = Pattern(500, 2);
+    const auto c = Pattern(200, 3);
+    queue.Queue(0, 0, a.data(), a.size());
+    queue.Queue(1, 64, b.data(), b.size());
+    queue.Queue(0, 1000, c.data(), c.size());
+    EXPECT_TRUE(backend.inFlight.empty());
+
+    queue.Flush();
+    ASSERT_EQ(backend.inFlight.size(), 1);
+    EXPECT_EQ(backend.inFlight[0].second.size(), 3);
+    EXPECT_EQ(queue.Batches(), 1);
+
+    // Nothing queued, nothing submitted
+    queue.Flush();
+    EXPECT_EQ(backend.inFlight.size(), 1);
+
+    backend.Complete(1);
+    EXPECT_TRUE(std::equal(a.begin(), a.end(), backend.targets[0].begin()));
+    EXPECT_TRUE(std::equal(b.begin(), b.end(), backend.targets[1].begin() + 64));
+    EXPECT_TRUE(std::equal(c.begin(), c.end(), backend.targets[0].begin() + 1000));
+    queue.Flush();
+    EXPECT_EQ(queue.Ring().Used(), 0);
+}
+
+TEST(UploadQueueTest, FullRingDefersWithoutWaiting) {
+    MockBackend backend;
+    UploadQueue<MockBackend> queue;
+    queue.Init(&backend, 1024);
+
+    // GPU lags three frames behind, staging memory of a batch must survive until then
+    std::vector<std::vector<u8>> uploads;
+    for (u32 frame = 0; frame < 12; ++frame) {
+        for (u32 i = 0; i < 3; ++i) {
+            uploads.push_back(Pattern(200, frame * 3 + i));
+            queue.Queue(0, 256 * (frame * 3 + i), uploads.back().data(), 200);
+        }
+        queue.Flush();
+        EXPECT_LE(queue.Ring().Used(), 1024);
+        if (backend.fence >= 3) backend.Complete(backend.fence - 2);
+    }
+    EXPECT_GT(queue.Deferred(), 0);
+
+    while (queue.Deferred() > 0 or !backend.inFlight.empty()) {
+        queue.Flush();
+        backend.Complete(backend.fence);
+    }
+    for (u32 i = 0; i < uploads.size(); ++i) {
+        EXPECT_TRUE(std::equal(uploads[i].begin(), uploads[i].end(), backend.targets[0].begin() + 256 * i)) << i;
+    }
+}
+
+TEST(UploadQueueTest, OrderIsKept) {
+    MockBackend backend;
+    UploadQueue<MockBackend> queue;
+    queue.Init(&backend, 256);
+
+    // The big upload waits, the small one after it writes the same range and must win
+    const auto big = Pattern(200, 10);
+    const auto small = Pattern(100, 20);
+    const auto first = Pattern(100, 30);
+    queue.Queue(0, 0, first.data(), first.size());
+    queue.Queue(0, 0, big.data(), big.size());
+    queue.Queue(0, 0, small.data(), small.size());
+    queue.Flush();
+    EXPECT_EQ(queue.Deferred(), 300);
+
+    while (queue.Deferred() > 0 or !backend.inFlight.empty()) {
+        queue.Flush();
+        backend.Complete(backend.fence);
+    }
+    EXPECT_TRUE(std::equal(small.begin(), small.end(), backend.targets[0].begin()));
+    EXPECT_TRUE(std::equal(big.begin() + 100, big.end(), backend.targets[0].begin() + 100));
+}
+
+TEST(UploadQueueTest, OversizedUploadGrowsIdleRing) {
+    MockBackend backend;
+    UploadQueue<MockBackend> queue;
+    queue.Init(&backend, 256);
+
+    const auto small = Pattern(100, 1);
+    const auto huge = Pattern(1000, 2);
+    queue.Queue(0, 0, small.data(), small.size());
+    queue.Queue(1, 0, huge.data(), huge.size());
+    queue.Flush();
+    EXPECT_EQ(backend.maps, 1);
+    EXPECT_EQ(queue.Deferred(), 1000);
+
+    // Still in flight, the ring can't be replaced yet
+    queue.Flush();
+    EXPECT_EQ(backend.maps, 1);
+
+    backend.Complete(backend.fence);
+    queue.Flush();
+    EXPECT_EQ(backend.maps, 2);
+    EXPECT_GE(queue.Ring().Size(), 1000);
+    backend.Complete(backend.fence);
+    EXPECT_TRUE(std::equal(huge.begin(), huge.end(), backend.targets[1].begin()));
+}
+
+}
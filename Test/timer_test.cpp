@@ -0,0 +1,142 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file timer_test.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Timer unit testing
+ *
+ * Frames are a few microseconds long except the ones that sleep, so thresholds leave
+ * a wide margin for slow machines.
+ */
+
+#include <gtest/gtest.h>
+#include "common/timer.hpp"
+
+#include <chrono>
+#include <thread>
+
+namespace reveal3d {
+
+namespace {
+
+void Sleep(u32 milliseconds) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
+}
+
+}
+
+TEST(TimerTest, History) {
+    Timer timer;
+    timer.Reset();
+    for (u32 i = 0; i < 10; ++i) {
+        timer.Tick();
+    }
+    std::array<f32, Timer::historySize> times {};
+    EXPECT_EQ(timer.FrameHistory(times), 10u);
+    EXPECT_EQ(timer.FrameHistory(std::span(times).first(4)), 4u);
+
+    for (u32 i = 0; i < Timer::historySize * 2; ++i) {
+        timer.Tick();
+    }
+    EXPECT_EQ(timer.FrameHistory(times), Timer::historySize);
+
+    timer.Reset();
+    EXPECT_EQ(timer.FrameHistory(times), 0u);
+    EXPECT_EQ(timer.FramePercentile(99.0), 0.0f);
+}
+
+// Newest time is the last one, one slow frame out of 20 is above p90 and is p99
+TEST(TimerTest, Percentiles) {
+    Timer timer;
+    timer.Reset();
+    for (u32 i = 0; i < 19; ++i) {
+        timer.Tick();
+    }
+    Sleep(20);
+    timer.Tick();
+
+    std::array<f32, Timer::historySize> times {};
+    const u32 size = timer.FrameHistory(times);
+    EXPECT_GE(times[size - 1], 20.0f);
+    EXPECT_LT(timer.FramePercentile(90.0), 10.0f);
+    EXPECT_GE(timer.FramePercentile(99.0), 20.0f);
+}
+
+TEST(TimerTest, Histogram) {
+    Timer timer;
+    timer.Reset();
+    for (u32 i = 0; i < 8; ++i) {
+        timer.Tick();
+    }
+    Sleep(30);
+    timer.Tick();
+
+    u32 bins[4];
+    timer.FrameHistogram(10.0f, bins);
+    EXPECT_GE(bins[0], 7u);
+    EXPECT_EQ(bins[0] + bins[1] + bins[2] + bins[3], 9u);
+    EXPECT_GE(bins[3], 1u);
+}
+
+TEST(TimerTest, HitchKeepsStages) {
+    Timer timer;
+    timer.SetHitchThreshold(15.0f);
+    timer.Reset();
+    timer.Tick();
+
+    StageTimes stages;
+    stages.time[StageTimes::culling] = 12.0;
+    timer.RecordStages(stages);
+    timer.Tick();
+    EXPECT_EQ(timer.HitchCount(), 0u);
+
+    timer.RecordStages(stages);
+    Sleep(25);
+    timer.Tick();
+    ASSERT_EQ(timer.HitchCount(), 1u);
+    const Hitch hitch = timer.Hitches().back();
+    EXPECT_EQ(hitch.frame, timer.TotalFrames() - 1);
+    EXPECT_GE(hitch.time, 15.0f);
+    EXPECT_EQ(hitch.stages.time[StageTimes::culling], 12.0);
+
+    // Stages are only kept for the frame they were recorded in
+    Sleep(25);
+    timer.Tick();
+    ASSERT_EQ(timer.HitchCount(), 2u);
+    EXPECT_EQ(timer.Hitches().back().stages.time[StageTimes::culling], 0.0);
+}
+
+TEST(TimerTest, HitchOverMean) {
+    Timer timer;
+    timer.SetHitchThreshold(0.0f, 4.0f);
+    timer.Reset();
+    for (u32 i = 0; i < 20; ++i) {
+        Sleep(2);
+        timer.Tick();
+    }
+    const u64 before = timer.HitchCount();
+    Sleep(40);
+    timer.Tick();
+    EXPECT_EQ(timer.HitchCount(), before + 1);
+}
+
+TEST(TimerTest, HitchRingKeepsLatest) {
+    Timer timer;
+    timer.SetHitchThreshold(1.0f);
+    timer.Reset();
+    timer.Tick();
+    for (u32 i = 0; i < Timer::hitchCapacity + 3; ++i) {
+        Sleep(2);
+        timer.Tick();
+    }
+    EXPECT_EQ(timer.HitchCount(), Timer::hitchCapacity + 3);
+    const std::vector<Hitch> hitches = timer.Hitches();
+    ASSERT_EQ(hitches.size(), Timer::hitchCapacity);
+    EXPECT_EQ(hitches.back().frame, timer.TotalFrames() - 1);
+    EXPECT_EQ(hitches.front().frame, timer.TotalFrames() - Timer::hitchCapacity);
+}
+
+}
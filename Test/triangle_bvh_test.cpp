@@ -0,0 +1,150 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file triangle_bvh_test.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Triangle BVH unit testing
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+
+#include "spatial/triangle_bvh.hpp"
+
+namespace reveal3d {
+
+class TriangleBvhTest : public testing::Test {
+protected:
+    static constexpr u32 count = 5000;
+
+    TriangleBvhTest() : generator_(5) {
+        std::uniform_real_distribution<f32> position(-20.0f, 20.0f);
+        std::uniform_real_distribution<f32> offset(-1.0f, 1.0f);
+        for (u32 t = 0; t < count; ++t) {
+            const math::vec3 center { position(generator_), position(generator_), position(generator_) };
+            for (u32 v = 0; v < 3; ++v) {
+                render::Vertex vertex;
+                vertex.pos = { center.x + offset(generator_), center.y + offset(generator_), center.z + offset(generator_) };
+                vertices_.push_back(vertex);
+                indices_.push_back(t * 3 + v);
+            }
+        }
+        bvh_.Build(vertices_.data(), indices_.data(), indices_.size());
+    }
+
+    // Möller-Trumbore against every triangle
+    spatial::TriangleHit BruteForce(const math::vec3 &o, const math::vec3 &d) {
+        spatial::TriangleHit best;
+        for (u32 t = 0; t < count; ++t) {
+            const math::vec3 &a = vertices_[indices_[t * 3]].pos;
+            const math::vec3 &b = vertices_[indices_[t * 3 + 1]].pos;
+            const math::vec3 &c = vertices_[indices_[t * 3 + 2]].pos;
+            const f32 e1[3] = { b.x - a.x, b.y - a.y, b.z - a.z };
+            const f32 e2[3] = { c.x - a.x, c.y - a.y, c.z - a.z };
+            const f32 h[3] = { d.y * e2[2] - d.z * e2[1], d.z * e2[0] - d.x * e2[2], d.x * e2[1] - d.y * e2[0] };
+            const f32 det = e1[0] * h[0] + e1[1] * h[1] + e1[2] * h[2];
+            if (std::abs(det) < 1e-8f) continue;
+            const f32 f = 1.0f / det;
+            const f32 s[3] = { o.x - a.x, o.y - a.y, o.z - a.z };
+            const f32 u = f * (s[0] * h[0] + s[1] * h[1] + s[2] * h[2]);
+            if (u < 0.0f or u > 1.0f) continue;
+            const f32 q[3] = { s[1] * e1[2] - s[2] * e1[1], s[2] * e1[0] - s[0] * e1[2], s[0] * e1[1] - s[1] * e1[0] };
+            const f32 v = f * (d.x * q[0] + d.y * q[1] + d.z * q[2]);
+            if (v < 0.0f or u + v > 1.0f) continue;
+            const f32 t2 = f * (e2[0] * q[0] + e2[1] * q[1] + e2[2] * q[2]);
+            if (t2 > 1e-8f and t2 < best.distance) {
+                best = { t2, t, u, v };
+            }
+        }
+        return best;
+    }
+
+    std::vector<render::Vertex> vertices_;
+    std::vector<u32> indices_;
+    spatial::TriangleBvh bvh_;
+    std::mt19937 generator_;
+};
+
+TEST_F(TriangleBvhTest, Build) {
+    EXPECT_EQ(bvh_.TriangleCount(), count);
+    EXPECT_GT(bvh_.NodeCount(), 1);
+}
+
+TEST_F(TriangleBvhTest, MatchesBruteForce) {
+    std::uniform_real_distribution<f32> target(-20.0f, 20.0f);
+    u32 hits = 0;
+
+    for (u32 i = 0; i < 200; ++i) {
+        const math::vec3 origin { -40.0f, target(generator_), target(generator_) };
+        const math::vec3 to { 40.0f, target(generator_), target(generator_) };
+        const math::vec3 direction { to.x - origin.x, to.y - origin.y, to.z - origin.z };
+
+        const spatial::TriangleHit expected = BruteForce(origin, direction);
+        spatial::TriangleHit hit;
+        const bool found = bvh_.Raycast(origin, direction, FLT_MAX, hit);
+
+        EXPECT_EQ(found, expected.triangle != UINT_MAX);
+        if (found) {
+            ++hits;
+            EXPECT_EQ(hit.triangle, expected.triangle);
+            EXPECT_NEAR(hit.distance, expected.distance, 1e-5f);
+            EXPECT_NEAR(hit.u, expected.u, 1e-4f);
+            EXPECT_NEAR(hit.v, expected.v, 1e-4f);
+        }
+    }
+    EXPECT_GT(hits, 0);
+}
+
+TEST_F(TriangleBvhTest, MaxDistance) {
+    const math::vec3 origin { -40.0f, 0.5f, 0.5f };
+    const math::vec3 direction { 1.0f, 0.0f, 0.0f };
+    spatial::TriangleHit hit;
+    EXPECT_FALSE(bvh_.Raycast(origin, direction, 1.0f, hit));
+}
+
+// Packets of diverging rays from a shared origin, every lane matches its single ray
+TEST_F(TriangleBvhTest, PacketMatchesSingleRays) {
+    std::uniform_real_distribution<f32> target(-20.0f, 20.0f);
+    u32 hits = 0;
+
+    for (u32 i = 0; i < 100; ++i) {
+        spatial::RayPacket packet;
+        spatial::PacketHit packetHit;
+        for (u32 lane = 0; lane < 4; ++lane) {
+            packet.origin[0][lane] = -40.0f;
+            packet.origin[1][lane] = (f32)i * 0.1f - 5.0f;
+            packet.origin[2][lane] = 0.0f;
+            packet.direction[0][lane] = 80.0f;
+            packet.direction[1][lane] = target(generator_);
+            packet.direction[2][lane] = target(generator_);
+        }
+        packetHit.distance[3] = i % 2 == 0 ? 0.0f : FLT_MAX; // Disabled lane
+        const u32 mask = bvh_.RaycastPacket(packet, packetHit);
+
+        for (u32 lane = 0; lane < 4; ++lane) {
+            const math::vec3 origin { packet.origin[0][lane], packet.origin[1][lane], packet.origin[2][lane] };
+            const math::vec3 direction { packet.direction[0][lane], packet.direction[1][lane], packet.direction[2][lane] };
+            spatial::TriangleHit hit;
+            const bool found = (lane != 3 or i % 2 == 1) and bvh_.Raycast(origin, direction, FLT_MAX, hit);
+
+            EXPECT_EQ((mask >> lane) & 1, found ? 1u : 0u);
+            if (found) {
+                ++hits;
+                EXPECT_EQ(packetHit.triangle[lane], hit.triangle);
+                EXPECT_NEAR(packetHit.distance[lane], hit.distance, 1e-5f);
+                EXPECT_NEAR(packetHit.u[lane], hit.u, 1e-4f);
+                EXPECT_NEAR(packetHit.v[lane], hit.v, 1e-4f);
+            }
+        }
+        if (i % 2 == 0) EXPECT_EQ(packetHit.distance[3], 0.0f);
+    }
+    EXPECT_GT(hits, 0);
+}
+
+}
@@ -13,8 +13,6 @@
 #include <gtest/gtest.h>
 #include "math/math.hpp"
 
-LogLevel loglevel = logDEBUG;
-
 namespace reveal3d {
 
 class Vector3Test : public testing::Test {
@@ -0,0 +1,140 @@
+/************************************************************************
+ * Copyright (c) 2024 Alvaro Cabrera Barrio
+ * This code is licensed under MIT license (see LICENSE.txt for details)
+ ************************************************************************/
+/**
+ * @file visibility_cache_test.cpp
+ * @version 1.0
+ * @date 19/10/2026
+ * @brief Visibility cache unit testing
+ *
+ * Cached results are compared every frame with a full frustum culling pass.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+
+#include "render/visibility_cache.hpp"
+
+namespace reveal3d {
+
+class VisibilityCacheTest : public testing::Test {
+protected:
+    static constexpr u32 count = 20000;
+
+    VisibilityCacheTest() : generator_(11) {
+        boxes_.Resize(count);
+        for (u32 i = 0; i < count; ++i) {
+            boxes_.Set(i, RandomBox());
+        }
+        cache_.Resize(count);
+        mirror_.resize(count, 0);
+    }
+
+    render::Bounds RandomBox() {
+        std::uniform_real_distribution<f32> position(-100.0f, 100.0f);
+        std::uniform_real_distribution<f32> size(0.1f, 2.0f);
+        render::Bounds bounds;
+        bounds.center = { position(generator_), position(generator_), position(generator_) };
+        bounds.extents = { size(generator_), size(generator_), size(generator_) };
+        return bounds;
+    }
+
+    // 90 degree camera turned yaw radians around y
+    static render::Frustum Camera(f32 x, f32 y, f32 z, f32 yaw) {
+        const f32 f[3] = { std::sin(yaw), 0.0f, std::cos(yaw) };
+        const f32 r[3] = { std::cos(yaw), 0.0f, -std::sin(yaw) };
+        const f32 u[3] = { 0.0f, 1.0f, 0.0f };
+        const f32 p[3] = { x, y, z };
+        const f32 s = 1.0f / std::sqrt(2.0f);
+        auto plane = [&](const f32 a[3], const f32 b[3], f32 sign, f32 offset) {
+            const f32 n[3] = { (a[0] + sign * b[0]) * s, (a[1] + sign * b[1]) * s, (a[2] + sign * b[2]) * s };
+            return math::vec4 { n[0], n[1], n[2], -(n[0] * p[0] + n[1] * p[1] + n[2] * p[2]) + offset };
+        };
+
+        render::Frustum frustum;
+        frustum.planes[render::Frustum::left]   = plane(f, r, 1.0f, 0.0f);
+        frustum.planes[render::Frustum::right]  = plane(f, r, -1.0f, 0.0f);
+        frustum.planes[render::Frustum::bottom] = plane(f, u, 1.0f, 0.0f);
+        frustum.planes[render::Frustum::top]    = plane(f, u, -1.0f, 0.0f);
+        const f32 forward = f[0] * p[0] + f[1] * p[1] + f[2] * p[2];
+        frustum.planes[render::Frustum::zNear]  = { f[0], f[1], f[2], -forward - 0.1f };
+        frustum.planes[render::Frustum::zFar]   = { -f[0], -f[1], -f[2], forward + 80.0f };
+        return frustum;
+    }
+
+    void Check(const render::Frustum &frustum) {
+        cache_.Update(frustum, boxes_);
+        for (const u32 index : cache_.Changed()) {
+            mirror_[index] ^= 1;
+        }
+
+        std::vector<u8> expected(count);
+        render::FrustumCull(frustum, boxes_, 0, count, expected.data());
+        for (u32 i = 0; i < count; ++i) {
+            ASSERT_EQ(cache_.Visible(i), (bool)expected[i]) << "box " << i;
+            ASSERT_EQ(mirror_[i], expected[i]) << "box " << i;
+        }
+    }
+
+    render::CullingBoxes boxes_;
+    render::VisibilityCache cache_;
+    std::vector<u8> mirror_; // Rebuilt from changed lists only
+    std::mt19937 generator_;
+};
+
+TEST_F(VisibilityCacheTest, FirstUpdateTestsEverything) {
+    Check(Camera(0.0f, 0.0f, 0.0f, 0.0f));
+    EXPECT_EQ(cache_.Tested(), count);
+}
+
+TEST_F(VisibilityCacheTest, StillCamera) {
+    const render::Frustum frustum = Camera(0.0f, 0.0f, 0.0f, 0.0f);
+    Check(frustum);
+    Check(frustum);
+    EXPECT_EQ(cache_.Tested(), 0);
+}
+
+TEST_F(VisibilityCacheTest, SlowCamera) {
+    Check(Camera(0.0f, 0.0f, 0.0f, 0.0f));
+    u32 tested = 0;
+    for (u32 frame = 1; frame <= 120; ++frame) {
+        Check(Camera(0.02f * (f32)frame, 0.0f, 0.01f * (f32)frame, 0.001f * (f32)frame));
+        tested += cache_.Tested();
+    }
+    EXPECT_LT(tested / 120, count / 10);
+}
+
+TEST_F(VisibilityCacheTest, MovedBoxes) {
+    const render::Frustum frustum = Camera(0.0f, 0.0f, 0.0f, 0.0f);
+    Check(frustum);
+    for (u32 i = 0; i < 100; ++i) {
+        boxes_.Set(i * 7, RandomBox());
+        cache_.Invalidate(i * 7);
+    }
+    Check(frustum);
+    EXPECT_EQ(cache_.Tested(), 100);
+}
+
+TEST_F(VisibilityCacheTest, CameraJump) {
+    Check(Camera(0.0f, 0.0f, 0.0f, 0.0f));
+    Check(Camera(50.0f, 10.0f, -30.0f, 2.0f));
+    EXPECT_EQ(cache_.Tested(), count);
+    Check(Camera(50.0f, 10.0f, -30.0f, 2.001f));
+}
+
+TEST_F(VisibilityCacheTest, Resize) {
+    Check(Camera(0.0f, 0.0f, 0.0f, 0.0f));
+    boxes_.Resize(count + 10);
+    mirror_.resize(count + 10, 0);
+    for (u32 i = count; i < count + 10; ++i) {
+        boxes_.Set(i, RandomBox());
+    }
+    cache_.Resize(count + 10);
+    cache_.Update(Camera(0.0f, 0.0f, 0.0f, 0.0f), boxes_);
+    EXPECT_EQ(cache_.Tested(), 10);
+}
+
+}